@@ -16,36 +16,56 @@ C_SRCS += \
 ../src/composite_widget.c \
 ../src/device_audio_task.c \
 ../src/device_mouse_hid_task.c \
+../src/dg8saq_queue.c \
+../src/eventlog.c \
 ../src/features.c \
 ../src/flashyBlinky.c \
 ../src/flashyblinky_image.c \
 ../src/freq_and_filters.c \
 ../src/host_audio_task.c \
+../src/hpsdr_cc.c \
 ../src/hpsdr_device_audio_task.c \
+../src/hpsdr_frame.c \
 ../src/hpsdr_image.c \
+../src/hpsdr_mic.c \
 ../src/hpsdr_taskAK5394A.c \
 ../src/hpsdr_usb_descriptors.c \
 ../src/hpsdr_usb_specific_request.c \
 ../src/image.c \
+../src/iq_correction.c \
+../src/iq_decimator.c \
+../src/packet_sizer.c \
+../src/ram_budget.c \
 ../src/rotary_encoder.c \
+../src/si570_tune.c \
+../src/spectrum.c \
+../src/spectrum_fft.c \
+../src/spk_usb_counters.c \
+../src/stream_health.c \
+../src/sweep.c \
 ../src/taskAK5394A.c \
 ../src/taskEXERCISE.c \
 ../src/taskLCD.c \
 ../src/taskMoboCtrl.c \
 ../src/taskPowerDisplay.c \
 ../src/taskPushButtonMenu.c \
+../src/taskRunStats.c \
+../src/taskStartupLeds.c \
 ../src/taskStartupLogDisplay.c \
+../src/telemetry.c \
 ../src/uac1_device_audio_task.c \
 ../src/uac1_image.c \
 ../src/uac1_taskAK5394A.c \
 ../src/uac1_usb_descriptors.c \
 ../src/uac1_usb_specific_request.c \
+../src/uac2_audio_controls.c \
 ../src/uac2_device_audio_task.c \
 ../src/uac2_image.c \
 ../src/uac2_taskAK5394A.c \
 ../src/uac2_usb_descriptors.c \
 ../src/uac2_usb_specific_request.c \
 ../src/usb_descriptors.c \
+../src/usb_power.c \
 ../src/usb_specific_request.c \
 ../src/widget.c 
 
@@ -62,36 +82,56 @@ OBJS += \
 ./src/composite_widget.o \
 ./src/device_audio_task.o \
 ./src/device_mouse_hid_task.o \
+./src/dg8saq_queue.o \
+./src/eventlog.o \
 ./src/features.o \
 ./src/flashyBlinky.o \
 ./src/flashyblinky_image.o \
 ./src/freq_and_filters.o \
 ./src/host_audio_task.o \
+./src/hpsdr_cc.o \
 ./src/hpsdr_device_audio_task.o \
+./src/hpsdr_frame.o \
 ./src/hpsdr_image.o \
+./src/hpsdr_mic.o \
 ./src/hpsdr_taskAK5394A.o \
 ./src/hpsdr_usb_descriptors.o \
 ./src/hpsdr_usb_specific_request.o \
 ./src/image.o \
+./src/iq_correction.o \
+./src/iq_decimator.o \
+./src/packet_sizer.o \
+./src/ram_budget.o \
 ./src/rotary_encoder.o \
+./src/si570_tune.o \
+./src/spectrum.o \
+./src/spectrum_fft.o \
+./src/spk_usb_counters.o \
+./src/stream_health.o \
+./src/sweep.o \
 ./src/taskAK5394A.o \
 ./src/taskEXERCISE.o \
 ./src/taskLCD.o \
 ./src/taskMoboCtrl.o \
 ./src/taskPowerDisplay.o \
 ./src/taskPushButtonMenu.o \
+./src/taskRunStats.o \
+./src/taskStartupLeds.o \
 ./src/taskStartupLogDisplay.o \
+./src/telemetry.o \
 ./src/uac1_device_audio_task.o \
 ./src/uac1_image.o \
 ./src/uac1_taskAK5394A.o \
 ./src/uac1_usb_descriptors.o \
 ./src/uac1_usb_specific_request.o \
+./src/uac2_audio_controls.o \
 ./src/uac2_device_audio_task.o \
 ./src/uac2_image.o \
 ./src/uac2_taskAK5394A.o \
 ./src/uac2_usb_descriptors.o \
 ./src/uac2_usb_specific_request.o \
 ./src/usb_descriptors.o \
+./src/usb_power.o \
 ./src/usb_specific_request.o \
 ./src/widget.o 
 
@@ -109,36 +149,56 @@ C_DEPS += \
 ./src/composite_widget.d \
 ./src/device_audio_task.d \
 ./src/device_mouse_hid_task.d \
+./src/dg8saq_queue.d \
+./src/eventlog.d \
 ./src/features.d \
 ./src/flashyBlinky.d \
 ./src/flashyblinky_image.d \
 ./src/freq_and_filters.d \
 ./src/host_audio_task.d \
+./src/hpsdr_cc.d \
 ./src/hpsdr_device_audio_task.d \
+./src/hpsdr_frame.d \
 ./src/hpsdr_image.d \
+./src/hpsdr_mic.d \
 ./src/hpsdr_taskAK5394A.d \
 ./src/hpsdr_usb_descriptors.d \
 ./src/hpsdr_usb_specific_request.d \
 ./src/image.d \
+./src/iq_correction.d \
+./src/iq_decimator.d \
+./src/packet_sizer.d \
+./src/ram_budget.d \
 ./src/rotary_encoder.d \
+./src/si570_tune.d \
+./src/spectrum.d \
+./src/spectrum_fft.d \
+./src/spk_usb_counters.d \
+./src/stream_health.d \
+./src/sweep.d \
 ./src/taskAK5394A.d \
 ./src/taskEXERCISE.d \
 ./src/taskLCD.d \
 ./src/taskMoboCtrl.d \
 ./src/taskPowerDisplay.d \
 ./src/taskPushButtonMenu.d \
+./src/taskRunStats.d \
+./src/taskStartupLeds.d \
 ./src/taskStartupLogDisplay.d \
+./src/telemetry.d \
 ./src/uac1_device_audio_task.d \
 ./src/uac1_image.d \
 ./src/uac1_taskAK5394A.d \
 ./src/uac1_usb_descriptors.d \
 ./src/uac1_usb_specific_request.d \
+./src/uac2_audio_controls.d \
 ./src/uac2_device_audio_task.d \
 ./src/uac2_image.d \
 ./src/uac2_taskAK5394A.d \
 ./src/uac2_usb_descriptors.d \
 ./src/uac2_usb_specific_request.d \
 ./src/usb_descriptors.d \
+./src/usb_power.d \
 ./src/usb_specific_request.d \
 ./src/widget.d 
 
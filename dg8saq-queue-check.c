@@ -0,0 +1,571 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * dg8saq-queue-check.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Run the DG8SAQ command queue of src/dg8saq_queue.c on the host, built
+ * for the Mobo firmware tuning the Si570, and for SI570_SMOOTH_TUNE:
+ *
+ *   dg8saq-queue-check-0 [-v]
+ *   dg8saq-queue-check-1 [-v]
+ *
+ * The hooks of the Mobo firmware are answered by a model of the Si570
+ * that takes CHECK_COMMAND_TICKS of I2C a command. The DG8SAQ task only
+ * runs between requests, or while EP0 is held for a request deferred, as
+ * it has the lower priority; a host waits CHECK_HOST_WAIT for that:
+ *
+ *   - a sweep of frequency sets and register writes, back to back, is
+ *     acknowledged without EP0 held, the commands run in the order they
+ *     came and only the last frequency set of a run is tuned to
+ *   - the frequency reads back as set at once
+ *   - a frequency query with nothing cached is deferred, one cached is
+ *     answered at once and refreshed for the next time
+ *   - a host to device command makes the other replies stale
+ *   - the CW keys are read by the task while the host asks for them, and
+ *     answered at once, the PTT set too, which makes the cache stale when
+ *     it changes and is not run again when it does not
+ *   - a Mobo feature query is deferred and gets its own reply, not the one
+ *     of a query given up on, which is not sent once the host went on
+ *   - requests to a task that stopped are not answered
+ *
+ * and with SI570_SMOOTH_TUNE, si570_tune.c being a stub:
+ *
+ *   - the subtract and multiply loaded from the Mobo firmware once
+ *   - a frequency set tuned to by si570_tune.c and the filters switched,
+ *     not the Mobo firmware told
+ *   - in TX the filters held, and the frequency left to the Mobo firmware
+ *     where the board holds it, as one si570_tune.c cannot make
+ *
+ * Prints the time EP0 was held against running each command in place,
+ * exits 1 if a check fails, -v lists the commands run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "board.h"
+#include "FreeRTOS.h"
+#include "eventlog.h"
+#include "dg8saq_queue.h"
+#include "sweep.h"
+#if SI570_SMOOTH_TUNE
+#include "Mobo_config.h"
+#include "freq_and_filters.h"
+#include "si570_tune.h"
+#endif
+
+#define CHECK_COMMAND_TICKS		10			// 1 ms of I2C at 100 kHz
+#define CHECK_WRITE_REGISTER	0x64		// a Mobo register, not a frequency set or an Si570 setting
+#define CHECK_SWEEP				200			// frequency sets
+#define CHECK_REGISTER_EVERY	25			// one register write every so many
+#define CHECK_RUN_MAX			512			// commands logged
+#define CHECK_FREQ(seq)			(0x0e100000 + (seq) * 0x1000)	// of a sweep set
+#define CHECK_SUB				0x00100000	// the subtract and multiply of the Mobo firmware
+#define CHECK_MUL				0x00800000
+#define CHECK_FREQ_BAD			0x7fffffff	// one si570_tune.c cannot make
+#define CHECK_FEATURE			0x61		// a Mobo feature query, answers its wValue
+#define CHECK_MS				(configTICK_RATE_HZ / 1000)
+#define CHECK_HOST_WAIT			(500 * CHECK_MS)	// a host gives up on a request after
+
+enum {
+	CHECK_EP0_IDLE,
+	CHECK_EP0_ANSWERED,
+	CHECK_EP0_DEFERRED,
+	CHECK_EP0_STALLED
+};
+
+extern void vStartTaskDG8SAQ(void);
+
+volatile int dg8saq_queue_check_semaphore;
+
+static int verbose;
+static const char *fail;			// first rule a case broke
+
+static int check_task_runs = 1;		// the DG8SAQ task gets the CPU
+static portTickType check_budget;	// ticks the task has not used yet
+static portTickType check_ep0;		// ticks EP0 was held for requests deferred
+static portTickType check_now;		// the tick count
+static unsigned check_events;
+
+// EP0 as the host sees it
+static int check_ep0_state;
+static U16 check_setups;			// the ticket of the request in progress
+static U8 check_ep0_data[DG8SAQ_QUEUE_DATA];
+static U16 check_ep0_length;
+
+static U32 check_freq = CHECK_FREQ(0);	// the Si570 model
+static unsigned check_mobo_sets;		// frequency sets the Mobo firmware ran
+static U8 check_keys;				// the CW paddles, change on their own
+static U16 check_ptt;
+static struct {
+	U8 request;
+	U16 value;
+} check_run[CHECK_RUN_MAX];
+static unsigned check_runs;
+
+void eventlog_put(eventlog_id_t id, U32 arg0, U32 arg1, U32 arg2) {
+	check_events += 1;
+	if (verbose)
+		printf("event %u: request 0x%x, %u queued, %u ticks\n", id, arg0, arg1, arg2);
+}
+
+// no sweep, the TC and its interrupt are not modelled
+Bool sweep_next(U32 *freq) {
+	return FALSE;
+}
+
+void sweep_tuned(void) {
+}
+
+void sweep_stop(void) {
+}
+
+void sweep_init(void) {
+}
+
+static void check_log(U8 request, U16 value) {
+	if (check_runs < CHECK_RUN_MAX) {
+		check_run[check_runs].request = request;
+		check_run[check_runs].value = value;
+	}
+	check_runs += 1;
+	if (verbose)
+		printf("run 0x%02x %u\n", request, value);
+}
+
+void dg8saqFunctionWrite(U8 type, U16 wValue, U16 wIndex, U8 *Buffer, U8 len) {
+	check_log(type, wValue);
+	if (type == DG8SAQ_SET_FREQ && len == 4) {
+		memcpy(&check_freq, Buffer, 4);
+		check_mobo_sets += 1;
+	}
+}
+
+U8 dg8saqFunctionSetup(U8 type, U16 wValue, U16 wIndex, U8 *Buffer) {
+	U32 word;
+
+	check_log(type, wValue);
+	if (type == DG8SAQ_GET_SUB_MUL) {
+		word = CHECK_MUL;
+		memcpy(Buffer, &word, 4);
+		word = CHECK_SUB;
+		memcpy(Buffer + 4, &word, 4);
+		return 8;
+	}
+	if (type == DG8SAQ_GET_FREQ) {
+		memcpy(Buffer, &check_freq, 4);
+		return 4;
+	}
+	if (type == DG8SAQ_SET_PTT)
+		check_ptt = wValue;
+	if (type == DG8SAQ_SET_PTT || type == DG8SAQ_GET_KEYS) {
+		Buffer[0] = check_keys;
+		return 1;
+	}
+	if (type == CHECK_FEATURE) {
+		Buffer[0] = wValue;
+		return 1;
+	}
+	return 0;
+}
+
+#if SI570_SMOOTH_TUNE
+Bool TX_state;
+int dg8saq_queue_check_frq_during_tx = 1, dg8saq_queue_check_fltr_during_tx = 0;
+
+static U32 check_si570_freq;			// si570_tune.c's, 0 if forgotten
+static S32 check_sub;
+static U32 check_mul;
+static unsigned check_filters;
+static U32 check_filter_freq;
+
+// the Si570 model tuned, logged with the wValue of the sweep set
+Bool si570_set_freq(U32 freq) {
+	if (freq == CHECK_FREQ_BAD)
+		return FALSE;
+	check_log(DG8SAQ_SET_FREQ, 2 * ((freq - CHECK_FREQ(0)) / (CHECK_FREQ(1) - CHECK_FREQ(0))));
+	check_freq = check_si570_freq = freq;
+	return TRUE;
+}
+
+U32 si570_get_freq(void) {
+	return check_si570_freq;
+}
+
+void si570_set_xtal(U32 xtal) {
+}
+
+void si570_set_smooth(U16 ppm) {
+}
+
+void si570_set_sub_mul(S32 sub, U32 mul) {
+	check_sub = sub;
+	check_mul = mul;
+}
+
+void si570_forget(void) {
+	check_si570_freq = 0;
+}
+
+U8 SetFilter(U32 freq) {
+	check_filters += 1;
+	check_filter_freq = freq;
+	return 0;
+}
+
+void SetLPF(U32 freq) {
+	if (freq != check_filter_freq)
+		fail = fail ? fail : "band pass and low pass filters apart";
+}
+#endif
+
+//
+// the Si570 tuned around the queue
+//
+static void check_retune(U32 freq) {
+	check_freq = freq;
+#if SI570_SMOOTH_TUNE
+	check_si570_freq = freq;
+#endif
+}
+
+//
+// the DG8SAQ task, for the ticks the USB device task leaves it
+//
+static void check_task(portTickType ticks) {
+	check_now += ticks;
+	check_budget += ticks;
+	while (check_task_runs && check_budget >= CHECK_COMMAND_TICKS) {
+		if (! dg8saq_queue_run()) {
+			check_budget = 0;	// idle, nothing banked
+			return;
+		}
+		check_budget -= CHECK_COMMAND_TICKS;
+	}
+}
+
+portTickType xTaskGetTickCount(void) {
+	return check_now;
+}
+
+//
+// the control endpoint API, on the state of EP0 the host sees
+//
+void usb_ctrl_send(const void *data, U16 length) {
+	memcpy(check_ep0_data, data, length);
+	check_ep0_length = length;
+	check_ep0_state = CHECK_EP0_ANSWERED;
+}
+
+void usb_ctrl_stall(void) {
+	check_ep0_state = CHECK_EP0_STALLED;
+}
+
+U16 usb_ctrl_defer(void) {
+	check_ep0_state = CHECK_EP0_DEFERRED;
+	return check_setups;
+}
+
+Bool usb_ctrl_deferred_send(U16 ticket, const void *data, U16 length) {
+	if (check_ep0_state != CHECK_EP0_DEFERRED || ticket != check_setups)
+		return FALSE;
+	usb_ctrl_send(data, length);
+	return TRUE;
+}
+
+Bool usb_ctrl_deferred_ack(U16 ticket) {
+	return usb_ctrl_deferred_send(ticket, NULL, 0);
+}
+
+Bool usb_ctrl_deferred_stall(U16 ticket) {
+	if (check_ep0_state != CHECK_EP0_DEFERRED || ticket != check_setups)
+		return FALSE;
+	usb_ctrl_stall();
+	return TRUE;
+}
+
+static void check_setup(void) {
+	check_setups += 1;
+	check_ep0_state = CHECK_EP0_IDLE;
+}
+
+//
+// the host waiting for a request deferred, CHECK_HOST_WAIT at most, FALSE
+// if it was not answered
+//
+static Bool check_ep0_wait(void) {
+	portTickType waited = 0;
+
+	while (check_ep0_state == CHECK_EP0_DEFERRED && waited < CHECK_HOST_WAIT) {
+		check_task(CHECK_COMMAND_TICKS);
+		waited += CHECK_COMMAND_TICKS;
+	}
+	check_ep0 += waited;
+	return check_ep0_state == CHECK_EP0_ANSWERED;
+}
+
+//
+// a host to device command, acknowledged by the completion of its data
+// stage but when deferred
+//
+static Bool check_write(U8 request, U16 value, const U8 *data, U8 length) {
+	check_setup();
+	if (! dg8saq_queue_write(request, value, 0, data, length))
+		return FALSE;
+	return check_ep0_state != CHECK_EP0_DEFERRED || check_ep0_wait();
+}
+
+//
+// a query, the reply back in MCU order, -1 if it was not answered
+//
+static S16 check_request(U8 request, U16 value, U8 *reply) {
+	check_setup();
+	dg8saq_queue_query(request, value, 0);
+	if (! check_ep0_wait())
+		return -1;
+	memcpy(reply, check_ep0_data, check_ep0_length);
+	dg8saq_reverse(reply, check_ep0_length);
+	return check_ep0_length;
+}
+
+static void check_set_freq(U32 freq, U16 seq) {
+	U8 data[4];
+
+	memcpy(data, &freq, 4);
+	if (! check_write(DG8SAQ_SET_FREQ, seq, data, 4))
+		fail = fail ? fail : "frequency set not queued";
+}
+
+static S16 check_query(U8 request, U8 *reply) {
+	return check_request(request, 0, reply);
+}
+
+static S16 check_set_ptt(U16 ptt, U8 *reply) {
+	return check_request(DG8SAQ_SET_PTT, ptt, reply);
+}
+
+static U32 check_get_freq(void) {
+	U8 reply[DG8SAQ_QUEUE_DATA];
+	U32 freq = 0;
+
+	if (check_query(DG8SAQ_GET_FREQ, reply) != 4)
+		fail = fail ? fail : "no frequency read";
+	else
+		memcpy(&freq, reply, 4);
+	return freq;
+}
+
+int main(int argc, char *argv[]) {
+	U8 reply[DG8SAQ_QUEUE_DATA], data[4] = { 0 };
+	U16 seq, last;
+	unsigned n, tuned = 0, registers = 0, runs, events;
+#if SI570_SMOOTH_TUNE
+	unsigned sets;
+#endif
+	portTickType ep0, sweep;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	vStartTaskDG8SAQ();
+
+	// nothing cached, waited for, then at once
+	if (check_get_freq() != check_freq)
+		fail = fail ? fail : "first frequency read";
+	if (check_ep0 == 0 || check_ep0 > 2 * CHECK_COMMAND_TICKS)
+		fail = fail ? fail : "first query not waited for";
+	check_task(100);
+	ep0 = check_ep0;
+	if (check_get_freq() != check_freq || check_ep0 != ep0)
+		fail = fail ? fail : "cached frequency not at once";
+	check_task(100);
+
+	// the sweep, back to back, wValue counting up
+	runs = check_runs;
+	ep0 = check_ep0;
+	for (seq = 1; seq <= CHECK_SWEEP; seq += 1) {
+		check_set_freq(CHECK_FREQ(seq), 2 * seq);
+		if (seq % CHECK_REGISTER_EVERY == 0 && ! check_write(CHECK_WRITE_REGISTER, 2 * seq + 1, data, 1))
+			fail = fail ? fail : "register write not queued";
+		// the USB device task is idle a command's time between requests at the most
+		check_task(seq % 3 == 0 ? CHECK_COMMAND_TICKS : 0);
+	}
+	sweep = check_ep0 - ep0;
+	if (sweep != 0)
+		fail = fail ? fail : "EP0 waited in the sweep";
+	// read back before the last set was tuned to
+	if (check_get_freq() != CHECK_FREQ(CHECK_SWEEP))
+		fail = fail ? fail : "frequency read back not the one set";
+	check_task(1000);
+	if (check_freq != CHECK_FREQ(CHECK_SWEEP))
+		fail = fail ? fail : "last frequency set not tuned to";
+
+	for (n = runs, last = 0; n < check_runs && n < CHECK_RUN_MAX; n += 1) {
+		if (check_run[n].request == DG8SAQ_GET_FREQ || check_run[n].request == DG8SAQ_GET_SUB_MUL)
+			continue;
+		if (check_run[n].value <= last)
+			fail = fail ? fail : "commands out of order";
+		last = check_run[n].value;
+		if (check_run[n].request == DG8SAQ_SET_FREQ)
+			tuned += 1;
+		else
+			registers += 1;
+	}
+	if (registers != CHECK_SWEEP / CHECK_REGISTER_EVERY)
+		fail = fail ? fail : "register writes lost";
+	if (tuned >= CHECK_SWEEP)
+		fail = fail ? fail : "frequency sets not coalesced";
+
+	// a cached reply refreshed for the next query, the Si570 model tuned
+	// around the queue
+	check_retune(0x0e200000);
+	check_get_freq();
+	check_task(100);
+	ep0 = check_ep0;
+	if (check_get_freq() != 0x0e200000 || check_ep0 != ep0)
+		fail = fail ? fail : "cached reply not at once";
+	for (n = 0; n < 4 * DG8SAQ_QUEUE_SLOTS; n += 1)
+		check_get_freq();
+	if (check_ep0 != ep0)
+		fail = fail ? fail : "repeated query filled the queue";
+	check_task(100);
+
+	// stale after a host to device command
+	check_retune(0x0e300000);
+	check_write(CHECK_WRITE_REGISTER, 0, data, 1);
+	if (check_get_freq() != 0x0e300000 || check_ep0 == ep0)
+		fail = fail ? fail : "stale reply answered";
+	check_task(100);
+
+	// the paddles waited for once, then read by the task while the host
+	// asks for them, and answered at once
+	check_keys = 1;
+	ep0 = check_ep0;
+	if (check_query(DG8SAQ_GET_KEYS, reply) != 1 || reply[0] != 1 || check_ep0 == ep0)
+		fail = fail ? fail : "first paddle read not deferred";
+	for (n = 2; n <= 4; n += 1) {
+		check_keys = n;
+		check_task(DG8SAQ_STATUS_PERIOD * CHECK_MS);
+		ep0 = check_ep0;
+		if (check_query(DG8SAQ_GET_KEYS, reply) != 1 || reply[0] != n || check_ep0 != ep0)
+			fail = fail ? fail : "paddles not read by the task";
+	}
+	// and let go stale once the host stopped asking
+	check_task(2 * DG8SAQ_STATUS_IDLE * CHECK_MS);
+	check_keys = 5;
+	ep0 = check_ep0;
+	if (check_query(DG8SAQ_GET_KEYS, reply) != 1 || reply[0] != 5 || check_ep0 == ep0)
+		fail = fail ? fail : "paddles not asked for answered from the cache";
+
+	// the PTT set, answered with the paddles, and the cache stale after it
+	check_retune(0x0e400000);
+	ep0 = check_ep0;
+	if (check_set_ptt(1, reply) != 1 || reply[0] != check_keys || check_ep0 != ep0)
+		fail = fail ? fail : "PTT set not answered at once";
+	check_task(100);
+	if (check_ptt != 1)
+		fail = fail ? fail : "PTT not set";
+	if (check_get_freq() != 0x0e400000)
+		fail = fail ? fail : "reply stale after the PTT answered";
+	check_task(100);
+
+	// set again as it is, neither run nor the cache stale
+	runs = check_runs;
+	ep0 = check_ep0;
+	if (check_set_ptt(1, reply) != 1 || check_get_freq() != 0x0e400000 || check_ep0 != ep0)
+		fail = fail ? fail : "PTT set again made the cache stale";
+	check_task(100);
+	for (n = runs; n < check_runs && n < CHECK_RUN_MAX; n += 1)
+		if (check_run[n].request == DG8SAQ_SET_PTT)
+			fail = fail ? fail : "PTT set again run";
+
+	// a Mobo feature given up on, its reply not the one of the next
+	events = check_events;
+	check_task_runs = 0;
+	if (check_request(CHECK_FEATURE, 1, reply) >= 0)
+		fail = fail ? fail : "query to a stopped task answered";
+	check_task_runs = 1;
+	if (check_request(CHECK_FEATURE, 2, reply) != 1 || reply[0] != 2 || check_events != events + 1)
+		fail = fail ? fail : "reply of a query given up on taken";
+	check_task(100);
+
+	// and not sent once the host went on to another request
+	events = check_events;
+	check_task_runs = 0;
+	check_request(CHECK_FEATURE, 3, reply);
+	check_write(CHECK_WRITE_REGISTER, 0, data, 1);
+	check_task_runs = 1;
+	check_task(100);
+	if (check_events != events + 1 || check_ep0_state != CHECK_EP0_IDLE)
+		fail = fail ? fail : "reply sent to the request after";
+
+#if SI570_SMOOTH_TUNE
+	// the subtract and multiply of the Mobo firmware, before the sweep
+	if (check_sub != CHECK_SUB || check_mul != CHECK_MUL)
+		fail = fail ? fail : "subtract and multiply not loaded";
+
+	// tuned by si570_tune.c, the filters switched for it
+	sets = check_mobo_sets;
+	check_set_freq(0x0e500000, 0);
+	check_task(100);
+	if (check_si570_freq != 0x0e500000 || check_filters == 0 || check_filter_freq != 0x0e500000
+		|| check_mobo_sets != sets)
+		fail = fail ? fail : "frequency set not tuned by si570_tune.c";
+
+	// in TX the filters held
+	TX_state = TRUE;
+	check_set_freq(0x0e510000, 0);
+	check_task(100);
+	if (check_si570_freq != 0x0e510000 || check_filter_freq != 0x0e500000 || check_mobo_sets != sets)
+		fail = fail ? fail : "filters switched in TX";
+
+	// and the frequency too on a board that holds it, by the Mobo firmware
+	dg8saq_queue_check_frq_during_tx = 0;
+	check_set_freq(0x0e520000, 0);
+	check_task(100);
+	if (check_si570_freq != 0 || check_mobo_sets != sets + 1 || check_filter_freq != 0x0e500000)
+		fail = fail ? fail : "frequency in TX not left to the Mobo firmware";
+	dg8saq_queue_check_frq_during_tx = 1;
+	TX_state = FALSE;
+
+	// one si570_tune.c cannot make, by the Mobo firmware, and read back from it
+	check_set_freq(0x0e530000, 0);
+	check_task(100);
+	check_set_freq(CHECK_FREQ_BAD, 0);
+	check_task(100);
+	if (check_si570_freq != 0 || check_mobo_sets != sets + 2 || check_freq != CHECK_FREQ_BAD)
+		fail = fail ? fail : "frequency set not left to the Mobo firmware";
+	if (check_get_freq() != CHECK_FREQ_BAD)
+		fail = fail ? fail : "frequency not read back from the Mobo firmware";
+	check_task(100);
+	if (check_runs > CHECK_RUN_MAX || check_run[check_runs - 1].request != DG8SAQ_GET_FREQ)
+		fail = fail ? fail : "frequency read back not the Mobo firmware's";
+#endif
+
+	// a task that stopped, the command deferred dropped for the query after
+	events = check_events;
+	check_task_runs = 0;
+	for (n = 0; n < DG8SAQ_QUEUE_SLOTS; n += 1)
+		check_write(CHECK_WRITE_REGISTER, 0, data, 1);
+	ep0 = check_ep0;
+	if (check_write(CHECK_WRITE_REGISTER, 0, data, 1) || check_query(DG8SAQ_GET_VERSION, reply) >= 0)
+		fail = fail ? fail : "request to a stopped task taken";
+	if (check_events != events + 1 || check_ep0 - ep0 > 2 * CHECK_HOST_WAIT)
+		fail = fail ? fail : "stopped task not given up on";
+	check_task_runs = 1;
+	check_task(1000);
+
+	printf("dg8saq-queue-check: %s, %u frequency sets, %u tuned to, %u register writes in order, "
+		   "EP0 held %lu ms against %u ms run in place\n",
+		   SI570_SMOOTH_TUNE ? "smooth tune" : "Mobo tune", CHECK_SWEEP, tuned, registers, sweep / CHECK_MS,
+		   (CHECK_SWEEP + registers) * CHECK_COMMAND_TICKS / CHECK_MS);
+	if (fail) {
+		fprintf(stderr, "dg8saq-queue-check: %s\n", fail);
+		return 1;
+	}
+	return 0;
+}
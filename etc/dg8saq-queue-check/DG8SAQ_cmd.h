@@ -0,0 +1,20 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * DG8SAQ_cmd.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the DG8SAQ command hooks of the Mobo firmware,
+ * dg8saq-queue-check answers them from a model of the Si570.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_DG8SAQ_CMD_H_
+#define DG8SAQ_QUEUE_CHECK_DG8SAQ_CMD_H_
+
+#include "compiler.h"
+
+extern void dg8saqFunctionWrite(U8 type, U16 wValue, U16 wIndex, U8 *Buffer, U8 len);
+extern U8 dg8saqFunctionSetup(U8 type, U16 wValue, U16 wIndex, U8 *Buffer);
+
+#endif  // DG8SAQ_QUEUE_CHECK_DG8SAQ_CMD_H_
@@ -0,0 +1,32 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * FreeRTOS.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for FreeRTOS.h and FreeRTOSConfig.h, one task at a time,
+ * so critical sections are nothing, for dg8saq-queue-check.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_FREERTOS_H_
+#define DG8SAQ_QUEUE_CHECK_FREERTOS_H_
+
+typedef unsigned long portTickType;
+typedef unsigned long portSTACK_TYPE;
+typedef void (*pdTASK_CODE)(void *);
+typedef void *xTaskHandle;
+
+#define portBASE_TYPE					long	// a macro, as in portmacro.h, for signed portBASE_TYPE
+#define pdFALSE							0
+#define portMAX_DELAY					((portTickType)-1)
+#define portENTER_CRITICAL()
+#define portEXIT_CRITICAL()
+#define tskIDLE_PRIORITY				0
+
+#define configTICK_RATE_HZ				10000
+#define configTSK_DG8SAQ_NAME			((const signed char *)"DG8SAQ")
+#define configTSK_DG8SAQ_STACK_SIZE		256
+#define configTSK_DG8SAQ_PRIORITY		(tskIDLE_PRIORITY + 1)
+
+#endif  // DG8SAQ_QUEUE_CHECK_FREERTOS_H_
@@ -0,0 +1,19 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * Mobo_config.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the Mobo firmware configuration, the transmit state
+ * dg8saq-queue-check sets.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_MOBO_CONFIG_H_
+#define DG8SAQ_QUEUE_CHECK_MOBO_CONFIG_H_
+
+#include "compiler.h"
+
+extern Bool TX_state;
+
+#endif  // DG8SAQ_QUEUE_CHECK_MOBO_CONFIG_H_
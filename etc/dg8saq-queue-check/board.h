@@ -0,0 +1,28 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * board.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the board header, the Mobo firmware tunes the Si570
+ * unless built with SI570_SMOOTH_TUNE 1, for dg8saq-queue-check.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_BOARD_H_
+#define DG8SAQ_QUEUE_CHECK_BOARD_H_
+
+#ifndef SI570_SMOOTH_TUNE
+#define SI570_SMOOTH_TUNE	0
+#endif
+
+#define BPF_LPF_Module		1
+#define TX_FILTERS			1
+
+// constants on the board, set by the check
+extern int dg8saq_queue_check_frq_during_tx, dg8saq_queue_check_fltr_during_tx;
+
+#define FRQ_CGH_DURING_TX	dg8saq_queue_check_frq_during_tx
+#define FLTR_CGH_DURING_TX	dg8saq_queue_check_fltr_during_tx
+
+#endif  // DG8SAQ_QUEUE_CHECK_BOARD_H_
@@ -0,0 +1,17 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h, the one of usb-ctrl-replay, for
+ * dg8saq-queue-check.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_COMPILER_H_
+#define DG8SAQ_QUEUE_CHECK_COMPILER_H_
+
+#include "../usb-ctrl-replay/compiler.h"
+
+#endif  // DG8SAQ_QUEUE_CHECK_COMPILER_H_
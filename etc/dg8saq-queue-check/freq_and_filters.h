@@ -0,0 +1,20 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * freq_and_filters.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the filter switching of the Mobo firmware,
+ * dg8saq-queue-check counts the switches.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_FREQ_AND_FILTERS_H_
+#define DG8SAQ_QUEUE_CHECK_FREQ_AND_FILTERS_H_
+
+#include "compiler.h"
+
+extern U8 SetFilter(U32 freq);
+extern void SetLPF(U32 freq);
+
+#endif  // DG8SAQ_QUEUE_CHECK_FREQ_AND_FILTERS_H_
@@ -0,0 +1,26 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * semphr.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the FreeRTOS semaphores, a binary semaphore is a flag,
+ * for dg8saq-queue-check.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_SEMPHR_H_
+#define DG8SAQ_QUEUE_CHECK_SEMPHR_H_
+
+#include "FreeRTOS.h"
+
+typedef volatile int *xSemaphoreHandle;
+
+extern volatile int dg8saq_queue_check_semaphore;
+
+#define vSemaphoreCreateBinary(s)	((s) = &dg8saq_queue_check_semaphore, *(s) = 1)
+#define xSemaphoreGive(s)			(*(s) = 1)
+#define xSemaphoreGiveFromISR(s, woken)	(*(woken) = pdFALSE, *(s) = 1)
+#define xSemaphoreTake(s, ticks)	(*(s) ? (*(s) = 0, 1) : 0)
+
+#endif  // DG8SAQ_QUEUE_CHECK_SEMPHR_H_
@@ -0,0 +1,19 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * task.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the FreeRTOS task API, the tick count is the time of
+ * the model dg8saq-queue-check runs.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_TASK_H_
+#define DG8SAQ_QUEUE_CHECK_TASK_H_
+
+#include "FreeRTOS.h"
+
+extern portTickType xTaskGetTickCount(void);
+
+#endif  // DG8SAQ_QUEUE_CHECK_TASK_H_
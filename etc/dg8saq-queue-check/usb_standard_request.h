@@ -0,0 +1,24 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_standard_request.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the control endpoint API of usb_standard_request.h,
+ * dg8saq-queue-check plays the host on it.
+ */
+
+#ifndef DG8SAQ_QUEUE_CHECK_USB_STANDARD_REQUEST_H_
+#define DG8SAQ_QUEUE_CHECK_USB_STANDARD_REQUEST_H_
+
+#include "compiler.h"
+
+extern void usb_ctrl_send(const void *data, U16 length);
+extern void usb_ctrl_stall(void);
+extern U16 usb_ctrl_defer(void);
+extern Bool usb_ctrl_deferred_send(U16 ticket, const void *data, U16 length);
+extern Bool usb_ctrl_deferred_ack(U16 ticket);
+extern Bool usb_ctrl_deferred_stall(U16 ticket);
+
+#endif  // DG8SAQ_QUEUE_CHECK_USB_STANDARD_REQUEST_H_
@@ -0,0 +1,27 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h, the one of usb-ctrl-replay and
+ * the swap32() hpsdr_frame.c needs on a little endian host, and the work
+ * counters of hpsdr_mic.c, for hpsdr-frame-check.
+ */
+
+#ifndef HPSDR_FRAME_CHECK_COMPILER_H_
+#define HPSDR_FRAME_CHECK_COMPILER_H_
+
+#include "../usb-ctrl-replay/compiler.h"
+
+#define swap32(u32)		((U32)__builtin_bswap32((U32)(u32)))
+
+// the work of hpsdr_mic.c, counted by hpsdr-frame-check
+extern struct hpsdr_mic_work {
+	U32 inputs, outputs;
+} hpsdr_mic_work;
+
+#define HPSDR_MIC_WORK(what, n)	(hpsdr_mic_work.what += (n))
+
+#endif  // HPSDR_FRAME_CHECK_COMPILER_H_
@@ -0,0 +1,24 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h, the one of usb-ctrl-replay and
+ * the work counter of iq_correction.c, for iq-correction-check.
+ */
+
+#ifndef IQ_CORRECTION_CHECK_COMPILER_H_
+#define IQ_CORRECTION_CHECK_COMPILER_H_
+
+#include "../usb-ctrl-replay/compiler.h"
+
+// the work of iq_correction.c, counted by iq-correction-check
+extern struct iq_correction_work {
+	U32 runs, pairs;
+} iq_correction_work;
+
+#define IQ_CORRECTION_WORK(what, n)	(iq_correction_work.what += (n))
+
+#endif  // IQ_CORRECTION_CHECK_COMPILER_H_
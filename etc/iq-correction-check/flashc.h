@@ -0,0 +1,20 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * flashc.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the flash controller driver, the user page is plain
+ * memory, for iq-correction-check.
+ */
+
+#ifndef IQ_CORRECTION_CHECK_FLASHC_H_
+#define IQ_CORRECTION_CHECK_FLASHC_H_
+
+#include <string.h>
+
+#define flashc_memcpy(dst, src, nbytes, erase)		memcpy((dst), (src), (nbytes))
+#define flashc_memset8(dst, src, nbytes, erase)		memset((dst), (src), (nbytes))
+
+#endif  // IQ_CORRECTION_CHECK_FLASHC_H_
@@ -0,0 +1,23 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * taskAK5394A.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the ADC buffers of taskAK5394A.h, without FreeRTOS,
+ * defined by iq-correction-check. -include'd, the guard of the real one
+ * keeps that out of iq_correction.c.
+ */
+
+#ifndef TASKAK5394A_H_
+#define TASKAK5394A_H_
+
+#include "compiler.h"
+
+#define AUDIO_BUFFER_SIZE	(48*2*8) // 48 khz, stereo, 8 ms worth
+
+extern volatile U32 audio_buffer_0[AUDIO_BUFFER_SIZE];
+extern volatile U32 audio_buffer_1[AUDIO_BUFFER_SIZE];
+
+#endif  // TASKAK5394A_H_
@@ -0,0 +1,17 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * widget.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for widget.h, the factory reset handler is kept by
+ * iq-correction-check to call it.
+ */
+
+#ifndef IQ_CORRECTION_CHECK_WIDGET_H_
+#define IQ_CORRECTION_CHECK_WIDGET_H_
+
+extern void widget_factory_reset_handler_register(void (*handler)(void));
+
+#endif  // IQ_CORRECTION_CHECK_WIDGET_H_
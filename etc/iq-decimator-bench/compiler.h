@@ -0,0 +1,24 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h, the one of usb-ctrl-replay and
+ * the work counters of iq_decimator.c, for iq-decimator-bench.
+ */
+
+#ifndef IQ_DECIMATOR_BENCH_COMPILER_H_
+#define IQ_DECIMATOR_BENCH_COMPILER_H_
+
+#include "../usb-ctrl-replay/compiler.h"
+
+// the work of iq_decimator.c, counted by iq-decimator-bench
+extern struct iq_decimator_work {
+	U32 inputs, combs, outputs;
+} iq_decimator_work;
+
+#define IQ_DECIMATOR_WORK(what, n)	(iq_decimator_work.what += (n))
+
+#endif  // IQ_DECIMATOR_BENCH_COMPILER_H_
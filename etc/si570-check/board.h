@@ -0,0 +1,21 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * board.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the board header, the TWIM the Si570 is on, for
+ * si570-check.
+ */
+
+#ifndef SI570_CHECK_BOARD_H_
+#define SI570_CHECK_BOARD_H_
+
+#include "twim_patched.h"
+
+extern avr32_twim_t si570_check_twim;
+
+#define TWIM0				(&si570_check_twim)
+
+#endif  // SI570_CHECK_BOARD_H_
@@ -0,0 +1,24 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h, the one of usb-ctrl-replay and
+ * the work counter of si570_tune.c, for si570-check.
+ */
+
+#ifndef SI570_CHECK_COMPILER_H_
+#define SI570_CHECK_COMPILER_H_
+
+#include "../usb-ctrl-replay/compiler.h"
+
+// the 64 bit divisions of si570_tune.c, counted by si570-check
+extern struct si570_work {
+	U32 divides;
+} si570_work;
+
+#define SI570_WORK(what, n)	(si570_work.what += (n))
+
+#endif  // SI570_CHECK_COMPILER_H_
@@ -0,0 +1,32 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * twim_patched.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the TWIM driver, si570-check answers the writes from
+ * a model of the Si570 registers.
+ */
+
+#ifndef SI570_CHECK_TWIM_PATCHED_H_
+#define SI570_CHECK_TWIM_PATCHED_H_
+
+#define TWI_SUCCESS			0
+#define TWI_RECEIVE_NACK	-5
+
+typedef struct {
+	int bus;
+} avr32_twim_t;
+
+typedef struct {
+	char chip;
+	unsigned int addr;
+	int addr_length;
+	void *buffer;
+	unsigned int length;
+} twi_package_t;
+
+extern int twim_write_packet(volatile avr32_twim_t *twi, const twi_package_t *package);
+
+#endif  // SI570_CHECK_TWIM_PATCHED_H_
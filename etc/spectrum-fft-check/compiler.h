@@ -0,0 +1,26 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h, the one of usb-ctrl-replay, clz()
+ * and the work counters of spectrum_fft.c, for spectrum-fft-check.
+ */
+
+#ifndef SPECTRUM_FFT_CHECK_COMPILER_H_
+#define SPECTRUM_FFT_CHECK_COMPILER_H_
+
+#include "../usb-ctrl-replay/compiler.h"
+
+#define clz(u)			((u) ? __builtin_clz(u) : 32)
+
+// the work of spectrum_fft.c, counted by spectrum-fft-check
+extern struct spectrum_fft_work {
+	U32 windows, butterflies, rotations, levels;
+} spectrum_fft_work;
+
+#define SPECTRUM_FFT_WORK(what, n)	(spectrum_fft_work.what += (n))
+
+#endif  // SPECTRUM_FFT_CHECK_COMPILER_H_
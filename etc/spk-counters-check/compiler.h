@@ -0,0 +1,22 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h, the one of usb-ctrl-replay and
+ * the barrier of spk_usb_counters.c, a full fence and now and then a
+ * yield, in spk-counters-check.
+ */
+
+#ifndef SPK_COUNTERS_CHECK_COMPILER_H_
+#define SPK_COUNTERS_CHECK_COMPILER_H_
+
+#include "../usb-ctrl-replay/compiler.h"
+
+extern void spk_counters_check_barrier(void);
+
+#define SPK_USB_COUNTERS_BARRIER()	spk_counters_check_barrier()
+
+#endif  // SPK_COUNTERS_CHECK_COMPILER_H_
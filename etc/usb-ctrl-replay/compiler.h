@@ -0,0 +1,57 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h, just what usb_standard_request.c
+ * needs, for usb-ctrl-replay.
+ */
+
+#ifndef _COMPILER_H_
+#define _COMPILER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int8_t		S8;
+typedef uint8_t		U8;
+typedef int16_t		S16;
+typedef uint16_t	U16;
+typedef int32_t		S32;
+typedef uint32_t	U32;
+typedef int64_t		S64;
+typedef uint64_t	U64;
+typedef unsigned char Bool;
+
+#define FALSE		0
+#define TRUE		1
+#define DISABLED	0
+#define ENABLED		1
+#define DISABLE		0
+#define ENABLE		1
+
+#define LITTLE_ENDIAN_MCU	1
+
+#define TPASTE2(a, b)	a##b
+
+#define LSB(u16)		((U8)((u16) & 0xFF))
+#define MSB(u16)		((U8)((u16) >> 8))
+
+// one thread, the interrupt runs from pump() only
+#define AVR32_ENTER_CRITICAL_REGION()	{
+#define AVR32_LEAVE_CRITICAL_REGION()	}
+
+#define min(a, b)		((a) < (b) ? (a) : (b))
+#define max(a, b)		((a) > (b) ? (a) : (b))
+
+#define Rd_bits(value, mask)			((value) & (mask))
+#define Tst_bits(value, mask)			(Rd_bits(value, mask) != 0)
+#define Set_bits(lvalue, mask)			((lvalue) |= (mask))
+#define Clr_bits(lvalue, mask)			((lvalue) &= ~(mask))
+#define Rd_bitfield(value, mask)		(Rd_bits(value, mask) >> __builtin_ctz(mask))
+#define Wr_bitfield(lvalue, mask, bitfield) \
+	((lvalue) = ((lvalue) & ~(mask)) | (((bitfield) << __builtin_ctz(mask)) & (mask)))
+
+#endif  // _COMPILER_H_
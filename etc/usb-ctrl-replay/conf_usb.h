@@ -0,0 +1,23 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * conf_usb.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * USB configuration of the usb-ctrl-replay host build: device only,
+ * dual speed, no operating system.
+ */
+
+#ifndef _CONF_USB_H_
+#define _CONF_USB_H_
+
+#include "compiler.h"
+
+#define USB_DEVICE_FEATURE			ENABLED
+#define USB_HOST_FEATURE			DISABLED
+#define USB_HIGH_SPEED_SUPPORT		ENABLED
+
+#define Usb_set_configuration_action()
+
+#endif  // _CONF_USB_H_
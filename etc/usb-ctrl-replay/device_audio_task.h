@@ -0,0 +1,19 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * device_audio_task.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The audio task state uac2_audio_controls.c reads and writes, provided
+ * by usb-ctrl-replay.c.
+ */
+
+#ifndef _DEVICE_AUDIO_TASK_H_
+#define _DEVICE_AUDIO_TASK_H_
+
+#include "compiler.h"
+
+extern volatile Bool mute, spk_mute;
+
+#endif  // _DEVICE_AUDIO_TASK_H_
@@ -0,0 +1,9 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * preprocessor.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for usb-ctrl-replay, TPASTE2 comes with compiler.h.
+ */
@@ -0,0 +1,35 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * uac2_usb_descriptors.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The interface numbers and entity IDs of src/uac2_usb_descriptors.h that
+ * uac2_audio_controls.c routes on, for usb-ctrl-replay. The recordings
+ * use these values, keep them in step with the firmware.
+ */
+
+#ifndef _UAC2_USB_DESCRIPTORS_H_
+#define _UAC2_USB_DESCRIPTORS_H_
+
+#define DSC_INTERFACE_AUDIO				1
+#define DSC_INTERFACE_AS_OUT			2
+
+#define INPUT_TERMINAL_ID				0x01
+#define INPUT_TERMINAL_NB_CHANNELS		0x02
+#define INPUT_TERMINAL_CHANNEL_CONF		0x00000003
+#define INPUT_TERMINAL_STRING_DESC		0x00
+#define MIC_FEATURE_UNIT_ID				0x02
+#define CSD_ID_1						0x04
+#define CSD_ID_2						0x05
+#define CSX_ID							0x06
+#define CSD_ID_IQ						0x07
+#define CSX_INPUT_PINS					0x02
+#define SPK_INPUT_TERMINAL_ID			0x11
+#define SPK_INPUT_TERMINAL_NB_CHANNELS	0x02
+#define SPK_INPUT_TERMINAL_CHANNEL_CONF	0x0003
+#define SPK_INPUT_TERMINAL_STRING_DESC	0x08
+#define SPK_FEATURE_UNIT_ID				0x12
+
+#endif  // _UAC2_USB_DESCRIPTORS_H_
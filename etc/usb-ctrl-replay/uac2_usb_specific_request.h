@@ -0,0 +1,21 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * uac2_usb_specific_request.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * What uac2_audio_controls.c takes from uac2_usb_specific_request.c,
+ * provided by usb-ctrl-replay.c.
+ */
+
+#ifndef _UAC2_USB_SPECIFIC_REQUEST_H_
+#define _UAC2_USB_SPECIFIC_REQUEST_H_
+
+#include "compiler.h"
+
+extern Bool Mic_freq_valid;
+
+extern void uac2_freq_change_handler(void);
+
+#endif  // _UAC2_USB_SPECIFIC_REQUEST_H_
@@ -0,0 +1,74 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_descriptors.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Descriptor access for usb-ctrl-replay, the descriptors themselves
+ * are in usb-ctrl-replay.c.
+ */
+
+#ifndef _USB_DESCRIPTORS_H_
+#define _USB_DESCRIPTORS_H_
+
+#include "compiler.h"
+#include "usb_drv.h"
+
+#define NB_CONFIGURATION		1
+#define EP_CONTROL_LENGTH		64
+#define DEVICE_STATUS			0x01	// self powered
+#define INTERFACE_STATUS		0x00
+
+#define LANG_ID					0x00
+
+typedef struct __attribute__((__packed__)) {
+	U8  bLength;
+	U8  bDescriptorType;
+	U16 wTotalLength;
+	U8  bNumInterfaces;
+	U8  bConfigurationValue;
+	U8  iConfiguration;
+	U8  bmAttributes;
+	U8  MaxPower;
+} S_usb_configuration_descriptor;
+
+typedef struct __attribute__((__packed__)) {
+	U8  bLength;
+	U8  bDescriptorType;
+	U8  bInterfaceNumber;
+	U8  bAlternateSetting;
+	U8  bNumEndpoints;
+	U8  bInterfaceClass;
+	U8  bInterfaceSubClass;
+	U8  bInterfaceProtocol;
+	U8  iInterface;
+} S_usb_interface_descriptor;
+
+typedef struct __attribute__((__packed__)) {
+	U8  bLength;
+	U8  bDescriptorType;
+	U8  bEndpointAddress;
+	U8  bmAttributes;
+	U16 wMaxPacketSize;
+	U8  bInterval;
+} S_usb_endpoint_descriptor;
+
+extern const U8 replay_dev_desc[18];
+extern const U8 replay_conf_desc_fs[];
+extern const U8 replay_conf_desc_hs[];
+extern const U16 replay_conf_desc_length;
+extern const U8 replay_qualifier_desc[10];
+
+#define Usb_get_dev_desc_pointer()			(replay_dev_desc)
+#define Usb_get_dev_desc_length()			(sizeof(replay_dev_desc))
+#define Usb_get_conf_desc_pointer()			(replay_conf_desc_fs)
+#define Usb_get_conf_desc_length()			(replay_conf_desc_length)
+#define Usb_get_conf_desc_fs_pointer()		(replay_conf_desc_fs)
+#define Usb_get_conf_desc_fs_length()		(replay_conf_desc_length)
+#define Usb_get_conf_desc_hs_pointer()		(replay_conf_desc_hs)
+#define Usb_get_conf_desc_hs_length()		(replay_conf_desc_length)
+#define Usb_get_qualifier_desc_pointer()	(replay_qualifier_desc)
+#define Usb_get_qualifier_desc_length()		(sizeof(replay_qualifier_desc))
+
+#endif  // _USB_DESCRIPTORS_H_
@@ -0,0 +1,96 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_drv.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Simulated USBB device controller for usb-ctrl-replay. The default
+ * control endpoint is a single 64 byte bank with the RXSTPI, RXOUTI,
+ * TXINI and NAKOUTI flags and their enables, as the driver macros of
+ * the real usb_drv.h see them; usb-ctrl-replay.c plays the host side.
+ */
+
+#ifndef _USB_DRV_H_
+#define _USB_DRV_H_
+
+#include "compiler.h"
+
+#define EP_CONTROL			0
+#define MAX_PEP_NB			7
+
+#define TYPE_BULK			2
+#define DIRECTION_IN		1
+#define SINGLE_BANK			0
+
+typedef struct {
+	// default control endpoint
+	Bool rxstpi, rxouti, txini, nakouti;		// interrupt flags
+	Bool rxstpe, rxoute, txine, nakoute;		// and their enables
+	Bool ep0_interrupt_enabled;
+	U8 fifo[64];
+	U16 fifo_pos;							// next byte the MCU reads or writes
+	U16 byte_count;
+	// device
+	U8 address;
+	Bool address_enabled;
+	Bool full_speed;
+	U32 udcon;
+	Bool ep_enabled[MAX_PEP_NB];
+	Bool ep_stall[MAX_PEP_NB];
+} usb_sim_t;
+
+extern usb_sim_t usb_sim;
+
+#define AVR32_USBB_udcon					(usb_sim.udcon)
+#define AVR32_USBB_UDCON_UADD_MASK			0x0000007F
+#define AVR32_USBB_UDCON_SPDCONF_MASK		0x00000C00
+#define AVR32_USBB_UDCON_TSTJ_MASK			0x00001000
+#define AVR32_USBB_UDCON_TSTK_MASK			0x00002000
+#define AVR32_USBB_UDCON_TSTPCKT_MASK		0x00004000
+
+#define Usb_configure_address(addr)				(usb_sim.address = (addr))
+#define Usb_enable_address()					(usb_sim.address_enabled = TRUE)
+#define Is_usb_full_speed_mode()				(usb_sim.full_speed)
+
+#define Usb_enable_endpoint_interrupt(ep)		(usb_sim.ep0_interrupt_enabled = TRUE)
+#define Is_usb_endpoint_enabled(ep)				(usb_sim.ep_enabled[ep])
+#define Usb_disable_endpoint(ep)				(usb_sim.ep_enabled[ep] = FALSE)
+#define Usb_unallocate_memory(ep)
+#define Usb_configure_endpoint(ep, type, dir, size, bank, nyet)	(TRUE)
+#define Usb_reset_endpoint(ep)
+#define Usb_reset_data_toggle(ep)
+#define Usb_send_in(ep)
+
+#define Usb_enable_stall_handshake(ep)			(usb_sim.ep_stall[ep] = TRUE)
+#define Usb_disable_stall_handshake(ep)			(usb_sim.ep_stall[ep] = FALSE)
+#define Is_usb_endpoint_stall_requested(ep)		(usb_sim.ep_stall[ep])
+
+#define Is_usb_setup_received()					(usb_sim.rxstpi)
+#define Is_usb_control_out_received()			(usb_sim.rxouti)
+#define Is_usb_control_in_ready()				(usb_sim.txini)
+#define Is_usb_nak_out(ep)						(usb_sim.nakouti)
+#define Usb_ack_setup_received_free()			(usb_sim.rxstpi = FALSE, usb_sim.byte_count = 0)
+#define Usb_ack_control_out_received_free()		(usb_sim.rxouti = FALSE, usb_sim.byte_count = 0)
+#define Usb_ack_control_in_ready_send()			(usb_sim.txini = FALSE)
+#define Usb_ack_nak_out(ep)						(usb_sim.nakouti = FALSE)
+
+#define Usb_enable_setup_received_interrupt()			(usb_sim.rxstpe = TRUE)
+#define Usb_disable_setup_received_interrupt()			(usb_sim.rxstpe = FALSE)
+#define Is_usb_setup_received_interrupt_enabled()		(usb_sim.rxstpe)
+#define Usb_enable_control_out_received_interrupt()		(usb_sim.rxoute = TRUE)
+#define Usb_disable_control_out_received_interrupt()	(usb_sim.rxoute = FALSE)
+#define Usb_enable_control_in_ready_interrupt()			(usb_sim.txine = TRUE)
+#define Usb_disable_control_in_ready_interrupt()		(usb_sim.txine = FALSE)
+#define Usb_enable_nak_out_interrupt(ep)				(usb_sim.nakoute = TRUE)
+#define Usb_disable_nak_out_interrupt(ep)				(usb_sim.nakoute = FALSE)
+
+#define Usb_byte_count(ep)						(usb_sim.byte_count)
+#define Usb_reset_endpoint_fifo_access(ep)		(usb_sim.fifo_pos = 0)
+#define Usb_read_endpoint_data(ep, scale)		(usb_sim_read_fifo(scale))
+
+extern U32 usb_sim_read_fifo(int bits);
+extern U32 usb_write_ep_txpacket(U8 ep, const void *txbuf, U32 data_length, const void **ptxbuf);
+extern U32 usb_read_ep_rxpacket(U8 ep, void *rxbuf, U32 data_length, void **prxbuf);
+
+#endif  // _USB_DRV_H_
@@ -0,0 +1,35 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_specific_request.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The usb_specific_request hooks usb_standard_request.c calls, and the
+ * request state uac2_audio_controls.c works on, provided by usb-ctrl-replay.c.
+ */
+
+#ifndef _USB_SPECIFIC_REQUEST_H_
+#define _USB_SPECIFIC_REQUEST_H_
+
+#include "compiler.h"
+
+extern void usb_user_endpoint_init(U8);
+extern void usb_user_set_interface(U8 wIndex, U8 wValue);
+extern Bool usb_user_get_descriptor(U8, U8);
+
+extern U8 clock_selected;
+extern Bool clock_changed;
+
+extern volatile  U8	usb_alternate_setting, usb_alternate_setting_out;
+extern volatile  Bool  usb_alternate_setting_changed, usb_alternate_setting_out_changed;
+
+typedef union {
+	U32 frequency;
+	U8 freq_bytes[4];
+} S_freq;
+
+extern S_freq current_freq, Mic_freq;
+extern Bool freq_changed;
+
+#endif  // _USB_SPECIFIC_REQUEST_H_
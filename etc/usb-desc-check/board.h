@@ -0,0 +1,15 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * board.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Empty host stand-in for board.h, conf_usb.h includes it, the descriptors
+ * need nothing from it.
+ */
+
+#ifndef _BOARD_H_
+#define _BOARD_H_
+
+#endif  // _BOARD_H_
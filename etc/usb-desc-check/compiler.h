@@ -0,0 +1,12 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h for usb-desc-check, the one of
+ * usb-ctrl-replay: little endian, so the descriptors come out as on the wire.
+ */
+
+#include "../usb-ctrl-replay/compiler.h"
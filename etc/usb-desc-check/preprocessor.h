@@ -0,0 +1,11 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * preprocessor.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for preprocessor.h for usb-desc-check.
+ */
+
+#include "../usb-ctrl-replay/preprocessor.h"
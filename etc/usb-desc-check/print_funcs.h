@@ -0,0 +1,14 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * print_funcs.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Empty host stand-in for print_funcs.h, for usb-desc-check.
+ */
+
+#ifndef _PRINT_FUNCS_H_
+#define _PRINT_FUNCS_H_
+
+#endif  // _PRINT_FUNCS_H_
@@ -0,0 +1,22 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_drv.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the USBB driver, the descriptors only need the
+ * endpoint types, for usb-desc-check.
+ */
+
+#ifndef _USB_DRV_H_
+#define _USB_DRV_H_
+
+#include "compiler.h"
+
+#define TYPE_CONTROL		0
+#define TYPE_ISOCHRONOUS	1
+#define TYPE_BULK			2
+#define TYPE_INTERRUPT		3
+
+#endif  // _USB_DRV_H_
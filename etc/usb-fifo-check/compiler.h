@@ -0,0 +1,58 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * compiler.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Host stand-in for the AVR32 compiler.h for usb-fifo-check, the one of
+ * usb-ctrl-replay plus the unions and alignment macros of usb_drv.c.
+ */
+
+#ifndef _USB_FIFO_CHECK_COMPILER_H_
+#define _USB_FIFO_CHECK_COMPILER_H_
+
+#include "../usb-ctrl-replay/compiler.h"
+
+typedef int64_t		S64;
+typedef Bool		Status_bool_t;
+
+#define TPASTE3(a, b, c)	a##b##c
+
+typedef union {
+	S32 s32;
+	U32 u32;
+	S16 s16[2];
+	U16 u16[2];
+	S8  s8[4];
+	U8  u8[4];
+} Union32;
+
+typedef union {
+	S64 s64;
+	U64 u64;
+	S32 s32[2];
+	U32 u32[2];
+	S16 s16[4];
+	U16 u16[4];
+	S8  s8[8];
+	U8  u8[8];
+} Union64;
+
+#define POINTERS(qualifier) \
+	qualifier U64 *u64ptr; qualifier U32 *u32ptr; qualifier U16 *u16ptr; qualifier U8 *u8ptr;
+
+typedef union { POINTERS() } UnionPtr;
+typedef union { POINTERS(volatile) } UnionVPtr;
+typedef union { POINTERS(const) } UnionCPtr;
+typedef union { POINTERS(const volatile) } UnionCVPtr;
+typedef struct { POINTERS(const) } StructCPtr;
+typedef struct { POINTERS(const volatile) } StructCVPtr;
+
+// usb_drv.c casts pointers to U32 as on the 32 bit target, these only
+// look at the low bits and work all the same on a 64 bit host
+#define Test_align(val, n)		(!Tst_bits(val, (n) - 1))
+#define Get_align(val, n)		(Rd_bits(val, (n) - 1))
+#define Align_down(val, n)		((val) & ~((n) - 1))
+
+#endif  // _USB_FIFO_CHECK_COMPILER_H_
@@ -0,0 +1,16 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_descriptors.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * What usb_drv.c takes from usb_descriptors.h, for usb-fifo-check.
+ */
+
+#ifndef _USB_DESCRIPTORS_H_
+#define _USB_DESCRIPTORS_H_
+
+#define EP_CONTROL_LENGTH		64
+
+#endif  // _USB_DESCRIPTORS_H_
@@ -0,0 +1,63 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_drv.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Simulated endpoint FIFO for usb-fifo-check. Usb_fifo_read() and
+ * Usb_fifo_write() go to usb-fifo-check.c, which checks every access
+ * against the rules of the USBB FIFO data register: natural alignment
+ * up to 32 bits, and the address equal to the DPRAM position modulo
+ * 32 bits.
+ */
+
+#ifndef _USB_DRV_H_
+#define _USB_DRV_H_
+
+#include "compiler.h"
+
+#define USB_DEVICE_FEATURE		ENABLED
+#define USB_HOST_FEATURE		DISABLED
+
+#define MAX_PEP_NB				7
+#define EP_CONTROL				0
+#define TYPE_CONTROL			0
+#define DIRECTION_OUT			0
+#define SINGLE_BANK				0
+
+typedef struct {
+	Bool in;					// IN endpoint, the MCU writes
+	U16 size;					// endpoint size
+	U16 pos;					// DPRAM position of the next access
+	U16 received;				// byte count of an OUT bank
+	U8 data[1024];
+} usb_fifo_sim_t;
+
+extern usb_fifo_sim_t usb_fifo_sim;
+extern UnionVPtr pep_fifo[MAX_PEP_NB];
+
+#define Is_usb_id_device()						(TRUE)
+#define Is_usb_endpoint_enabled(ep)				(FALSE)
+#define Usb_configure_endpoint(ep, type, dir, size, bank, nyet)	(TRUE)
+#define Usb_get_endpoint_size(ep)				(usb_fifo_sim.size)
+#define Usb_byte_count(ep)						(usb_fifo_sim.in ? usb_fifo_sim.pos : usb_fifo_sim.received)
+
+#define Usb_fifo_read(ptr, scale)				(TPASTE2(usb_fifo_sim_read, scale)(ptr))
+#define Usb_fifo_write(ptr, scale, data)		(TPASTE2(usb_fifo_sim_write, scale)((ptr), (data)))
+
+extern U8  usb_fifo_sim_read8(const volatile void *ptr);
+extern U16 usb_fifo_sim_read16(const volatile void *ptr);
+extern U32 usb_fifo_sim_read32(const volatile void *ptr);
+extern U64 usb_fifo_sim_read64(const volatile void *ptr);
+extern void usb_fifo_sim_write8(volatile void *ptr, U8 data);
+extern void usb_fifo_sim_write16(volatile void *ptr, U16 data);
+extern void usb_fifo_sim_write32(volatile void *ptr, U32 data);
+extern void usb_fifo_sim_write64(volatile void *ptr, U64 data);
+
+extern Status_bool_t usb_init_device(void);
+extern U32 usb_set_ep_txpacket(U8 ep, U8 txbyte, U32 data_length);
+extern U32 usb_write_ep_txpacket(U8 ep, const void *txbuf, U32 data_length, const void **ptxbuf);
+extern U32 usb_read_ep_rxpacket(U8 ep, void *rxbuf, U32 data_length, void **prxbuf);
+
+#endif  // _USB_DRV_H_
@@ -0,0 +1,574 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * hpsdr-frame-check.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Play recorded HPSDR Protocol-1 OUT frames through the parser of
+ * src/hpsdr_frame.c and the command and control registers of
+ * src/hpsdr_cc.c on the host, as hpsdr_device_audio_task.c does:
+ *
+ *   hpsdr-frame-check [-v] file...
+ *
+ * A recording has one item per line, # starts a comment:
+ *
+ *   rate n                  DAC rate for the following frames
+ *   mute 0|1                speaker mute for the following frames
+ *   frame [xx ...]          the bytes of an OUT packet as on the wire,
+ *   + xx ...                continued on the following lines
+ *   cc c0 c1 c2 c3 c4       the packet must parse to this C0 to C4
+ *   bad                     the packet must be dropped
+ *   dac n left right        pair n of the packet as the DAC gets it
+ *   send c0 c1 c2 c3 c4     a frame of silence with this C0 to C4
+ *   field name value        a field of the registers, see hpsdr_cc.h
+ *   changed name 0|1        hpsdr_cc_changed() of a field
+ *   mox 0|1                 MOX of the last frame
+ *   status name value       set a status field
+ *   in c0 c1 c2 c3 c4       the next IN frame starts with this C0 to C4
+ *
+ * Every packet that parses is unpacked into a speaker buffer at each word
+ * offset, the I/Q pair when C0 has MOX set and the L/R audio otherwise,
+ * and checked byte by byte against the frame: each sample repeated up to
+ * the DAC rate, silence when muted, nothing written past the pairs.
+ *
+ * Before the recordings every C0 address goes through the registers with
+ * a pattern, every field of it checked against the bits of C1 to C4 and
+ * every other address left alone, and every status field through the IN
+ * frame headers of each slot, and samples either side of the ADC overload
+ * margin through the IN frames. The mic filters of src/hpsdr_mic.c get
+ * tones at each IQ rate: flat to HPSDR_MIC_PASS, 48 dB down from
+ * HPSDR_MIC_STOP, what would fold into the pass band 40 dB down, and the
+ * work a frame, on a model of the UC3A, within 10% of the CPU. Each
+ * recording starts from cleared registers and status.
+ *
+ * Exits 1 if any packet fails, -v prints each packet.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "compiler.h"
+#include "hpsdr_frame.h"
+#include "hpsdr_cc.h"
+#include "hpsdr_mic.h"
+
+#define CHECK_PAIRS		(HPSDR_FRAME_SAMPLES * 192000 / HPSDR_OUT_RATE)
+#define CHECK_GUARD		8			// words checked on either side of the pairs
+#define CHECK_FILL		0xeeeeeeee
+
+// a UC3A model of the mic work: per IQ sample a load, the sign extension,
+// an add and store per integrator and the phase; per mic sample a load,
+// subtract and store per comb, two halfword loads, an add and a MAC per
+// pair of taps, and the rest
+#define CHECK_CPU_HZ			66000000
+#define CHECK_CYCLES_INPUT		(6 + 2 * HPSDR_MIC_ORDER)
+#define CHECK_CYCLES_OUTPUT		(3 * HPSDR_MIC_ORDER + 4 * (HPSDR_MIC_TAPS / 2) + 3 + 20)
+#define CHECK_MIC_BUDGET		10		// percent of the CPU at most
+#define CHECK_MIC_FRAMES		200		// of IQ samples per tone, the first half to settle
+#define CHECK_MIC_AMPLITUDE		0x400000	// half scale
+
+static int verbose;
+struct hpsdr_mic_work hpsdr_mic_work;
+
+static struct {
+	U8 bytes[2 * HPSDR_FRAME_BYTES];
+	int length;
+	U32 rate;
+	Bool mute;
+	Bool parsed;				// the packet passed the parser
+	U8 cc[HPSDR_CC_BYTES];
+	U32 dac[2 * CHECK_PAIRS];	// what the speaker buffer got
+	int lineno;
+} packet;
+
+static const char *fail;		// first rule the packet broke
+
+// the tables of hpsdr_cc.h as written, to check the descriptors against
+typedef struct {
+	const char *name;
+	U8 address, byte, lsb, width;
+} check_field_t;
+
+#define CHECK_FIELD(name, address, byte, lsb, width)	{ #name, address, byte, lsb, width },
+
+static const check_field_t check_fields[cc_end] = { HPSDR_CC_FIELDS(CHECK_FIELD) };
+static const check_field_t check_status[cs_end] = { HPSDR_CC_STATUS(CHECK_FIELD) };
+
+static int check_find(const check_field_t *table, int n, const char *name) {
+	int i;
+
+	for (i = 0; i < n; i += 1)
+		if (strcmp(table[i].name, name) == 0)
+			return i;
+	return -1;
+}
+
+// a field from C0 to C4 as the tables have it, bit by bit
+static U32 check_extract(const check_field_t *fp, const U8 *cc) {
+	U32 value = 0;
+	int bit, n;
+
+	for (n = fp->width - 1; n >= 0; n -= 1) {
+		bit = 8 * (4 - fp->byte) + fp->lsb + n;		// from the bottom of C4, C0 past the top
+		if (fp->byte == HPSDR_CC_C0)
+			bit = fp->lsb + n + 32;
+		value = (value << 1) | ((cc[4 - bit / 8] >> (bit % 8)) & 1);
+	}
+	return value;
+}
+
+//
+// the pair n of the DAC, from the bytes of the frame
+//
+static U32 reference(int n, int left) {
+	const U8 *p = packet.bytes + 4 * HPSDR_CC_WORDS + 8 * (n / (packet.rate / HPSDR_OUT_RATE));
+
+	if (packet.mute)
+		return 0;
+	if (packet.cc[0] & HPSDR_C0_MOX)
+		p += 4 * hpsdr_out_iq;
+	if (! left)
+		p += 2;
+	return ((U32)p[0] << 16) | ((U32)p[1] << 8);
+}
+
+//
+// run the packet through the parser and unpack it, into each word offset
+// of a buffer, in two runs split at each point as at the buffer wrap
+//
+static void unpack(void) {
+	U32 frame[HPSDR_FRAME_WORDS + 1];
+	U32 buffer[2 * CHECK_PAIRS + 2 * CHECK_GUARD + 2];
+	U8 repeat = packet.rate / HPSDR_OUT_RATE, ofs, split;
+	hpsdr_out_source_t source;
+	const U32 *rp;
+	volatile U32 *dst;
+	int i, pairs = HPSDR_FRAME_SAMPLES * repeat;
+
+	memset(frame, 0, sizeof(frame));
+	memcpy(frame, packet.bytes, min(packet.length, HPSDR_FRAME_BYTES));
+	packet.parsed = packet.length == HPSDR_FRAME_BYTES && hpsdr_frame_parse_header(frame, packet.cc);
+	if (! packet.parsed)
+		return;
+	hpsdr_cc_decode(packet.cc);
+
+	if (repeat == 0 || repeat * HPSDR_OUT_RATE != packet.rate || pairs > CHECK_PAIRS) {
+		fail = "no such rate";
+		return;
+	}
+	source = (packet.cc[0] & HPSDR_C0_MOX) ? hpsdr_out_iq : hpsdr_out_audio;
+	for (ofs = 0; ofs < 2 && ! fail; ofs += 1)
+		for (split = 0; split < HPSDR_FRAME_SAMPLES && ! fail; split += 1) {
+			for (i = 0; i < sizeof(buffer) / sizeof(buffer[0]); i += 1)
+				buffer[i] = CHECK_FILL;
+			dst = buffer + CHECK_GUARD + ofs;
+			rp = frame + HPSDR_CC_WORDS;
+			if (packet.mute) {
+				hpsdr_frame_get_silence(dst, split * repeat);
+				hpsdr_frame_get_silence(dst + 2 * split * repeat, (HPSDR_FRAME_SAMPLES - split) * repeat);
+			} else {
+				rp = hpsdr_frame_get(rp, dst, split, 0, 1, source, repeat);
+				rp = hpsdr_frame_get(rp, dst + 2 * split * repeat, HPSDR_FRAME_SAMPLES - split,
+									 0, 1, source, repeat);
+				if (rp != frame + HPSDR_FRAME_WORDS)
+					fail = "did not end at the end of the frame";
+			}
+			for (i = 0; i < sizeof(buffer) / sizeof(buffer[0]); i += 1)
+				if ((i < CHECK_GUARD + ofs || i >= CHECK_GUARD + ofs + 2 * pairs) && buffer[i] != CHECK_FILL)
+					fail = fail ? fail : "wrote outside the pairs";
+			for (i = 0; i < pairs; i += 1)
+				if (dst[2 * i] != reference(i, 1) || dst[2 * i + 1] != reference(i, 0))
+					fail = fail ? fail : "wrong sample";
+		}
+	memcpy(packet.dac, (U32 *)dst, 2 * pairs * sizeof(U32));
+}
+
+// C0 to C4 for a C0 address, different for each address and MOX
+static U32 check_pattern(U8 address, U8 mox, U8 *cc) {
+	int i;
+
+	cc[0] = (address << 1) | mox;
+	for (i = 1; i < HPSDR_CC_BYTES; i += 1)
+		cc[i] = (U8)(address * 37 + mox * 101 + i * 59);
+	return ((U32)cc[1] << 24) | ((U32)cc[2] << 16) | ((U32)cc[3] << 8) | cc[4];
+}
+
+//
+// every C0 address with and without MOX, then the same again
+//
+static int check_addresses(void) {
+	U8 cc[HPSDR_CC_BYTES], other[HPSDR_CC_BYTES], address, mox, pass;
+	U32 value;
+	Bool marked;
+	int i, errors = 0;
+
+	hpsdr_cc_init();
+	for (i = 0; i < cc_end; i += 1)
+		hpsdr_cc_changed(i);
+	for (address = 0; address < HPSDR_CC_ADDRESSES; address += 1)
+		for (mox = 0; mox < 2; mox += 1)
+			for (pass = 0; pass < 2; pass += 1) {
+				fail = NULL;
+				value = check_pattern(address, mox, cc);
+				hpsdr_cc_decode(cc);
+
+				if (hpsdr_cc_registers[address] != value || hpsdr_cc_mox != mox)
+					fail = "register or MOX not filed";
+				for (i = 0; i < HPSDR_CC_ADDRESSES; i += 1)
+					if (i != address && hpsdr_cc_registers[i] != (i < address ? check_pattern(i, 1, other) : 0))
+						fail = fail ? fail : "other register written";
+				// a new value marks the address once, for whichever field
+				// asks first, the same value again not at all
+				marked = pass == 0;
+				for (i = 0; i < cc_end; i += 1) {
+					if (check_fields[i].address != address)
+						continue;
+					if (hpsdr_cc_fields[i].address != address
+						|| hpsdr_cc_get(i) != check_extract(&check_fields[i], cc))
+						fail = fail ? fail : check_fields[i].name;
+					if (hpsdr_cc_changed(i) != marked)
+						fail = fail ? fail : "changed mark";
+					marked = FALSE;
+				}
+				if (fail) {
+					fprintf(stderr, "hpsdr-frame-check: C0 %02x: %s\n", cc[0], fail);
+					errors += 1;
+				}
+			}
+	return errors;
+}
+
+//
+// every status field set to all ones and back, through the IN frame
+// headers of every slot
+//
+static int check_status_fields(void) {
+	U32 frame[HPSDR_CC_WORDS];
+	U8 cc[HPSDR_CC_BYTES], want[HPSDR_CC_BYTES];
+	int i, n, k, bit, errors = 0;
+
+	hpsdr_frame_init();
+	hpsdr_cc_init();
+	for (i = 0; i < cs_end; i += 1) {
+		fail = NULL;
+		hpsdr_cc_set_status(i, 0xffffffff);
+		for (n = 0; n < HPSDR_CC_SLOTS; n += 1) {
+			hpsdr_frame_begin(frame);
+			hpsdr_frame_parse_header(frame, cc);
+			// the slot address and the bits of the field alone
+			memset(want, 0, sizeof(want));
+			want[0] = n << 3;
+			if (check_status[i].byte == HPSDR_CC_C0 || check_status[i].address == n)
+				for (k = 0; k < check_status[i].width; k += 1) {
+					bit = check_status[i].byte == HPSDR_CC_C0 ? check_status[i].lsb + k + 32
+						: 8 * (4 - check_status[i].byte) + check_status[i].lsb + k;
+					want[4 - bit / 8] |= 1 << (bit % 8);
+				}
+			if (memcmp(cc, want, sizeof(cc)) != 0)
+				fail = fail ? fail : "IN header";
+		}
+		hpsdr_cc_set_status(i, 0);
+		for (n = 0; n < HPSDR_CC_SLOTS; n += 1) {
+			hpsdr_frame_begin(frame);
+			hpsdr_frame_parse_header(frame, cc);
+			if (cc[0] != n << 3 || cc[1] != 0 || cc[2] != 0 || cc[3] != 0 || cc[4] != 0)
+				fail = fail ? fail : "status not cleared";
+		}
+		if (fail) {
+			fprintf(stderr, "hpsdr-frame-check: %s: %s\n", check_status[i].name, fail);
+			errors += 1;
+		}
+	}
+	return errors;
+}
+
+//
+// the ADC overload of hpsdr_frame_put(), on samples either side of the
+// margin at both ends of the scale
+//
+static int check_overload(void) {
+	static const struct {
+		U32 sample;
+		Bool overload;
+	} samples[] = {
+		{ 0x000000, FALSE }, { 0x7ffeff, FALSE }, { 0x7fff00, TRUE }, { 0x7fffff, TRUE },
+		{ 0xffffff, FALSE }, { 0x800100, FALSE }, { 0x8000ff, TRUE }, { 0x800000, TRUE },
+		{ 0xff7fff00, TRUE }, { 0xff000000, FALSE },		// the top byte ignored
+	};
+	U32 frame[2], pair[2];
+	S16 mic[1] = { 0 };
+	int i, errors = 0;
+
+	hpsdr_frame_overload();
+	for (i = 0; i < sizeof(samples) / sizeof(samples[0]); i += 1) {
+		pair[0] = samples[i].sample;
+		pair[1] = 0;
+		hpsdr_frame_put(frame, pair, 1, 0, 1, mic);
+		if (hpsdr_frame_overload() != samples[i].overload || hpsdr_frame_overload()) {
+			fprintf(stderr, "hpsdr-frame-check: overload of %06x\n", samples[i].sample);
+			errors += 1;
+		}
+		pair[0] = 0;
+		pair[1] = samples[i].sample;
+		hpsdr_frame_put(frame, pair, 1, 0, 1, mic);
+		if (hpsdr_frame_overload() != samples[i].overload) {
+			fprintf(stderr, "hpsdr-frame-check: overload of Q %06x\n", samples[i].sample);
+			errors += 1;
+		}
+	}
+	return errors;
+}
+
+//
+// the level in dB of a tone at f Hz in the IQ samples at ratio times
+// 48 kHz after the mic filters, its mic samples checked held for ratio
+// slots, and the work done
+//
+static double check_mic_tone(U8 ratio, double f, U32 *inputs, U32 *outputs) {
+	static hpsdr_mic_t mic_filter;
+	U32 pairs[2 * HPSDR_FRAME_SAMPLES];
+	S16 mic[HPSDR_FRAME_SAMPLES];
+	double rate = (double)ratio * HPSDR_OUT_RATE, fout, re = 0, im = 0, phase;
+	int frame, i, n = 0, split;
+
+	// fout is where f lands at 48 kHz
+	fout = fmod(f, HPSDR_OUT_RATE);
+	if (fout > HPSDR_OUT_RATE / 2)
+		fout = HPSDR_OUT_RATE - fout;
+	mic_filter.ratio = 0;
+	memset(&hpsdr_mic_work, 0, sizeof(hpsdr_mic_work));
+	for (frame = 0; frame < CHECK_MIC_FRAMES; frame += 1) {
+		for (i = 0; i < HPSDR_FRAME_SAMPLES; i += 1) {
+			phase = 2 * M_PI * f * (frame * HPSDR_FRAME_SAMPLES + i) / rate;
+			pairs[2 * i] = (U32)lround(CHECK_MIC_AMPLITUDE * sin(phase)) & 0xffffff;
+			pairs[2 * i + 1] = (U32)lround(CHECK_MIC_AMPLITUDE * cos(phase)) & 0xffffff;
+		}
+		// in two runs, as at the wrap of the ADC buffers
+		split = (frame * 17) % HPSDR_FRAME_SAMPLES;
+		hpsdr_mic_run(&mic_filter, pairs, split, 0, ratio, mic);
+		hpsdr_mic_run(&mic_filter, pairs + 2 * split, HPSDR_FRAME_SAMPLES - split, 0, ratio, mic + split);
+
+		for (i = 0; i < HPSDR_FRAME_SAMPLES; i += 1, n += 1) {
+			if ((n + 1) % ratio != 0) {
+				if (n > 0 && i > 0 && mic[i] != mic[i - 1])
+					fail = fail ? fail : "mic sample not held";
+				continue;
+			}
+			if (frame < CHECK_MIC_FRAMES / 2)
+				continue;
+			phase = 2 * M_PI * fout * (n / ratio) / HPSDR_OUT_RATE;
+			re += mic[i] * cos(phase);
+			im += mic[i] * sin(phase);
+		}
+	}
+	*inputs = hpsdr_mic_work.inputs;
+	*outputs = hpsdr_mic_work.outputs;
+	n = (CHECK_MIC_FRAMES - CHECK_MIC_FRAMES / 2) * HPSDR_FRAME_SAMPLES / ratio;
+	if (fout == 0 || fout == HPSDR_OUT_RATE / 2)
+		re /= 2;
+	return 20 * log10(2 * hypot(re, im) / n / (CHECK_MIC_AMPLITUDE >> 8) + 1e-9);
+}
+
+//
+// the mic filters at each ratio: flat in the pass band, down in the stop
+// band, the images of the pass band at the IQ rate down before they fold,
+// and within the CPU budget
+//
+static int check_mic(void) {
+	static const U8 ratios[HPSDR_MIC_RATIOS] = { 1, 2, 4 };
+	double f, db, pass_min, pass_max, stop, alias;
+	U32 inputs, outputs, cycles, budget;
+	int r, errors = 0;
+
+	for (r = 0; r < HPSDR_MIC_RATIOS; r += 1) {
+		fail = NULL;
+		pass_min = 100;
+		pass_max = stop = alias = -200;
+		for (f = 250; f <= HPSDR_MIC_PASS; f += 250) {
+			db = check_mic_tone(ratios[r], f, &inputs, &outputs);
+			pass_min = min(pass_min, db);
+			pass_max = max(pass_max, db);
+		}
+		for (f = HPSDR_MIC_STOP; f <= HPSDR_OUT_RATE / 2; f += 250)
+			stop = max(stop, check_mic_tone(ratios[r], f, &inputs, &outputs));
+		for (f = HPSDR_OUT_RATE - HPSDR_MIC_PASS; f <= ratios[r] * HPSDR_OUT_RATE / 2; f += 250)
+			if (fabs(f - HPSDR_OUT_RATE * floor(f / HPSDR_OUT_RATE + 0.5)) <= HPSDR_MIC_PASS)
+				alias = max(alias, check_mic_tone(ratios[r], f, &inputs, &outputs));
+
+		// the work of the last tone, a frame on average
+		cycles = (inputs * CHECK_CYCLES_INPUT + outputs * CHECK_CYCLES_OUTPUT) / CHECK_MIC_FRAMES;
+		budget = (U32)((double)CHECK_CPU_HZ * HPSDR_FRAME_SAMPLES / (ratios[r] * HPSDR_OUT_RATE)
+					   * CHECK_MIC_BUDGET / 100);
+		if (pass_min < -0.25 || pass_max > 0.25)
+			fail = fail ? fail : "pass band not flat";
+		else if (stop > -48)
+			fail = fail ? fail : "stop band";
+		else if (ratios[r] > 1 && alias > -40)
+			fail = fail ? fail : "aliases";
+		else if (cycles > budget)
+			fail = fail ? fail : "over the CPU budget";
+		if (fail) {
+			fprintf(stderr, "hpsdr-frame-check: mic at %u kHz: %s\n", ratios[r] * HPSDR_OUT_RATE / 1000, fail);
+			errors += 1;
+		}
+		if (fail || verbose)
+			printf("mic at %3u kHz: pass %+.2f..%+.2f dB, stop %.1f dB, aliases %.1f dB, %u cycles a frame of %u\n",
+				   ratios[r] * HPSDR_OUT_RATE / 1000, pass_min, pass_max, stop, alias, cycles, budget);
+	}
+	return errors;
+}
+
+static int parse_bytes(char *s, U8 *bytes, int max) {
+	char *tok;
+	int n = 0;
+
+	for (tok = strtok(s, " \t\n"); tok != NULL; tok = strtok(NULL, " \t\n"))
+		if (n < max)
+			bytes[n++] = strtoul(tok, NULL, 16);
+	return n;
+}
+
+static int replay(const char *file) {
+	FILE *fp = fopen(file, "r");
+	char line[1024], *cmd, *args, *hash, name[64];
+	U8 cc[HPSDR_CC_BYTES];
+	U32 frame[HPSDR_CC_WORDS];
+	unsigned long n, left, right, value;
+	int lineno = 0, packets = 0, pending = 0, status = 0, i;
+
+	if (fp == NULL) {
+		perror(file);
+		return 1;
+	}
+	packet.rate = HPSDR_OUT_RATE;
+	packet.mute = FALSE;
+	packet.parsed = FALSE;
+	hpsdr_frame_init();
+	hpsdr_cc_init();
+	for (;;) {
+		cmd = NULL;
+		if (fgets(line, sizeof(line), fp) != NULL) {
+			lineno += 1;
+			if ((hash = strchr(line, '#')) != NULL)
+				*hash = '\0';
+			cmd = strtok(line, " \t\n");
+			if (cmd == NULL)
+				continue;
+			args = strtok(NULL, "");
+			if (args == NULL)
+				args = "";
+		}
+
+		// a packet is complete at the first line that does not continue it
+		if (pending && (cmd == NULL || strcmp(cmd, "+") != 0)) {
+			fail = NULL;
+			unpack();
+			if (fail) {
+				fprintf(stderr, "%s:%d: %s\n", file, packet.lineno, fail);
+				status = 1;
+			} else if (verbose)
+				printf("%s:%d: %d bytes, %s\n", file, packet.lineno, packet.length,
+					   packet.parsed ? "parsed" : "dropped");
+			pending = 0;
+		}
+		if (cmd == NULL)
+			break;
+
+		if (strcmp(cmd, "rate") == 0)
+			packet.rate = strtoul(args, NULL, 0);
+		else if (strcmp(cmd, "mute") == 0)
+			packet.mute = strtoul(args, NULL, 0) != 0;
+		else if (strcmp(cmd, "frame") == 0) {
+			packet.length = parse_bytes(args, packet.bytes, sizeof(packet.bytes));
+			packet.lineno = lineno;
+			packets += 1;
+			pending = 1;
+		} else if (strcmp(cmd, "send") == 0 && parse_bytes(args, packet.bytes + 3, HPSDR_CC_BYTES) == HPSDR_CC_BYTES) {
+			memset(packet.bytes, HPSDR_SYNC, 3);
+			memset(packet.bytes + 3 + HPSDR_CC_BYTES, 0, HPSDR_FRAME_BYTES - 3 - HPSDR_CC_BYTES);
+			packet.length = HPSDR_FRAME_BYTES;
+			packet.lineno = lineno;
+			packets += 1;
+			pending = 1;
+		} else if (strcmp(cmd, "+") == 0 && pending)
+			packet.length += parse_bytes(args, packet.bytes + packet.length,
+										 sizeof(packet.bytes) - packet.length);
+		else if (strcmp(cmd, "cc") == 0 && parse_bytes(args, cc, sizeof(cc)) == sizeof(cc)) {
+			if (! packet.parsed || memcmp(cc, packet.cc, sizeof(cc)) != 0) {
+				fprintf(stderr, "%s:%d: packet %s\n", file, lineno, packet.parsed ? "has other C0 to C4" : "dropped");
+				status = 1;
+			}
+		} else if (strcmp(cmd, "bad") == 0) {
+			if (packet.parsed) {
+				fprintf(stderr, "%s:%d: packet not dropped\n", file, lineno);
+				status = 1;
+			}
+		} else if (strcmp(cmd, "dac") == 0 && sscanf(args, "%lu %lx %lx", &n, &left, &right) == 3) {
+			if (! packet.parsed || n >= HPSDR_FRAME_SAMPLES * packet.rate / HPSDR_OUT_RATE) {
+				fprintf(stderr, "%s:%d: no pair %lu\n", file, lineno, n);
+				status = 1;
+			} else if (packet.dac[2 * n] != left || packet.dac[2 * n + 1] != right) {
+				fprintf(stderr, "%s:%d: pair %lu is %06x %06x\n", file, lineno, n,
+						packet.dac[2 * n], packet.dac[2 * n + 1]);
+				status = 1;
+			}
+		} else if ((strcmp(cmd, "field") == 0 || strcmp(cmd, "changed") == 0)
+				   && sscanf(args, "%63s %li", name, &value) == 2
+				   && (i = check_find(check_fields, cc_end, name)) >= 0) {
+			if ((cmd[0] == 'f' ? hpsdr_cc_get(i) : hpsdr_cc_changed(i)) != value) {
+				fprintf(stderr, "%s:%d: %s %s is %u\n", file, lineno, cmd, name,
+						cmd[0] == 'f' ? hpsdr_cc_get(i) : !value);
+				status = 1;
+			}
+		} else if (strcmp(cmd, "mox") == 0) {
+			if (hpsdr_cc_mox != strtoul(args, NULL, 0)) {
+				fprintf(stderr, "%s:%d: MOX is %u\n", file, lineno, hpsdr_cc_mox);
+				status = 1;
+			}
+		} else if (strcmp(cmd, "status") == 0 && sscanf(args, "%63s %li", name, &value) == 2
+				   && (i = check_find(check_status, cs_end, name)) >= 0)
+			hpsdr_cc_set_status(i, value);
+		else if (strcmp(cmd, "in") == 0 && parse_bytes(args, cc, sizeof(cc)) == sizeof(cc)) {
+			hpsdr_frame_begin(frame);
+			if (! hpsdr_frame_parse_header(frame, packet.cc) || memcmp(cc, packet.cc, sizeof(cc)) != 0) {
+				fprintf(stderr, "%s:%d: IN frame starts %02x %02x %02x %02x %02x\n", file, lineno,
+						packet.cc[0], packet.cc[1], packet.cc[2], packet.cc[3], packet.cc[4]);
+				status = 1;
+			}
+			packet.parsed = FALSE;
+		} else {
+			fprintf(stderr, "%s:%d: cannot parse\n", file, lineno);
+			status = 1;
+			break;
+		}
+	}
+	fclose(fp);
+	if (status == 0)
+		printf("%s: %d packets ok\n", file, packets);
+	return status;
+}
+
+int main(int argc, char *argv[]) {
+	int c, status = 0;
+
+	while ((c = getopt(argc, argv, "v")) != -1) {
+		switch (c) {
+		case 'v': verbose = 1; break;
+		default:
+			fprintf(stderr, "usage: hpsdr-frame-check [-v] file...\n");
+			return 2;
+		}
+	}
+	if (check_addresses() + check_status_fields() + check_overload() + check_mic() > 0)
+		status = 1;
+	else
+		printf("hpsdr-frame-check: %d C0 addresses, %d status fields, mic filters ok\n",
+			   HPSDR_CC_ADDRESSES, cs_end);
+	for ( ; optind < argc; optind += 1)
+		status |= replay(argv[optind]);
+	return status;
+}
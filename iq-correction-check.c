@@ -0,0 +1,252 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * iq-correction-check.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Run the IQ imbalance correction of src/iq_correction.c on the host:
+ *
+ *   iq-correction-check [-v]
+ *
+ * A complex tone at the highest ADC rate with a gain and a phase error in
+ * Q fills both ADC buffers, in either channel order. The matrix that takes
+ * the error out is set with the vendor request operations, and the
+ * buffers are corrected a packet at a time ahead of a reader that wraps
+ * from one buffer into the other, as the record paths do:
+ *
+ *   - the image rejection, the tone over its mirror, 60 dB at least after
+ *   - staged coefficients change nothing until applied
+ *   - a saved matrix is there at the next boot, until a factory reset
+ *   - the identity corrects nothing
+ *   - the cycles per sample at 192 kHz, estimated from the runs and pairs
+ *     iq_correction.c counts on a model of the UC3A
+ *
+ * Prints the rejection before and after and the estimate, exits 1 if a
+ * check fails, -v lists every case and the work counted.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "taskAK5394A.h"
+#include "iq_correction.h"
+
+#define CHECK_RATE			192000		// ADC rate, the highest record rate
+#define CHECK_PAIRS			AUDIO_BUFFER_SIZE	// both buffers, a whole number of cycles
+#define CHECK_CYCLES		48			// of the tone in them, 12 kHz
+#define CHECK_AMPLITUDE		0x400000	// half scale
+#define CHECK_PACKET		24			// pairs a high speed packet at 192 kHz
+#define CHECK_START			200			// the reader index, in buffer 0
+#define CHECK_REJECTION		60			// dB at least after
+
+// a UC3A model of the work: per run the call and return, the four matrix
+// loads and the loop set up; per pair two loads and sign extensions, four
+// mulsd or macsd, a rounding add and 64 bit shift and a saturation for
+// each of I and Q, two stores and the loop
+#define CHECK_CPU_HZ		66000000
+#define CHECK_BUDGET		15			// percent of the CPU at most
+#define CHECK_CYCLES_RUN	(3 + 4 + 5)
+#define CHECK_CYCLES_PAIR	(2 * (1 + 2 + 2 * 2 + 2 + 2 + 4 + 1) + 3)
+
+volatile U32 audio_buffer_0[AUDIO_BUFFER_SIZE];
+volatile U32 audio_buffer_1[AUDIO_BUFFER_SIZE];
+struct iq_correction_work iq_correction_work;
+
+extern struct { U16 magic; S16 matrix[4]; } iq_correction_nvram;
+
+static void (*check_factory_reset)(void);
+
+void widget_factory_reset_handler_register(void (*handler)(void)) {
+	check_factory_reset = handler;
+}
+
+static int verbose;
+static const char *fail;	// first rule a case broke
+
+static volatile U32 *check_pair(int n) {
+	return n < CHECK_PAIRS / 2 ? &audio_buffer_0[2 * n] : &audio_buffer_1[2 * n - CHECK_PAIRS];
+}
+
+//
+// the tone with Q off by gain_db and phase_deg
+//
+static void check_fill(double gain_db, double phase_deg, U8 left, U8 right) {
+	double g = pow(10, gain_db / 20), p = phase_deg * M_PI / 180, w;
+	int n;
+
+	for (n = 0; n < CHECK_PAIRS; n += 1) {
+		w = 2 * M_PI * CHECK_CYCLES * n / CHECK_PAIRS;
+		check_pair(n)[left] = (U32)lround(CHECK_AMPLITUDE * cos(w)) & 0xffffff;
+		check_pair(n)[right] = (U32)lround(CHECK_AMPLITUDE * g * sin(w + p)) & 0xffffff;
+	}
+}
+
+//
+// the tone over its mirror in dB
+//
+static double check_rejection(U8 left, U8 right) {
+	double re[2] = { 0, 0 }, im[2] = { 0, 0 }, i, q, w;
+	int n, k;
+
+	for (n = 0; n < CHECK_PAIRS; n += 1) {
+		i = (S32)(check_pair(n)[left] << 8) >> 8;
+		q = (S32)(check_pair(n)[right] << 8) >> 8;
+		for (k = 0; k < 2; k += 1) {
+			w = (k == 0 ? -2 : 2) * M_PI * CHECK_CYCLES * n / CHECK_PAIRS;
+			re[k] += i * cos(w) - q * sin(w);
+			im[k] += i * sin(w) + q * cos(w);
+		}
+	}
+	return 20 * log10(hypot(re[0], im[0]) / (hypot(re[1], im[1]) + 1e-3));
+}
+
+//
+// a packet at a time, the matrix taken at each, from CHECK_START in
+// buffer 0 round to it again
+//
+static Bool check_correct(U8 left, U8 right) {
+	U32 index = CHECK_START;
+	U8 out = 0;
+	Bool active = FALSE;
+	int done;
+
+	for (done = 0; done < CHECK_PAIRS; done += CHECK_PACKET) {
+		active = iq_correction_latch();
+		if (active)
+			iq_correction_ahead(out, index, CHECK_PACKET, left, right);
+		index += 2 * CHECK_PACKET;
+		if (index >= AUDIO_BUFFER_SIZE) {
+			index -= AUDIO_BUFFER_SIZE;
+			out = 1 - out;
+		}
+	}
+	return active;
+}
+
+static void check_set(const S16 *m, U16 operation) {
+	U8 reply[IQ_CORRECTION_RECORD_SIZE];
+	U16 k;
+
+	for (k = 0; k < 4; k += 1)
+		iq_correction_request(IQ_CORRECTION_SET_A + k, (U16)m[k], reply);
+	if (iq_correction_request(operation, 0, reply) != IQ_CORRECTION_RECORD_SIZE
+		|| reply[0] != IQ_CORRECTION_VERSION || (reply[1] & IQ_CORRECTION_FLAG_BAD_OP))
+		fail = fail ? fail : "vendor request reply";
+}
+
+//
+// the matrix for the error, in Q14 as a host would round it
+//
+static void check_matrix(double gain_db, double phase_deg, S16 *m) {
+	double g = pow(10, gain_db / 20), p = phase_deg * M_PI / 180;
+
+	m[0] = IQ_CORRECTION_ONE;
+	m[1] = 0;
+	m[2] = (S16)lround(-tan(p) * IQ_CORRECTION_ONE);
+	m[3] = (S16)lround(IQ_CORRECTION_ONE / (g * cos(p)));
+}
+
+static const struct {
+	double gain_db, phase_deg;
+} check_cases[] = {
+	{ 0.5, 2 }, { -1.0, 5 }, { 0.2, -3 }, { 1.0, -8 }, { 0.05, 0.5 }
+};
+
+#define CHECK_CASES	(sizeof(check_cases) / sizeof(check_cases[0]))
+
+int main(int argc, char *argv[]) {
+	static const S16 identity[4] = { IQ_CORRECTION_ONE, 0, 0, IQ_CORRECTION_ONE };
+	double before, after, worst_before = 200, worst_after = 200, cycles;
+	U8 reply[IQ_CORRECTION_RECORD_SIZE], left, right;
+	S16 m[4];
+	unsigned c;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	// a fresh user page, nothing saved
+	memset(&iq_correction_nvram, 0xff, sizeof(iq_correction_nvram));
+	iq_correction_init();
+	if (iq_correction_latch())
+		fail = fail ? fail : "not the identity at boot";
+
+	for (c = 0; c < CHECK_CASES; c += 1) {
+		left = c & 1;
+		right = 1 - left;
+		check_fill(check_cases[c].gain_db, check_cases[c].phase_deg, left, right);
+		before = check_rejection(left, right);
+		check_matrix(check_cases[c].gain_db, check_cases[c].phase_deg, m);
+		check_set(m, IQ_CORRECTION_APPLY);
+		if (!check_correct(left, right))
+			fail = fail ? fail : "matrix not taken";
+		after = check_rejection(left, right);
+		worst_before = min(worst_before, before);
+		worst_after = min(worst_after, after);
+		if (after < CHECK_REJECTION)
+			fail = fail ? fail : "image rejection";
+		if (verbose)
+			printf("%+.2f dB %+.1f deg, %s: %.1f dB before, %.1f dB after\n",
+				   check_cases[c].gain_db, check_cases[c].phase_deg, left ? "swapped" : "normal",
+				   before, after);
+	}
+
+	// staged only, the last matrix stays in effect and corrects again
+	check_fill(check_cases[0].gain_db, check_cases[0].phase_deg, 0, 1);
+	check_matrix(check_cases[0].gain_db, check_cases[0].phase_deg, m);
+	check_set(m, IQ_CORRECTION_APPLY);
+	check_set(identity, IQ_CORRECTION_READ);
+	check_correct(0, 1);
+	if (check_rejection(0, 1) < CHECK_REJECTION)
+		fail = fail ? fail : "staged coefficients took effect";
+
+	// saved, there after a reboot, gone after a factory reset
+	check_set(m, IQ_CORRECTION_SAVE);
+	iq_correction_init();
+	check_fill(check_cases[0].gain_db, check_cases[0].phase_deg, 0, 1);
+	check_correct(0, 1);
+	iq_correction_request(IQ_CORRECTION_READ, 0, reply);
+	if (check_rejection(0, 1) < CHECK_REJECTION || !(reply[1] & IQ_CORRECTION_FLAG_SAVED))
+		fail = fail ? fail : "saved matrix not read back";
+	check_factory_reset();
+	iq_correction_init();
+	iq_correction_request(IQ_CORRECTION_READ, 0, reply);
+	if (iq_correction_latch() || (reply[1] & (IQ_CORRECTION_FLAG_SAVED | IQ_CORRECTION_FLAG_ACTIVE)))
+		fail = fail ? fail : "saved matrix after a factory reset";
+
+	// the identity leaves the buffers alone
+	check_set(m, IQ_CORRECTION_APPLY);
+	iq_correction_request(IQ_CORRECTION_IDENTITY, 0, reply);
+	check_fill(check_cases[0].gain_db, check_cases[0].phase_deg, 0, 1);
+	before = check_rejection(0, 1);
+	if (check_correct(0, 1) || check_rejection(0, 1) != before)
+		fail = fail ? fail : "identity corrected";
+	if (!(iq_correction_request(0x55, 0, reply) && (reply[1] & IQ_CORRECTION_FLAG_BAD_OP)))
+		fail = fail ? fail : "unknown operation taken";
+
+	// the work of one pass over both buffers, cycles a pair on the model
+	memset(&iq_correction_work, 0, sizeof(iq_correction_work));
+	check_set(m, IQ_CORRECTION_APPLY);
+	check_correct(0, 1);
+	if (iq_correction_work.pairs != CHECK_PAIRS)
+		fail = fail ? fail : "pairs corrected not one each";
+	cycles = ((double)iq_correction_work.runs * CHECK_CYCLES_RUN
+			  + (double)iq_correction_work.pairs * CHECK_CYCLES_PAIR) / CHECK_PAIRS;
+	if (cycles * CHECK_RATE > (double)CHECK_CPU_HZ * CHECK_BUDGET / 100)
+		fail = fail ? fail : "over the CPU budget";
+	if (verbose)
+		printf("%u runs of %u pairs in all\n", iq_correction_work.runs, iq_correction_work.pairs);
+
+	printf("iq-correction-check: %u cases: image rejection %.1f dB before, %.1f dB after, "
+		   "an estimated %.1f cycles a sample on a UC3A model, %.1f%% of the CPU at %u Hz\n",
+		   (unsigned)CHECK_CASES, worst_before, worst_after, cycles / 2,
+		   100 * cycles * CHECK_RATE / CHECK_CPU_HZ, CHECK_RATE);
+	if (fail) {
+		fprintf(stderr, "iq-correction-check: %s\n", fail);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,145 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * iq-decimator-bench.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Run the narrowband IQ decimator of src/iq_decimator.c on the host, built
+ * for one UAC2_IQ_DECIMATION:
+ *
+ *   iq-decimator-bench [-v]
+ *
+ * Complex tones at the highest ADC rate, I the cosine and Q the sine, go
+ * through it in runs of odd lengths as the ADC buffers wrap, and the tone
+ * is measured where it lands at the output rate:
+ *
+ *   - one output pair per UAC2_IQ_DECIMATION input pairs, whatever the runs
+ *   - flat to 0.1 dB up to IQ_DECIMATOR_PASS percent of the output rate
+ *   - 60 dB down from IQ_DECIMATOR_STOP percent up to half the ADC rate
+ *     where it folds into the pass band
+ *   - the cycles per input and per output pair on a model of the UC3A,
+ *     within 40% of the CPU
+ *
+ * Prints the response and the cycles, exits 1 if a check fails, -v lists
+ * every tone.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "iq_decimator.h"
+
+#define CHECK_RATE			192000		// ADC rate, the highest record rate
+#define CHECK_OUT_RATE		(CHECK_RATE / UAC2_IQ_DECIMATION)
+#define CHECK_OUTPUTS		512			// pairs per tone, the first half to settle
+#define CHECK_AMPLITUDE		0x400000	// half scale
+#define CHECK_STEP			(CHECK_OUT_RATE / 100)
+
+// a UC3A model of the work: per input pair a load and the sign extension
+// of each sample, an add and store per integrator and the phase; per CIC
+// output a load, subtract and store per comb and the history; per output
+// pair two word loads, an add, a halfword load and a macwh.d per pair of
+// taps, the rounding and saturation
+#define CHECK_CPU_HZ		66000000
+#define CHECK_BUDGET		40			// percent of the CPU at most
+#define CHECK_INTEGRATORS	(IQ_DECIMATOR_CIC > 1 ? 3 * IQ_DECIMATOR_ORDER : 1)
+#define CHECK_COMBS			(IQ_DECIMATOR_CIC > 1 ? 3 * IQ_DECIMATOR_ORDER : 0)
+#define CHECK_CYCLES_INPUT	(2 * (3 + CHECK_INTEGRATORS) + 3)
+#define CHECK_CYCLES_COMB	(2 * (1 + CHECK_COMBS + 3) + 6)
+#define CHECK_CYCLES_OUTPUT	(2 * (5 * (IQ_DECIMATOR_TAPS / 2) + 3 + 8) + 4)
+
+struct iq_decimator_work iq_decimator_work;
+
+static int verbose;
+static const char *fail;	// first rule a tone broke
+
+//
+// the level in dB of a complex tone at f Hz at the ADC rate, after the
+// decimator, at the frequency it folds to at the output rate
+//
+static double check_tone(double f) {
+	static iq_decimator_t decimator;
+	static U32 pairs[2 * CHECK_OUTPUTS * UAC2_IQ_DECIMATION];
+	static S32 iq[2 * CHECK_OUTPUTS];
+	double fout, phase, re = 0, im = 0;
+	int n, i, run, split = 0;
+
+	for (i = 0; i < CHECK_OUTPUTS * UAC2_IQ_DECIMATION; i += 1) {
+		phase = 2 * M_PI * f * i / CHECK_RATE;
+		pairs[2 * i] = (U32)lround(CHECK_AMPLITUDE * cos(phase)) & 0xffffff;
+		pairs[2 * i + 1] = (U32)lround(CHECK_AMPLITUDE * sin(phase)) & 0xffffff;
+	}
+
+	// in runs of 1 to 61 pairs, the whole always a multiple of the decimation
+	iq_decimator_init(&decimator);
+	n = 0;
+	for (i = 0; i < CHECK_OUTPUTS * UAC2_IQ_DECIMATION; i += run) {
+		run = min(split % 61 + 1, CHECK_OUTPUTS * UAC2_IQ_DECIMATION - i);
+		split += 17;
+		n += iq_decimator_run(&decimator, &pairs[2 * i], run, &iq[2 * n]);
+		if (n != (i + run) / UAC2_IQ_DECIMATION)
+			fail = fail ? fail : "output pairs not one per decimation";
+	}
+
+	fout = f - CHECK_OUT_RATE * floor(f / CHECK_OUT_RATE + 0.5);
+	for (i = CHECK_OUTPUTS / 2; i < n; i += 1) {
+		phase = 2 * M_PI * fout * i / CHECK_OUT_RATE;
+		re += iq[2 * i] * cos(phase) + iq[2 * i + 1] * sin(phase);
+		im += iq[2 * i + 1] * cos(phase) - iq[2 * i] * sin(phase);
+	}
+	return 20 * log10(hypot(re, im) / (CHECK_OUTPUTS - CHECK_OUTPUTS / 2) / CHECK_AMPLITUDE + 1e-12);
+}
+
+int main(int argc, char *argv[]) {
+	double f, db, pass_min = 100, pass_max = -200, stop = -200, cycles;
+	U32 inputs, combs, outputs;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	for (f = 0; f <= CHECK_OUT_RATE * IQ_DECIMATOR_PASS / 100; f += CHECK_STEP) {
+		db = check_tone(f);
+		pass_min = min(pass_min, db);
+		pass_max = max(pass_max, db);
+		if (verbose)
+			printf("%6.0f Hz: %+.3f dB\n", f, db);
+	}
+	for (f = CHECK_OUT_RATE * IQ_DECIMATOR_STOP / 100; f <= CHECK_RATE / 2; f += CHECK_STEP) {
+		if (fabs(f - CHECK_OUT_RATE * floor(f / CHECK_OUT_RATE + 0.5)) > CHECK_OUT_RATE * IQ_DECIMATOR_PASS / 100)
+			continue;
+		db = check_tone(f);
+		stop = max(stop, db);
+		if (verbose)
+			printf("%6.0f Hz: %.1f dB\n", f, db);
+	}
+
+	// the work of one tone, in cycles a second at the ADC rate
+	memset(&iq_decimator_work, 0, sizeof(iq_decimator_work));
+	check_tone(CHECK_STEP);
+	inputs = iq_decimator_work.inputs;
+	combs = iq_decimator_work.combs;
+	outputs = iq_decimator_work.outputs;
+	cycles = (double)inputs * CHECK_CYCLES_INPUT + (double)combs * CHECK_CYCLES_COMB
+		+ (double)outputs * CHECK_CYCLES_OUTPUT;
+
+	if (pass_min < -0.1 || pass_max > 0.1)
+		fail = fail ? fail : "pass band not flat";
+	else if (stop > -60)
+		fail = fail ? fail : "stop band";
+	else if (cycles / inputs * CHECK_RATE > (double)CHECK_CPU_HZ * CHECK_BUDGET / 100)
+		fail = fail ? fail : "over the CPU budget";
+
+	printf("iq-decimator-bench: %u to %u Hz: pass %+.2f..%+.2f dB, stop %.1f dB, "
+		   "%.1f cycles an input, %.0f an output, %.0f%% of the CPU\n",
+		   CHECK_RATE, CHECK_OUT_RATE, pass_min, pass_max, stop, cycles / inputs, cycles / outputs,
+		   100 * cycles / inputs * CHECK_RATE / CHECK_CPU_HZ);
+	if (fail) {
+		fprintf(stderr, "iq-decimator-bench: decimation %u: %s\n", UAC2_IQ_DECIMATION, fail);
+		return 1;
+	}
+	return 0;
+}
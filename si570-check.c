@@ -0,0 +1,380 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * si570-check.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Run the Si570 driver of src/si570_tune.c on the host against a double
+ * precision reference:
+ *
+ *   si570-check [-v]
+ *
+ * The I2C writes go to a model of the Si570 registers. Frequencies
+ * anywhere from 10 MHz to the top of the DCO range, and walks of small
+ * steps that cross the edge of the smooth tune range, with the nominal
+ * crystal and a calibrated one:
+ *
+ *   - HS_DIV and N1 as the reference picks them, the lowest DCO, and no
+ *     write for a frequency the dividers cannot make
+ *   - RFREQ that of the rounded double, one LSB off for 1% at most, the
+ *     output within CHECK_PPB of the frequency set
+ *   - within the smooth tune range of the last full update RFREQ alone,
+ *     with the M divider frozen, else all of it with the DCO frozen and
+ *     NewFreq, and a full update too where RFREQ alone would take the DCO
+ *     out of its range
+ *   - a write that fails leaves nothing frozen and the next update full
+ *   - with the subtract and multiply of a smart VFO, the frequency they
+ *     make tuned to and the one set read back
+ *   - the time an update takes on a model of the UC3A and the I2C bus
+ *
+ * Prints the counts and the times, exits 1 if a check fails, -v lists
+ * every update.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "board.h"
+#include "eventlog.h"
+#include "si570_tune.h"
+
+#define CHECK_RANDOM		10000		// frequencies anywhere
+#define CHECK_WALKS			200			// walks of small steps
+#define CHECK_WALK_STEPS	50
+#define CHECK_PPB			0.1			// output within, of the frequency set
+#define CHECK_CALIBRATION	150			// ppm off the nominal crystal
+#define CHECK_MHZ			2097152.0	// 1 << 21, DG8SAQ_SET_FREQ units
+#define CHECK_XTAL_MHZ		16777216.0	// 1 << 24, DG8SAQ_SET_XTAL units
+#define CHECK_RFREQ_ONE		268435456.0	// 1 << 28
+
+// a UC3A model of the work: per 64 bit quotient a call of __udivdi3, the
+// UC3A divides 32 bits at most; per update the compares, the register
+// bytes and the TWIM packages; per I2C byte nine bit times, per write a
+// start and a stop; a full update waits for the DCO to settle
+#define CHECK_CPU_HZ		66000000
+#define CHECK_I2C_HZ		400000
+#define CHECK_CYCLES_DIVIDE	250
+#define CHECK_CYCLES_UPDATE	200
+#define CHECK_SETTLE_MS		10
+
+avr32_twim_t si570_check_twim;
+struct si570_work si570_work;
+
+static int verbose;
+static const char *fail;			// first rule an update broke
+
+// the Si570 model, and the writes of one update
+static U8 check_regs[256];
+static struct {
+	U8 reg, length, value;			// value the first byte
+} check_write[8];
+static unsigned check_writes, check_bits;
+static int check_nack = -1;			// the write that fails
+static unsigned check_events;
+
+// the reference: the crystal, and the state of the last full update
+static double ref_xtal = SI570_XTAL_DEFAULT / CHECK_XTAL_MHZ;
+static U32 ref_center;
+static int ref_hs_div, ref_n1;
+static unsigned ref_ppm = SI570_SMOOTH_PPM;
+static S32 ref_sub;
+static U32 ref_mul = SI570_MUL_ONE;
+
+// what the updates took
+static unsigned check_updates, check_smooth, check_full, check_none, check_lsb, check_edge;
+static double check_ppb_max;
+static unsigned long check_smooth_bits, check_full_bits, check_smooth_divides, check_full_divides;
+
+static U32 check_seed = 1;
+
+static U32 check_random(void) {
+	check_seed = check_seed * 1103515245 + 12345;
+	return check_seed >> 8;
+}
+
+static U32 check_random32(void) {
+	return check_random() << 16 ^ check_random();
+}
+
+void eventlog_put(eventlog_id_t id, U32 arg0, U32 arg1, U32 arg2) {
+	check_events += 1;
+	if (verbose)
+		printf("event %u: register %u, error -%u, frequency 0x%x\n", id, arg0, arg1, arg2);
+}
+
+int twim_write_packet(volatile avr32_twim_t *twi, const twi_package_t *package) {
+	unsigned n = check_writes++;
+
+	if (twi != TWIM0 || package->chip != SI570_I2C_ADDRESS || package->addr_length != 1)
+		fail = fail ? fail : "write not to the Si570";
+	check_bits += 2 + 9 * (2 + package->length);
+	if ((int)n == check_nack)
+		return TWI_RECEIVE_NACK;
+	if (n < sizeof(check_write) / sizeof(check_write[0])) {
+		check_write[n].reg = package->addr;
+		check_write[n].length = package->length;
+		check_write[n].value = *(U8 *)package->buffer;
+	}
+	memcpy(&check_regs[package->addr], package->buffer, package->length);
+	return TWI_SUCCESS;
+}
+
+//
+// the lowest DCO, in double
+//
+static int ref_dividers(double f, int *hs_div, int *n1) {
+	static const int hs_divs[] = { 11, 9, 7, 6, 5, 4 };
+	double dco, best = 0;
+	int h, n;
+
+	for (h = 0; h < 6; h += 1) {
+		n = (int)ceil(SI570_DCO_MIN / (f * hs_divs[h]));
+		if (n > 1 && (n & 1) != 0)
+			n += 1;
+		if (n > 128)
+			continue;
+		dco = f * hs_divs[h] * n;
+		if (dco <= SI570_DCO_MAX && (best == 0 || dco < best)) {
+			best = dco;
+			*hs_div = hs_divs[h];
+			*n1 = n;
+		}
+	}
+	return best != 0;
+}
+
+//
+// the frequency subtracted and multiplied, exact, 0 if out of range
+//
+static U32 ref_vfo(U32 freq) {
+	S64 diff = (S64)freq - ref_sub;
+	unsigned __int128 vfo = (unsigned __int128)diff * ref_mul >> 21;
+
+	return diff > 0 && vfo <= 0xffffffff ? (U32)vfo : 0;
+}
+
+static int check_write_is(unsigned n, U8 reg, U8 length, U8 value) {
+	return check_write[n].reg == reg && check_write[n].length == length
+		&& (length != 1 || check_write[n].value == value);
+}
+
+//
+// one update against the reference
+//
+static void check_freq(U32 freq) {
+	U32 vfo = ref_vfo(freq);
+	double f = vfo / CHECK_MHZ, out, ppb;
+	int smooth, hs_div = ref_hs_div, n1 = ref_n1, reg_hs_div, reg_n1;
+	U64 rfreq = 0, reg_rfreq;
+	Bool ok;
+
+	smooth = ref_center != 0 && fabs((double)vfo - ref_center) * 1e6 <= (double)ref_ppm * ref_center;
+	if (smooth && (f * hs_div * n1 < SI570_DCO_MIN || f * hs_div * n1 > SI570_DCO_MAX)) {
+		smooth = 0;
+		check_edge += 1;
+	}
+	if (! smooth && (vfo == 0 || ! ref_dividers(f, &hs_div, &n1)))
+		hs_div = 0;
+	else
+		rfreq = (U64)floor(f * hs_div * n1 / ref_xtal * CHECK_RFREQ_ONE + 0.5);
+
+	check_writes = 0;
+	check_bits = 0;
+	si570_work.divides = 0;
+	ok = si570_set_freq(freq);
+	check_updates += 1;
+
+	if (hs_div == 0) {
+		if (ok || check_writes != 0)
+			fail = fail ? fail : "frequency with no dividers written";
+		check_none += 1;
+		return;
+	}
+	if (! ok) {
+		fail = fail ? fail : "update failed";
+		return;
+	}
+
+	if (smooth) {
+		if (check_writes != 3 || ! check_write_is(0, SI570_REG_CONTROL, 1, SI570_FREEZE_M)
+			|| ! check_write_is(1, SI570_REG_N1_RFREQ, SI570_REGS - 1, 0)
+			|| ! check_write_is(2, SI570_REG_CONTROL, 1, 0))
+			fail = fail ? fail : "smooth update not RFREQ alone with M frozen";
+		check_smooth += 1;
+		check_smooth_bits += check_bits;
+		check_smooth_divides += si570_work.divides;
+	} else {
+		if (check_writes != 4 || ! check_write_is(0, SI570_REG_FREEZE, 1, SI570_FREEZE_DCO)
+			|| ! check_write_is(1, SI570_REG_HS_N1, SI570_REGS, 0)
+			|| ! check_write_is(2, SI570_REG_FREEZE, 1, 0)
+			|| ! check_write_is(3, SI570_REG_CONTROL, 1, SI570_NEW_FREQ))
+			fail = fail ? fail : "full update not with the DCO frozen and NewFreq";
+		check_full += 1;
+		check_full_bits += check_bits;
+		check_full_divides += si570_work.divides;
+		ref_center = vfo;
+		ref_hs_div = hs_div;
+		ref_n1 = n1;
+	}
+
+	// what the Si570 has now
+	reg_hs_div = (check_regs[7] >> 5) + 4;
+	reg_n1 = ((check_regs[7] & 0x1f) << 2 | check_regs[8] >> 6) + 1;
+	reg_rfreq = (U64)(check_regs[8] & 0x3f) << 32 | (U32)check_regs[9] << 24 | check_regs[10] << 16
+		| check_regs[11] << 8 | check_regs[12];
+	out = ref_xtal * (reg_rfreq / CHECK_RFREQ_ONE) / (reg_hs_div * reg_n1);
+	ppb = fabs(out - f) / f * 1e9;
+	if (ppb > check_ppb_max)
+		check_ppb_max = ppb;
+
+	if (verbose)
+		printf("%.6f MHz %s HS_DIV %d N1 %d RFREQ 0x%010llx, %.3f ppb\n", f, smooth ? "smooth" : "full",
+			   reg_hs_div, reg_n1, (unsigned long long)reg_rfreq, ppb);
+	if (reg_hs_div != hs_div || reg_n1 != n1)
+		fail = fail ? fail : "dividers not the reference's";
+	if (reg_rfreq != rfreq) {
+		if (reg_rfreq + 1 != rfreq && reg_rfreq != rfreq + 1)
+			fail = fail ? fail : "RFREQ off the reference";
+		check_lsb += 1;
+	}
+	if (ppb > CHECK_PPB)
+		fail = fail ? fail : "output off the frequency set";
+	if (si570_get_freq() != freq)
+		fail = fail ? fail : "frequency not read back";
+}
+
+//
+// steps of up to max_ppm either way from start
+//
+static void check_walk(U32 start, unsigned max_ppm) {
+	U32 freq = start;
+	S64 step;
+	int n;
+
+	check_freq(freq);
+	for (n = 0; n < CHECK_WALK_STEPS; n += 1) {
+		step = (S64)freq * (check_random() % (max_ppm + 1)) / 1000000;
+		freq += check_random() & 1 ? step : -step;
+		check_freq(freq);
+	}
+}
+
+static void check_walks(void) {
+	int n;
+
+	for (n = 0; n < CHECK_WALKS; n += 1)
+		check_walk((10 + check_random() % 150) * (U32)CHECK_MHZ + check_random() % (U32)CHECK_MHZ,
+				   n % 2 ? 100 : 1000);
+}
+
+static double check_us(unsigned long bits, unsigned long divides, unsigned updates) {
+	if (updates == 0)
+		return 0;
+	return ((double)bits / CHECK_I2C_HZ
+			+ (double)(divides * CHECK_CYCLES_DIVIDE + updates * CHECK_CYCLES_UPDATE) / CHECK_CPU_HZ)
+		* 1e6 / updates;
+}
+
+int main(int argc, char *argv[]) {
+	U32 xtal;
+	double smooth_us, full_us;
+	unsigned none;
+	int n;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	// nothing written before the first update, and none for what cannot be made
+	check_freq(0);
+	check_freq((U32)(950 * CHECK_MHZ));		// between HS_DIV 6 and 5 with N1 1
+	check_freq((U32)(1500 * CHECK_MHZ));	// above the DCO over 4
+	if (check_none != 3)
+		fail = fail ? fail : "impossible frequency taken";
+
+	// anywhere, and in small steps
+	for (n = 0; n < CHECK_RANDOM; n += 1)
+		check_freq((U32)(10 * CHECK_MHZ) + check_random32() % (U32)(1408 * CHECK_MHZ));
+	check_walks();
+
+	// a calibrated crystal, from the next update on
+	xtal = (U32)(SI570_XTAL_DEFAULT * (1 + CHECK_CALIBRATION / 1e6));
+	si570_set_xtal(xtal);
+	ref_xtal = xtal / CHECK_XTAL_MHZ;
+	check_walks();
+	si570_set_xtal(0);
+	ref_xtal = SI570_XTAL_DEFAULT / CHECK_XTAL_MHZ;
+
+	// no smooth tuning, then a narrower range
+	si570_set_smooth(0);
+	ref_ppm = 0;
+	check_walk((U32)(14 * CHECK_MHZ), 100);
+	si570_set_smooth(500);
+	ref_ppm = 500;
+	check_walk((U32)(14 * CHECK_MHZ), 100);
+	si570_set_smooth(SI570_SMOOTH_PPM);
+	ref_ppm = SI570_SMOOTH_PPM;
+
+	// the RFREQ write of a smooth update fails: M not left frozen, the
+	// next update a full one
+	check_freq((U32)(28 * CHECK_MHZ));
+	check_writes = 0;
+	check_nack = 1;
+	if (si570_set_freq((U32)(28.01 * CHECK_MHZ)) || check_events != 1)
+		fail = fail ? fail : "failed write not reported";
+	check_nack = -1;
+	if (check_regs[SI570_REG_CONTROL] != 0)
+		fail = fail ? fail : "M left frozen";
+	ref_center = 0;
+	check_freq((U32)(28.02 * CHECK_MHZ));
+
+	// the register writes by the Mobo firmware
+	si570_forget();
+	ref_center = 0;
+	check_walk((U32)(7 * CHECK_MHZ), 100);
+
+	// a smart VFO at 4 times the frequency, then off it by a 9 MHz IF, then
+	// at 1.5 times, and below the subtract nothing
+	none = check_none;
+	ref_mul = 4 * SI570_MUL_ONE;
+	si570_set_sub_mul(ref_sub, ref_mul);
+	check_walk((U32)(3.5 * CHECK_MHZ), 1000);
+	ref_sub = (S32)(-9 * CHECK_MHZ);
+	si570_set_sub_mul(ref_sub, ref_mul);
+	check_walk((U32)(7 * CHECK_MHZ), 1000);
+	ref_sub = (S32)(9 * CHECK_MHZ);
+	ref_mul = 3 * SI570_MUL_ONE / 2;
+	si570_set_sub_mul(ref_sub, ref_mul);
+	check_walk((U32)(21 * CHECK_MHZ), 1000);
+	check_freq((U32)(8 * CHECK_MHZ));
+	if (check_none != none + 1)
+		fail = fail ? fail : "frequency below the subtract taken";
+	ref_sub = 0;
+	ref_mul = SI570_MUL_ONE;
+	si570_set_sub_mul(0, 0);
+	check_walk((U32)(14 * CHECK_MHZ), 100);
+
+	smooth_us = check_us(check_smooth_bits, check_smooth_divides, check_smooth);
+	full_us = check_us(check_full_bits, check_full_divides, check_full);
+	// the double rounds the other way now and then, not as a rule
+	if (check_lsb * 100 > check_updates)
+		fail = fail ? fail : "RFREQ not rounded";
+	if (check_smooth == 0 || smooth_us >= full_us)
+		fail = fail ? fail : "smooth update no faster";
+	if (check_edge == 0)
+		fail = fail ? fail : "no smooth step out of the DCO range";
+
+	printf("si570-check: %u updates, %u smooth, %u full (%u out of the DCO range smooth), %u impossible, "
+		   "registers as the reference (%u RFREQ 1 LSB off), within %.3f ppb, smooth %.0f us, "
+		   "full %.0f us + %u ms settling\n",
+		   check_updates, check_smooth, check_full, check_edge, check_none, check_lsb, check_ppb_max,
+		   smooth_us, full_us, CHECK_SETTLE_MS);
+	if (fail) {
+		fprintf(stderr, "si570-check: %s\n", fail);
+		return 1;
+	}
+	return 0;
+}
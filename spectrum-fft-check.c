@@ -0,0 +1,290 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * spectrum-fft-check.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Run the spectrum FFT of src/spectrum_fft.c on the host against a double
+ * precision reference:
+ *
+ *   spectrum-fft-check [-v]
+ *
+ * Blocks of IQ, tones at and between bins and noise, in either channel
+ * order, are windowed in two runs as the ADC buffers wrap:
+ *
+ *   - every bin of the FFT within 120 dB below full scale of the
+ *     reference DFT with the same window
+ *   - the level of every bin down to 80 dB within 0.05 dB of 10 log10
+ *     of its power
+ *   - a full scale tone at 0 dB, one at -60 dBFS at -60 dB, in its bin
+ *   - the frames, averaged and grouped, as the reference levels say
+ *   - the cycles per FFT on a model of the UC3A, and the CPU at the
+ *     most FFTs a second the spectrum task runs, within 10%
+ *
+ * Prints the errors and the cycles, exits 1 if a check fails, -v lists
+ * every block.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "spectrum_fft.h"
+
+#define N					SPECTRUM_FFT_SIZE
+#define CHECK_FULL_SCALE	8388608.0	// 1 << 23
+#define CHECK_ERROR			120			// dB below full scale at least, FFT against the reference
+#define CHECK_LEVEL_ERROR	0.05		// dB
+#define CHECK_LEVEL_RANGE	80			// dB below full scale, the bins the levels are checked on
+#define CHECK_SPLIT			77			// pairs in the first run of the window
+
+// a UC3A model of the work: per windowed pair two loads, sign extensions,
+// a table load, two muls.d and shifts and two stores; per butterfly four
+// ld.d, sixteen adds, four st.d and the loop; per rotation four muls.d,
+// the 64 bit adds, roundings and shifts; per level the digit reversal,
+// two muls.d, the clz, normalize, table and interpolation, the scaling
+// and the add into the sum
+#define CHECK_CPU_HZ		66000000
+#define CHECK_BUDGET		10			// percent of the CPU at most
+#define CHECK_CYCLES_WINDOW		20
+#define CHECK_CYCLES_BUTTERFLY	34
+#define CHECK_CYCLES_ROTATION	22
+#define CHECK_CYCLES_LEVEL		45
+
+struct spectrum_fft_work spectrum_fft_work;
+
+static int verbose;
+static const char *fail;	// first rule a block broke
+
+static U32 pairs[2 * N];
+static S32 x[2 * N];
+static double ref_re[N], ref_im[N];
+
+static double check_window(int n) {
+	double t = 2 * M_PI * n / N;
+
+	return 0.35875 - 0.48829 * cos(t) + 0.14128 * cos(2 * t) - 0.01168 * cos(3 * t);
+}
+
+//
+// the block: tones of amplitude in dBFS at bin fractions, and noise
+//
+static void check_fill(const double *bin, const double *dbfs, int tones, double noise, unsigned seed) {
+	double i, q, a;
+	int n, t;
+
+	srand(seed);
+	for (n = 0; n < N; n += 1) {
+		i = q = 0;
+		for (t = 0; t < tones; t += 1) {
+			a = CHECK_FULL_SCALE * pow(10, dbfs[t] / 20);
+			i += a * cos(2 * M_PI * bin[t] * n / N);
+			q += a * sin(2 * M_PI * bin[t] * n / N);
+		}
+		i += noise * CHECK_FULL_SCALE * (rand() / (double)RAND_MAX - 0.5);
+		q += noise * CHECK_FULL_SCALE * (rand() / (double)RAND_MAX - 0.5);
+		i = fmin(fmax(i, -CHECK_FULL_SCALE), CHECK_FULL_SCALE - 1);
+		q = fmin(fmax(q, -CHECK_FULL_SCALE), CHECK_FULL_SCALE - 1);
+		pairs[2 * n] = (U32)lround(i) & 0xffffff;
+		pairs[2 * n + 1] = (U32)lround(q) & 0xffffff;
+	}
+}
+
+// the level in dB below full scale of a reference power
+static double check_level(double power) {
+	double fs = CHECK_FULL_SCALE * N * 0.35875 / (1 << SPECTRUM_FFT_PRESHIFT);
+
+	return power > 0 ? -10 * log10(power / (fs * fs)) : 256;
+}
+
+//
+// the reference DFT of the block windowed in double, scaled as the FFT is
+//
+static void check_reference(void) {
+	double i, q, w;
+	int n, k;
+
+	for (k = 0; k < N; k += 1) {
+		ref_re[k] = ref_im[k] = 0;
+		for (n = 0; n < N; n += 1) {
+			i = (S32)(pairs[2 * n] << 8) >> 8;
+			q = (S32)(pairs[2 * n + 1] << 8) >> 8;
+			w = llround(check_window(n) * (1 << 30)) / (double)(1 << 30) / (1 << SPECTRUM_FFT_PRESHIFT);
+			ref_re[k] += w * (i * cos(2 * M_PI * k * n / N) + q * sin(2 * M_PI * k * n / N));
+			ref_im[k] += w * (q * cos(2 * M_PI * k * n / N) - i * sin(2 * M_PI * k * n / N));
+		}
+	}
+}
+
+static U16 check_reversed(U16 k) {
+	U16 r = 0;
+	int d;
+
+	for (d = 0; d < SPECTRUM_FFT_LOG4; d += 1) {
+		r = (r << 2) | (k & 3);
+		k >>= 2;
+	}
+	return r;
+}
+
+//
+// window in two runs, swapped or not, the FFT and the error of its worst
+// bin against the reference in dB below full scale
+//
+static double check_fft(Bool swapped) {
+	static U32 swap[2 * N];
+	double err = 0, er, ei;
+	int n, k;
+	U8 left = swapped ? 1 : 0;
+
+	for (n = 0; n < N; n += 1) {
+		swap[2 * n + left] = pairs[2 * n];
+		swap[2 * n + 1 - left] = pairs[2 * n + 1];
+	}
+	spectrum_fft_window(x, 0, swap, CHECK_SPLIT, left, 1 - left);
+	spectrum_fft_window(x, CHECK_SPLIT, &swap[2 * CHECK_SPLIT], N - CHECK_SPLIT, left, 1 - left);
+	spectrum_fft_run(x);
+
+	check_reference();
+	for (k = 0; k < N; k += 1) {
+		n = check_reversed(k);
+		er = x[2 * n] - ref_re[k];
+		ei = x[2 * n + 1] - ref_im[k];
+		err = fmax(err, er * er + ei * ei);
+	}
+	return check_level(err);
+}
+
+//
+// the levels of the FFT against those of the reference, the worst error
+// in dB, over the bins the reference has within CHECK_LEVEL_RANGE of full
+// scale, below it the error of the FFT itself shows
+//
+static double check_levels(U32 *sum) {
+	double worst = 0, ref;
+	int n, k;
+
+	memset(sum, 0, N * sizeof(*sum));
+	spectrum_fft_accumulate(x, sum);
+	for (n = 0; n < N; n += 1) {
+		k = (n + N / 2) % N;
+		ref = check_level(ref_re[k] * ref_re[k] + ref_im[k] * ref_im[k]);
+		if (ref < CHECK_LEVEL_RANGE)
+			worst = fmax(worst, fabs(sum[n] / 256.0 - ref));
+	}
+	return worst;
+}
+
+static const struct {
+	double bin[3], dbfs[3];
+	int tones;
+	double noise;
+} check_blocks[] = {
+	{ { 10 }, { 0 }, 1, 0 },							// full scale, in its bin
+	{ { -37 }, { -60 }, 1, 0 },							// -60 dBFS, negative frequency
+	{ { 5.5, -80.25 }, { -6, -20 }, 2, 0 },				// between bins
+	{ { 0, 64, -100 }, { -10, -30, -50 }, 3, 1e-4 },	// DC and noise
+	{ { 0 }, { -200 }, 0, 0.5 },						// noise only
+	{ { 127 }, { -3 }, 1, 1e-6 },						// the top bin
+};
+
+#define CHECK_BLOCKS	(sizeof(check_blocks) / sizeof(check_blocks[0]))
+
+int main(int argc, char *argv[]) {
+	static U32 sum[N], avg[N];
+	U8 bins[N];
+	double error, error_min = 200, level, level_max = 0, cycles;
+	unsigned b, shift, n, k, least;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	for (b = 0; b < CHECK_BLOCKS; b += 1) {
+		check_fill(check_blocks[b].bin, check_blocks[b].dbfs, check_blocks[b].tones, check_blocks[b].noise, b);
+		error = check_fft(b & 1);
+		error_min = fmin(error_min, error);
+		level = check_levels(sum);
+		level_max = fmax(level_max, level);
+		if (verbose)
+			printf("block %u: FFT error %.1f dB below full scale, levels within %.3f dB\n", b, error, level);
+	}
+	if (error_min < CHECK_ERROR)
+		fail = fail ? fail : "FFT against the reference";
+	if (level_max > CHECK_LEVEL_ERROR)
+		fail = fail ? fail : "levels against the reference";
+
+	// the full scale and -60 dBFS tones in their bins, the window three
+	// bins either side, all else down at the error of the FFT
+	check_fill(check_blocks[0].bin, check_blocks[0].dbfs, 1, 0, 0);
+	check_fft(FALSE);
+	check_levels(sum);
+	if (fabs(sum[N / 2 + 10] / 256.0) > 0.05)
+		fail = fail ? fail : "full scale tone not at 0 dB";
+	for (n = 0; n < N; n += 1)
+		if ((n < N / 2 + 10 - 3 || n > N / 2 + 10 + 3) && sum[n] / 256.0 < 110)
+			fail = fail ? fail : "full scale tone leaks past the window";
+	check_fill(check_blocks[1].bin, check_blocks[1].dbfs, 1, 0, 1);
+	check_fft(TRUE);
+	check_levels(sum);
+	if (fabs(sum[N / 2 - 37] / 256.0 - 60) > 0.05)
+		fail = fail ? fail : "-60 dBFS tone not at -60 dB";
+
+	// frames of three averaged FFTs at each grouping, against the levels
+	for (shift = 0; shift <= 2; shift += 1) {
+		memset(sum, 0, sizeof(sum));
+		memset(avg, 0, sizeof(avg));
+		for (b = 0; b < 3; b += 1) {
+			check_fill(check_blocks[3].bin, check_blocks[3].dbfs, 3, 0.01, 10 + b);
+			check_fft(FALSE);
+			spectrum_fft_accumulate(x, sum);
+		}
+		memcpy(avg, sum, sizeof(avg));
+		spectrum_fft_frame(sum, 3, shift, bins);
+		for (n = 0; n < (N >> shift); n += 1) {
+			least = 0xffffffff;
+			for (k = n << shift; k < (n + 1) << shift; k += 1)
+				least = min(least, avg[k] / 3);
+			if (bins[n] != min((least + 64) >> 7, 0xff))
+				fail = fail ? fail : "frame not the strongest averaged bins";
+		}
+		for (n = 0; n < N; n += 1)
+			if (sum[n] != 0)
+				fail = fail ? fail : "sums not cleared by the frame";
+	}
+
+	// the level function alone, over 64 bits of power
+	for (n = 0; n < 64 * 16; n += 1) {
+		U64 power = (U64)ldexp(1 + (n % 16) / 16.0 + 0.013, n / 16);
+		double ref = check_level((double)power);
+
+		if (ref >= 0 && ref < 255 && fabs(spectrum_fft_level(power) / 256.0 - ref) > CHECK_LEVEL_ERROR)
+			fail = fail ? fail : "level function";
+	}
+	if (spectrum_fft_level(0) != SPECTRUM_FFT_LEVEL_MAX)
+		fail = fail ? fail : "level of no power";
+
+	// the work of one FFT
+	check_fill(check_blocks[2].bin, check_blocks[2].dbfs, 2, 0, 2);
+	memset(&spectrum_fft_work, 0, sizeof(spectrum_fft_work));
+	check_fft(FALSE);
+	check_levels(sum);
+	cycles = (double)spectrum_fft_work.windows * CHECK_CYCLES_WINDOW
+		+ (double)spectrum_fft_work.butterflies * CHECK_CYCLES_BUTTERFLY
+		+ (double)spectrum_fft_work.rotations * CHECK_CYCLES_ROTATION
+		+ (double)spectrum_fft_work.levels * CHECK_CYCLES_LEVEL;
+	if (cycles * 1000 / SPECTRUM_FFT_PERIOD_MIN > (double)CHECK_CPU_HZ * CHECK_BUDGET / 100)
+		fail = fail ? fail : "over the CPU budget";
+
+	printf("spectrum-fft-check: %u point radix-4: error %.1f dB below full scale, levels within %.3f dB, "
+		   "%.0f cycles an FFT, %.1f%% of the CPU at %u a second\n",
+		   N, error_min, level_max, cycles, 100 * cycles * 1000 / SPECTRUM_FFT_PERIOD_MIN / CHECK_CPU_HZ,
+		   1000 / SPECTRUM_FFT_PERIOD_MIN);
+	if (fail) {
+		fprintf(stderr, "spectrum-fft-check: %s\n", fail);
+		return 1;
+	}
+	return 0;
+}
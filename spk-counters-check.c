@@ -0,0 +1,172 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * spk-counters-check.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Run the speaker OUT stream counters of src/spk_usb_counters.c on the
+ * host, one writer thread as the device audio task against reader threads
+ * as the AK5394A and Telemetry tasks:
+ *
+ *   spk-counters-check [-v]
+ *
+ * The writer counts CHECK_UPDATES packets of a known number of samples
+ * each, back to back. The barriers of spk_usb_counters.c yield every
+ * CHECK_YIELD_EVERY, so the threads interleave at the points that matter
+ * on one core as well. Every reader snapshot:
+ *
+ *   - has the sample count of exactly its heart beat, nothing torn
+ *   - is no older than the one the reader took before
+ *
+ * and the readers have to retry, or the race was not run into. A reader
+ * that copies the published counters without the retry runs alongside
+ * and counts the copies it took that the writer had moved on from.
+ * Prints the snapshots taken, exits 1 if a check fails, -v prints each
+ * reader's counts.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "spk_usb_counters.h"
+
+#define CHECK_UPDATES		1000000
+#define CHECK_READERS		3
+#define CHECK_YIELD_EVERY	7			// barriers of a thread
+
+static int verbose;
+static volatile int check_done;
+
+typedef struct {
+	unsigned long reads, retries, changed, torn, back;
+} check_reader_t;
+
+static check_reader_t check_readers[CHECK_READERS + 1];
+static __thread unsigned long check_barriers;
+
+void spk_counters_check_barrier(void) {
+	__sync_synchronize();
+	if (++check_barriers % CHECK_YIELD_EVERY == 0)
+		sched_yield();
+}
+
+//
+// the samples of packet n, 44 to 52 as at 48 kHz with feedback
+//
+static U32 check_packet(U32 n) {
+	return 44 + n % 9;
+}
+
+// the samples of packets 1 to heart_beat
+static U32 check_samples(U32 heart_beat) {
+	U32 r = heart_beat % 9;
+
+	return 44 * heart_beat + 36 * (heart_beat / 9) + r * (r + 1) / 2;
+}
+
+static void *check_writer(void *arg) {
+	U32 n;
+
+	for (n = 1; n <= CHECK_UPDATES; n += 1)
+		spk_usb_counters_update(check_packet(n));
+	check_done = 1;
+	return NULL;
+}
+
+static void check_snapshot(check_reader_t *reader, const spk_usb_counts_t *now, spk_usb_counts_t *last) {
+	reader->reads += 1;
+	if (now->sample_counter != check_samples(now->heart_beat))
+		reader->torn += 1;
+	if (now->heart_beat < last->heart_beat)
+		reader->back += 1;
+	if (now->heart_beat != last->heart_beat)
+		reader->changed += 1;
+	*last = *now;
+}
+
+static void *check_reader(void *arg) {
+	check_reader_t *reader = arg;
+	spk_usb_counts_t now, last = { 0, 0 };
+
+	while (! check_done) {
+		spk_usb_counters_read(&now);
+		check_snapshot(reader, &now, &last);
+	}
+	// two barriers a try
+	reader->retries = check_barriers / 2 - reader->reads;
+	return NULL;
+}
+
+//
+// the published copy without the retry: update seq publishes heart beat
+// seq, a copy with another the writer went on to overwrite
+//
+static void *check_reader_unsafe(void *arg) {
+	check_reader_t *reader = arg;
+	U32 seq, heart_beat;
+
+	while (! check_done) {
+		seq = spk_usb_counters.seq;
+		spk_counters_check_barrier();
+		heart_beat = spk_usb_counters.copy[seq & 1].heart_beat;
+		reader->reads += 1;
+		if (heart_beat != seq)
+			reader->torn += 1;
+	}
+	return NULL;
+}
+
+int main(int argc, char *argv[]) {
+	pthread_t writer, readers[CHECK_READERS + 1];
+	spk_usb_counts_t end;
+	const char *fail = NULL;
+	unsigned long reads = 0, retries = 0, changed = 0, torn = 0, back = 0;
+	int n;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	for (n = 0; n < CHECK_READERS; n += 1)
+		pthread_create(&readers[n], NULL, check_reader, &check_readers[n]);
+	pthread_create(&readers[CHECK_READERS], NULL, check_reader_unsafe, &check_readers[CHECK_READERS]);
+	pthread_create(&writer, NULL, check_writer, NULL);
+	pthread_join(writer, NULL);
+	for (n = 0; n <= CHECK_READERS; n += 1)
+		pthread_join(readers[n], NULL);
+
+	for (n = 0; n < CHECK_READERS; n += 1) {
+		if (verbose)
+			printf("reader %d: %lu snapshots, %lu retries, %lu new, %lu torn, %lu back\n", n,
+				   check_readers[n].reads, check_readers[n].retries, check_readers[n].changed,
+				   check_readers[n].torn, check_readers[n].back);
+		reads += check_readers[n].reads;
+		retries += check_readers[n].retries;
+		changed += check_readers[n].changed;
+		torn += check_readers[n].torn;
+		back += check_readers[n].back;
+	}
+	spk_usb_counters_read(&end);
+
+	printf("spk-counters-check: %u updates, %lu snapshots by %u readers, %lu retries, %lu new, %lu torn, "
+		   "%lu back, %lu of %lu overwritten without the retry\n",
+		   CHECK_UPDATES, reads, CHECK_READERS, retries, changed, torn, back,
+		   check_readers[CHECK_READERS].torn, check_readers[CHECK_READERS].reads);
+	if (torn != 0)
+		fail = "torn snapshot";
+	else if (back != 0)
+		fail = "snapshot went back";
+	else if (retries == 0)
+		fail = "no retry, the race was not run into";
+	else if (end.heart_beat != CHECK_UPDATES || end.sample_counter != check_samples(CHECK_UPDATES))
+		fail = "counters lost updates";
+	if (fail) {
+		fprintf(stderr, "spk-counters-check: %s\n", fail);
+		return 1;
+	}
+	return 0;
+}
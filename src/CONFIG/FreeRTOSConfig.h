@@ -80,7 +80,7 @@
  *----------------------------------------------------------*/
 
 #define configUSE_PREEMPTION      1
-#define configUSE_IDLE_HOOK       0
+#define configUSE_IDLE_HOOK       1	// usb_power.c sleeps while suspended
 #define configUSE_TICK_HOOK       0
 #define configCPU_CLOCK_HZ        ( FCPU_HZ ) /* Hz clk gen */
 #define configPBA_CLOCK_HZ        ( FPBA_HZ )
@@ -89,10 +89,11 @@
 ////////////////#define configMINIMAL_STACK_SIZE  ( ( unsigned portSHORT ) 128 )
 #define configMINIMAL_STACK_SIZE  ( ( unsigned portSHORT ) 2048 )
 //#define configMINIMAL_STACK_SIZE  ( ( unsigned portSHORT ) 1024 )
-/* configTOTAL_HEAP_SIZE is not used when heap_3.c is used. */
+/* configTOTAL_HEAP_SIZE is not used when heap_pool.c is used, see configPOOL_CLASSES. */
 #define configTOTAL_HEAP_SIZE     ( ( size_t ) ( 1024*50 ) )
 #define configMAX_TASK_NAME_LEN   ( 20 )
 #define configUSE_TRACE_FACILITY  0
+#define configGENERATE_RUN_TIME_STATS 1
 #define configUSE_16_BIT_TICKS    0
 #define configIDLE_SHOULD_YIELD   1
 #define configUSE_MUTEXES		  1
@@ -111,7 +112,44 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelayUntil             1
 #define INCLUDE_vTaskDelay                  1
 #define INCLUDE_xTaskGetCurrentTaskHandle   0
-#define INCLUDE_xTaskGetSchedulerState      0
+#define INCLUDE_xTaskGetSchedulerState      1	// print_dbg waits for room only before the scheduler runs
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+
+
+/* Run-time statistics time base, see taskRunStats.c.
+   configRUNSTATS_TC_CHANNEL is a free-running TC channel clocked at PBA/32
+   (~2MHz). The 16-bit counter is extended in software on every context
+   switch, which at configTICK_RATE_HZ happens far more often than the
+   ~32ms wrap period. */
+#define configRUNSTATS_TC_CHANNEL     0
+extern void vConfigureTimerForRunTimeStats( void );
+extern unsigned long ulGetRunTimeCounterValue( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	vConfigureTimerForRunTimeStats()
+#define portGET_RUN_TIME_COUNTER_VALUE()			ulGetRunTimeCounterValue()
+
+/* The frequency sweep dwell timer, see sweep.c, a TC channel of the same
+   block, clear of configRUNSTATS_TC_CHANNEL and configTICK_TC_CHANNEL. */
+#define configSWEEP_TC_CHANNEL        1
+
+
+/* Memory allocation, see heap_pool.c and ram_budget.c.
+   pvPortMalloc() serves each request from the smallest of these fixed block
+   pools that fits, POOL_CLASS( block size in bytes, number of blocks ),
+   smallest first. Tasks created in this tree get static stacks through
+   ram_budget_task_create(), so the pools only hold the TCBs, the queue and
+   semaphore structures, and the stacks of the idle task and of tasks created
+   with plain xTaskCreate(). The boot report prints their actual use. */
+#define configPOOL_CLASSES \
+	POOL_CLASS(  128, 24 )	/* TCBs, queue and semaphore structures */ \
+	POOL_CLASS( 1024,  4 )	/* 256 word stacks, small queue buffers */ \
+	POOL_CLASS( 4096,  6 )	/* 1024 word stacks */ \
+	POOL_CLASS( 8192,  1 )	/* configMINIMAL_STACK_SIZE, the idle task */
+
+/* Let xTaskGenericCreate() use a caller supplied stack buffer, the default
+   in FreeRTOS.h ignores it. vPortFree() ignores addresses outside the pools,
+   so vPortFreeAligned() needs no change. */
+#define pvPortMallocAligned( xSize, pvBuffer ) \
+	( ( ( pvBuffer ) == NULL ) ? pvPortMalloc( xSize ) : ( void * ) ( pvBuffer ) )
 
 
 /* configTICK_USE_TC is a boolean indicating whether to use a Timer Counter or
@@ -198,6 +236,41 @@ to exclude the API function. */
 #define configTSK_MoboCtrl_NAME				  ((const signed portCHAR *)"taskMoboCtrl")
 #define configTSK_MoboCtrl_STACK_SIZE		  1024
 #define configTSK_MoboCtrl_PRIORITY			  (tskIDLE_PRIORITY + 1) // Was 0
+
+/* Run-time statistics task definitions. */
+#define configTSK_RUNSTATS_NAME				  ((const signed portCHAR *)"RunStats")
+#define configTSK_RUNSTATS_STACK_SIZE		  256
+#define configTSK_RUNSTATS_PRIORITY			  (tskIDLE_PRIORITY + 1)
+#define configTSK_RUNSTATS_PERIOD			  10000	// 1s at 10kHz tick
+
+/* Event log UART dump task definitions. */
+#define configTSK_EVENTLOG_NAME				  ((const signed portCHAR *)"EventLog")
+#define configTSK_EVENTLOG_STACK_SIZE		  256
+#define configTSK_EVENTLOG_PRIORITY			  (tskIDLE_PRIORITY)
+#define configTSK_EVENTLOG_PERIOD			  1000	// 100ms at 10kHz tick
+
+/* Startup LED walk task definitions. */
+#define configTSK_STARTUP_LEDS_NAME			  ((const signed portCHAR *)"StartupLeds")
+#define configTSK_STARTUP_LEDS_STACK_SIZE	  256
+#define configTSK_STARTUP_LEDS_PRIORITY		  (tskIDLE_PRIORITY)
+#define configTSK_STARTUP_LEDS_PERIOD		  1000	// 100ms at 10kHz tick, to notice a new walk
+
+/* Telemetry endpoint task definitions. */
+#define configTSK_TELEMETRY_NAME			  ((const signed portCHAR *)"Telemetry")
+#define configTSK_TELEMETRY_STACK_SIZE		  256
+#define configTSK_TELEMETRY_PRIORITY		  (tskIDLE_PRIORITY + 1)
+#define configTSK_TELEMETRY_PERIOD			  1000	// 100ms at 10kHz tick, until the host sets another
+
+/* Spectrum stream task definitions. */
+#define configTSK_SPECTRUM_NAME				  ((const signed portCHAR *)"Spectrum")
+#define configTSK_SPECTRUM_STACK_SIZE		  256
+#define configTSK_SPECTRUM_PRIORITY			  (tskIDLE_PRIORITY + 1)
+#define configTSK_SPECTRUM_PERIOD			  1000	// 100ms at 10kHz tick, a frame until the host sets another
+
+/* DG8SAQ command queue task definitions. */
+#define configTSK_DG8SAQ_NAME				  ((const signed portCHAR *)"DG8SAQ")
+#define configTSK_DG8SAQ_STACK_SIZE			  256
+#define configTSK_DG8SAQ_PRIORITY			  (tskIDLE_PRIORITY + 1)
 // Not used... is in a loop with a fixed wait of 10ms at the end
 //#define configTSK_MoboCtrl_PERIOD			  100
 
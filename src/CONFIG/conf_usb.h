@@ -142,6 +142,7 @@
 #define UAC2_EP_AUDIO_OUT_FB	1
 #define UAC2_EP_HID_TX			4
 #define UAC2_EP_HID_RX			5
+#define UAC2_EP_TELEMETRY		6
 
 // HPSDR endpoints
 #define HPSDR_EP_RF_IN			4
@@ -161,13 +162,17 @@
 // Write here the action to associate with each USB event.
 // Be careful not to waste time in order not to disturb the functions.
 #define Usb_sof_action()
-#define Usb_wake_up_action()
-#define Usb_resume_action()
-#define Usb_suspend_action()
+#define Usb_wake_up_action()			usb_power_resume()
+#define Usb_resume_action()				usb_power_resume()
+#define Usb_suspend_action()			usb_power_suspend()
 #define Usb_reset_action()
 #define Usb_vbus_on_action()
 #define Usb_vbus_off_action()
 #define Usb_set_configuration_action()
+
+// usb_power.c, audio hardware gated while the bus is suspended
+extern void usb_power_suspend(void);
+extern void usb_power_resume(void);
 //! @}
 
 #endif  // USB_DEVICE_FEATURE == ENABLED
@@ -58,6 +58,13 @@
 #define CALC_BAND_MUL_ADD	1	// Band dependent Frequency Subtract and Multiply Routines
 								// (for smart VFO) normally not needed with Mobo 4.3.
 
+#define SI570_SMOOTH_TUNE	0	// DG8SAQ frequency sets tuned by si570_tune.c, RFREQ alone within
+								// the smooth tune range, the Mobo code switching the filters,
+								// both held in TX as FRQ_ and FLTR_CGH_DURING_TX say, and
+								// tuning what si570_tune.c cannot. The Mobo frequency record,
+								// LCD and EEPROM, not kept. Needs CALC_FREQ_MUL_ADD, not
+								// CALC_BAND_MUL_ADD
+
 #define BPF_LPF_Module		1	// Band Pass and Low Pass filter switcing
 
 #define SCRAMBLED_FILTERS	1	// Enable a non contiguous order of filters
@@ -61,6 +61,7 @@
 #ifdef FREERTOS_USED
 #include "FreeRTOS.h"
 #include "task.h"
+#include "semphr.h"
 #endif
 #include "usb_drv.h"
 #include "usb_task.h"
@@ -86,6 +87,9 @@ volatile Bool usb_connected;
 #ifdef FREERTOS_USED
 //! Handle to the USB Device task
 xTaskHandle usb_device_tsk = NULL;
+
+//! Given by the USB interrupt when the control endpoint needs the task
+static xSemaphoreHandle usb_device_semphr = NULL;
 #endif
 
 
@@ -119,6 +123,8 @@ void usb_device_task_init(void)
   Enable_global_interrupt();
 
 #ifdef FREERTOS_USED
+  vSemaphoreCreateBinary(usb_device_semphr);
+  xSemaphoreTake(usb_device_semphr, 0);
   xTaskCreate(usb_device_task,
               configTSK_USB_DEV_NAME,
               configTSK_USB_DEV_STACK_SIZE,
@@ -153,11 +159,27 @@ void usb_start_device(void)
 #endif
   
   usb_init_device();  // Configure the USB controller EP0
+  usb_ctrl_reset();
   Usb_attach();
   usb_connected = TRUE;
 }
 
 
+//!
+//! @brief Wakes the USB device task, from the USB interrupt.
+//!
+portBASE_TYPE usb_device_task_wake_from_isr(void)
+{
+  portBASE_TYPE task_woken = pdFALSE;
+
+#ifdef FREERTOS_USED
+  if (usb_device_semphr != NULL)
+    xSemaphoreGiveFromISR(usb_device_semphr, &task_woken);
+#endif
+  return task_woken;
+}
+
+
 //!
 //! @brief Entry point of the USB device mamagement
 //!
@@ -165,6 +187,9 @@ void usb_start_device(void)
 //! event is checked here in order to launch the appropriate action.
 //! If a Setup request occurs on the Default Control Endpoint,
 //! the usb_process_request() function is call in the usb_standard_request.c file
+//! The task sleeps on usb_device_semphr, so a control request is served as
+//! soon as the interrupt latched it, and at the latest every
+//! configTSK_USB_DEV_PERIOD for the VBus and reset events.
 //!
 #ifdef FREERTOS_USED
 void usb_device_task(void *pvParameters)
@@ -173,12 +198,9 @@ void usb_device_task(void)
 #endif
 {
 #ifdef FREERTOS_USED
-  portTickType xLastWakeTime;
-
-  xLastWakeTime = xTaskGetTickCount();
   while (TRUE)
   {
-    vTaskDelayUntil(&xLastWakeTime, configTSK_USB_DEV_PERIOD);
+    xSemaphoreTake(usb_device_semphr, configTSK_USB_DEV_PERIOD);
 
 #endif  // FREERTOS_USED
     if (!usb_connected && Is_usb_vbus_high())
@@ -196,7 +218,7 @@ void usb_device_task(void)
     }
 
     // Connection to the device enumeration process
-    if (Is_usb_setup_received())
+    if (usb_ctrl_get_state() == USB_CTRL_SETUP || usb_ctrl_get_state() == USB_CTRL_OUT_DONE)
     {
       usb_process_request();
     }
@@ -92,6 +92,10 @@ extern void usb_device_task_init(void);
 //!
 extern void usb_start_device(void);
 
+  //! Wakes the USB device task from the USB interrupt to run
+  //! usb_process_request(), returns TRUE if a context switch is due.
+extern portBASE_TYPE usb_device_task_wake_from_isr(void);
+
 //!
 //! @brief Entry point of the USB device mamagement
 //!
@@ -96,22 +96,21 @@
 
 //_____ P R I V A T E   D E C L A R A T I O N S ____________________________
 
-static  void    usb_get_descriptor   (void);
-static  void    usb_set_address      (void);
-static  void    usb_set_configuration(void);
-static  void    usb_clear_feature    (void);
-static  void    usb_set_feature      (void);
-static  void    usb_get_status       (void);
-static  void    usb_get_configuration(void);
-static  Bool    usb_get_interface    (void);
-static  void    usb_set_interface    (void);
+static  Bool    usb_get_descriptor   (const S_usb_setup_data *setup);
+static  Bool    usb_set_address      (const S_usb_setup_data *setup);
+static  Bool    usb_set_configuration(const S_usb_setup_data *setup);
+static  Bool    usb_clear_feature    (const S_usb_setup_data *setup);
+static  Bool    usb_set_feature      (const S_usb_setup_data *setup);
+static  Bool    usb_get_status       (const S_usb_setup_data *setup);
+static  Bool    usb_get_configuration(const S_usb_setup_data *setup);
+static  Bool    usb_get_interface    (const S_usb_setup_data *setup);
+static  Bool    usb_set_interface    (const S_usb_setup_data *setup);
 
 
 //_____ D E C L A R A T I O N S ____________________________________________
 
         const     void                               *pbuffer;
                   U16                                 data_to_transfer;
-static            U8                                  bmRequestType;
         volatile  U8                                  usb_configuration_nb;
 extern  volatile  Bool                                usb_connected;
 
@@ -120,141 +119,521 @@ extern  volatile  Bool                                usb_connected;
 #define NB_INTERFACE 8
 static            U8                                  usb_interface_status[NB_INTERFACE];  // All interface with default setting
 
-//! This function reads the SETUP request sent to the default control endpoint
-//! and calls the appropriate function. When exiting of the usb_read_request
-//! function, the device is ready to manage the next request.
+//! State of the control transfer in progress on EP_CONTROL
+static struct
+{
+  volatile usb_ctrl_state_t state;
+  S_usb_setup_data          setup;
+  const U8                 *in_data;        //!< next byte of the IN data stage
+  U16                       in_remaining;
+  Bool                      in_zlp;         //!< end the IN data stage with a zero length packet
+  U8                        in_patch_type;  //!< if not 0, sent in place of byte 1 (bDescriptorType) of the data
+  U8                       *out_data;       //!< OUT data stage buffer
+  U16                       out_length;
+  U16                       out_received;
+  usb_ctrl_out_handler_t    out_done;
+  void                    (*status_done)(void);  //!< runs in the interrupt when the status IN stage completed
+  U16                       setups;         //!< SETUP packets latched, the ticket of a deferred request
+} usb_ctrl;
+
+static struct
+{
+  U8                       type_mask;
+  U8                       type;
+  usb_ctrl_setup_handler_t handler;
+} usb_ctrl_handlers[USB_CTRL_MAX_HANDLERS];
+static U8 usb_ctrl_nb_handlers;
+
+static U8 usb_ctrl_reply[2];  //!< data of the short standard replies
+
+#if (USB_HIGH_SPEED_SUPPORT==ENABLED)
+static U8 usb_test_mode;      //!< test selector, entered once SET_FEATURE(TEST_MODE) completed
+#endif
+
+
+//! Moves the state machine to state and enables the endpoint interrupts
+//! that state waits for. SETUP packets are only taken by the interrupt in
+//! the states it owns, while the task works on a request they stay pending.
 //!
-//! If the received request is not supported or a non-standard USB request, the function
-//! will call the custom decoding function in usb_specific_request module.
+static void usb_ctrl_set_state(usb_ctrl_state_t state)
+{
+  Usb_disable_setup_received_interrupt();
+  Usb_disable_control_in_ready_interrupt();
+  Usb_disable_control_out_received_interrupt();
+  Usb_disable_nak_out_interrupt(EP_CONTROL);
+
+  usb_ctrl.state = state;
+
+  switch (state)
+  {
+  case USB_CTRL_SETUP:
+  case USB_CTRL_OUT_DONE:
+  case USB_CTRL_TEST_MODE:
+    return;
+
+  case USB_CTRL_DATA_IN:
+    Usb_ack_nak_out(EP_CONTROL);
+    Usb_enable_nak_out_interrupt(EP_CONTROL);
+    Usb_enable_control_in_ready_interrupt();
+    break;
+
+  case USB_CTRL_STATUS_IN:
+    Usb_enable_control_in_ready_interrupt();
+    break;
+
+  case USB_CTRL_DATA_OUT:
+  case USB_CTRL_STATUS_OUT:
+    Usb_enable_control_out_received_interrupt();
+    break;
+
+  case USB_CTRL_IDLE:
+  case USB_CTRL_DEFERRED:
+  default:
+    break;
+  }
+  Usb_enable_setup_received_interrupt();
+}
+
+
+void usb_ctrl_reset(void)
+{
+  usb_ctrl.status_done = NULL;
+  usb_ctrl_set_state(USB_CTRL_IDLE);
+  Usb_enable_endpoint_interrupt(EP_CONTROL);
+}
+
+
+usb_ctrl_state_t usb_ctrl_get_state(void)
+{
+  return usb_ctrl.state;
+}
+
+
+Bool usb_ctrl_register(U8 type_mask, U8 type, usb_ctrl_setup_handler_t handler)
+{
+  if (usb_ctrl_nb_handlers >= USB_CTRL_MAX_HANDLERS)
+    return FALSE;
+  usb_ctrl_handlers[usb_ctrl_nb_handlers].type_mask = type_mask;
+  usb_ctrl_handlers[usb_ctrl_nb_handlers].type      = type;
+  usb_ctrl_handlers[usb_ctrl_nb_handlers].handler   = handler;
+  usb_ctrl_nb_handlers++;
+  return TRUE;
+}
+
+
+//! Starts the IN data stage, the SETUP packet already acknowledged.
 //!
-//! @note List of supported requests:
-//! GET_DESCRIPTOR
-//! GET_CONFIGURATION
-//! SET_ADDRESS
-//! SET_CONFIGURATION
-//! CLEAR_FEATURE
-//! SET_FEATURE
-//! GET_STATUS
+static void usb_ctrl_start_in(const void *data, U16 length, U8 patch_type)
+{
+  U16 wLength = usb_ctrl.setup.wLength;
+
+  usb_ctrl.in_data       = data;
+  usb_ctrl.in_patch_type = patch_type;
+  if (wLength > length)
+  {
+    usb_ctrl.in_zlp = !(length % EP_CONTROL_LENGTH);  //!< zero length packet condition
+  }
+  else
+  {
+    // No need to test ZLP sending since we send the exact number of bytes as
+    // expected by the host.
+    usb_ctrl.in_zlp = FALSE;
+    length = wLength;                                  //!< send only requested number of data bytes
+  }
+  usb_ctrl.in_remaining = length;
+  usb_ctrl_set_state(USB_CTRL_DATA_IN);
+}
+
+
+static void usb_ctrl_send_patched(const void *data, U16 length, U8 patch_type)
+{
+  Usb_ack_setup_received_free();
+  usb_ctrl_start_in(data, length, patch_type);
+}
+
+
+void usb_ctrl_send(const void *data, U16 length)
+{
+  usb_ctrl_send_patched(data, length, 0);
+}
+
+
+void usb_ctrl_receive(U8 *buffer, U16 length, usb_ctrl_out_handler_t done)
+{
+  usb_ctrl.out_data     = buffer;
+  usb_ctrl.out_length   = min(length, usb_ctrl.setup.wLength);
+  usb_ctrl.out_received = 0;
+  usb_ctrl.out_done     = done;
+
+  Usb_ack_setup_received_free();
+  if (usb_ctrl.out_length == 0)
+    usb_ctrl_set_state(USB_CTRL_OUT_DONE);
+  else
+    usb_ctrl_set_state(USB_CTRL_DATA_OUT);
+}
+
+
+//! Sends the zero length IN packet of the status stage, done runs in the
+//! interrupt once the host took it.
 //!
-void usb_process_request(void)
+static void usb_ctrl_status(void (*done)(void))
 {
-  U8 bRequest;
+  usb_ctrl.status_done = done;
+  Usb_ack_setup_received_free();
+  Usb_ack_control_in_ready_send();
+  usb_ctrl_set_state(USB_CTRL_STATUS_IN);
+}
+
+
+void usb_ctrl_ack(void)
+{
+  usb_ctrl_status(NULL);
+}
 
+
+void usb_ctrl_stall(void)
+{
+  //!< keep that order (set StallRq/clear RxSetup) or a
+  //!< OUT request following the SETUP may be acknowledged
+  Usb_enable_stall_handshake(EP_CONTROL);
+  Usb_ack_setup_received_free();
+  usb_ctrl_set_state(USB_CTRL_IDLE);
+}
+
+
+U16 usb_ctrl_defer(void)
+{
+  U16 ticket = usb_ctrl.setups;  //!< before a new SETUP can be taken
+
+  if (usb_ctrl.state == USB_CTRL_SETUP)
+    Usb_ack_setup_received_free();
+  usb_ctrl_set_state(USB_CTRL_DEFERRED);
+  return ticket;
+}
+
+
+//! TRUE while the request of ticket is deferred, no SETUP packet came
+//! since, not even one the interrupt has not taken yet.
+//!
+static Bool usb_ctrl_deferred(U16 ticket)
+{
+  return usb_ctrl.state == USB_CTRL_DEFERRED && usb_ctrl.setups == ticket && !Is_usb_setup_received();
+}
+
+
+Bool usb_ctrl_deferred_send(U16 ticket, const void *data, U16 length)
+{
+  Bool ok;
+
+  AVR32_ENTER_CRITICAL_REGION();
+  ok = usb_ctrl_deferred(ticket);
+  if (ok)
+    usb_ctrl_start_in(data, length, 0);
+  AVR32_LEAVE_CRITICAL_REGION();
+  return ok;
+}
+
+
+Bool usb_ctrl_deferred_ack(U16 ticket)
+{
+  Bool ok;
+
+  AVR32_ENTER_CRITICAL_REGION();
+  ok = usb_ctrl_deferred(ticket);
+  if (ok)
+  {
+    usb_ctrl.status_done = NULL;
+    Usb_ack_control_in_ready_send();
+    usb_ctrl_set_state(USB_CTRL_STATUS_IN);
+  }
+  AVR32_LEAVE_CRITICAL_REGION();
+  return ok;
+}
+
+
+Bool usb_ctrl_deferred_stall(U16 ticket)
+{
+  Bool ok;
+
+  AVR32_ENTER_CRITICAL_REGION();
+  ok = usb_ctrl_deferred(ticket);
+  if (ok)
+  {
+    Usb_enable_stall_handshake(EP_CONTROL);
+    usb_ctrl_set_state(USB_CTRL_IDLE);
+  }
+  AVR32_LEAVE_CRITICAL_REGION();
+  return ok;
+}
+
+
+//! Fills the next packet of the IN data stage, an empty one after the data
+//! when a ZLP is due.
+//!
+static void usb_ctrl_write_packet(void)
+{
   Usb_reset_endpoint_fifo_access(EP_CONTROL);
-  bmRequestType = Usb_read_endpoint_data(EP_CONTROL, 8);
-  bRequest      = Usb_read_endpoint_data(EP_CONTROL, 8);
 
-  switch (bRequest)
+  if (usb_ctrl.in_remaining == 0)
+  {
+    usb_ctrl.in_zlp = FALSE;
+    return;
+  }
+
+  if (usb_ctrl.in_patch_type && usb_ctrl.in_remaining >= 2)
+  {
+    usb_write_ep_txpacket(EP_CONTROL, usb_ctrl.in_data, 1, NULL);
+    usb_write_ep_txpacket(EP_CONTROL, &usb_ctrl.in_patch_type, 1, NULL);
+    usb_ctrl.in_data      += 2;
+    usb_ctrl.in_remaining -= 2;
+    usb_ctrl.in_patch_type = 0;
+  }
+  usb_ctrl.in_remaining = usb_write_ep_txpacket(EP_CONTROL, usb_ctrl.in_data, usb_ctrl.in_remaining,
+                                                (const void **)&usb_ctrl.in_data);
+}
+
+
+//! Takes one packet of the OUT data stage, returns TRUE once the stage
+//! is complete.
+//!
+static Bool usb_ctrl_read_packet(void)
+{
+  U16 count = Usb_byte_count(EP_CONTROL);
+  U16 room  = usb_ctrl.out_length - usb_ctrl.out_received;
+
+  Usb_reset_endpoint_fifo_access(EP_CONTROL);
+  usb_ctrl.out_received += room - usb_read_ep_rxpacket(EP_CONTROL, usb_ctrl.out_data + usb_ctrl.out_received,
+                                                       room, NULL);
+  Usb_ack_control_out_received_free();
+
+  return usb_ctrl.out_received >= usb_ctrl.out_length || count < EP_CONTROL_LENGTH;
+}
+
+
+//! This function is called from the USB interrupt for the events of the
+//! default control endpoint. A SETUP packet always starts a new transfer,
+//! abandoning any other in progress. Returns TRUE when usb_process_request()
+//! must run.
+//!
+Bool usb_ctrl_interrupt(void)
+{
+  if (Is_usb_setup_received() && Is_usb_setup_received_interrupt_enabled())
+  {
+    Usb_reset_endpoint_fifo_access(EP_CONTROL);
+    usb_ctrl.setup.bmRequestType = Usb_read_endpoint_data(EP_CONTROL, 8);
+    usb_ctrl.setup.bRequest      = Usb_read_endpoint_data(EP_CONTROL, 8);
+    usb_ctrl.setup.wValue        = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
+    usb_ctrl.setup.wIndex        = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
+    usb_ctrl.setup.wLength       = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
+    usb_ctrl.status_done = NULL;
+    usb_ctrl.setups++;
+    usb_ctrl_set_state(USB_CTRL_SETUP);
+    return TRUE;
+  }
+
+  switch (usb_ctrl.state)
+  {
+  case USB_CTRL_DATA_IN:
+    if (Is_usb_nak_out(EP_CONTROL))
+    {
+      // the host moved on to the status stage, it wants no more data
+      Usb_ack_nak_out(EP_CONTROL);
+      usb_ctrl_set_state(USB_CTRL_STATUS_OUT);
+    }
+    else if (Is_usb_control_in_ready())
+    {
+      if (usb_ctrl.in_remaining == 0 && !usb_ctrl.in_zlp)
+      {
+        usb_ctrl_set_state(USB_CTRL_STATUS_OUT);
+        break;
+      }
+      usb_ctrl_write_packet();
+      Usb_ack_control_in_ready_send();
+    }
+    break;
+
+  case USB_CTRL_DATA_OUT:
+    if (Is_usb_control_out_received() && usb_ctrl_read_packet())
+    {
+      usb_ctrl_set_state(USB_CTRL_OUT_DONE);
+      return TRUE;
+    }
+    break;
+
+  case USB_CTRL_STATUS_IN:
+    if (Is_usb_control_in_ready())
+    {
+      usb_ctrl_set_state(USB_CTRL_IDLE);
+      if (usb_ctrl.status_done)
+        usb_ctrl.status_done();
+    }
+    break;
+
+  case USB_CTRL_STATUS_OUT:
+    if (Is_usb_control_out_received())
+    {
+      Usb_ack_control_out_received_free();
+      usb_ctrl_set_state(USB_CTRL_IDLE);
+    }
+    break;
+
+  default:
+    break;
+  }
+  return FALSE;
+}
+
+
+//! Answers a standard request, returns FALSE if it is not one of those
+//! decoded here.
+//!
+static Bool usb_standard_request(const S_usb_setup_data *setup, Bool *ok)
+{
+  U8 bmRequestType = setup->bmRequestType;
+
+  if ((bmRequestType & DRT_MASK) != DRT_STD)
+    return FALSE;
+
+  switch (setup->bRequest)
   {
   case GET_DESCRIPTOR:
-    if (bmRequestType == IN_DEVICE) usb_get_descriptor();
-    else goto unsupported_request;
+    if (bmRequestType != IN_DEVICE) return FALSE;
+    *ok = usb_get_descriptor(setup);
     break;
 
   case GET_CONFIGURATION:
-    if (bmRequestType == IN_DEVICE) usb_get_configuration();
-    else goto unsupported_request;
+    if (bmRequestType != IN_DEVICE) return FALSE;
+    *ok = usb_get_configuration(setup);
     break;
 
   case SET_ADDRESS:
-    if (bmRequestType == OUT_DEVICE) usb_set_address();
-    else goto unsupported_request;
+    if (bmRequestType != OUT_DEVICE) return FALSE;
+    *ok = usb_set_address(setup);
     break;
 
   case SET_CONFIGURATION:
-    if (bmRequestType == OUT_DEVICE) usb_set_configuration();
-    else goto unsupported_request;
+    if (bmRequestType != OUT_DEVICE) return FALSE;
+    *ok = usb_set_configuration(setup);
     break;
 
   case CLEAR_FEATURE:
-    if (bmRequestType <= 0x02) usb_clear_feature();
-    else goto unsupported_request;
+    if (bmRequestType > 0x02) return FALSE;
+    *ok = usb_clear_feature(setup);
     break;
 
   case SET_FEATURE:
-    if (bmRequestType <= 0x02) usb_set_feature();
-    else goto unsupported_request;
+    if (bmRequestType > 0x02) return FALSE;
+    *ok = usb_set_feature(setup);
     break;
 
   case GET_STATUS:
-    if (0x7F < bmRequestType && bmRequestType <= 0x82) usb_get_status();
-    else goto unsupported_request;
+    if (bmRequestType <= 0x7F || bmRequestType > 0x82) return FALSE;
+    *ok = usb_get_status(setup);
     break;
 
   case GET_INTERFACE:
-    if (bmRequestType == IN_INTERFACE)
-    {
-		if(!usb_get_interface())
-		{
-			Usb_enable_stall_handshake(EP_CONTROL);
-			Usb_ack_setup_received_free();
-		}
-    }
-    else goto unsupported_request;
+    if (bmRequestType != IN_INTERFACE) return FALSE;
+    *ok = usb_get_interface(setup);
     break;
 
   case SET_INTERFACE:
-    if (bmRequestType == OUT_INTERFACE) usb_set_interface();
-    else goto unsupported_request;
+    if (bmRequestType != OUT_INTERFACE) return FALSE;
+    *ok = usb_set_interface(setup);
     break;
 
   case SET_DESCRIPTOR:
   case SYNCH_FRAME:
-  default:  //!< unsupported request => call to user read request
-unsupported_request:
-    if (!usb_user_read_request(bmRequestType, bRequest))
+  default:
+    return FALSE;
+  }
+  return TRUE;
+}
+
+
+//! This function runs the task side of the control transfer state machine.
+//! A latched SETUP request goes to the standard request decoding, then to
+//! the registered handlers, and is stalled if none takes it. A completed
+//! OUT data stage goes to the handler that asked for it.
+//!
+void usb_process_request(void)
+{
+  const S_usb_setup_data *setup = &usb_ctrl.setup;
+  Bool ok = TRUE;
+  U8 i;
+
+  if (usb_ctrl.state == USB_CTRL_SETUP)
+  {
+    if (usb_standard_request(setup, &ok))
+    {
+      if (!ok)
+        usb_ctrl_stall();
+      return;
+    }
+    for (i = 0; i < usb_ctrl_nb_handlers; i++)
+    {
+      if ((setup->bmRequestType & usb_ctrl_handlers[i].type_mask) == usb_ctrl_handlers[i].type &&
+          usb_ctrl_handlers[i].handler(setup))
+        break;
+    }
+    if (usb_ctrl.state == USB_CTRL_SETUP)
+      usb_ctrl_stall();  //!< not taken, or taken but not answered
+  }
+
+  // an OUT request with wLength 0 is complete right away
+  if (usb_ctrl.state == USB_CTRL_OUT_DONE)
+  {
+    if (usb_ctrl.out_done(setup, usb_ctrl.out_data, usb_ctrl.out_received))
+    {
+      if (usb_ctrl.state == USB_CTRL_DEFERRED)
+        return;  //!< the status stage sent by usb_ctrl_deferred_ack/stall()
+      usb_ctrl.status_done = NULL;
+      Usb_ack_control_in_ready_send();
+      usb_ctrl_set_state(USB_CTRL_STATUS_IN);
+    }
+    else
     {
       Usb_enable_stall_handshake(EP_CONTROL);
-      Usb_ack_setup_received_free();
+      usb_ctrl_set_state(USB_CTRL_IDLE);
     }
-    break;
-	} // end switch
+  }
 }
 
 
 //! This function manages the SET ADDRESS request. When complete, the device
 //! will filter the requests using the new address.
 //!
-void usb_set_address(void)
+static void usb_set_address_done(void)
 {
-  U8 addr = Usb_read_endpoint_data(EP_CONTROL, 8);
-  Usb_configure_address(addr);
-
-  Usb_ack_setup_received_free();
-
-  Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-  while (!Is_usb_control_in_ready()); //!< waits for status phase done
-                                      //!< before using the new address
   Usb_enable_address();
 }
 
+static Bool usb_set_address(const S_usb_setup_data *setup)
+{
+  Usb_configure_address(LSB(setup->wValue));
+  usb_ctrl_status(usb_set_address_done);  //!< use the new address after the STATUS phase
+  return TRUE;
+}
+
 
 //! This function manages the SET CONFIGURATION request. If the selected
 //! configuration is valid, this function call the usb_user_endpoint_init()
 //! function that will configure the endpoints following the configuration
 //! number.
 //!
-void usb_set_configuration(void)
+static Bool usb_set_configuration(const S_usb_setup_data *setup)
 {
-  U8 configuration_number = Usb_read_endpoint_data(EP_CONTROL, 8);
+  U8 configuration_number = LSB(setup->wValue);
 
-  if (configuration_number <= NB_CONFIGURATION)
-  {
-    Usb_ack_setup_received_free();
-    usb_configuration_nb = configuration_number;
+  if (configuration_number > NB_CONFIGURATION)
+    return FALSE;
 
-    usb_user_endpoint_init(usb_configuration_nb); //!< endpoint configuration
-    Usb_set_configuration_action();
- 
-    Usb_ack_control_in_ready_send();              //!< send a ZLP for STATUS phase
-  }
-  else
-  {
-    //!< keep that order (set StallRq/clear RxSetup) or a
-    //!< OUT request following the SETUP may be acknowledged
-    Usb_enable_stall_handshake(EP_CONTROL);
-    Usb_ack_setup_received_free();
-  }
+  usb_configuration_nb = configuration_number;
+
+  usb_user_endpoint_init(usb_configuration_nb); //!< endpoint configuration
+  Usb_set_configuration_action();
+
+  usb_ctrl_ack();                               //!< send a ZLP for STATUS phase
+  return TRUE;
 }
 
 //! This function manages the GET DESCRIPTOR request. The device descriptor,
@@ -263,22 +642,11 @@ void usb_set_configuration(void)
 //! function.
 //! Only 1 configuration is supported.
 //!
-void usb_get_descriptor(void)
+static Bool usb_get_descriptor(const S_usb_setup_data *setup)
 {
-  Bool    zlp;
-  U16     wLength;
-  U8      descriptor_type;
-  U8      string_type;
-  Union32 temp;
-  //U16	  wInterface;
-
-#if (USB_HIGH_SPEED_SUPPORT==ENABLED)
-  Bool    b_first_data = TRUE;
-#endif
-  
-  zlp             = FALSE;                                  /* no zero length packet */
-  string_type     = Usb_read_endpoint_data(EP_CONTROL, 8);  /* read LSB of wValue    */
-  descriptor_type = Usb_read_endpoint_data(EP_CONTROL, 8);  /* read MSB of wValue    */
+  U8      descriptor_type = MSB(setup->wValue);
+  U8      string_type     = LSB(setup->wValue);
+  U8      patch_type      = 0;
 
   switch (descriptor_type)
   {
@@ -314,6 +682,7 @@ void usb_get_descriptor(void)
 		  data_to_transfer = Usb_get_conf_desc_hs_length();  //!< sizeof(usb_conf_desc_hs);
 		  pbuffer          = Usb_get_conf_desc_hs_pointer();
 	  }
+	  patch_type = OTHER_SPEED_CONFIGURATION_DESCRIPTOR;  //!< the other configuration, sent as such
 	  break;
 
   case DEVICE_QUALIFIER_DESCRIPTOR:
@@ -325,319 +694,198 @@ void usb_get_descriptor(void)
 
   default:
 	  if (!usb_user_get_descriptor(descriptor_type, string_type))
-		  {
-			  Usb_enable_stall_handshake(EP_CONTROL);
-			  Usb_ack_setup_received_free();
-			  return;
-		  }
+		  return FALSE;
 	  break;
   }
 
-
-  temp.u32 = Usb_read_endpoint_data(EP_CONTROL, 32);      //!< read wIndex and wLength with a 32-bit access
-                                                          //!< since this access is aligned with a 32-bit
-                                                          //!< boundary from the beginning of the endpoint
-  wLength = usb_format_usb_to_mcu_data(16, temp.u16[1]);  //!< ignore wIndex, keep and format wLength
-  Usb_ack_setup_received_free();                          //!< clear the setup received flag
-
-  if (wLength > data_to_transfer)
-  {
-    zlp = !(data_to_transfer % EP_CONTROL_LENGTH);  //!< zero length packet condition
-  }
-  else
-  {
-    // No need to test ZLP sending since we send the exact number of bytes as
-    // expected by the host.
-    data_to_transfer = wLength; //!< send only requested number of data bytes
-  }
-
-  Usb_ack_nak_out(EP_CONTROL);
-
-  while (data_to_transfer && !Is_usb_nak_out(EP_CONTROL))
-  {
-    while (!Is_usb_control_in_ready() && !Is_usb_nak_out(EP_CONTROL));
-
-    if (Is_usb_nak_out(EP_CONTROL))
-      break;  // don't clear the flag now, it will be cleared after
-
-    Usb_reset_endpoint_fifo_access(EP_CONTROL);
-    
-#if (USB_HIGH_SPEED_SUPPORT==ENABLED) // To support other descriptors like OTHER_SPEED_CONFIGURATION_DESCRIPTOR
-    if( b_first_data ) {
-      b_first_data = FALSE;
-      if( 0!= data_to_transfer ) {
-        usb_write_ep_txpacket(EP_CONTROL, pbuffer, 1, &pbuffer);
-        data_to_transfer--;
-      }
-      if( 0!= data_to_transfer ) {
-        usb_write_ep_txpacket(EP_CONTROL, &descriptor_type, 1, NULL);
-        pbuffer = ((const U8*)pbuffer)+1;
-        data_to_transfer--;
-      }
-    }
-#endif
-    if( 0!= data_to_transfer ) {
-       data_to_transfer = usb_write_ep_txpacket(EP_CONTROL, pbuffer,
-                                                data_to_transfer, &pbuffer);
-    }
-    if (Is_usb_nak_out(EP_CONTROL))
-      break;
-    
-    Usb_ack_control_in_ready_send();  //!< Send data until necessary
-  }
-
-  if (zlp && !Is_usb_nak_out(EP_CONTROL))
-  {
-    while (!Is_usb_control_in_ready());
-    Usb_ack_control_in_ready_send();
-  }
-
-  while (!Is_usb_nak_out(EP_CONTROL));
-  Usb_ack_nak_out(EP_CONTROL);
-  while (!Is_usb_control_out_received());
-  Usb_ack_control_out_received_free();
+  usb_ctrl_send_patched(pbuffer, data_to_transfer, patch_type);
+  return TRUE;
 }
 
 //! This function manages the GET CONFIGURATION request. The current
 //! configuration number is returned.
 //!
-void usb_get_configuration(void)
+static Bool usb_get_configuration(const S_usb_setup_data *setup)
 {
-  Usb_ack_setup_received_free();
-
-  Usb_reset_endpoint_fifo_access(EP_CONTROL);
-  Usb_write_endpoint_data(EP_CONTROL, 8, usb_configuration_nb);
-  Usb_ack_control_in_ready_send();
-
-  while (!Is_usb_control_out_received());
-  Usb_ack_control_out_received_free();
+  usb_ctrl_reply[0] = usb_configuration_nb;
+  usb_ctrl_send(usb_ctrl_reply, 1);
+  return TRUE;
 }
 
 
 //! This function manages the GET STATUS request. The device, interface or
 //! endpoint status is returned.
 //!
-void usb_get_status(void)
+static Bool usb_get_status(const S_usb_setup_data *setup)
 {
   U8 wIndex;
 
-  switch (bmRequestType)
+  switch (setup->bmRequestType)
   {
   case REQUEST_DEVICE_STATUS:
-    Usb_ack_setup_received_free();
-    Usb_reset_endpoint_fifo_access(EP_CONTROL);
-    Usb_write_endpoint_data(EP_CONTROL, 8, DEVICE_STATUS);
+    usb_ctrl_reply[0] = DEVICE_STATUS;
     break;
 
   case REQUEST_INTERFACE_STATUS:
-    Usb_ack_setup_received_free();
-    Usb_reset_endpoint_fifo_access(EP_CONTROL);
-    Usb_write_endpoint_data(EP_CONTROL, 8, INTERFACE_STATUS);
+    usb_ctrl_reply[0] = INTERFACE_STATUS;
     break;
 
   case REQUEST_ENDPOINT_STATUS:
-    Usb_read_endpoint_data(EP_CONTROL, 16); //!< dummy read (wValue)
-    wIndex = Usb_read_endpoint_data(EP_CONTROL, 8);
-    wIndex = Get_desc_ep_nbr(wIndex);
-    Usb_ack_setup_received_free();
-    Usb_reset_endpoint_fifo_access(EP_CONTROL);
-    Usb_write_endpoint_data(EP_CONTROL, 8, Is_usb_endpoint_stall_requested(wIndex) );
+    wIndex = Get_desc_ep_nbr(LSB(setup->wIndex));
+    usb_ctrl_reply[0] = Is_usb_endpoint_stall_requested(wIndex);
     break;
 
   default:
-    Usb_enable_stall_handshake(EP_CONTROL);
-    Usb_ack_setup_received_free();
-    return;
+    return FALSE;
   }
 
-  Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-  Usb_ack_control_in_ready_send();
+  usb_ctrl_reply[1] = 0x00;
+  usb_ctrl_send(usb_ctrl_reply, 2);
+  return TRUE;
+}
 
-  while (!Is_usb_control_out_received());
-  Usb_ack_control_out_received_free();
+
+#if (USB_HIGH_SPEED_SUPPORT==ENABLED)
+//! Enters the test mode selected by SET_FEATURE(TEST_MODE), from the
+//! interrupt once the STATUS phase completed.
+//!
+static void usb_test_mode_done(void)
+{
+  Wr_bitfield(AVR32_USBB_udcon, AVR32_USBB_UDCON_SPDCONF_MASK, 2);
+
+  switch (usb_test_mode)
+  {
+  case TEST_J:
+    Set_bits(AVR32_USBB_udcon, AVR32_USBB_UDCON_TSTJ_MASK);
+    break;
+
+  case TEST_K:
+    Set_bits(AVR32_USBB_udcon, AVR32_USBB_UDCON_TSTK_MASK);
+    break;
+
+  case TEST_PACKET:
+    {
+      static const U8 test_packet[] =
+      {
+        // 00000000 * 9
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        // 01010101 * 8
+        0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+        // 01110111 * 8
+        0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE,
+        // 0, {111111S * 15}, 111111
+        0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        // S, 111111S, {0111111S * 7}
+        0x7F, 0xBF, 0xDF, 0xEF, 0xF7, 0xFB, 0xFD,
+        // 00111111, {S0111111 * 9}, S0
+        0xFC, 0x7E, 0xBF, 0xDF, 0xEF, 0xF7, 0xFB, 0xFD, 0x7E
+      };
+
+      usb_ctrl_set_state(USB_CTRL_TEST_MODE);  //!< the control endpoint is gone until reset
+      Usb_disable_endpoint(EP_CONTROL);
+      Usb_unallocate_memory(EP_CONTROL);
+      (void)Usb_configure_endpoint(EP_CONTROL, TYPE_BULK, DIRECTION_IN, 64, SINGLE_BANK, 0);
+      Usb_reset_endpoint(EP_CONTROL);
+      Set_bits(AVR32_USBB_udcon, AVR32_USBB_UDCON_TSTPCKT_MASK);
+      usb_write_ep_txpacket(EP_CONTROL, &test_packet, sizeof(test_packet), NULL);
+      Usb_send_in(EP_CONTROL);
+    }
+    break;
+
+  case TEST_SE0_NAK:
+  default:
+    break;
+  }
 }
+#endif
 
 
 //! This function manages the SET FEATURE request. The USB test modes are
 //! supported by this function.
 //!
-void usb_set_feature(void)
+static Bool usb_set_feature(const S_usb_setup_data *setup)
 {
-  U16 wValue  = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-  U16 wIndex  = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-  U16 wLength = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
+  U16 wIndex = setup->wIndex;
 
-  if (wLength)
-    goto unsupported_request;
+  if (setup->wLength)
+    return FALSE;
 
-  switch (wValue)
+  switch (setup->wValue)
   {
   case FEATURE_ENDPOINT_HALT:
     wIndex = Get_desc_ep_nbr(wIndex);  // clear direction flag
-    if (bmRequestType != ENDPOINT_TYPE ||
+    if (setup->bmRequestType != ENDPOINT_TYPE ||
         wIndex == EP_CONTROL ||
         !Is_usb_endpoint_enabled(wIndex))
-      goto unsupported_request;
+      return FALSE;
 
     Usb_enable_stall_handshake(wIndex);
-    Usb_ack_setup_received_free();
-    Usb_ack_control_in_ready_send();
-    break;
+    usb_ctrl_ack();
+    return TRUE;
 
 #if (USB_HIGH_SPEED_SUPPORT==ENABLED)
   case FEATURE_TEST_MODE:
-    if (bmRequestType != DEVICE_TYPE ||
+    if (setup->bmRequestType != DEVICE_TYPE ||
         wIndex & 0x00FF)
-      goto unsupported_request;
+      return FALSE;
 
     switch (wIndex >> 8)
     {
     case TEST_J:
-      Usb_ack_setup_received_free();
-      Usb_ack_control_in_ready_send();
-      while (!Is_usb_control_in_ready());
-      Wr_bitfield(AVR32_USBB_udcon, AVR32_USBB_UDCON_SPDCONF_MASK, 2);
-      Set_bits(AVR32_USBB_udcon, AVR32_USBB_UDCON_TSTJ_MASK);
-      break;
-
     case TEST_K:
-      Usb_ack_setup_received_free();
-      Usb_ack_control_in_ready_send();
-      while (!Is_usb_control_in_ready());
-      Wr_bitfield(AVR32_USBB_udcon, AVR32_USBB_UDCON_SPDCONF_MASK, 2);
-      Set_bits(AVR32_USBB_udcon, AVR32_USBB_UDCON_TSTK_MASK);
-      break;
-
     case TEST_SE0_NAK:
-      Usb_ack_setup_received_free();
-      Usb_ack_control_in_ready_send();
-      while (!Is_usb_control_in_ready());
-      Wr_bitfield(AVR32_USBB_udcon, AVR32_USBB_UDCON_SPDCONF_MASK, 2);
-      break;
-
     case TEST_PACKET:
-      {
-        static const U8 test_packet[] =
-        {
-          // 00000000 * 9
-          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-          // 01010101 * 8
-          0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
-          // 01110111 * 8
-          0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE,
-          // 0, {111111S * 15}, 111111
-          0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-          // S, 111111S, {0111111S * 7}
-          0x7F, 0xBF, 0xDF, 0xEF, 0xF7, 0xFB, 0xFD,
-          // 00111111, {S0111111 * 9}, S0
-          0xFC, 0x7E, 0xBF, 0xDF, 0xEF, 0xF7, 0xFB, 0xFD, 0x7E
-        };
-
-        Usb_ack_setup_received_free();
-        Usb_ack_control_in_ready_send();
-        while (!Is_usb_control_in_ready());
-        Wr_bitfield(AVR32_USBB_udcon, AVR32_USBB_UDCON_SPDCONF_MASK, 2);
-        Usb_disable_endpoint(EP_CONTROL);
-        Usb_unallocate_memory(EP_CONTROL);
-        (void)Usb_configure_endpoint(EP_CONTROL, TYPE_BULK, DIRECTION_IN, 64, SINGLE_BANK, 0);
-        Usb_reset_endpoint(EP_CONTROL);
-        Set_bits(AVR32_USBB_udcon, AVR32_USBB_UDCON_TSTPCKT_MASK);
-        usb_write_ep_txpacket(EP_CONTROL, &test_packet, sizeof(test_packet), NULL);
-        Usb_send_in(EP_CONTROL);
-      }
-      break;
+      usb_test_mode = wIndex >> 8;
+      usb_ctrl_status(usb_test_mode_done);
+      return TRUE;
 
     case TEST_FORCE_ENABLE: // Only for downstream facing hub ports
     default:
-      goto unsupported_request;
+      return FALSE;
     }
-    break;
 #endif
 
   case FEATURE_DEVICE_REMOTE_WAKEUP:
   default:
-    goto unsupported_request;
+    return FALSE;
   }
-
-  return;
-
-unsupported_request:
-  Usb_enable_stall_handshake(EP_CONTROL);
-  Usb_ack_setup_received_free();
 }
 
 
 //! This function manages the CLEAR FEATURE request.
 //!
-void usb_clear_feature(void)
+static Bool usb_clear_feature(const S_usb_setup_data *setup)
 {
-  U8 wValue;
   U8 wIndex;
 
-  if (bmRequestType == DEVICE_TYPE || bmRequestType == INTERFACE_TYPE)
-  {
-    //!< keep that order (set StallRq/clear RxSetup) or a
-    //!< OUT request following the SETUP may be acknowledged
-    Usb_enable_stall_handshake(EP_CONTROL);
-    Usb_ack_setup_received_free();
-  }
-  else if (bmRequestType == ENDPOINT_TYPE)
-  {
-    wValue = Usb_read_endpoint_data(EP_CONTROL, 8);
+  if (setup->bmRequestType != ENDPOINT_TYPE || LSB(setup->wValue) != FEATURE_ENDPOINT_HALT)
+    return FALSE;
 
-    if (wValue == FEATURE_ENDPOINT_HALT)
-    {
-      Usb_read_endpoint_data(EP_CONTROL, 8);  //!< dummy read (MSB of wValue)
-      wIndex = Usb_read_endpoint_data(EP_CONTROL, 8);
-      wIndex = Get_desc_ep_nbr(wIndex);
+  wIndex = Get_desc_ep_nbr(LSB(setup->wIndex));
+  if (!Is_usb_endpoint_enabled(wIndex))
+    return FALSE;
 
-      if (Is_usb_endpoint_enabled(wIndex))
-      {
-        if (wIndex != EP_CONTROL)
-        {
-          Usb_disable_stall_handshake(wIndex);
-          Usb_reset_endpoint(wIndex);
-          Usb_reset_data_toggle(wIndex);
-        }
-        Usb_ack_setup_received_free();
-        Usb_ack_control_in_ready_send();
-      }
-      else
-      {
-        Usb_enable_stall_handshake(EP_CONTROL);
-        Usb_ack_setup_received_free();
-      }
-    }
-    else
-    {
-      Usb_enable_stall_handshake(EP_CONTROL);
-      Usb_ack_setup_received_free();
-    }
+  if (wIndex != EP_CONTROL)
+  {
+    Usb_disable_stall_handshake(wIndex);
+    Usb_reset_endpoint(wIndex);
+    Usb_reset_data_toggle(wIndex);
   }
+  usb_ctrl_ack();
+  return TRUE;
 }
 
 //! This function manages the GET INTERFACE request.
 //!
-Bool usb_get_interface(void)
+static Bool usb_get_interface(const S_usb_setup_data *setup)
 {
-   U16   wInterface;
-   U16   wValue;
- 
-   // Read wValue
-   wValue = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-   // wValue = Alternate Setting
+   // wValue = 0
    // wIndex = Interface
-   wInterface=usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-   if(0!=wValue)
+   if (0 != setup->wValue || setup->wIndex >= NB_INTERFACE)
       return FALSE;
-   Usb_ack_setup_received_free();
-
-   Usb_reset_endpoint_fifo_access(EP_CONTROL);
-   Usb_write_endpoint_data(EP_CONTROL, 8, usb_interface_status[wInterface] );
-   Usb_ack_control_in_ready_send();
 
-   while( !Is_usb_control_out_received() );
-   Usb_ack_control_out_received_free();
+   usb_ctrl_reply[0] = usb_interface_status[setup->wIndex];
+   usb_ctrl_send(usb_ctrl_reply, 1);
    return TRUE;
 }
 
@@ -645,15 +893,14 @@ Bool usb_get_interface(void)
 
 //! This function manages the SET INTERFACE request.
 //!
-void usb_set_interface(void)
+static Bool usb_set_interface(const S_usb_setup_data *setup)
 {
    U8 u8_i;
 
    // wValue = Alternate Setting
    // wIndex = Interface
-   U16 wValue  = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-   U16 wIndex  = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-   Usb_ack_setup_received_free();
+   U16 wValue  = setup->wValue;
+   U16 wIndex  = setup->wIndex;
 
    // Get descriptor
 #if (USB_HIGH_SPEED_SUPPORT==ENABLED)
@@ -676,9 +923,7 @@ void usb_set_interface(void)
    if( usb_configuration_nb == 0 )
    {
       // No configuration selected then no interface enable
-      Usb_enable_stall_handshake(EP_CONTROL);
-      Usb_ack_setup_received_free();
-      return;
+      return FALSE;
    }
    u8_i = usb_configuration_nb;
    while( u8_i != 0 )
@@ -701,18 +946,14 @@ void usb_set_interface(void)
    if( wIndex >= ((S_usb_configuration_descriptor*)pbuffer)->bNumInterfaces )
    {
       // Interface number unknown
-      Usb_enable_stall_handshake(EP_CONTROL);
-      Usb_ack_setup_received_free();
-      return;
+      return FALSE;
    }
    while( 1 )
    {
       if( data_to_transfer <= ((S_usb_interface_descriptor*)pbuffer)->bLength )
       {
          // Interface unknown
-         Usb_enable_stall_handshake(EP_CONTROL);
-         Usb_ack_setup_received_free();
-         return;
+         return FALSE;
       }
       data_to_transfer -=  ((S_usb_interface_descriptor*)pbuffer)->bLength;
       pbuffer =  (U8*)pbuffer + ((S_usb_interface_descriptor*)pbuffer)->bLength;
@@ -747,8 +988,8 @@ void usb_set_interface(void)
    }
 
    // send a ZLP for STATUS phase
-   Usb_ack_control_in_ready_send();
-   while (!Is_usb_control_in_ready());
+   usb_ctrl_ack();
+   return TRUE;
 }
 
 
@@ -203,12 +203,101 @@
   //! The device high-level application should test this before performing any applicative request.
 #define Is_device_enumerated()            (usb_configuration_nb != 0)
 
-  //! This function reads the SETUP request sent to the default control endpoint
-  //! and calls the appropriate function. When exiting of the usb_read_request
-  //! function, the device is ready to manage the next request.
+//_____ C O N T R O L   T R A N S F E R S __________________________________
+
+  //! The default control endpoint is run by a state machine. usb_ctrl_interrupt(),
+  //! called from the USB interrupt, latches SETUP packets and moves the data and
+  //! status stages one packet per interrupt; nothing spins on the endpoint flags.
+  //! Decisions are taken in task context: when usb_ctrl_interrupt() returns TRUE,
+  //! usb_process_request() must be run by the USB device task, which dispatches
+  //! the latched SETUP or completes an OUT data stage.
   //!
-  //! If the received request is not supported or a non-standard USB request, the function
-  //! will call the custom decoding function in usb_specific_request module.
+  //! A handler answers a request with exactly one of usb_ctrl_send(),
+  //! usb_ctrl_receive(), usb_ctrl_ack() or usb_ctrl_stall() and returns, the
+  //! host is NAKed until it does. Class and vendor handlers are registered with
+  //! usb_ctrl_register(); requests no handler takes are stalled.
+  //!
+  //! A handler that cannot answer yet, or an OUT completion that cannot take
+  //! its data yet, calls usb_ctrl_defer() and returns, TRUE. The host is NAKed
+  //! until another task answers with usb_ctrl_deferred_send/ack/stall() and the
+  //! ticket usb_ctrl_defer() gave; those fail once a new SETUP packet or a bus
+  //! reset took the endpoint, the host having given up on the request.
+  //!
+typedef enum
+{
+  USB_CTRL_IDLE,            //!< waiting for a SETUP packet
+  USB_CTRL_SETUP,           //!< SETUP latched, waiting for usb_process_request()
+  USB_CTRL_DATA_IN,         //!< sending the IN data stage
+  USB_CTRL_DATA_OUT,        //!< receiving the OUT data stage
+  USB_CTRL_OUT_DONE,        //!< OUT data received, waiting for usb_process_request()
+  USB_CTRL_STATUS_IN,       //!< zero length IN packet of the status stage queued
+  USB_CTRL_STATUS_OUT,      //!< waiting for the zero length OUT packet of the status stage
+  USB_CTRL_DEFERRED,        //!< the request answered later by usb_ctrl_deferred_send/ack/stall()
+  USB_CTRL_TEST_MODE        //!< a USB test mode runs, the control endpoint is gone until reset
+} usb_ctrl_state_t;
+
+  //! The SETUP packet, converted to MCU byte order
+typedef struct
+{
+  U8  bmRequestType;
+  U8  bRequest;
+  U16 wValue;
+  U16 wIndex;
+  U16 wLength;
+} S_usb_setup_data;
+
+  //! Request handler: returns FALSE if the request is not its own, TRUE once it
+  //! has answered it with usb_ctrl_send/receive/ack/stall().
+typedef Bool (*usb_ctrl_setup_handler_t)(const S_usb_setup_data *setup);
+
+  //! Completion of an OUT data stage, runs in task context: returns TRUE to
+  //! acknowledge the status stage, FALSE to stall it.
+typedef Bool (*usb_ctrl_out_handler_t)(const S_usb_setup_data *setup, U8 *data, U16 length);
+
+#define USB_CTRL_MAX_HANDLERS             4
+
+  //! Registers handler for the requests with (bmRequestType & type_mask) == type,
+  //! handlers are asked in registration order. Returns FALSE when the table is full.
+extern Bool usb_ctrl_register(U8 type_mask, U8 type, usb_ctrl_setup_handler_t handler);
+
+  //! IN data stage of length bytes, clipped to wLength. The data is sent from
+  //! the interrupt and must stay valid until the status stage completed.
+extern void usb_ctrl_send(const void *data, U16 length);
+
+  //! OUT data stage of length bytes into buffer, done is called once they
+  //! arrived.
+extern void usb_ctrl_receive(U8 *buffer, U16 length, usb_ctrl_out_handler_t done);
+
+  //! Request without data stage accepted, sends the status stage.
+extern void usb_ctrl_ack(void);
+
+  //! Request refused.
+extern void usb_ctrl_stall(void);
+
+  //! Answer of the request left to another task, returns the ticket for
+  //! usb_ctrl_deferred_send/ack/stall().
+extern U16 usb_ctrl_defer(void);
+
+  //! usb_ctrl_send(), usb_ctrl_ack() and usb_ctrl_stall() of a deferred request,
+  //! from task context. FALSE if the request of ticket is no longer the one
+  //! in progress, nothing is sent then.
+extern Bool usb_ctrl_deferred_send(U16 ticket, const void *data, U16 length);
+extern Bool usb_ctrl_deferred_ack(U16 ticket);
+extern Bool usb_ctrl_deferred_stall(U16 ticket);
+
+  //! Control endpoint interrupt, returns TRUE when usb_process_request() has work.
+extern Bool usb_ctrl_interrupt(void);
+
+  //! Puts the state machine back to idle after a bus reset.
+extern void usb_ctrl_reset(void);
+
+extern usb_ctrl_state_t usb_ctrl_get_state(void);
+
+  //! Task side of the control transfer state machine: dispatches a latched
+  //! SETUP request or completes an OUT data stage.
+  //!
+  //! Standard requests are answered here; other requests go to the handlers
+  //! registered with usb_ctrl_register(), or are stalled.
   //!
   //! @note List of supported requests:
   //! GET_DESCRIPTOR
@@ -218,6 +307,8 @@
   //! CLEAR_FEATURE
   //! SET_FEATURE
   //! GET_STATUS
+  //! GET_INTERFACE
+  //! SET_INTERFACE
   //!
 extern void usb_process_request(void);
 
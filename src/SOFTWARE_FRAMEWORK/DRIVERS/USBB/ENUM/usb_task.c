@@ -77,6 +77,7 @@
 
 #if USB_DEVICE_FEATURE == ENABLED
 #include "usb_descriptors.h"
+#include "usb_standard_request.h"
 #include "usb_device_task.h"
 #endif
 
@@ -544,9 +545,17 @@ static void usb_general_interrupt(void)
     {
       Usb_ack_reset();
       usb_init_device();
+      usb_ctrl_reset();
       Usb_reset_action();
       Usb_send_event(EVT_USB_RESET);
     }
+    // Default control endpoint: the transfer stages run here, the USB device
+    // task is woken to dispatch a SETUP request or a completed OUT stage
+    if (Is_usb_endpoint_interrupt(EP_CONTROL) && Is_usb_endpoint_interrupt_enabled(EP_CONTROL))
+    {
+      if (usb_ctrl_interrupt())
+        task_woken |= usb_device_task_wake_from_isr();
+    }
   }
 #endif  // End DEVICE FEATURE MODE
 
@@ -215,6 +215,13 @@ U32 usb_set_ep_txpacket(U8 ep, U8 txbyte, U32 data_length)
 //!  This function writes the buffer pointed to by txbuf to the selected
 //!  endpoint FIFO, using as few accesses as possible.
 //!
+//!  8-bit accesses bring the FIFO data register to 32-bit alignment. If the
+//!  buffer is then 32-bit aligned too, the bulk goes out in 64-bit accesses,
+//!  else in 32-bit accesses gathered from the buffer byte by byte. At most 3
+//!  trailing bytes take 8-bit accesses, so any buffer alignment takes at most
+//!  6 8-bit accesses to the FIFO. The usb-fifo-check host tool runs this
+//!  against a simulated FIFO.
+//!
 //! @param ep           Number of the addressed endpoint
 //! @param txbuf        Address of buffer to read
 //! @param data_length  Number of bytes to write
@@ -235,91 +242,67 @@ U32 usb_write_ep_txpacket(U8 ep, const void *txbuf, U32 data_length, const void
   // Use aggregated pointers to have several alignments available for a same address
   UnionVPtr   ep_fifo;
   UnionCPtr   txbuf_cur;
-#if (!defined __OPTIMIZE_SIZE__) || !__OPTIMIZE_SIZE__  // Auto-generated when GCC's -Os command option is used
-  StructCPtr  txbuf_end;
-#else
-  UnionCPtr   txbuf_end;
-#endif  // !__OPTIMIZE_SIZE__
+  Union32     txval;
+  U32         count;
 
   // Initialize pointers for copy loops and limit the number of bytes to copy
   ep_fifo.u8ptr = pep_fifo[ep].u8ptr;
   txbuf_cur.u8ptr = txbuf;
-  txbuf_end.u8ptr = txbuf_cur.u8ptr +
-                    min(data_length, Usb_get_endpoint_size(ep) - Usb_byte_count(ep));
-#if (!defined __OPTIMIZE_SIZE__) || !__OPTIMIZE_SIZE__  // Auto-generated when GCC's -Os command option is used
-  txbuf_end.u16ptr = (U16 *)Align_down((U32)txbuf_end.u8ptr, sizeof(U16));
-  txbuf_end.u32ptr = (U32 *)Align_down((U32)txbuf_end.u16ptr, sizeof(U32));
-  txbuf_end.u64ptr = (U64 *)Align_down((U32)txbuf_end.u32ptr, sizeof(U64));
+  count = min(data_length, Usb_get_endpoint_size(ep) - Usb_byte_count(ep));
 
-  // If all addresses are aligned the same way with respect to 16-bit boundaries
-  if (Get_align((U32)txbuf_cur.u8ptr, sizeof(U16)) == Get_align((U32)ep_fifo.u8ptr, sizeof(U16)))
+  // Copy 8-bit data to reach 32-bit alignment of the FIFO data register
+  for (; count && !Test_align((U32)ep_fifo.u8ptr, sizeof(U32)); count--)
   {
-    // If pointer to transmission buffer is not 16-bit aligned
-    if (!Test_align((U32)txbuf_cur.u8ptr, sizeof(U16)))
+    // 8-bit accesses to FIFO data registers do require pointer post-increment
+    Usb_fifo_write(ep_fifo.u8ptr++, 8, *txbuf_cur.u8ptr++);
+  }
+
+  // If the transmission buffer is now 32-bit aligned too
+  if (Test_align((U32)txbuf_cur.u8ptr, sizeof(U32)))
+  {
+    // If pointer to transmission buffer is not 64-bit aligned
+    if (count >= sizeof(U32) && !Test_align((U32)txbuf_cur.u8ptr, sizeof(U64)))
     {
-      // Copy 8-bit data to reach 16-bit alignment
-      if (txbuf_cur.u8ptr < txbuf_end.u8ptr)
-      {
-        // 8-bit accesses to FIFO data registers do require pointer post-increment
-        *ep_fifo.u8ptr++ = *txbuf_cur.u8ptr++;
-      }
+      // Copy 32-bit data to reach 64-bit alignment
+      // 32-bit accesses to FIFO data registers do not require pointer post-increment
+      Usb_fifo_write(ep_fifo.u32ptr, 32, *txbuf_cur.u32ptr++);
+      count -= sizeof(U32);
     }
 
-    // If all addresses are aligned the same way with respect to 32-bit boundaries
-    if (Get_align((U32)txbuf_cur.u16ptr, sizeof(U32)) == Get_align((U32)ep_fifo.u16ptr, sizeof(U32)))
+    // Copy 64-bit-aligned data
+    for (; count >= sizeof(U64); count -= sizeof(U64))
     {
-      // If pointer to transmission buffer is not 32-bit aligned
-      if (!Test_align((U32)txbuf_cur.u16ptr, sizeof(U32)))
-      {
-        // Copy 16-bit data to reach 32-bit alignment
-        if (txbuf_cur.u16ptr < txbuf_end.u16ptr)
-        {
-          // 16-bit accesses to FIFO data registers do require pointer post-increment
-          *ep_fifo.u16ptr++ = *txbuf_cur.u16ptr++;
-        }
-      }
-
-      // If pointer to transmission buffer is not 64-bit aligned
-      if (!Test_align((U32)txbuf_cur.u32ptr, sizeof(U64)))
-      {
-        // Copy 32-bit data to reach 64-bit alignment
-        if (txbuf_cur.u32ptr < txbuf_end.u32ptr)
-        {
-          // 32-bit accesses to FIFO data registers do not require pointer post-increment
-          *ep_fifo.u32ptr = *txbuf_cur.u32ptr++;
-        }
-      }
-
-      // Copy 64-bit-aligned data
-      while (txbuf_cur.u64ptr < txbuf_end.u64ptr)
-      {
-        // 64-bit accesses to FIFO data registers do not require pointer post-increment
-        *ep_fifo.u64ptr = *txbuf_cur.u64ptr++;
-      }
-
-      // Copy 32-bit-aligned data
-      if (txbuf_cur.u32ptr < txbuf_end.u32ptr)
-      {
-        // 32-bit accesses to FIFO data registers do not require pointer post-increment
-        *ep_fifo.u32ptr = *txbuf_cur.u32ptr++;
-      }
+      // 64-bit accesses to FIFO data registers do not require pointer post-increment
+      Usb_fifo_write(ep_fifo.u64ptr, 64, *txbuf_cur.u64ptr++);
     }
 
-    // Copy remaining 16-bit data if some
-    while (txbuf_cur.u16ptr < txbuf_end.u16ptr)
+    // Copy remaining 32-bit data if some
+    if (count >= sizeof(U32))
     {
-      // 16-bit accesses to FIFO data registers do require pointer post-increment
-      *ep_fifo.u16ptr++ = *txbuf_cur.u16ptr++;
+      // 32-bit accesses to FIFO data registers do not require pointer post-increment
+      Usb_fifo_write(ep_fifo.u32ptr, 32, *txbuf_cur.u32ptr++);
+      count -= sizeof(U32);
+    }
+  }
+  else
+  {
+    // Gather 8-bit data from the buffer into 32-bit accesses
+    for (; count >= sizeof(U32); count -= sizeof(U32))
+    {
+      txval.u8[0] = *txbuf_cur.u8ptr++;
+      txval.u8[1] = *txbuf_cur.u8ptr++;
+      txval.u8[2] = *txbuf_cur.u8ptr++;
+      txval.u8[3] = *txbuf_cur.u8ptr++;
+      // 32-bit accesses to FIFO data registers do not require pointer post-increment
+      Usb_fifo_write(ep_fifo.u32ptr, 32, txval.u32);
     }
   }
-
-#endif  // !__OPTIMIZE_SIZE__
 
   // Copy remaining 8-bit data if some
-  while (txbuf_cur.u8ptr < txbuf_end.u8ptr)
+  for (; count; count--)
   {
     // 8-bit accesses to FIFO data registers do require pointer post-increment
-    *ep_fifo.u8ptr++ = *txbuf_cur.u8ptr++;
+    Usb_fifo_write(ep_fifo.u8ptr++, 8, *txbuf_cur.u8ptr++);
   }
 
   // Save current position in FIFO data register
@@ -335,6 +318,9 @@ U32 usb_write_ep_txpacket(U8 ep, const void *txbuf, U32 data_length, const void
 //!  This function reads the selected endpoint FIFO to the buffer pointed to by
 //!  rxbuf, using as few accesses as possible.
 //!
+//!  The accesses are split as in usb_write_ep_txpacket, 32-bit FIFO reads
+//!  are scattered to a buffer that is not 32-bit aligned byte by byte.
+//!
 //! @param ep           Number of the addressed endpoint
 //! @param rxbuf        Address of buffer to write
 //! @param data_length  Number of bytes to read
@@ -355,90 +341,67 @@ U32 usb_read_ep_rxpacket(U8 ep, void *rxbuf, U32 data_length, void **prxbuf)
   // Use aggregated pointers to have several alignments available for a same address
   UnionCVPtr  ep_fifo;
   UnionPtr    rxbuf_cur;
-#if (!defined __OPTIMIZE_SIZE__) || !__OPTIMIZE_SIZE__  // Auto-generated when GCC's -Os command option is used
-  StructCPtr  rxbuf_end;
-#else
-  StructCPtr  rxbuf_end;
-#endif  // !__OPTIMIZE_SIZE__
+  Union32     rxval;
+  U32         count;
 
   // Initialize pointers for copy loops and limit the number of bytes to copy
   ep_fifo.u8ptr = pep_fifo[ep].u8ptr;
   rxbuf_cur.u8ptr = rxbuf;
-  rxbuf_end.u8ptr = rxbuf_cur.u8ptr + min(data_length, Usb_byte_count(ep));
-#if (!defined __OPTIMIZE_SIZE__) || !__OPTIMIZE_SIZE__  // Auto-generated when GCC's -Os command option is used
-  rxbuf_end.u16ptr = (U16 *)Align_down((U32)rxbuf_end.u8ptr, sizeof(U16));
-  rxbuf_end.u32ptr = (U32 *)Align_down((U32)rxbuf_end.u16ptr, sizeof(U32));
-  rxbuf_end.u64ptr = (U64 *)Align_down((U32)rxbuf_end.u32ptr, sizeof(U64));
+  count = min(data_length, Usb_byte_count(ep));
 
-  // If all addresses are aligned the same way with respect to 16-bit boundaries
-  if (Get_align((U32)rxbuf_cur.u8ptr, sizeof(U16)) == Get_align((U32)ep_fifo.u8ptr, sizeof(U16)))
+  // Copy 8-bit data to reach 32-bit alignment of the FIFO data register
+  for (; count && !Test_align((U32)ep_fifo.u8ptr, sizeof(U32)); count--)
   {
-    // If pointer to reception buffer is not 16-bit aligned
-    if (!Test_align((U32)rxbuf_cur.u8ptr, sizeof(U16)))
+    // 8-bit accesses to FIFO data registers do require pointer post-increment
+    *rxbuf_cur.u8ptr++ = Usb_fifo_read(ep_fifo.u8ptr++, 8);
+  }
+
+  // If the reception buffer is now 32-bit aligned too
+  if (Test_align((U32)rxbuf_cur.u8ptr, sizeof(U32)))
+  {
+    // If pointer to reception buffer is not 64-bit aligned
+    if (count >= sizeof(U32) && !Test_align((U32)rxbuf_cur.u8ptr, sizeof(U64)))
     {
-      // Copy 8-bit data to reach 16-bit alignment
-      if (rxbuf_cur.u8ptr < rxbuf_end.u8ptr)
-      {
-        // 8-bit accesses to FIFO data registers do require pointer post-increment
-        *rxbuf_cur.u8ptr++ = *ep_fifo.u8ptr++;
-      }
+      // Copy 32-bit data to reach 64-bit alignment
+      // 32-bit accesses to FIFO data registers do not require pointer post-increment
+      *rxbuf_cur.u32ptr++ = Usb_fifo_read(ep_fifo.u32ptr, 32);
+      count -= sizeof(U32);
     }
 
-    // If all addresses are aligned the same way with respect to 32-bit boundaries
-    if (Get_align((U32)rxbuf_cur.u16ptr, sizeof(U32)) == Get_align((U32)ep_fifo.u16ptr, sizeof(U32)))
+    // Copy 64-bit-aligned data
+    for (; count >= sizeof(U64); count -= sizeof(U64))
     {
-      // If pointer to reception buffer is not 32-bit aligned
-      if (!Test_align((U32)rxbuf_cur.u16ptr, sizeof(U32)))
-      {
-        // Copy 16-bit data to reach 32-bit alignment
-        if (rxbuf_cur.u16ptr < rxbuf_end.u16ptr)
-        {
-          // 16-bit accesses to FIFO data registers do require pointer post-increment
-          *rxbuf_cur.u16ptr++ = *ep_fifo.u16ptr++;
-        }
-      }
-
-      // If pointer to reception buffer is not 64-bit aligned
-      if (!Test_align((U32)rxbuf_cur.u32ptr, sizeof(U64)))
-      {
-        // Copy 32-bit data to reach 64-bit alignment
-        if (rxbuf_cur.u32ptr < rxbuf_end.u32ptr)
-        {
-          // 32-bit accesses to FIFO data registers do not require pointer post-increment
-          *rxbuf_cur.u32ptr++ = *ep_fifo.u32ptr;
-        }
-      }
-
-      // Copy 64-bit-aligned data
-      while (rxbuf_cur.u64ptr < rxbuf_end.u64ptr)
-      {
-        // 64-bit accesses to FIFO data registers do not require pointer post-increment
-        *rxbuf_cur.u64ptr++ = *ep_fifo.u64ptr;
-      }
-
-      // Copy 32-bit-aligned data
-      if (rxbuf_cur.u32ptr < rxbuf_end.u32ptr)
-      {
-        // 32-bit accesses to FIFO data registers do not require pointer post-increment
-        *rxbuf_cur.u32ptr++ = *ep_fifo.u32ptr;
-      }
+      // 64-bit accesses to FIFO data registers do not require pointer post-increment
+      *rxbuf_cur.u64ptr++ = Usb_fifo_read(ep_fifo.u64ptr, 64);
     }
 
-    // Copy remaining 16-bit data if some
-    while (rxbuf_cur.u16ptr < rxbuf_end.u16ptr)
+    // Copy remaining 32-bit data if some
+    if (count >= sizeof(U32))
     {
-      // 16-bit accesses to FIFO data registers do require pointer post-increment
-      *rxbuf_cur.u16ptr++ = *ep_fifo.u16ptr++;
+      // 32-bit accesses to FIFO data registers do not require pointer post-increment
+      *rxbuf_cur.u32ptr++ = Usb_fifo_read(ep_fifo.u32ptr, 32);
+      count -= sizeof(U32);
+    }
+  }
+  else
+  {
+    // Scatter 32-bit accesses to the buffer as 8-bit data
+    for (; count >= sizeof(U32); count -= sizeof(U32))
+    {
+      // 32-bit accesses to FIFO data registers do not require pointer post-increment
+      rxval.u32 = Usb_fifo_read(ep_fifo.u32ptr, 32);
+      *rxbuf_cur.u8ptr++ = rxval.u8[0];
+      *rxbuf_cur.u8ptr++ = rxval.u8[1];
+      *rxbuf_cur.u8ptr++ = rxval.u8[2];
+      *rxbuf_cur.u8ptr++ = rxval.u8[3];
     }
   }
-
-#endif  // !__OPTIMIZE_SIZE__
 
   // Copy remaining 8-bit data if some
-  while (rxbuf_cur.u8ptr < rxbuf_end.u8ptr)
+  for (; count; count--)
   {
     // 8-bit accesses to FIFO data registers do require pointer post-increment
-    *rxbuf_cur.u8ptr++ = *ep_fifo.u8ptr++;
+    *rxbuf_cur.u8ptr++ = Usb_fifo_read(ep_fifo.u8ptr++, 8);
   }
 
   // Save current position in FIFO data register
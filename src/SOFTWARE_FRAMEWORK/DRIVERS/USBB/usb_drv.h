@@ -898,6 +898,19 @@
           (*pep_fifo[(ep)].TPASTE3(u, scale, ptr)\
            TPASTE3(Pep_fifo_access_, scale, _post_inc)() = (data))
 
+  //! Read or write 64-, 32-, 16- or 8-bit data at a given address of a FIFO
+  //! data register, the single accesses of usb_read_ep_rxpacket and
+  //! usb_write_ep_txpacket, which keep track of the address themselves.
+  //! @param ptr    Address within the FIFO data register
+  //! @param scale  Data scale in bits: 64, 32, 16 or 8
+  //! @param data   64-, 32-, 16- or 8-bit data to write
+  //! @warning The same alignment rules as for Usb_read_endpoint_data and
+  //! Usb_write_endpoint_data apply.
+#define Usb_fifo_read(ptr, scale) \
+          (*(volatile TPASTE2(U, scale) *)(ptr))
+#define Usb_fifo_write(ptr, scale, data) \
+          (*(volatile TPASTE2(U, scale) *)(ptr) = (data))
+
   //! Read 64-, 32-, 16- or 8-bit indexed data from FIFO data register of selected endpoint.
   //! @param ep     Endpoint of which to access FIFO data register
   //! @param scale  Data scale in bits: 64, 32, 16 or 8
@@ -359,6 +359,12 @@ void vPortFree( void *pv ) PRIVILEGED_FUNCTION;
 void vPortInitialiseBlocks( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Block size, count, current and peak use of one class of the fixed block
+ * pools, heap_pool.c only.  Returns pdFALSE past the last class.
+ */
+portBASE_TYPE xPortGetPoolClass( unsigned portBASE_TYPE uxClass, size_t *pxBlockSize, unsigned portBASE_TYPE *puxBlockCount, unsigned portBASE_TYPE *puxUsed, unsigned portBASE_TYPE *puxPeak ) PRIVILEGED_FUNCTION;
+
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
  * sets up a tick interrupt and sets timers for the correct tick frequency.
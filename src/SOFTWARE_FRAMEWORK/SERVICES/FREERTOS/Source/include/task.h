@@ -1104,6 +1104,31 @@ unsigned long ulTaskEndTrace( void ) PRIVILEGED_FUNCTION;
  */
 unsigned portBASE_TYPE uxTaskGetStackHighWaterMark( xTaskHandle xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task.h
+ * <pre>unsigned long ulTaskGetRunTimeCounter( xTaskHandle xTask );</pre>
+ *
+ * configGENERATE_RUN_TIME_STATS must be set to 1 in FreeRTOSConfig.h for
+ * this function to be available.
+ *
+ * Returns the total time xTask has spent in the Running state, in units of
+ * the counter returned by portGET_RUN_TIME_COUNTER_VALUE().  Set xTask to
+ * NULL to query the calling task.
+ */
+unsigned long ulTaskGetRunTimeCounter( xTaskHandle xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task.h
+ * <pre>xTaskHandle xTaskGetIdleTaskHandle( void );</pre>
+ *
+ * configGENERATE_RUN_TIME_STATS must be set to 1 in FreeRTOSConfig.h for
+ * this function to be available.
+ *
+ * Returns the handle of the idle task, or NULL before the scheduler has been
+ * started.
+ */
+xTaskHandle xTaskGetIdleTaskHandle( void ) PRIVILEGED_FUNCTION;
+
 /**
  * task.h
  * <pre>void vTaskSetApplicationTaskTag( xTaskHandle xTask, pdTASK_HOOK_CODE pxHookFunction );</pre>
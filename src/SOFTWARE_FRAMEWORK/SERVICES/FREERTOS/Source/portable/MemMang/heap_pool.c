@@ -0,0 +1,208 @@
+/*
+ * Implementation of pvPortMalloc() and vPortFree() on fixed size block
+ * pools, replacing heap_3.c.
+ *
+ * The pools are statically allocated and described by configPOOL_CLASSES in
+ * FreeRTOSConfig.h as a list of POOL_CLASS( block size, block count ) entries,
+ * smallest block size first.  A request is served from the smallest class
+ * whose blocks are large enough and which still has a free block, so both
+ * allocation and free take a bounded number of steps, there is no
+ * fragmentation, and the memory map is fixed at link time.
+ *
+ * vPortFree() ignores pointers outside the pools, so a task created with a
+ * static stack buffer through xTaskGenericCreate() can be deleted normally.
+ *
+ * See heap_2.c and heap_1.c for alternative implementations, and the memory
+ * management pages of http://www.FreeRTOS.org for more information.
+ */
+
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#ifndef configPOOL_CLASSES
+	#error configPOOL_CLASSES must be defined in FreeRTOSConfig.h when heap_pool.c is used
+#endif
+
+/* Blocks are kept word aligned, as task stacks require. */
+#define poolALIGN( xSize )		( ( ( xSize ) + sizeof( unsigned long ) - 1 ) & ~( sizeof( unsigned long ) - 1 ) )
+
+typedef struct xPOOL_BLOCK
+{
+	struct xPOOL_BLOCK *pxNext;
+} xPoolBlock;
+
+typedef struct xPOOL_CLASS
+{
+	size_t xBlockSize;
+	unsigned portBASE_TYPE uxBlockCount;
+} xPoolClass;
+
+typedef struct xPOOL_STATE
+{
+	unsigned char *pucStart;				/* First block of the class. */
+	unsigned char *pucEnd;					/* One past the last block. */
+	xPoolBlock *pxFree;						/* Free list head. */
+	unsigned portBASE_TYPE uxUsed;
+	unsigned portBASE_TYPE uxPeak;
+} xPoolState;
+
+#define POOL_CLASS( xBlockSize, uxBlockCount )	{ poolALIGN( xBlockSize ), ( uxBlockCount ) },
+static const xPoolClass xPoolClasses[] = { configPOOL_CLASSES };
+#undef POOL_CLASS
+
+#define poolNUM_CLASSES		( sizeof( xPoolClasses ) / sizeof( xPoolClasses[ 0 ] ) )
+
+#define POOL_CLASS( xBlockSize, uxBlockCount )	+ ( poolALIGN( xBlockSize ) * ( uxBlockCount ) )
+static unsigned long ulPoolArena[ ( 0 configPOOL_CLASSES ) / sizeof( unsigned long ) ];
+#undef POOL_CLASS
+
+static xPoolState xPoolStates[ poolNUM_CLASSES ];
+static portBASE_TYPE xPoolInitialised = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+static void prvPoolInit( void )
+{
+unsigned char *pucBlock = ( unsigned char * ) ulPoolArena;
+unsigned portBASE_TYPE uxClass, uxBlock;
+xPoolState *pxState;
+
+	for( uxClass = 0; uxClass < poolNUM_CLASSES; uxClass++ )
+	{
+		pxState = &xPoolStates[ uxClass ];
+		pxState->pucStart = pucBlock;
+		pxState->pxFree = NULL;
+
+		/* Thread the blocks so the lowest address is handed out first. */
+		pucBlock += xPoolClasses[ uxClass ].xBlockSize * xPoolClasses[ uxClass ].uxBlockCount;
+		pxState->pucEnd = pucBlock;
+		for( uxBlock = xPoolClasses[ uxClass ].uxBlockCount; uxBlock > 0; uxBlock-- )
+		{
+			xPoolBlock *pxBlock = ( xPoolBlock * ) ( pxState->pucStart + ( uxBlock - 1 ) * xPoolClasses[ uxClass ].xBlockSize );
+			pxBlock->pxNext = pxState->pxFree;
+			pxState->pxFree = pxBlock;
+		}
+	}
+
+	xPoolInitialised = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+void *pvReturn = NULL;
+unsigned portBASE_TYPE uxClass;
+xPoolState *pxState;
+
+	vTaskSuspendAll();
+	{
+		if( xPoolInitialised == pdFALSE )
+		{
+			prvPoolInit();
+		}
+
+		for( uxClass = 0; uxClass < poolNUM_CLASSES; uxClass++ )
+		{
+			pxState = &xPoolStates[ uxClass ];
+			if( ( xPoolClasses[ uxClass ].xBlockSize >= xWantedSize ) && ( pxState->pxFree != NULL ) )
+			{
+				pvReturn = ( void * ) pxState->pxFree;
+				pxState->pxFree = pxState->pxFree->pxNext;
+				pxState->uxUsed++;
+				if( pxState->uxUsed > pxState->uxPeak )
+				{
+					pxState->uxPeak = pxState->uxUsed;
+				}
+				break;
+			}
+		}
+	}
+	xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+	}
+	#endif
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+unsigned char *pucBlock = ( unsigned char * ) pv;
+unsigned portBASE_TYPE uxClass;
+xPoolState *pxState;
+
+	if( pv )
+	{
+		vTaskSuspendAll();
+		{
+			for( uxClass = 0; uxClass < poolNUM_CLASSES; uxClass++ )
+			{
+				pxState = &xPoolStates[ uxClass ];
+				if( ( pucBlock >= pxState->pucStart ) && ( pucBlock < pxState->pucEnd ) )
+				{
+					( ( xPoolBlock * ) pv )->pxNext = pxState->pxFree;
+					pxState->pxFree = ( xPoolBlock * ) pv;
+					pxState->uxUsed--;
+					break;
+				}
+			}
+		}
+		xTaskResumeAll();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* The pools are threaded on first use. */
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+size_t xFree = 0;
+unsigned portBASE_TYPE uxClass;
+
+	vTaskSuspendAll();
+	{
+		for( uxClass = 0; uxClass < poolNUM_CLASSES; uxClass++ )
+		{
+			xFree += xPoolClasses[ uxClass ].xBlockSize * ( xPoolClasses[ uxClass ].uxBlockCount - xPoolStates[ uxClass ].uxUsed );
+		}
+	}
+	xTaskResumeAll();
+
+	return xFree;
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortGetPoolClass( unsigned portBASE_TYPE uxClass, size_t *pxBlockSize, unsigned portBASE_TYPE *puxBlockCount, unsigned portBASE_TYPE *puxUsed, unsigned portBASE_TYPE *puxPeak )
+{
+	if( uxClass >= poolNUM_CLASSES )
+	{
+		return pdFALSE;
+	}
+
+	*pxBlockSize = xPoolClasses[ uxClass ].xBlockSize;
+	*puxBlockCount = xPoolClasses[ uxClass ].uxBlockCount;
+	*puxUsed = xPoolStates[ uxClass ].uxUsed;
+	*puxPeak = xPoolStates[ uxClass ].uxPeak;
+	return pdTRUE;
+}
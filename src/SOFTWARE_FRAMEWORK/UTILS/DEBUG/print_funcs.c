@@ -77,6 +77,11 @@
 #include "gpio.h"
 #include "usart.h"
 #include "print_funcs.h"
+#ifdef DBG_USART_PDCA_PID
+#include "intc.h"
+#include "pdca.h"
+#include "stream_health.h"
+#endif
 //#include "uart_usb_lib.h"
 
 #include "FreeRTOS.h" // BSB 20120810 added
@@ -85,6 +90,140 @@
 //! ASCII representation of hexadecimal digits.
 static const char HEX_DIGITS[16] = "0123456789ABCDEF";
 
+
+#ifdef DBG_USART_PDCA_PID
+
+#define DBG_TX_MASK		(DBG_TX_BUFFER_SIZE-1)
+
+//! Transmit ring for DBG_USART, drained by PDCA channel DBG_USART_PDCA_CHANNEL.
+static U8 dbg_tx_buffer[DBG_TX_BUFFER_SIZE];
+static volatile U16 dbg_tx_head;			// end of the bytes ready to send
+static volatile U16 dbg_tx_reserved;		// next free byte, producers copy up to here
+static volatile U8 dbg_tx_writers;			// producers still copying, dbg_tx_head waits for them
+static volatile U16 dbg_tx_tail;			// first byte not yet sent
+static volatile U16 dbg_tx_busy;			// bytes handed to the PDCA, 0 when idle
+static volatile unsigned long dbg_tx_overflow;	// characters dropped on a full ring
+static Bool dbg_tx_enabled = FALSE;
+
+//! Retire a finished transfer and hand the next contiguous run of the ring
+//! to the PDCA. Called with interrupts masked, from producers and the ISR.
+static void dbg_tx_kick(void)
+{
+	volatile avr32_pdca_channel_t *pdca = &AVR32_PDCA.channel[DBG_USART_PDCA_CHANNEL];
+	U16 head = dbg_tx_head;
+
+	if (dbg_tx_busy != 0) {
+		if (pdca->tcr != 0)
+			return;							// still sending
+		dbg_tx_tail = (dbg_tx_tail + dbg_tx_busy) & DBG_TX_MASK;
+		dbg_tx_busy = 0;
+	}
+	if (head == dbg_tx_tail) {
+		pdca->idr = AVR32_PDCA_TRC_MASK;	// ring empty, go idle
+		return;
+	}
+	dbg_tx_busy = (head > dbg_tx_tail ? head : DBG_TX_BUFFER_SIZE) - dbg_tx_tail;
+	pdca->mar = (U32)&dbg_tx_buffer[dbg_tx_tail];
+	pdca->tcr = dbg_tx_busy;				// also clears TRC
+	pdca->ier = AVR32_PDCA_TRC_MASK;
+}
+
+__attribute__((__interrupt__)) static void dbg_tx_int_handler(void)
+{
+	// producers at a higher interrupt level must not see a half update
+	AVR32_ENTER_CRITICAL_REGION();
+	dbg_tx_kick();
+	AVR32_LEAVE_CRITICAL_REGION();
+}
+
+static void dbg_tx_init(void)
+{
+	static const pdca_channel_options_t DBG_PDCA_OPTIONS = {
+		.addr = NULL,
+		.pid = DBG_USART_PDCA_PID,
+		.size = 0,
+		.r_addr = NULL,
+		.r_size = 0,
+		.transfer_size = PDCA_TRANSFER_SIZE_BYTE
+	};
+
+	dbg_tx_head = dbg_tx_reserved = dbg_tx_tail = dbg_tx_busy = 0;
+	dbg_tx_writers = 0;
+	INTC_register_interrupt( (__int_handler) &dbg_tx_int_handler, AVR32_PDCA_IRQ_0 + DBG_USART_PDCA_CHANNEL, AVR32_INTC_INT0);
+	pdca_init_channel(DBG_USART_PDCA_CHANNEL, &DBG_PDCA_OPTIONS);
+	pdca_enable(DBG_USART_PDCA_CHANNEL);
+	dbg_tx_enabled = TRUE;
+}
+
+//! Queue str for transmission, expanding \n to \r\n like usart_putchar().
+//! Never waits once the scheduler runs; a message that does not fit is dropped.
+//! The space is reserved with interrupts masked and filled with them on, it
+//! goes out once no producer, interrupted by this one or interrupting it, is
+//! still copying.
+static void dbg_tx_write(const char *str)
+{
+	int len, i, n;
+	U16 head = 0;
+	Bool reserved = FALSE, dropped = FALSE;
+
+	if (!dbg_tx_enabled) {
+		usart_write_line(DBG_USART, str);
+		return;
+	}
+	for (len = 0, i = 0; str[i] != '\0'; i++)
+		len += (str[i] == '\n') ? 2 : 1;
+	if (len == 0)
+		return;
+
+	while (!reserved && !dropped) {
+		AVR32_ENTER_CRITICAL_REGION();
+		dbg_tx_kick();						// reclaim a finished transfer
+		n = DBG_TX_BUFFER_SIZE - 1 - ((dbg_tx_reserved - dbg_tx_tail) & DBG_TX_MASK);
+		if (len <= n) {
+			head = dbg_tx_reserved;
+			dbg_tx_reserved = (head + len) & DBG_TX_MASK;
+			dbg_tx_writers++;
+			reserved = TRUE;
+		}
+		else if (len > DBG_TX_BUFFER_SIZE - 1 || xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+			dbg_tx_overflow += len;
+			STREAM_HEALTH_COUNT(sh_dbg_dropped);
+			dropped = TRUE;
+		}
+		AVR32_LEAVE_CRITICAL_REGION();
+	}
+	if (dropped)
+		return;
+
+	for (i = 0; str[i] != '\0'; i++) {
+		if (str[i] == '\n') {
+			dbg_tx_buffer[head] = '\r';
+			head = (head + 1) & DBG_TX_MASK;
+		}
+		dbg_tx_buffer[head] = str[i];
+		head = (head + 1) & DBG_TX_MASK;
+	}
+
+	AVR32_ENTER_CRITICAL_REGION();
+	if (--dbg_tx_writers == 0) {
+		dbg_tx_head = dbg_tx_reserved;		// all reserved so far is filled
+		dbg_tx_kick();
+	}
+	AVR32_LEAVE_CRITICAL_REGION();
+}
+
+#endif // DBG_USART_PDCA_PID
+
+
+unsigned long print_dbg_overflow(void)
+{
+#ifdef DBG_USART_PDCA_PID
+	return dbg_tx_overflow;
+#else
+	return 0;
+#endif
+}
+
 /////////////////////////////////////////////
 // BSB 20110127-20120717 Added read functions
 /////////////////////////////////////////////
@@ -118,7 +257,7 @@ char read_dbg_char(char echo, char rtos_delay, char checksum_mode)
 
 		read_data = usart_getchar(DBG_USART); // returns int
 	  	if (echo == DBG_ECHO)
-	  		usart_putchar(DBG_USART, read_data);
+	  		print_dbg_char_char(read_data);
 		dbg_checksum += read_data;	// Checksum function is addition...
 		dbg_checksum &= 0xFF;		// ... of which we save 8 lsbs. Redundant code line?
 		return read_data;
@@ -158,7 +297,7 @@ char read_dbg_char_hex(char echo, char rtos_delay)
 void print_dbg_char_char(int c)
 {
 	// Redirection to the debug USART.
-	usart_putchar(DBG_USART, c);
+	print_char(DBG_USART, c);
 }
 
 /////////////////////////////////////////////
@@ -197,6 +336,11 @@ void init_dbg_rs232_ex(unsigned long baudrate, long pba_hz)
 
   // Initialize it in RS232 mode.
   usart_init_rs232(DBG_USART, &dbg_usart_options, pba_hz);
+
+#ifdef DBG_USART_PDCA_PID
+  // From here on print_dbg* go through the PDCA driven ring.
+  dbg_tx_init();
+#endif
 }
 
 
@@ -245,6 +389,12 @@ void print_dbg_hex(unsigned long n)
 
 void print(volatile avr32_usart_t *usart, const char *str)
 {
+#ifdef DBG_USART_PDCA_PID
+  if (usart == DBG_USART) {
+    dbg_tx_write(str);
+    return;
+  }
+#endif
   // Invoke the USART driver to transmit the input string with the given USART.
   usart_write_line(usart, str);
 }
@@ -121,6 +121,7 @@
 #  define DBG_USART_TX_FUNCTION   AVR32_USART1_TXD_0_2_FUNCTION
 
 #  define DBG_USART_BAUDRATE      57600
+#  define DBG_USART_PDCA_PID      AVR32_PDCA_PID_USART1_TX
 #elif BOARD == EVK1105
 #  define DBG_USART               (&AVR32_USART0)
 #  define DBG_USART_RX_PIN        AVR32_USART0_RXD_0_0_PIN
@@ -171,6 +172,23 @@
 #endif
 //! @}
 
+/*! \name Non-blocking transmit path for the Debug Module
+ *
+ * When the board defines DBG_USART_PDCA_PID, print_dbg* copy into a RAM
+ * ring which a PDCA channel drains to DBG_USART in the background. Writers
+ * never wait for the UART; a message that does not fit is dropped whole and
+ * counted, see print_dbg_overflow(), and in the stream health counters for
+ * the host, see stream_health.h. All print_dbg* functions may be called
+ * from tasks and from interrupt handlers. Before the scheduler starts the
+ * writer waits for room instead, so boot output is not lost.
+ */
+//! @{
+#ifdef DBG_USART_PDCA_PID
+#  define DBG_USART_PDCA_CHANNEL  2       //!< 0 and 1 are SSC RX/TX, see taskAK5394A.h
+#  define DBG_TX_BUFFER_SIZE      2048    //!< Must be a power of two.
+#endif
+//! @}
+
 /*! \name VT100 Common Commands
  */
 //! @{
@@ -271,6 +289,11 @@ extern char read_dbg_char_hex(char echo, char rtos_delay); // char or int? exter
  */
 void print_dbg_char_char(int c);
 
+/*! \brief Returns the number of debug characters dropped because the
+ *         transmit ring was full.
+ */
+extern unsigned long print_dbg_overflow(void);
+
 /////////////////////////////////////////////////////
 // BSB 20110128-20120717 End of insertion
 /////////////////////////////////////////////////////
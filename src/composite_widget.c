@@ -173,6 +173,7 @@
 #include "FreeRTOS.h"
 
 #include "features.h"
+#include "iq_correction.h"
 #include "widget.h"
 #include "image.h"
 #include "composite_widget.h"
@@ -267,6 +268,9 @@ int i;
 	// Initialize features management
 	features_init();
 
+	// Initialize the IQ correction matrix saved next to the features
+	iq_correction_init();
+
 	// Initialize widget management
 	widget_init();
 
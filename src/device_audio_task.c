@@ -1,6 +1,8 @@
 /* -*- mode: c++; tab-width: 4; c-basic-offset: 4 -*- */
 #include "compiler.h"
+#include "FreeRTOS.h"
 #include "device_audio_task.h"
+#include "eventlog.h"
 
 //!
 //! Public : (bit) mute
@@ -10,3 +12,29 @@
 volatile Bool mute, spk_mute;
 volatile U32 FB_rate;
 S16 volume, spk_volume;
+volatile U16 spk_gap;
+
+static U32 enumerated_time;				// run-time counter at enumeration
+static volatile U8 first_sample_pending;	// streams not yet timed, one bit each
+
+//
+// the device audio task saw the device configured, start timing
+//
+void device_audio_enumerated(void) {
+	enumerated_time = portGET_RUN_TIME_COUNTER_VALUE();
+	first_sample_pending = (1 << DEVICE_AUDIO_RECORD) | (1 << DEVICE_AUDIO_PLAYBACK);
+}
+
+//
+// the first sample of a stream went out or came in, log the time taken
+// the first time only, called from the device audio task
+//
+void device_audio_first_sample(U8 stream) {
+	U32 elapsed;
+
+	if ( ! (first_sample_pending & (1 << stream)))
+		return;
+	first_sample_pending &= ~(1 << stream);
+	elapsed = portGET_RUN_TIME_COUNTER_VALUE() - enumerated_time;
+	eventlog_put(ev_first_sample, stream, (U32)((U64)elapsed * 1000000 / EVENTLOG_TIME_HZ), 0);
+}
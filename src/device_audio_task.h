@@ -71,6 +71,17 @@ extern volatile Bool mute, spk_mute;
 extern volatile U32 FB_rate;
 extern S16 volume, spk_volume;
 
+// speaker buffer health, written by the device audio task at each feedback
+extern volatile U16 spk_gap;				// words between the USB writer and the DAC reader
+
+// enumeration to first sample, logged as ev_first_sample once per stream
+// and enumeration
+#define DEVICE_AUDIO_RECORD		0
+#define DEVICE_AUDIO_PLAYBACK	1
+
+extern void device_audio_enumerated(void);
+extern void device_audio_first_sample(U8 stream);
+
 //_____ M A C R O S ________________________________________________________
 
 
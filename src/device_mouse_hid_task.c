@@ -93,6 +93,7 @@
 #include "usb_standard_request.h"
 #include "usb_specific_request.h"
 #include "device_mouse_hid_task.h"
+#include "ram_budget.h"
 
 #if LCD_DISPLAY			// Multi-line LCD display
 #include "taskLCD.h"
@@ -109,6 +110,8 @@
 
 //_____ D E C L A R A T I O N S ____________________________________________
 
+RAM_BUDGET_STACK(device_mouse_hid_stack, configTSK_USB_DHID_MOUSE_STACK_SIZE);
+
 // static U8 usb_state = 'r'; // BSB 20120718 unused variable, sane?
 // static U8 ep_hid_rx; // BSB 20120718 unused variable, sane?
    static U8 ep_hid_tx;
@@ -136,12 +139,12 @@ void device_mouse_hid_task_init(U8 ep_rx, U8 ep_tx)
 #endif  // FREERTOS_USED
 
 #ifdef FREERTOS_USED
-	xTaskCreate(device_mouse_hid_task,
+	ram_budget_task_create(device_mouse_hid_task,
 				configTSK_USB_DHID_MOUSE_NAME,
 				configTSK_USB_DHID_MOUSE_STACK_SIZE,
 				NULL,
 				configTSK_USB_DHID_MOUSE_PRIORITY,
-				NULL);
+				device_mouse_hid_stack);
 #endif  // FREERTOS_USED
 
 	// Added BSB 20120718
@@ -177,6 +180,7 @@ void device_mouse_hid_task(void)
   U8 ReportByte1 = 0;				// 1st variable byte of HID report
   U8 ReportByte2 = 0; 			// 2nd variable byte of HID report
   U8 ReportByte1_prev = 0;		// Previous ReportByte1
+  U8 report[3];					// HID report as it goes out
   char a = 0;						// ASCII character as part of HID protocol over uart
   char gotcmd = 0;				// Initially, no user command was recorded
 
@@ -346,9 +350,10 @@ void device_mouse_hid_task(void)
     if ( Is_usb_in_ready(EP_HID_TX) )
     {
        Usb_reset_endpoint_fifo_access(EP_HID_TX);
-       Usb_write_endpoint_data(EP_HID_TX, 8, ReportByte0);
-       Usb_write_endpoint_data(EP_HID_TX, 8, ReportByte1);
-       Usb_write_endpoint_data(EP_HID_TX, 8, ReportByte2);
+       report[0] = ReportByte0;
+       report[1] = ReportByte1;
+       report[2] = ReportByte2;
+       usb_write_ep_txpacket(EP_HID_TX, report, sizeof(report), NULL);
        Usb_ack_in_ready_send(EP_HID_TX);
        print_dbg_char_char('H');					// Confirm HID command forwarded to HOST
        print_dbg_char_char('\n');					// Confirm HID command forwarded to HOST
@@ -0,0 +1,586 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * dg8saq_queue.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The DG8SAQ command queue and its task, see dg8saq_queue.h
+ */
+
+#include <string.h>
+
+#include "compiler.h"
+#include "board.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include "DG8SAQ_cmd.h"
+#include "eventlog.h"
+#include "ram_budget.h"
+#include "sweep.h"
+#include "usb_standard_request.h"
+#include "si570_tune.h"
+#include "dg8saq_queue.h"
+#if SI570_SMOOTH_TUNE
+#include "Mobo_config.h"
+#include "freq_and_filters.h"
+#endif
+
+#if SI570_SMOOTH_TUNE && CALC_BAND_MUL_ADD
+#error "si570_tune.c has no band dependent Subtract and Multiply, use CALC_FREQ_MUL_ADD"
+#endif
+
+#define DG8SAQ_MS_TO_TICKS(ms)	((portTickType)(ms) * (configTICK_RATE_HZ / 1000))
+#define DG8SAQ_SLOT(n)			(&dg8saq_slots[(dg8saq_head + (n)) % DG8SAQ_QUEUE_SLOTS])
+#define DG8SAQ_IS_FREQ_SET(s)	(! (s)->query && ((s)->request == DG8SAQ_SET_FREQ || \
+															(s)->request == DG8SAQ_SET_FREQ_REGISTERS))
+#define DG8SAQ_IS_CACHED(r)		((r) == DG8SAQ_GET_VERSION || (r) == DG8SAQ_GET_SUB_MUL || \
+								 (r) == DG8SAQ_GET_FREQ || (r) == DG8SAQ_GET_KEYS)
+#define DG8SAQ_IS_LIVE(r)		((r) == DG8SAQ_GET_KEYS)
+#define DG8SAQ_PTT_UNKNOWN		0xffff
+
+enum {
+	DG8SAQ_SLOT_QUEUED,
+	DG8SAQ_SLOT_RUNNING,
+	DG8SAQ_SLOT_DROPPED		// a frequency set another took the place of
+};
+
+typedef struct {
+	volatile U8 state;
+	Bool query;
+	U8 request;
+	U8 length;
+	U16 value;
+	U16 index;
+	U16 generation;			// of the status cache when queued
+	U16 ticket;				// of usb_ctrl_defer(), for the request deferred
+	U8 data[DG8SAQ_QUEUE_DATA];
+} dg8saq_slot_t;
+
+typedef struct {
+	Bool used;				// by a query
+	Bool valid;				// reply up to date
+	portTickType asked;		// when last answered from, a live one is read again while recent
+	U8 request;
+	U8 length;
+	U16 value;
+	U16 index;
+	U8 reply[DG8SAQ_STATUS_SIZE];
+} dg8saq_status_t;
+
+RAM_BUDGET_STACK(dg8saq_stack, configTSK_DG8SAQ_STACK_SIZE);
+
+// the USB device task adds at dg8saq_head + dg8saq_count, the DG8SAQ task
+// takes from dg8saq_head
+static dg8saq_slot_t dg8saq_slots[DG8SAQ_QUEUE_SLOTS];
+static volatile U8 dg8saq_head, dg8saq_count;
+
+// the request EP0 waits for, one at a time as EP0 takes them, copied to
+// dg8saq_deferred by the DG8SAQ task to be run
+static dg8saq_slot_t dg8saq_pending, dg8saq_deferred;
+static volatile Bool dg8saq_pending_waiting;
+static portTickType dg8saq_pending_since;
+
+static dg8saq_status_t dg8saq_status[DG8SAQ_STATUS_ENTRIES];
+static U8 dg8saq_status_next;			// entry a new query takes
+static volatile U16 dg8saq_generation;	// one up for each command that makes the cache stale
+static portTickType dg8saq_status_read;	// when the live entries were last read
+static U16 dg8saq_ptt = DG8SAQ_PTT_UNKNOWN;	// the PTT set last
+
+static U8 dg8saq_answer[DG8SAQ_STATUS_SIZE];		// sent from the cache
+static U8 dg8saq_deferred_answer[DG8SAQ_QUEUE_DATA];	// sent by the DG8SAQ task
+static U8 dg8saq_reply[256];			// the dg8saqBuffer of the DG8SAQ task
+static xSemaphoreHandle dg8saq_ready;
+
+#if SI570_SMOOTH_TUNE
+static Bool dg8saq_sub_mul_known;		// by si570_tune.c
+
+static void dg8saq_sub_mul(const U8 *data) {
+	U32 mul;
+	S32 sub;
+
+	memcpy(&mul, data, 4);
+	memcpy(&sub, data + 4, 4);
+	si570_set_sub_mul(sub, mul);
+	dg8saq_sub_mul_known = TRUE;
+}
+
+//
+// a frequency set tuned to by si570_tune.c, and the filters switched for it
+// by the Mobo firmware, which only writes the Si570 from
+// dg8saqFunctionWrite(), both held while transmitting as the Mobo firmware
+// holds them. FALSE for the Mobo firmware to run it: held, or a frequency
+// si570_tune.c cannot make
+//
+static Bool dg8saq_set_freq(U32 freq) {
+	if (TX_state && ! FRQ_CGH_DURING_TX)
+		return FALSE;
+	if (! si570_set_freq(freq))
+		return FALSE;
+	if (TX_state && ! FLTR_CGH_DURING_TX)
+		return TRUE;
+#if BPF_LPF_Module
+	SetFilter(freq);
+#endif
+#if TX_FILTERS
+	SetLPF(freq);
+#endif
+	return TRUE;
+}
+#endif
+
+//
+// a host to device command run, the Si570 ones by si570_tune.c on a board that
+// has it tune the Si570, the Mobo firmware told of the others, and of the
+// settings too
+//
+static void dg8saq_write(U8 request, U16 value, U16 index, U8 *data, U8 length) {
+#if SI570_SMOOTH_TUNE
+	U32 word;
+	U16 ppm;
+
+	switch (request) {
+	case DG8SAQ_SET_FREQ:
+		if (length == 4) {
+			// the subtract and multiply the Mobo firmware has from its EEPROM
+			if (! dg8saq_sub_mul_known) {
+				if (dg8saqFunctionSetup(DG8SAQ_GET_SUB_MUL, 0, 0, dg8saq_reply) == 8)
+					dg8saq_sub_mul(dg8saq_reply);
+				dg8saq_sub_mul_known = TRUE;
+			}
+			memcpy(&word, data, 4);
+			if (dg8saq_set_freq(word))
+				return;
+			// tuned by the Mobo firmware, the registers no longer si570_tune.c's
+			si570_forget();
+		}
+		break;
+	case DG8SAQ_SET_SUB_MUL:
+		if (length == 8)
+			dg8saq_sub_mul(data);
+		break;
+	case DG8SAQ_SET_FREQ_REGISTERS:
+		si570_forget();
+		break;
+	case DG8SAQ_SET_XTAL:
+		if (length == 4) {
+			memcpy(&word, data, 4);
+			si570_set_xtal(word);
+		}
+		break;
+	case DG8SAQ_SET_SMOOTH:
+		if (length == 2) {
+			memcpy(&ppm, data, 2);
+			si570_set_smooth(ppm);
+		}
+		break;
+	}
+#endif
+	// This is our all important hook - Do the magic... control Si570 etc...
+	dg8saqFunctionWrite(request, value, index, data, length);
+}
+
+static U8 dg8saq_setup(U8 request, U16 value, U16 index, U8 *reply) {
+#if SI570_SMOOTH_TUNE
+	U32 freq = si570_get_freq();
+
+	if (request == DG8SAQ_GET_FREQ && freq != 0) {
+		memcpy(reply, &freq, 4);
+		return 4;
+	}
+#endif
+	// This is our all important hook - Process and execute command, read CW paddle state etc...
+	return dg8saqFunctionSetup(request, value, index, reply);
+}
+
+//
+// the frequency reads back as set, before it is tuned to
+//
+static void dg8saq_status_freq(const U8 *data) {
+	dg8saq_status_t *entry;
+
+	for (entry = dg8saq_status; entry < dg8saq_status + DG8SAQ_STATUS_ENTRIES; entry += 1)
+		if (entry->used && entry->request == DG8SAQ_GET_FREQ) {
+			memcpy(entry->reply, data, 4);
+			entry->length = 4;
+			entry->valid = TRUE;
+		}
+}
+
+//
+// every reply cached out of date but the live ones, in a critical section
+//
+static void dg8saq_status_stale(void) {
+	dg8saq_status_t *entry;
+
+	dg8saq_generation += 1;
+	for (entry = dg8saq_status; entry < dg8saq_status + DG8SAQ_STATUS_ENTRIES; entry += 1)
+		if (! DG8SAQ_IS_LIVE(entry->request))
+			entry->valid = FALSE;
+}
+
+static dg8saq_status_t *dg8saq_status_find(U8 request, U16 value, U16 index) {
+	dg8saq_status_t *entry;
+
+	for (entry = dg8saq_status; entry < dg8saq_status + DG8SAQ_STATUS_ENTRIES; entry += 1)
+		if (entry->used && entry->request == request && entry->value == value && entry->index == index)
+			return entry;
+	return NULL;
+}
+
+//
+// the reply to a query run kept, the one of a PTT set as the CW keys it
+// reads, in a critical section. A reply from before the last command that
+// made the cache stale is not, but for a live one
+//
+static void dg8saq_status_keep(const dg8saq_slot_t *slot, const U8 *reply, U8 length) {
+	dg8saq_status_t *entry;
+	U8 request = slot->request;
+	U16 value = slot->value, index = slot->index;
+
+	if (request == DG8SAQ_SET_PTT)
+		request = DG8SAQ_GET_KEYS, value = 0, index = 0;
+	if (! DG8SAQ_IS_CACHED(request) || (! DG8SAQ_IS_LIVE(request) && slot->generation != dg8saq_generation))
+		return;
+	entry = dg8saq_status_find(request, value, index);
+	if (entry == NULL) {
+		entry = &dg8saq_status[dg8saq_status_next];
+		dg8saq_status_next = (dg8saq_status_next + 1) % DG8SAQ_STATUS_ENTRIES;
+		entry->used = TRUE;
+		entry->asked = xTaskGetTickCount();
+		entry->request = request;
+		entry->value = value;
+		entry->index = index;
+	}
+	length = min(length, DG8SAQ_STATUS_SIZE);
+	memcpy(entry->reply, reply, length);
+	entry->length = length;
+	entry->valid = TRUE;
+}
+
+//
+// the live entries read again if the host asked for them in the last
+// DG8SAQ_STATUS_IDLE, let go stale if it did not, FALSE if there was none
+// to read
+//
+static Bool dg8saq_status_refresh(void) {
+	dg8saq_status_t *entry;
+	dg8saq_slot_t slot;
+	Bool asked, read = FALSE;
+	U8 length;
+
+	for (entry = dg8saq_status; entry < dg8saq_status + DG8SAQ_STATUS_ENTRIES; entry += 1) {
+		if (! entry->used || ! DG8SAQ_IS_LIVE(entry->request))
+			continue;
+		portENTER_CRITICAL();
+		asked = xTaskGetTickCount() - entry->asked < DG8SAQ_MS_TO_TICKS(DG8SAQ_STATUS_IDLE);
+		if (! asked)
+			entry->valid = FALSE;
+		portEXIT_CRITICAL();
+		if (! asked)
+			continue;
+		slot.generation = dg8saq_generation;
+		slot.request = entry->request;
+		slot.value = entry->value;
+		slot.index = entry->index;
+		length = dg8saq_setup(slot.request, slot.value, slot.index, dg8saq_reply);
+		portENTER_CRITICAL();
+		dg8saq_status_keep(&slot, dg8saq_reply, length);
+		portEXIT_CRITICAL();
+		read = TRUE;
+	}
+	return read;
+}
+
+static void dg8saq_slot_fill(dg8saq_slot_t *slot, Bool query, U8 request, U16 value, U16 index) {
+	slot->state = DG8SAQ_SLOT_QUEUED;
+	slot->query = query;
+	slot->request = request;
+	slot->value = value;
+	slot->index = index;
+	slot->generation = dg8saq_generation;
+}
+
+static void dg8saq_queue_put(dg8saq_slot_t *slot, Bool query, U8 request, U16 value, U16 index) {
+	dg8saq_slot_fill(slot, query, request, value, index);
+
+	portENTER_CRITICAL();
+	dg8saq_count += 1;
+	portEXIT_CRITICAL();
+	xSemaphoreGive(dg8saq_ready);
+}
+
+//
+// the record for a request to defer, taken back from one the host gave up
+// on if the DG8SAQ task has not run it yet
+//
+static dg8saq_slot_t *dg8saq_pending_slot(void) {
+	Bool dropped;
+
+	portENTER_CRITICAL();
+	dropped = dg8saq_pending_waiting;
+	dg8saq_pending_waiting = FALSE;
+	portEXIT_CRITICAL();
+	if (dropped)
+		eventlog_put(ev_dg8saq_failed, dg8saq_pending.request, dg8saq_count,
+					 xTaskGetTickCount() - dg8saq_pending_since);
+	return &dg8saq_pending;
+}
+
+//
+// EP0 held until the DG8SAQ task ran the request, after the commands queued
+//
+static void dg8saq_defer(Bool query, U8 request, U16 value, U16 index) {
+	dg8saq_pending_slot();
+	dg8saq_slot_fill(&dg8saq_pending, query, request, value, index);
+	dg8saq_pending.ticket = usb_ctrl_defer();
+	dg8saq_pending_since = xTaskGetTickCount();
+
+	portENTER_CRITICAL();
+	dg8saq_pending_waiting = TRUE;
+	portEXIT_CRITICAL();
+	xSemaphoreGive(dg8saq_ready);
+}
+
+void dg8saq_reverse(U8 *buffer, U16 length) {
+	U8 *end = buffer + length - 1;
+	U8 tmp;
+
+	while (buffer < end) {
+		tmp = *buffer;
+		*buffer++ = *end;
+		*end-- = tmp;
+	}
+}
+
+Bool dg8saq_queue_write(U8 request, U16 value, U16 index, const U8 *data, U8 length) {
+	dg8saq_slot_t *slot = NULL, *queued;
+	Bool freq = request == DG8SAQ_SET_FREQ || request == DG8SAQ_SET_FREQ_REGISTERS;
+	Bool replaced = FALSE, deferred = FALSE;
+	U8 n;
+
+	if (length > DG8SAQ_QUEUE_DATA) {
+		eventlog_put(ev_dg8saq_failed, request, dg8saq_count, 0);
+		return FALSE;
+	}
+
+	portENTER_CRITICAL();
+	// a frequency set right after another not started yet takes its slot
+	if (freq && dg8saq_count != 0) {
+		slot = DG8SAQ_SLOT(dg8saq_count - 1);
+		replaced = slot->state == DG8SAQ_SLOT_QUEUED && DG8SAQ_IS_FREQ_SET(slot);
+		if (replaced) {
+			memcpy(slot->data, data, length);
+			slot->length = length;
+			slot->request = request;
+			slot->value = value;
+			slot->index = index;
+		}
+	}
+	portEXIT_CRITICAL();
+	if (! replaced) {
+		// the queue full, the status stage waits for the DG8SAQ task
+		deferred = dg8saq_count == DG8SAQ_QUEUE_SLOTS;
+		slot = deferred ? dg8saq_pending_slot() : DG8SAQ_SLOT(dg8saq_count);
+		memcpy(slot->data, data, length);
+		slot->length = length;
+	}
+
+	portENTER_CRITICAL();
+	// the other frequency sets not started yet are superseded
+	if (freq)
+		for (n = 0; n < dg8saq_count; n += 1) {
+			queued = DG8SAQ_SLOT(n);
+			if (queued != slot && queued->state == DG8SAQ_SLOT_QUEUED && DG8SAQ_IS_FREQ_SET(queued))
+				queued->state = DG8SAQ_SLOT_DROPPED;
+		}
+	// and the cache stale, but for the frequency itself once it is set
+	dg8saq_status_stale();
+	if (request == DG8SAQ_SET_FREQ && length == 4)
+		dg8saq_status_freq(data);
+	portEXIT_CRITICAL();
+
+	// the host takes the VFO back from a sweep
+	if (freq)
+		sweep_stop();
+
+	if (deferred)
+		dg8saq_defer(FALSE, request, value, index);
+	else if (! replaced)
+		dg8saq_queue_put(slot, FALSE, request, value, index);
+	return TRUE;
+}
+
+void dg8saq_queue_query(U8 request, U16 value, U16 index) {
+	dg8saq_status_t *entry = NULL;
+	dg8saq_slot_t *slot;
+	S16 length = -1;
+	Bool ptt = request == DG8SAQ_SET_PTT, queued = FALSE;
+
+	portENTER_CRITICAL();
+	if (ptt)
+		entry = dg8saq_status_find(DG8SAQ_GET_KEYS, 0, 0);
+	else if (DG8SAQ_IS_CACHED(request))
+		entry = dg8saq_status_find(request, value, index);
+	if (entry != NULL && entry->valid) {
+		memcpy(dg8saq_answer, entry->reply, entry->length);
+		length = entry->length;
+		entry->asked = xTaskGetTickCount();
+	}
+	if (dg8saq_count != 0) {
+		slot = DG8SAQ_SLOT(dg8saq_count - 1);
+		queued = slot->state == DG8SAQ_SLOT_QUEUED && slot->query && slot->request == request
+				 && slot->value == value && slot->index == index;
+	}
+	portEXIT_CRITICAL();
+
+	// a PTT set, or a Mobo feature, may change what the others read
+	if (! DG8SAQ_IS_CACHED(request) && ! (ptt && value == dg8saq_ptt)) {
+		portENTER_CRITICAL();
+		dg8saq_status_stale();
+		portEXIT_CRITICAL();
+	}
+
+	if (length < 0 || (ptt && value != dg8saq_ptt && dg8saq_count == DG8SAQ_QUEUE_SLOTS)
+		|| (! ptt && ! DG8SAQ_IS_CACHED(request))) {
+		// nothing at hand, or a PTT set that cannot be queued
+		if (ptt)
+			dg8saq_ptt = value;
+		dg8saq_defer(TRUE, request, value, index);
+		return;
+	}
+
+	// the PTT set when it changes, a reply cached but not live brought up
+	// to date for the next time, unless that is queued already
+	if (ptt ? value != dg8saq_ptt : ! DG8SAQ_IS_LIVE(request) && ! queued && dg8saq_count != DG8SAQ_QUEUE_SLOTS) {
+		if (ptt)
+			dg8saq_ptt = value;
+		slot = DG8SAQ_SLOT(dg8saq_count);
+		slot->length = 0;
+		dg8saq_queue_put(slot, TRUE, request, value, index);
+	}
+	dg8saq_reverse(dg8saq_answer, length);
+	usb_ctrl_send(dg8saq_answer, length);
+}
+
+//
+// the request EP0 waits for run, and answered if the host still waits,
+// FALSE if there was none
+//
+static Bool dg8saq_pending_run(void) {
+	dg8saq_slot_t *slot = &dg8saq_deferred;
+	Bool waiting;
+	U8 length;
+
+	portENTER_CRITICAL();
+	waiting = dg8saq_pending_waiting;
+	if (waiting)
+		*slot = dg8saq_pending;
+	dg8saq_pending_waiting = FALSE;
+	portEXIT_CRITICAL();
+	if (! waiting)
+		return FALSE;
+
+	if (slot->query) {
+		length = min(dg8saq_setup(slot->request, slot->value, slot->index, dg8saq_reply), DG8SAQ_QUEUE_DATA);
+		portENTER_CRITICAL();
+		dg8saq_status_keep(slot, dg8saq_reply, length);
+		portEXIT_CRITICAL();
+		memcpy(dg8saq_deferred_answer, dg8saq_reply, length);
+		dg8saq_reverse(dg8saq_deferred_answer, length);
+		waiting = usb_ctrl_deferred_send(slot->ticket, dg8saq_deferred_answer, length);
+	} else {
+		dg8saq_write(slot->request, slot->value, slot->index, slot->data, slot->length);
+		waiting = usb_ctrl_deferred_ack(slot->ticket);
+	}
+	// the host gave up on it
+	if (! waiting)
+		eventlog_put(ev_dg8saq_failed, slot->request, dg8saq_count, xTaskGetTickCount() - dg8saq_pending_since);
+	return TRUE;
+}
+
+Bool dg8saq_queue_run(void) {
+	dg8saq_slot_t *slot = NULL;
+	U32 freq;
+	U8 length;
+
+	// a sweep step is due now, ahead of the commands queued, the frequency
+	// in MCU order as a DG8SAQ_SET_FREQ has it
+	if (sweep_next(&freq)) {
+		dg8saq_write(DG8SAQ_SET_FREQ, 0, 0, (U8 *)&freq, 4);
+		sweep_tuned();
+		portENTER_CRITICAL();
+		dg8saq_status_freq((U8 *)&freq);
+		portEXIT_CRITICAL();
+		return TRUE;
+	}
+
+	// the CW keys, every DG8SAQ_STATUS_PERIOD
+	if (xTaskGetTickCount() - dg8saq_status_read >= DG8SAQ_MS_TO_TICKS(DG8SAQ_STATUS_PERIOD)) {
+		dg8saq_status_read = xTaskGetTickCount();
+		if (dg8saq_status_refresh())
+			return TRUE;
+	}
+
+	portENTER_CRITICAL();
+	while (dg8saq_count != 0 && DG8SAQ_SLOT(0)->state == DG8SAQ_SLOT_DROPPED) {
+		dg8saq_head = (dg8saq_head + 1) % DG8SAQ_QUEUE_SLOTS;
+		dg8saq_count -= 1;
+	}
+	if (dg8saq_count != 0) {
+		slot = DG8SAQ_SLOT(0);
+		slot->state = DG8SAQ_SLOT_RUNNING;
+	}
+	portEXIT_CRITICAL();
+	// the request EP0 waits for once the commands before it ran
+	if (slot == NULL)
+		return dg8saq_pending_run();
+
+	if (slot->query) {
+		length = dg8saq_setup(slot->request, slot->value, slot->index, dg8saq_reply);
+		portENTER_CRITICAL();
+		dg8saq_status_keep(slot, dg8saq_reply, length);
+		portEXIT_CRITICAL();
+	} else
+		dg8saq_write(slot->request, slot->value, slot->index, slot->data, slot->length);
+
+	portENTER_CRITICAL();
+	dg8saq_head = (dg8saq_head + 1) % DG8SAQ_QUEUE_SLOTS;
+	dg8saq_count -= 1;
+	portEXIT_CRITICAL();
+	return TRUE;
+}
+
+static void vtaskDG8SAQ(void *pvParameters) {
+	while (TRUE) {
+		// woken for a command, or to read the live entries again
+		xSemaphoreTake(dg8saq_ready, DG8SAQ_MS_TO_TICKS(DG8SAQ_STATUS_PERIOD));
+		while (dg8saq_queue_run())
+			;
+	}
+}
+
+void dg8saq_queue_wake(void) {
+	xSemaphoreGive(dg8saq_ready);
+}
+
+void dg8saq_queue_wake_from_isr(void) {
+	signed portBASE_TYPE woken = pdFALSE;
+
+	// the task runs at the next tick at the latest
+	xSemaphoreGiveFromISR(dg8saq_ready, &woken);
+}
+
+void vStartTaskDG8SAQ(void) {
+	vSemaphoreCreateBinary(dg8saq_ready);
+	xSemaphoreTake(dg8saq_ready, 0);
+	sweep_init();
+	ram_budget_task_create(vtaskDG8SAQ,
+				configTSK_DG8SAQ_NAME,
+				configTSK_DG8SAQ_STACK_SIZE,
+				NULL,
+				configTSK_DG8SAQ_PRIORITY,
+				dg8saq_stack);
+}
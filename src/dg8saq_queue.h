@@ -0,0 +1,94 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * dg8saq_queue.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * DG8SAQ commands run by a task of their own, off the control endpoint.
+ *
+ * dg8saqFunctionWrite() and dg8saqFunctionSetup() talk I2C to the Si570
+ * and the filters, too slow for the USB device task that answers EP0.
+ * usb_user_DG8SAQ() only copies a command into a slot of the queue and
+ * answers, the DG8SAQ task runs the slots in the order they came.
+ *
+ * Host to device commands are acknowledged once queued. A frequency set,
+ * DG8SAQ_SET_FREQ or DG8SAQ_SET_FREQ_REGISTERS, supersedes the ones still
+ * queued, only the last one is tuned to, and takes the slot of the last
+ * command queued if that is one, so a sweep does not fill the queue.
+ *
+ * The read only queries, of the version, the subtract and multiply, the
+ * frequency and the CW keys, are answered from the status cache, the last
+ * reply the task got for the same wValue and wIndex. One not live is
+ * queued as well, to bring its entry up to date, unless the same query is
+ * the last one queued. A host to device command makes those entries stale,
+ * but for a DG8SAQ_SET_FREQ, which they take the frequency of. The live
+ * one, the CW keys, the task reads again every DG8SAQ_STATUS_PERIOD while
+ * the host asked for it in the last DG8SAQ_STATUS_IDLE. Replies longer
+ * than DG8SAQ_STATUS_SIZE are cut to it.
+ *
+ * DG8SAQ_SET_PTT is answered with the CW keys cached, as it reads them,
+ * and queued if it changes the PTT. A PTT change, and the Mobo feature
+ * queries, may change what the others read, so they make the cache stale
+ * as a host to device command does.
+ *
+ * A request that needs the Mobo firmware to answer, a query with its entry
+ * missing or stale, a Mobo feature, or a command with the queue full,
+ * holds EP0, see usb_ctrl_defer(), until the task ran it after the ones
+ * queued before. Its reply is cut to DG8SAQ_QUEUE_DATA. The USB device
+ * task never waits on the DG8SAQ task.
+ *
+ * A board with SI570_SMOOTH_TUNE has the frequency sets, and the queries
+ * of the frequency, run by si570_tune.c rather than the Mobo firmware, see
+ * si570_tune.h, with the subtract and multiply the Mobo firmware has, and its
+ * filters switched for the frequency.
+ *
+ * The dg8saq-queue-check host tool runs the queue against a model of a
+ * slow Si570 and counts the time EP0 is held.
+ */
+
+#ifndef DG8SAQ_QUEUE_H_
+#define DG8SAQ_QUEUE_H_
+
+#include "compiler.h"
+
+#define DG8SAQ_QUEUE_SLOTS			8		// commands queued at most
+#define DG8SAQ_QUEUE_DATA			64		// data bytes a command, EP_CONTROL_LENGTH
+#define DG8SAQ_STATUS_ENTRIES		8		// query replies cached
+#define DG8SAQ_STATUS_SIZE			8		// bytes a reply at most
+#define DG8SAQ_STATUS_PERIOD		10		// ms between reads of the CW keys
+#define DG8SAQ_STATUS_IDLE			500		// ms the CW keys are read for after the host asked
+
+#define DG8SAQ_GET_VERSION			0x00	// query, the firmware version, 2 bytes
+#define DG8SAQ_SET_FREQ_REGISTERS	0x30	// host to device, the Si570 registers
+#define DG8SAQ_SET_SUB_MUL			0x31	// host to device, the multiply then the subtract, 8 bytes
+#define DG8SAQ_SET_FREQ				0x32	// host to device, the frequency, 4 bytes
+#define DG8SAQ_SET_XTAL				0x33	// host to device, the Si570 crystal, 4 bytes
+#define DG8SAQ_SET_SMOOTH			0x35	// host to device, the smooth tune range in ppm, 2 bytes
+#define DG8SAQ_GET_SUB_MUL			0x39	// query, as DG8SAQ_SET_SUB_MUL
+#define DG8SAQ_GET_FREQ				0x3a	// query, the frequency, 4 bytes
+#define DG8SAQ_SET_PTT				0x50	// query, the PTT set from wValue, the CW keys, 1 byte
+#define DG8SAQ_GET_KEYS				0x51	// query, the CW keys, 1 byte
+
+// a host to device command, data already in MCU order, for the completion
+// of its OUT data stage: FALSE to stall it, TRUE once queued or deferred
+extern Bool dg8saq_queue_write(U8 request, U16 value, U16 index, const U8 *data, U8 length);
+
+// a query answered on EP0, last byte first, from the cache or deferred
+extern void dg8saq_queue_query(U8 request, U16 value, U16 index);
+
+// DG8SAQ commands are sent last byte first in both directions
+extern void dg8saq_reverse(U8 *buffer, U16 length);
+
+// a sweep step due tuned to, the CW keys read when due, the oldest command
+// queued run, or else the request EP0 waits for, FALSE if there was none,
+// for the DG8SAQ task
+extern Bool dg8saq_queue_run(void);
+
+// the DG8SAQ task woken for a sweep step, see sweep.h
+extern void dg8saq_queue_wake(void);
+extern void dg8saq_queue_wake_from_isr(void);
+
+extern void vStartTaskDG8SAQ(void);
+
+#endif /* DG8SAQ_QUEUE_H_ */
@@ -0,0 +1,150 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * eventlog.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Binary event log, see eventlog.h
+ */
+
+#include "usart.h"     // Shall be included before FreeRTOS header files, since 'inline' is defined to ''; leading to
+                       // link errors
+#include "compiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "print_funcs.h"
+#include "features.h"
+
+#include "ram_budget.h"
+#include "eventlog.h"
+
+#define EVENTLOG_MASK	(EVENTLOG_SIZE-1)
+
+static eventlog_record_t eventlog_ring[EVENTLOG_SIZE];
+static volatile U32 eventlog_count;		// events logged since boot, the next sequence number
+
+//
+// log one event, safe from any context
+//
+void eventlog_put(eventlog_id_t id, U32 arg0, U32 arg1, U32 arg2) {
+	eventlog_record_t *rp;
+
+	AVR32_ENTER_CRITICAL_REGION();
+	rp = &eventlog_ring[eventlog_count & EVENTLOG_MASK];
+	rp->id = id;
+	rp->seq = eventlog_count;
+	rp->time = portGET_RUN_TIME_COUNTER_VALUE();
+	rp->arg[0] = arg0;
+	rp->arg[1] = arg1;
+	rp->arg[2] = arg2;
+	eventlog_count += 1;
+	AVR32_LEAVE_CRITICAL_REGION();
+}
+
+static void eventlog_put_le32(U8 *bp, U32 v) {
+	bp[0] = v;
+	bp[1] = v >> 8;
+	bp[2] = v >> 16;
+	bp[3] = v >> 24;
+}
+
+//
+// copy record seq out in wire order, FALSE if it is not in the ring
+// (overwritten already, or not yet logged)
+//
+static Bool eventlog_get_record(U32 seq, U8 *bp) {
+	eventlog_record_t record;
+	Bool valid;
+
+	AVR32_ENTER_CRITICAL_REGION();
+	valid = (eventlog_count - seq - 1) < EVENTLOG_SIZE;
+	if (valid)
+		record = eventlog_ring[seq & EVENTLOG_MASK];
+	AVR32_LEAVE_CRITICAL_REGION();
+	if ( ! valid)
+		return FALSE;
+
+	bp[0] = record.id;
+	bp[1] = record.id >> 8;
+	bp[2] = record.seq;
+	bp[3] = record.seq >> 8;
+	eventlog_put_le32(&bp[4], record.time);
+	eventlog_put_le32(&bp[8], record.arg[0]);
+	eventlog_put_le32(&bp[12], record.arg[1]);
+	eventlog_put_le32(&bp[16], record.arg[2]);
+	return TRUE;
+}
+
+//
+// the oldest full sequence number at or after the 16 bit seq
+// the host asked for, or the oldest record if it fell behind
+//
+static U32 eventlog_expand_seq(U16 seq) {
+	U32 count = eventlog_count;
+	U32 oldest = count > EVENTLOG_SIZE ? count - EVENTLOG_SIZE : 0;
+	U32 full = count - (U16)(count - seq);
+
+	if ((U16)(count - seq) > count - oldest)
+		return oldest;
+	return full;
+}
+
+//
+// vendor request reply: up to EVENTLOG_RECORDS_PER_REQUEST records
+// starting at seq, an empty reply means the host is up to date
+//
+U8 eventlog_get_records(U16 seq, U8 *buffer) {
+	U32 full = eventlog_expand_seq(seq);
+	U8 n;
+
+	for (n = 0; n < EVENTLOG_RECORDS_PER_REQUEST; n += 1)
+		if ( ! eventlog_get_record(full + n, &buffer[n * EVENTLOG_RECORD_SIZE]))
+			break;
+	return n * EVENTLOG_RECORD_SIZE;
+}
+
+#if EVENTLOG_UART_DRAIN
+RAM_BUDGET_STACK(eventlog_stack, configTSK_EVENTLOG_STACK_SIZE);
+
+//
+// write new records to the debug UART as hex lines for widget-eventlog,
+// at idle priority so the formatting never competes with the audio tasks
+//
+static void vtaskEventLog(void *pvParameters) {
+	static const char hex[16] = "0123456789abcdef";
+	char line[sizeof(EVENTLOG_UART_PREFIX) + 2*EVENTLOG_RECORD_SIZE + 1];
+	U8 record[EVENTLOG_RECORD_SIZE];
+	U32 next = 0;
+	int i, j;
+
+	while (TRUE) {
+		vTaskDelay(configTSK_EVENTLOG_PERIOD);
+		next = eventlog_expand_seq(next);
+		while (eventlog_get_record(next, record)) {
+			for (i = 0; EVENTLOG_UART_PREFIX[i] != '\0'; i += 1)
+				line[i] = EVENTLOG_UART_PREFIX[i];
+			for (j = 0; j < EVENTLOG_RECORD_SIZE; j += 1) {
+				line[i++] = hex[record[j] >> 4];
+				line[i++] = hex[record[j] & 0xF];
+			}
+			line[i++] = '\n';
+			line[i] = '\0';
+			print_dbg(line);
+			next += 1;
+		}
+	}
+}
+#endif
+
+void vStartTaskEventLog(void) {
+	eventlog_put(ev_boot, features[feature_image_index], 0, 0);
+#if EVENTLOG_UART_DRAIN
+	ram_budget_task_create(vtaskEventLog,
+				configTSK_EVENTLOG_NAME,
+				configTSK_EVENTLOG_STACK_SIZE,
+				NULL,
+				configTSK_EVENTLOG_PRIORITY,
+				eventlog_stack);
+#endif
+}
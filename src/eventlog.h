@@ -0,0 +1,34 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * eventlog.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Binary event log: an event id, a timestamp and up to three arguments
+ * go into a RAM ring, nothing is formatted on the MCU. eventlog_put() is
+ * a handful of stores under a short masked-interrupt section and may be
+ * called from tasks and interrupt handlers, so it can stay enabled in
+ * production builds.
+ *
+ * The ring is read either with the EVENTLOG_DG8SAQ_COMMAND vendor request
+ * or from the hex lines the EventLog task writes to the debug UART, and
+ * turned back into text by the widget-eventlog host tool.
+ * Events and their format strings live in eventlog_events.h.
+ */
+
+#ifndef EVENTLOG_H_
+#define EVENTLOG_H_
+
+#include "compiler.h"
+#include "eventlog_events.h"
+
+#define EVENTLOG_SIZE			128		// records in the ring, must be a power of two
+#define EVENTLOG_UART_DRAIN		1		// start the task dumping new records to the debug UART
+
+extern void eventlog_put(eventlog_id_t id, U32 arg0, U32 arg1, U32 arg2);
+extern U8 eventlog_get_records(U16 seq, U8 *buffer);
+
+extern void vStartTaskEventLog(void);
+
+#endif /* EVENTLOG_H_ */
@@ -0,0 +1,63 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * eventlog_events.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The event table and record layout of the binary event log.
+ *
+ * This file is shared between the firmware and the widget-eventlog host
+ * decoder, so it must not include anything beyond <stdint.h>. The enum of
+ * event ids and the table of format strings are both generated from
+ * EVENTLOG_EVENTS, so they cannot drift apart. Append new events at the
+ * end to keep old dumps decodable.
+ *
+ * The format strings are only ever expanded on the host and receive the
+ * three 32 bit arguments, so use only %d %u %x style conversions.
+ */
+
+#ifndef EVENTLOG_EVENTS_H_
+#define EVENTLOG_EVENTS_H_
+
+#include <stdint.h>
+
+#define EVENTLOG_EVENTS \
+	EVENT(ev_none,				"none")												\
+	EVENT(ev_boot,				"boot, image %u")									\
+	EVENT(ev_fb_adjust,			"feedback %+d, gap %u, FB_rate 0x%x")				\
+	EVENT(ev_rate_change,		"sample rate %u Hz")								\
+	EVENT(ev_clock_valid,		"clock valid requested")							\
+	EVENT(ev_host_mic,			"host microphone %u Hz, %u channels, %u bits")	\
+	EVENT(ev_usb_suspend,		"USB suspend, record DMA %u")						\
+	EVENT(ev_usb_resume,		"USB resume, record DMA %u")						\
+	EVENT(ev_first_sample,		"first sample of stream %u, %u us after enumeration")	\
+	EVENT(ev_dg8saq_failed,		"DG8SAQ request 0x%x failed, %u queued, %u ticks waited")	\
+	EVENT(ev_si570_failed,		"Si570 write to register %u failed, TWI error -%u, frequency 0x%x")
+
+#define EVENT(name, format) name,
+typedef enum {
+	EVENTLOG_EVENTS
+	ev_end
+} eventlog_id_t;
+#undef EVENT
+
+//
+// one record as it goes over the wire, all fields little endian
+//
+#define EVENTLOG_RECORD_SIZE	20
+typedef struct {
+	uint16_t id;			// eventlog_id_t
+	uint16_t seq;			// low 16 bits of the sequence number, gaps mean lost records
+	uint32_t time;			// EVENTLOG_TIME_HZ ticks since boot
+	uint32_t arg[3];
+} eventlog_record_t;
+
+#define EVENTLOG_TIME_HZ		(66000000/32)	// the run-time stats time base, FPBA_HZ/32
+
+#define EVENTLOG_DG8SAQ_COMMAND	0x73	// vendor IN request, wIndex = first seq wanted
+#define EVENTLOG_RECORDS_PER_REQUEST 3	// fits the 64 byte control endpoint
+
+#define EVENTLOG_UART_PREFIX	"EVT "	// UART dump line: prefix + 40 hex digits
+
+#endif /* EVENTLOG_EVENTS_H_ */
@@ -37,6 +37,8 @@ typedef enum {
   feature_log_index,			// startup log display timing
   feature_filter_index,			// setting of filter
   feature_quirk_index,			// setting of various quirks
+  feature_sync_index,			// playback rate reference, explicit or implicit feedback
+  feature_mic_index,			// ADC channel of the HPSDR mic samples
   feature_end_index				// end marker, used to size arrays
 } feature_index_t;
 
@@ -52,6 +54,8 @@ typedef enum {
 		"log",										\
 		"filter",									\
 		"quirk",									\
+		"sync",										\
+		"mic",										\
 		"end"
 
 //
@@ -113,6 +117,13 @@ typedef enum {
 	feature_quirk_ptest,		// Production test quirk
 	feature_quirk_none,			// No quirks, normal operation
 	feature_end_lquirk,
+	feature_sync_explicit,		// UAC2 playback feedback endpoint
+	feature_sync_implicit,		// UAC2 playback follows the record packet sizes
+	feature_end_sync,
+	feature_mic_none,			// HPSDR mic samples zero
+	feature_mic_left,			// HPSDR mic samples from the left ADC channel
+	feature_mic_right,			// and from the right one
+	feature_end_mic,
 	feature_end_values			// end
 } feature_values_t;
 
@@ -158,6 +169,13 @@ typedef enum {
 		"quirk_ptest",													\
 		"quirk_none",													\
 		"end",															\
+		"explicit",														\
+		"implicit",														\
+		"end",															\
+		"mic_none",														\
+		"mic_left",														\
+		"mic_right",													\
+		"end",															\
 		"end"
 	
 typedef uint8_t features_t[feature_end_index];
@@ -220,6 +238,13 @@ extern const features_t features_default;
 #define FEATURE_PROD_TEST_ON			(features[feature_quirk_index] == (uint8_t)feature_quirk_ptest)
 #define FEATURE_PROD_TEST_OFF			(features[feature_quirk_index] != (uint8_t)feature_quirk_ptest)
 
+#define FEATURE_SYNC_EXPLICIT			(features[feature_sync_index] == (uint8_t)feature_sync_explicit)
+#define FEATURE_SYNC_IMPLICIT			(features[feature_sync_index] == (uint8_t)feature_sync_implicit)
+
+#define FEATURE_MIC_NONE				(features[feature_mic_index] == (uint8_t)feature_mic_none)
+#define FEATURE_MIC_LEFT				(features[feature_mic_index] == (uint8_t)feature_mic_left)
+#define FEATURE_MIC_RIGHT				(features[feature_mic_index] == (uint8_t)feature_mic_right)
+
 
 //
 // the version in the features specifies
@@ -262,6 +287,12 @@ extern const features_t features_default;
 #ifndef FEATURE_QUIRK_DEFAULT
 #error "FEATURE_QUIRK_DEFAULT must be defined by the Makefile"
 #endif
+#ifndef FEATURE_SYNC_DEFAULT
+#error "FEATURE_SYNC_DEFAULT must be defined by the Makefile"
+#endif
+#ifndef FEATURE_MIC_DEFAULT
+#error "FEATURE_MIC_DEFAULT must be defined by the Makefile"
+#endif
 
 #define FEATURES_DEFAULT FEATURE_MAJOR_DEFAULT,		\
 		FEATURE_MINOR_DEFAULT,						\
@@ -274,7 +305,9 @@ extern const features_t features_default;
 		FEATURE_LCD_DEFAULT,						\
 		FEATURE_LOG_DEFAULT,						\
 		FEATURE_FILTER_DEFAULT,						\
-		FEATURE_QUIRK_DEFAULT
+		FEATURE_QUIRK_DEFAULT,						\
+		FEATURE_SYNC_DEFAULT,						\
+		FEATURE_MIC_DEFAULT
 
 extern const char * const feature_value_names[];
 extern const char * const feature_index_names[];
@@ -54,9 +54,6 @@ static uint16_t x_image_get_qualifier_desc_length(void) {
 // specific request handlers
 static void x_image_user_endpoint_init(uint8_t conf_nb) {
 }
-static Bool x_image_user_read_request(uint8_t type, uint8_t request) {
-	return FALSE;
-}
 static void x_image_user_set_interface(U8 wIndex, U8 wValue) {
 }
 
@@ -83,7 +80,6 @@ const image_t flashyblinky_image = {
 	NULL,
 #endif
 	x_image_user_endpoint_init,
-	x_image_user_read_request,
 	x_image_user_set_interface
 };
 
@@ -69,6 +69,7 @@
 #include "pwm_dac.h"
 #include "pm.h"
 #include "usb_stream_control.h"
+#include "eventlog.h"
 
 //_____ M A C R O S ________________________________________________________
 
@@ -183,10 +184,10 @@ void host_audio_task(void)
             }
          }
 
-         printf("Detecting Microphone settings:\r\n");
-         printf(". Sample freq      =%ld Hz.\r\n", g_sample_freq[     interf_audio_stream]);
-         printf(". Num of channels  =%d.\r\n", g_n_channels[       interf_audio_stream]);
-         printf(". Bits per sample  =%d.\r\n", g_n_bits_per_sample[interf_audio_stream]);
+         // Detected microphone settings
+         eventlog_put(ev_host_mic, g_sample_freq[interf_audio_stream],
+                      g_n_channels[interf_audio_stream],
+                      g_n_bits_per_sample[interf_audio_stream]);
 
          // Unmuting all features unit and setting default volume to MAX
          //
@@ -0,0 +1,112 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * hpsdr_cc.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * HPSDR Protocol-1 command and control registers, see hpsdr_cc.h
+ */
+
+#include "compiler.h"
+#include "hpsdr_frame.h"
+#include "hpsdr_cc.h"
+
+#define HPSDR_CC_MASK(width)	((U32)((1ULL << (width)) - 1))
+#define HPSDR_CC_DESC(name, address, byte, lsb, width) \
+	{ (byte) == HPSDR_CC_C0 ? HPSDR_CC_EVERY : (address), \
+	  (byte) == HPSDR_CC_C0 ? (lsb) : 8 * (4 - (byte)) + (lsb), HPSDR_CC_MASK(width) },
+
+const hpsdr_cc_field_desc_t hpsdr_cc_fields[cc_end] = {
+	HPSDR_CC_FIELDS(HPSDR_CC_DESC)
+};
+
+const hpsdr_cc_field_desc_t hpsdr_cc_status_fields[cs_end] = {
+	HPSDR_CC_STATUS(HPSDR_CC_DESC)
+};
+
+U32 hpsdr_cc_registers[HPSDR_CC_ADDRESSES];
+Bool hpsdr_cc_mox;
+
+static U32 hpsdr_cc_dirty[HPSDR_CC_ADDRESSES / 32];	// a bit per address
+static U32 hpsdr_cc_status[HPSDR_CC_SLOTS];			// C1 to C4 of each status address, C1 on top
+static U8 hpsdr_cc_status_c0;						// dot, dash and PTT
+
+static void hpsdr_cc_update_slot(U8 address) {
+	U8 cc[HPSDR_CC_BYTES];
+
+	hpsdr_cc_get_status(address, cc);
+	hpsdr_frame_set_status(address, cc);
+}
+
+void hpsdr_cc_init(void) {
+	U8 address;
+
+	for (address = 0; address < HPSDR_CC_ADDRESSES; address += 1)
+		hpsdr_cc_registers[address] = 0;
+	for (address = 0; address < HPSDR_CC_ADDRESSES / 32; address += 1)
+		hpsdr_cc_dirty[address] = 0xffffffff;	// everything applied once
+	hpsdr_cc_mox = FALSE;
+
+	for (address = 0; address < HPSDR_CC_SLOTS; address += 1)
+		hpsdr_cc_status[address] = 0;
+	hpsdr_cc_status_c0 = 0;
+	for (address = 0; address < HPSDR_CC_SLOTS; address += 1)
+		hpsdr_cc_update_slot(address);
+}
+
+//
+// one store and one mark whatever the address, the frames never branch
+// on what they carry
+//
+void hpsdr_cc_decode(const U8 *cc) {
+	U8 address = cc[0] >> 1;
+	U32 value = ((U32)cc[1] << 24) | ((U32)cc[2] << 16) | ((U32)cc[3] << 8) | cc[4];
+
+	hpsdr_cc_dirty[address >> 5] |= (U32)(hpsdr_cc_registers[address] != value) << (address & 31);
+	hpsdr_cc_registers[address] = value;
+	hpsdr_cc_mox = cc[0] & HPSDR_C0_MOX;
+}
+
+Bool hpsdr_cc_changed(hpsdr_cc_field_t field) {
+	U8 address = hpsdr_cc_fields[field].address;
+	U32 bit = (U32)1 << (address & 31);
+
+	if ((hpsdr_cc_dirty[address >> 5] & bit) == 0)
+		return FALSE;
+	hpsdr_cc_dirty[address >> 5] &= ~bit;
+	return TRUE;
+}
+
+void hpsdr_cc_set_status(hpsdr_cc_status_t field, U32 value) {
+	const hpsdr_cc_field_desc_t *fp = &hpsdr_cc_status_fields[field];
+	U32 old, new;
+	U8 address;
+
+	if (fp->address == HPSDR_CC_EVERY) {
+		old = hpsdr_cc_status_c0;
+		new = (old & ~(fp->mask << fp->shift)) | ((value & fp->mask) << fp->shift);
+		if (new == old)
+			return;
+		hpsdr_cc_status_c0 = new;
+		for (address = 0; address < HPSDR_CC_SLOTS; address += 1)
+			hpsdr_cc_update_slot(address);
+	} else {
+		old = hpsdr_cc_status[fp->address];
+		new = (old & ~(fp->mask << fp->shift)) | ((value & fp->mask) << fp->shift);
+		if (new == old)
+			return;
+		hpsdr_cc_status[fp->address] = new;
+		hpsdr_cc_update_slot(fp->address);
+	}
+}
+
+void hpsdr_cc_get_status(U8 address, U8 *cc) {
+	U32 value = hpsdr_cc_status[address];
+
+	cc[0] = (address << 3) | hpsdr_cc_status_c0;
+	cc[1] = value >> 24;
+	cc[2] = value >> 16;
+	cc[3] = value >> 8;
+	cc[4] = value;
+}
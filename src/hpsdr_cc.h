@@ -0,0 +1,167 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * hpsdr_cc.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The HPSDR Protocol-1 command and control registers.
+ *
+ * Every OUT frame carries C0 to C4: C0 bit 0 is MOX, C0 bits [7:1] the
+ * address of the register C1 to C4 are written to. hpsdr_cc_decode() files
+ * them away with one store and marks the address changed when they differ,
+ * whatever the address, so the frames cost the same whatever the client
+ * sends. The fields are read through the HPSDR_CC_FIELDS table, and the
+ * audio task applies an address only when hpsdr_cc_changed() says so.
+ *
+ * The other way the IN frames rotate through HPSDR_CC_SLOTS status
+ * addresses, C0 bits [7:3] the address and bits [2:0] dot, dash and PTT
+ * in every frame. hpsdr_cc_set_status() encodes a field through the
+ * HPSDR_CC_STATUS table and rebuilds the ready made IN frame headers of
+ * hpsdr_frame.c only when the status changed, so the IN frames never pay
+ * for it either.
+ *
+ * The hpsdr-frame-check host tool checks every C0 address.
+ */
+
+#ifndef HPSDR_CC_H_
+#define HPSDR_CC_H_
+
+#include "compiler.h"
+#include "hpsdr_frame.h"
+
+#define HPSDR_CC_ADDRESSES		128		// C0 bits [7:1]
+#define HPSDR_CC_C0				0		// byte of the status fields in C0 of every IN frame
+#define HPSDR_CC_EVERY			0xff	// address of those fields
+
+//
+// The OUT registers: name, C0 address, byte C1 to C4 of the lowest bit,
+// that bit, width. The frequencies are in Hz, C1 the most significant byte.
+//
+#define HPSDR_CC_FIELDS(X) \
+	X(cc_speed,				0x00, 1, 0, 2)	/* IQ rate, 48/96/192 kHz */ \
+	X(cc_ref_10mhz,			0x00, 1, 2, 2)	/* 10 MHz reference source */ \
+	X(cc_src_122mhz,		0x00, 1, 4, 1)	/* 122.88 MHz source */ \
+	X(cc_config,			0x00, 1, 5, 2)	/* boards present */ \
+	X(cc_mic_source,		0x00, 1, 7, 1)	/* mic from Penelope */ \
+	X(cc_class_e,			0x00, 2, 0, 1) \
+	X(cc_oc_out,			0x00, 2, 1, 7)	/* open collector outputs */ \
+	X(cc_alex_atten,		0x00, 3, 0, 2) \
+	X(cc_preamp,			0x00, 3, 2, 1) \
+	X(cc_dither,			0x00, 3, 3, 1) \
+	X(cc_random,			0x00, 3, 4, 1) \
+	X(cc_alex_rx_ant,		0x00, 3, 5, 2) \
+	X(cc_alex_rx_out,		0x00, 3, 7, 1) \
+	X(cc_alex_tx_relay,		0x00, 4, 0, 2) \
+	X(cc_duplex,			0x00, 4, 2, 1) \
+	X(cc_receivers,			0x00, 4, 3, 3)	/* receivers less one */ \
+	X(cc_time_stamp,		0x00, 4, 6, 1) \
+	X(cc_common_freq,		0x00, 4, 7, 1) \
+	X(cc_tx_freq,			0x01, 4, 0, 32) \
+	X(cc_rx1_freq,			0x02, 4, 0, 32) \
+	X(cc_rx2_freq,			0x03, 4, 0, 32) \
+	X(cc_rx3_freq,			0x04, 4, 0, 32) \
+	X(cc_rx4_freq,			0x05, 4, 0, 32) \
+	X(cc_rx5_freq,			0x06, 4, 0, 32) \
+	X(cc_rx6_freq,			0x07, 4, 0, 32) \
+	X(cc_rx7_freq,			0x08, 4, 0, 32) \
+	X(cc_drive_level,		0x09, 1, 0, 8) \
+	X(cc_mic_boost,			0x09, 2, 0, 1) \
+	X(cc_line_in,			0x09, 2, 1, 1) \
+	X(cc_apollo_filter,		0x09, 2, 2, 1) \
+	X(cc_apollo_tuner,		0x09, 2, 3, 1) \
+	X(cc_apollo_auto_tune,	0x09, 2, 4, 1) \
+	X(cc_hermes_filter,		0x09, 2, 5, 1) \
+	X(cc_alex_manual,		0x09, 2, 6, 1)	/* Alex filters from C3 and C4 */ \
+	X(cc_vna,				0x09, 2, 7, 1) \
+	X(cc_alex_hpf,			0x09, 3, 0, 7) \
+	X(cc_alex_lpf,			0x09, 4, 0, 7) \
+	X(cc_rx_preamps,		0x0a, 1, 0, 4)	/* one bit per receiver */ \
+	X(cc_line_in_gain,		0x0a, 2, 0, 5) \
+	X(cc_user_outputs,		0x0a, 3, 0, 4) \
+	X(cc_rx1_atten,			0x0a, 4, 0, 5)	/* dB */ \
+	X(cc_rx1_atten_on,		0x0a, 4, 5, 1) \
+	X(cc_rx2_atten,			0x0b, 1, 0, 5) \
+	X(cc_rx2_atten_on,		0x0b, 1, 5, 1) \
+	X(cc_keyer_reverse,		0x0b, 2, 6, 1) \
+	X(cc_keyer_speed,		0x0b, 3, 0, 6)	/* WPM */ \
+	X(cc_keyer_mode,		0x0b, 3, 6, 2) \
+	X(cc_keyer_weight,		0x0b, 4, 0, 7) \
+	X(cc_keyer_spacing,		0x0b, 4, 7, 1) \
+	X(cc_cw_internal,		0x0f, 1, 0, 1) \
+	X(cc_sidetone_level,	0x0f, 2, 0, 8) \
+	X(cc_cw_rf_delay,		0x0f, 3, 0, 8)	/* ms */ \
+	X(cc_cw_hang_high,		0x10, 1, 0, 8)	/* hang time ms, bits [9:2] */ \
+	X(cc_cw_hang_low,		0x10, 2, 0, 2)	/* and bits [1:0] */ \
+	X(cc_sidetone_high,		0x10, 3, 0, 8)	/* sidetone Hz, bits [11:4] */ \
+	X(cc_sidetone_low,		0x10, 4, 0, 4)	/* and bits [3:0] */
+
+//
+// The IN status: name, status address, byte C0 to C4 of the lowest bit,
+// that bit, width. The C0 fields go into every IN frame, whatever its
+// address.
+//
+#define HPSDR_CC_STATUS(X) \
+	X(cs_ptt,				0, HPSDR_CC_C0, 0, 1) \
+	X(cs_dash,				0, HPSDR_CC_C0, 1, 1) \
+	X(cs_dot,				0, HPSDR_CC_C0, 2, 1) \
+	X(cs_adc_overload,		0, 1, 0, 1) \
+	X(cs_hermes_io,			0, 1, 1, 4)	/* user inputs */ \
+	X(cs_mercury_version,	0, 2, 0, 8) \
+	X(cs_penelope_version,	0, 3, 0, 8) \
+	X(cs_ozy_version,		0, 4, 0, 8) \
+	X(cs_exciter_power,		1, 2, 0, 16)	/* AIN5, C1 C2 */ \
+	X(cs_fwd_power,			1, 4, 0, 16)	/* AIN1, C3 C4 */ \
+	X(cs_rev_power,			2, 2, 0, 16)	/* AIN2, C1 C2 */ \
+	X(cs_ain3,				2, 4, 0, 16) \
+	X(cs_ain4,				3, 2, 0, 16) \
+	X(cs_supply,			3, 4, 0, 16)	/* AIN6 */ \
+	X(cs_rx_overloads,		4, 4, 0, 32)	/* C1 to C4 bit 0, one per receiver */
+
+#define HPSDR_CC_ENUM(name, address, byte, lsb, width)	name,
+
+typedef enum {
+	HPSDR_CC_FIELDS(HPSDR_CC_ENUM)
+	cc_end
+} hpsdr_cc_field_t;
+
+typedef enum {
+	HPSDR_CC_STATUS(HPSDR_CC_ENUM)
+	cs_end
+} hpsdr_cc_status_t;
+
+// where a field is: the register, and the bits of it
+typedef struct {
+	U8 address;				// HPSDR_CC_EVERY for the C0 status
+	U8 shift;				// of the lowest bit in the register, C1 the top byte
+	U32 mask;				// of the field, not shifted
+} hpsdr_cc_field_desc_t;
+
+extern const hpsdr_cc_field_desc_t hpsdr_cc_fields[cc_end];
+extern const hpsdr_cc_field_desc_t hpsdr_cc_status_fields[cs_end];
+
+extern U32 hpsdr_cc_registers[HPSDR_CC_ADDRESSES];	// C1 to C4 of each address, C1 on top
+extern Bool hpsdr_cc_mox;							// C0 bit 0 of the last OUT frame
+
+// clear the registers and the status, the IN headers to match
+extern void hpsdr_cc_init(void);
+
+// file away C0 to C4 of an OUT frame
+extern void hpsdr_cc_decode(const U8 *cc);
+
+// a field of the registers
+#define hpsdr_cc_get(field) \
+	((hpsdr_cc_registers[hpsdr_cc_fields[field].address] >> hpsdr_cc_fields[field].shift) \
+	 & hpsdr_cc_fields[field].mask)
+
+// whether the register of the field changed since the last call for any
+// field of the register, clears the mark
+extern Bool hpsdr_cc_changed(hpsdr_cc_field_t field);
+
+// set a status field, the IN headers rebuilt if it changed
+extern void hpsdr_cc_set_status(hpsdr_cc_status_t field, U32 value);
+
+// the C0 to C4 the IN frames of a status address carry
+extern void hpsdr_cc_get_status(U8 address, U8 *cc);
+
+#endif /* HPSDR_CC_H_ */
@@ -85,9 +85,19 @@
 #include "composite_widget.h"
 #include "taskAK5394A.h"
 #include "hpsdr_taskAK5394A.h"
+#include "ram_budget.h"
+#include "usb_power.h"
+#include "taskStartupLeds.h"
+#include "hpsdr_frame.h"
+#include "hpsdr_cc.h"
+#include "hpsdr_mic.h"
+#include "stream_health.h"
+#include "iq_correction.h"
 
 //_____ M A C R O S ________________________________________________________
 
+#define HPSDR_FRAMES_PER_WAKEUP	4	// IN frames sent at most each time the task runs
+
 
 //_____ D E F I N I T I O N S ______________________________________________
 
@@ -98,9 +108,19 @@
 static U32  index, spk_index;
 static U8 audio_buffer_out, spk_buffer_in;	// the ID number of the buffer used for sending out
 											// to the USB and reading from USB
+static U16  spk_gap = SPK_BUFFER_SIZE, mic_gap = AUDIO_BUFFER_SIZE;	// last gaps, for the stream health
+
+U8 command_out [HPSDR_CC_BYTES];			// C0 to C4 of the last OUT frame
+
+static U32 iq_frame[HPSDR_FRAME_WORDS];		// IN frame being built
+static U32 out_frame[HPSDR_FRAME_WORDS];	// OUT frame being unpacked
+static const void *iq_in_next;				// the part of iq_frame still to go out
+static U32 iq_in_left;
+static U16 out_received;					// bytes of out_frame in so far
+static S16 mic_slots[HPSDR_FRAME_SAMPLES];	// of the IN frame being built, zero without a mic
+static hpsdr_mic_t mic_filter;
 
-U8 command [4][5];
-U8 command_out [8];
+static const U32 hpsdr_rates[4] = { 48000, 96000, 192000, 0 };	// by cc_speed
 
 static U8 ep_audio_in, ep_audio_out, ep_audio_out_fb;
 
@@ -120,17 +140,65 @@ void hpsdr_device_audio_task_init(U8 ep_in, U8 ep_out, U8 ep_out_fb)
 	ep_audio_out = ep_out;
 	ep_audio_out_fb = ep_out_fb;
 
-	xTaskCreate(hpsdr_device_audio_task,
+	ram_budget_task_create(hpsdr_device_audio_task,
 				configTSK_USB_DAUDIO_NAME,
 				configTSK_USB_DAUDIO_STACK_SIZE,
 				NULL,
 				configTSK_USB_DAUDIO_PRIORITY,
-				NULL);
+				ram_budget_device_audio_stack);
 
 
 }
 
 
+//
+// as much of the IN frame as the endpoint banks take: a frame is one packet
+// at high speed, HPSDR_FRAME_BYTES / HPSDR_EP_SIZE_FS at full speed, and what
+// does not fit goes out the next time round. TRUE once all of it is sent.
+//
+static Bool hpsdr_iq_in_send(U8 ep)
+{
+	while (iq_in_left != 0 && Is_usb_in_ready(ep)) {
+		Usb_reset_endpoint_fifo_access(ep);
+		iq_in_left = usb_write_ep_txpacket(ep, iq_in_next, iq_in_left, &iq_in_next);
+		Usb_ack_in_ready_send(ep);		// send the current bank
+	}
+	return iq_in_left == 0;
+}
+
+//
+// the OUT packets that are in, appended to out_frame, TRUE once it holds a
+// whole frame. A short packet before that, or one running past the end,
+// means the frame is out of sync, it is dropped rather than played shifted.
+//
+static Bool hpsdr_out_receive(U8 ep)
+{
+	U16 count;
+
+	while (Is_usb_out_received(ep)) {
+		count = Usb_byte_count(ep);
+		Usb_reset_endpoint_fifo_access(ep);
+		if (count > HPSDR_FRAME_BYTES - out_received) {
+			STREAM_HEALTH_COUNT(sh_out_sync);
+			out_received = 0;
+		} else {
+			usb_read_ep_rxpacket(ep, (U8 *)out_frame + out_received, count, NULL);
+			out_received += count;
+		}
+		Usb_ack_out_received_free(ep);
+
+		if (out_received == HPSDR_FRAME_BYTES) {
+			out_received = 0;
+			return TRUE;
+		}
+		if (out_received != 0 && count < Usb_get_endpoint_size(ep)) {
+			STREAM_HEALTH_COUNT(sh_out_sync);
+			out_received = 0;
+		}
+	}
+	return FALSE;
+}
+
 //!
 //! @brief Entry point of the device Audio task management
 //!
@@ -139,28 +207,28 @@ void hpsdr_device_audio_task(void *pvParameters)
 {
 	static U32  time=0;
 	static Bool startup=TRUE;
-	int i, j = 0;
-	U16 num_samples, num_remaining, gap;
-
-	U8 sample_MSB;
-	U8 sample_SB;
-	U8 sample_LSB;
+	int frames;
+	U16 num_samples, num_remaining, gap, run, left;
+	U32 *wp;
+	const U32 *rp;
+	volatile U32 *src;
+	Bool correct;
+	U8 repeat;
+	hpsdr_out_source_t source;
 
 	const U8 EP_IQ_IN = ep_audio_in;
 	const U8 EP_IQ_OUT = ep_audio_out;
 	// const U8 EP_IQ_OUT_FB = ep_audio_out_fb;
 	const U8 IN_LEFT = FEATURE_IN_NORMAL ? 0 : 1;
 	const U8 IN_RIGHT = FEATURE_IN_NORMAL ? 1 : 0;
-	// const U8 OUT_LEFT = FEATURE_OUT_NORMAL ? 0 : 1;
-	// const U8 OUT_RIGHT = FEATURE_OUT_NORMAL ? 1 : 0;
-	//  U32 sample;
+	const U8 OUT_LEFT = FEATURE_OUT_NORMAL ? 0 : 1;
+	const U8 OUT_RIGHT = FEATURE_OUT_NORMAL ? 1 : 0;
 
 	volatile avr32_pdca_channel_t *pdca_channel = pdca_get_handler(PDCA_CHANNEL_SSC_RX);
 	volatile avr32_pdca_channel_t *spk_pdca_channel = pdca_get_handler(PDCA_CHANNEL_SSC_TX);
 
-	for (i=0; i < 5; i++){
-		for (j=0; j < 4; j++) command[j][i] = 0;
-	}
+	hpsdr_frame_init();
+	hpsdr_cc_init();
 
 
 	portTickType xLastWakeTime;
@@ -172,23 +240,26 @@ void hpsdr_device_audio_task(void *pvParameters)
 		// First, check the device enumeration state
 		if (!Is_device_enumerated()) { time=0; startup=TRUE; continue; };
 
-		if( startup ) {
+		// suspended, the clocks are gated and the streams hold their place,
+		// after a resume the rate setup lines the record PDCA up again
+		if (usb_power_suspended) continue;
+		if (usb_power_resync() && !startup) freq_changed = TRUE;
 
-			time+=HPSDR_configTSK_USB_DAUDIO_PERIOD;
+		if( startup ) {
+			// the LED walk plays in its own task, the stream starts as soon
+			// as the clocks have settled and the ADC is out of calibration
 #define STARTUP_LED_DELAY  4000
-			if ( time<= 1*STARTUP_LED_DELAY ) {
-				LED_On( LED0 );
+#define STARTUP_SETTLE     10			// 1ms at 10kHz tick
+			if ( time == 0 ) {
+				device_audio_enumerated();
+				startup_leds_play(STARTUP_LED_DELAY);
 				pdca_disable_interrupt_reload_counter_zero(PDCA_CHANNEL_SSC_RX);
 				pdca_disable(PDCA_CHANNEL_SSC_RX);
-			} else if( time== 2*STARTUP_LED_DELAY ) LED_On( LED1 );
-			else if( time== 3*STARTUP_LED_DELAY ) LED_On( LED2 );
-			else if( time== 4*STARTUP_LED_DELAY ) LED_On( LED3 );
-			else if( time== 5*STARTUP_LED_DELAY ) {
-				LED_Off( LED0 );
-			} else if( time== 6*STARTUP_LED_DELAY ) LED_Off( LED1 );
-			else if( time== 7*STARTUP_LED_DELAY ) LED_Off( LED2 );
-			else if( time== 8*STARTUP_LED_DELAY ) LED_Off( LED3 );
-			else if( time >= 9*STARTUP_LED_DELAY ) {
+				iq_in_left = 0;						// the endpoints start empty
+				out_received = 0;
+			}
+			time+=HPSDR_configTSK_USB_DAUDIO_PERIOD;
+			if ( time >= STARTUP_SETTLE && (!FEATURE_ADC_AK5394A || !gpio_get_pin_value(AK5394_CAL)) ) {
 				startup=FALSE;
 
 				audio_buffer_in = 0;
@@ -214,6 +285,13 @@ void hpsdr_device_audio_task(void *pvParameters)
 		}
 		*/
 
+		// the status the IN frames carry, their headers are rebuilt only
+		// when it changes
+		hpsdr_cc_set_status(cs_ptt, gpio_get_pin_value(GPIO_PTT_INPUT) == 0);
+		hpsdr_cc_set_status(cs_dot, gpio_get_pin_value(GPIO_CW_KEY_1) == 0);
+		hpsdr_cc_set_status(cs_dash, gpio_get_pin_value(GPIO_CW_KEY_2) == 0);
+		hpsdr_cc_set_status(cs_adc_overload, hpsdr_frame_overload());
+
 		//  Fill frames of 512 bytes and send to host
 
 		num_samples = 63;	// (512 bytes - 8 bytes (sync+command)) / 8 (6 bytes I/Q + 2 bytes Mic)
@@ -236,68 +314,51 @@ void hpsdr_device_audio_task(void *pvParameters)
 			gap = (AUDIO_BUFFER_SIZE - index) + (AUDIO_BUFFER_SIZE - num_remaining);
 		}
 
-		if ((Is_usb_in_ready(EP_IQ_IN)) && (gap > (num_samples * 2))) {
-			Usb_reset_endpoint_fifo_access(EP_IQ_IN);
-
-			// fill the 1st 8 bytes with SYNC and CONTROL as in HPSDR protocol
-			for (i=0; i < 3; i++) Usb_write_endpoint_data(EP_IQ_IN, 8, 0x7f);
-			for (i=0; i < 5; i++) Usb_write_endpoint_data(EP_IQ_IN, 8, command[j][i]);
-
-			j++;
-			if (j > 3) j = 0;
-
-			for( i=0 ; i < num_samples ; i++ ) {
-				// Fill endpoint with samples
-				if(!mute) {
-					if (audio_buffer_out == 0) {
-						sample_LSB = audio_buffer_0[index+IN_LEFT];
-						sample_SB = audio_buffer_0[index+IN_LEFT] >> 8;
-						sample_MSB = audio_buffer_0[index+IN_LEFT] >> 16;
-					} else {
-						sample_LSB = audio_buffer_1[index+IN_LEFT];
-						sample_SB = audio_buffer_1[index+IN_LEFT] >> 8;
-						sample_MSB = audio_buffer_1[index+IN_LEFT] >> 16;
-					}
-
-					Usb_write_endpoint_data(EP_IQ_IN, 8, sample_MSB);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, sample_SB);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, sample_LSB);
-
-
-					if (audio_buffer_out == 0) {
-						sample_LSB = audio_buffer_0[index+IN_RIGHT];
-						sample_SB = audio_buffer_0[index+IN_RIGHT] >> 8;
-						sample_MSB = audio_buffer_0[index+IN_RIGHT] >> 16;
-					} else {
-						sample_LSB = audio_buffer_1[index+IN_RIGHT];
-						sample_SB = audio_buffer_1[index+IN_RIGHT] >> 8;
-						sample_MSB = audio_buffer_1[index+IN_RIGHT] >> 16;
-					};
-
-					Usb_write_endpoint_data(EP_IQ_IN, 8, sample_MSB);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, sample_SB);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, sample_LSB);
-
-					index += 2;
-					if (index >= AUDIO_BUFFER_SIZE) {
-						index=0;
-						audio_buffer_out = 1 - audio_buffer_out;
-					}
-				} else {
-					Usb_write_endpoint_data(EP_IQ_IN, 8, 0x00);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, 0x00);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, 0x00);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, 0x00);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, 0x00);
-					Usb_write_endpoint_data(EP_IQ_IN, 8, 0x00);
+		// count each time reader and writer come within a margin of each
+		// other, while the host is reading
+#define MIC_GAP_MARGIN	(AUDIO_BUFFER_SIZE / 8)
+		if (Is_usb_in_ready(EP_IQ_IN)) {
+			if (gap < MIC_GAP_MARGIN && mic_gap >= MIC_GAP_MARGIN)
+				STREAM_HEALTH_COUNT(sh_mic_underrun);
+			else if (gap > 2*AUDIO_BUFFER_SIZE - MIC_GAP_MARGIN && mic_gap <= 2*AUDIO_BUFFER_SIZE - MIC_GAP_MARGIN)
+				STREAM_HEALTH_COUNT(sh_mic_overrun);
+			mic_gap = gap;
+		}
 
+		// as many frames as the banks take and the samples allow, so 192 kHz
+		// keeps up even when the task runs late, after the rest of a frame
+		// begun at full speed
+		for (frames = 0; frames < HPSDR_FRAMES_PER_WAKEUP && hpsdr_iq_in_send(EP_IQ_IN)
+				 && Is_usb_in_ready(EP_IQ_IN) && gap > (num_samples * 2); frames++) {
+			wp = hpsdr_frame_begin(iq_frame);
+			correct = iq_correction_latch();		// one matrix a frame
+
+			// the samples of a frame may run over into the other buffer
+			for (left = num_samples; left > 0; left -= run) {
+				run = min(left, (AUDIO_BUFFER_SIZE - index) / 2);
+				src = (audio_buffer_out == 0 ? audio_buffer_0 : audio_buffer_1) + index;
+				if (mute)
+					wp = hpsdr_frame_put_silence(wp, run);
+				else {
+					if (!FEATURE_MIC_NONE)
+						hpsdr_mic_run(&mic_filter, src, run, FEATURE_MIC_LEFT ? 0 : 1,
+									  current_freq.frequency / HPSDR_OUT_RATE, mic_slots + num_samples - left);
+					if (correct)
+						iq_correction_run(src, run, IN_LEFT, IN_RIGHT);
+					wp = hpsdr_frame_put(wp, src, run, IN_LEFT, IN_RIGHT, mic_slots + num_samples - left);
+				}
+				index += 2 * run;
+				if (index >= AUDIO_BUFFER_SIZE) {
+					index = 0;
+					audio_buffer_out = 1 - audio_buffer_out;
 				}
-				// 2 bytes of Mic input data
-				Usb_write_endpoint_data(EP_IQ_IN, 8, 0x00);
-				Usb_write_endpoint_data(EP_IQ_IN, 8, 0x00);
-
 			}
-			Usb_ack_in_ready_send(EP_IQ_IN);		// send the current bank
+
+			iq_in_next = iq_frame;
+			iq_in_left = HPSDR_FRAME_BYTES;
+			hpsdr_iq_in_send(EP_IQ_IN);
+			if (!startup) device_audio_first_sample(DEVICE_AUDIO_RECORD);
+			gap -= num_samples * 2;
 		}	// end if in ready
 
 
@@ -317,92 +378,59 @@ void hpsdr_device_audio_task(void *pvParameters)
 
 		num_samples = 63;
 
-		if (Is_usb_out_received(EP_IQ_OUT) && (Usb_byte_count(EP_IQ_OUT) >= 8)) {
-
-			Usb_reset_endpoint_fifo_access(EP_IQ_OUT);
-
-			// read the first 8 bytes of command for now
-			for (i=0; i < 8; i++) command_out[i] = Usb_read_endpoint_data(EP_IQ_OUT, 8);
-
-			if ( (command_out[0] & 0xfe) == 0) {
-				switch (command_out[1] & 0x03) {
-				case 0:
-					if (current_freq.frequency != 48000) {
-						current_freq.frequency = 48000;
-						freq_changed = TRUE;
-					}
-					break;
-				case 1:
-					if (current_freq.frequency != 96000) {
-						current_freq.frequency = 96000;
-						freq_changed = TRUE;
-					}
-					break;
-				case 2:
-					if (current_freq.frequency != 192000) {
-						current_freq.frequency = 192000;
-						freq_changed = TRUE;
-					}
-					break;
-				default:
-					break;
-				}
+		if (hpsdr_out_receive(EP_IQ_OUT)) {
+
+			if (!startup) device_audio_first_sample(DEVICE_AUDIO_PLAYBACK);
+
+			// whole frames only, a frame out of sync is dropped rather than
+			// played shifted
+			if (!hpsdr_frame_parse_header(out_frame, command_out)) {
+				STREAM_HEALTH_COUNT(sh_out_sync);
+				continue;
 			}
 
-			/*
-			  for (i = 0; i < num_samples; i++){
-
-			  // skip audio left and right samples
-			  Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  Usb_read_endpoint_data(EP_IQ_OUT, 8);
-
-			  if (spk_mute) {
-			  Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  sample_LSB = 0;
-			  sample_SB = 0;
-			  sample_MSB = 0;
-			  } else {
-			  // read left IQ out 16 bits
-			  sample_MSB = Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  sample_SB = Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  sample_LSB = 0;
-			  };
-
-			  sample = (((U32) sample_MSB) << 16) + (((U32)sample_SB) << 8) + sample_LSB;
-			  if (spk_buffer_in == 0) spk_buffer_0[spk_index+OUT_LEFT] = sample;
-			  else spk_buffer_1[spk_index+OUT_LEFT] = sample;
-
-			  if (spk_mute) {
-			  Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  sample_LSB = 0;
-			  sample_SB = 0;
-			  sample_MSB = 0;
-			  } else {
-			  // read right IQ out 16 bits
-			  sample_MSB = Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  sample_SB = Usb_read_endpoint_data(EP_IQ_OUT, 8);
-			  sample_LSB = 0;
-			  };
-
-			  sample = (((U32) sample_MSB) << 16) + (((U32)sample_SB) << 8) + sample_LSB;
-			  if (spk_buffer_in == 0) spk_buffer_0[spk_index+OUT_RIGHT] = sample;
-			  else spk_buffer_1[spk_index+OUT_RIGHT] = sample;
-
-			  spk_index += 2;
-			  if (spk_index >= SPK_BUFFER_SIZE){
-			  spk_index = 0;
-			  spk_buffer_in = 1 - spk_buffer_in;
-			  }
-			  }
-
-			*/
-
-			Usb_ack_out_received_free(EP_IQ_OUT);
-		}	// end if out received
+			// the speaker gap counted only while frames come in
+#define SPK_GAP_MARGIN	(SPK_BUFFER_SIZE / 8)
+			if (gap < SPK_GAP_MARGIN && spk_gap >= SPK_GAP_MARGIN)
+				STREAM_HEALTH_COUNT(sh_spk_overrun);
+			else if (gap > 2*SPK_BUFFER_SIZE - SPK_GAP_MARGIN && spk_gap <= 2*SPK_BUFFER_SIZE - SPK_GAP_MARGIN)
+				STREAM_HEALTH_COUNT(sh_spk_underrun);
+			spk_gap = gap;
+
+			// into the register file whatever the address, then only what
+			// changed is applied
+			hpsdr_cc_decode(command_out);
+			if (hpsdr_cc_changed(cc_speed) && hpsdr_rates[hpsdr_cc_get(cc_speed)] != 0
+				&& hpsdr_rates[hpsdr_cc_get(cc_speed)] != current_freq.frequency) {
+				current_freq.frequency = hpsdr_rates[hpsdr_cc_get(cc_speed)];
+				freq_changed = TRUE;
+				STREAM_HEALTH_COUNT(sh_rate_change);
+			}
+
+			// the DAC plays the TX I/Q while transmitting, else the audio;
+			// the frame is at HPSDR_OUT_RATE, each sample repeated up to the
+			// DAC rate, and the samples of a frame may run over into the
+			// other buffer
+			source = hpsdr_cc_mox ? hpsdr_out_iq : hpsdr_out_audio;
+			repeat = current_freq.frequency / HPSDR_OUT_RATE;
+			spk_index -= spk_index % (2 * repeat);
+			rp = out_frame + HPSDR_CC_WORDS;
+			for (left = num_samples; left > 0; left -= run) {
+				run = min(left, (SPK_BUFFER_SIZE - spk_index) / (2 * repeat));
+				if (spk_mute) {
+					hpsdr_frame_get_silence((spk_buffer_in == 0 ? spk_buffer_0 : spk_buffer_1) + spk_index,
+											run * repeat);
+					rp += 2 * run;
+				} else
+					rp = hpsdr_frame_get(rp, (spk_buffer_in == 0 ? spk_buffer_0 : spk_buffer_1) + spk_index,
+										 run, OUT_LEFT, OUT_RIGHT, source, repeat);
+				spk_index += 2 * run * repeat;
+				if (spk_index >= SPK_BUFFER_SIZE) {
+					spk_index = 0;
+					spk_buffer_in = 1 - spk_buffer_in;
+				}
+			}
+		}	// end if out frame received
 
 
 	} // end while vTask
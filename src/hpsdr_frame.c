@@ -0,0 +1,122 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * hpsdr_frame.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * HPSDR Protocol-1 frames, see hpsdr_frame.h
+ */
+
+#include "compiler.h"
+#include "hpsdr_frame.h"
+
+static U32 hpsdr_frame_header[HPSDR_CC_SLOTS][2];	// wire order
+static U8 hpsdr_frame_slot;							// slot of the next IN frame
+static U32 hpsdr_frame_peak;						// bit 31 set by a sample near full scale
+
+void hpsdr_frame_set_status(U8 slot, const U8 *cc) {
+	hpsdr_frame_header[slot][0] = HPSDR_WIRE32(((U32)HPSDR_SYNC << 24) | ((U32)HPSDR_SYNC << 16)
+											   | ((U32)HPSDR_SYNC << 8) | cc[0]);
+	hpsdr_frame_header[slot][1] = HPSDR_WIRE32(((U32)cc[1] << 24) | ((U32)cc[2] << 16)
+											   | ((U32)cc[3] << 8) | cc[4]);
+}
+
+void hpsdr_frame_init(void) {
+	static const U8 zero[HPSDR_CC_BYTES];
+	U8 slot;
+
+	for (slot = 0; slot < HPSDR_CC_SLOTS; slot += 1)
+		hpsdr_frame_set_status(slot, zero);
+	hpsdr_frame_slot = 0;
+	hpsdr_frame_peak = 0;
+}
+
+U32 *hpsdr_frame_begin(U32 *frame) {
+	frame[0] = hpsdr_frame_header[hpsdr_frame_slot][0];
+	frame[1] = hpsdr_frame_header[hpsdr_frame_slot][1];
+	hpsdr_frame_slot = (hpsdr_frame_slot + 1) % HPSDR_CC_SLOTS;
+	return frame + 2;
+}
+
+//
+// I2 I1 I0 Q2 | Q1 Q0 M1 M0, the low 24 bits of each sample; the
+// magnitude of each, one's complement, ORed into the peak without a branch
+//
+U32 *hpsdr_frame_put(U32 *wp, const volatile U32 *src, U16 count, U8 left, U8 right,
+					 const S16 *mic) {
+	U32 i, q, peak = 0;
+	S32 v;
+
+	while (count--) {
+		i = src[left];
+		q = src[right];
+		src += 2;
+		*wp++ = HPSDR_WIRE32((i << 8) | ((q >> 16) & 0xff));
+		*wp++ = HPSDR_WIRE32((q << 16) | (U16)*mic++);
+		v = i << 8;
+		peak |= (v ^ (v >> 31)) + (HPSDR_OVERLOAD_MARGIN << 8);
+		v = q << 8;
+		peak |= (v ^ (v >> 31)) + (HPSDR_OVERLOAD_MARGIN << 8);
+	}
+	hpsdr_frame_peak |= peak;
+	return wp;
+}
+
+Bool hpsdr_frame_overload(void) {
+	Bool overload = hpsdr_frame_peak >> 31;
+
+	hpsdr_frame_peak = 0;
+	return overload;
+}
+
+U32 *hpsdr_frame_put_silence(U32 *wp, U16 count) {
+	while (count--) {
+		*wp++ = 0;
+		*wp++ = 0;
+	}
+	return wp;
+}
+
+Bool hpsdr_frame_parse_header(const U32 *frame, U8 *cc) {
+	U32 w0 = HPSDR_WIRE32(frame[0]), w1 = HPSDR_WIRE32(frame[1]);
+
+	if ((w0 >> 8) != (((U32)HPSDR_SYNC << 16) | ((U32)HPSDR_SYNC << 8) | HPSDR_SYNC))
+		return FALSE;
+	cc[0] = w0;
+	cc[1] = w1 >> 24;
+	cc[2] = w1 >> 16;
+	cc[3] = w1 >> 8;
+	cc[4] = w1;
+	return TRUE;
+}
+
+//
+// L1 L0 R1 R0 | I1 I0 Q1 Q0, each 16 bit sample to the top of a 24 bit one
+//
+const U32 *hpsdr_frame_get(const U32 *rp, volatile U32 *dst, U16 count,
+						   U8 left, U8 right, hpsdr_out_source_t source, U8 repeat) {
+	U32 w, l, r;
+	U8 k;
+
+	rp += source;
+	while (count--) {
+		w = HPSDR_WIRE32(*rp);
+		rp += 2;
+		l = (w >> 8) & 0xffff00;
+		r = (w << 8) & 0xffff00;
+		for (k = repeat; k > 0; k -= 1) {
+			dst[left] = l;
+			dst[right] = r;
+			dst += 2;
+		}
+	}
+	return rp - source;
+}
+
+void hpsdr_frame_get_silence(volatile U32 *dst, U16 pairs) {
+	while (pairs--) {
+		*dst++ = 0;
+		*dst++ = 0;
+	}
+}
@@ -0,0 +1,100 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * hpsdr_frame.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * HPSDR Protocol-1 (Ozy) frames of the IQ endpoints, 512 bytes each:
+ *
+ *   0x7f 0x7f 0x7f C0 C1 C2 C3 C4		sync and command & control
+ *   63 times I2 I1 I0 Q2 Q1 Q0 M1 M0	24 bit I and Q, 16 bit mic, MSB first
+ *
+ * The IN frames are built a word at a time in RAM and go to the FIFO in
+ * one usb_write_ep_txpacket() at high speed, in 64 byte packets at full
+ * speed. The sync and C&C bytes of each of the HPSDR_CC_SLOTS status
+ * addresses the IN frames rotate through are kept as two ready made
+ * header words, so a frame costs 2 stores of header and 2 stores per
+ * sample set. hpsdr_frame_set_status() rebuilds the header
+ * of one slot when its status changes.
+ *
+ * The OUT frames from the host have the same header, then
+ *
+ *   63 times L1 L0 R1 R0 I1 I0 Q1 Q0	16 bit audio and TX I/Q, MSB first
+ *
+ * always at HPSDR_OUT_RATE. They are read into RAM a packet at a time,
+ * one at high speed, eight at full speed, and unpacked a word per sample
+ * set: the L/R audio while receiving, the I/Q pair while C0 has MOX set. At higher
+ * DAC rates each sample is repeated to make up the rate. The
+ * hpsdr-frame-check host tool plays recorded frames through the parser.
+ */
+
+#ifndef HPSDR_FRAME_H_
+#define HPSDR_FRAME_H_
+
+#include "compiler.h"
+
+#define HPSDR_FRAME_BYTES		512
+#define HPSDR_FRAME_WORDS		(HPSDR_FRAME_BYTES/4)
+#define HPSDR_CC_WORDS			2		// sync and C0 to C4, ahead of the sample sets
+#define HPSDR_FRAME_SAMPLES		63		// (512 - 8) / 8
+#define HPSDR_SYNC				0x7f
+#define HPSDR_CC_BYTES			5		// C0 to C4
+#define HPSDR_CC_SLOTS			5		// status addresses the IN frames rotate through
+#define HPSDR_OUT_RATE			48000	// of the OUT frame samples, whatever the IQ rate
+#define HPSDR_C0_MOX			0x01	// C0 of OUT frames: transmitting
+#define HPSDR_OVERLOAD_MARGIN	0x100	// of a 24 bit sample to full scale, ADC overload
+
+// the bulk endpoints of the Ozy interface, hpsdr_usb_descriptors.h sizes
+// them from here: a frame is one packet at high speed, full speed bulk
+// packets are 64 bytes at most
+#define HPSDR_EP_SIZE_HS		HPSDR_FRAME_BYTES
+#define HPSDR_EP_SIZE_FS		64
+
+// the pair of an OUT sample set that goes to the DAC, its word in the set
+typedef enum {
+	hpsdr_out_audio = 0,		// L/R audio
+	hpsdr_out_iq = 1			// TX I/Q
+} hpsdr_out_source_t;
+
+// a word as it goes over the wire, most significant byte first
+#if LITTLE_ENDIAN_MCU
+#define HPSDR_WIRE32(u32)		swap32(u32)
+#else
+#define HPSDR_WIRE32(u32)		((U32)(u32))
+#endif
+
+// C0 to C4 of the IN frames of one slot
+extern void hpsdr_frame_set_status(U8 slot, const U8 *cc);
+extern void hpsdr_frame_init(void);
+
+// start a frame with the header of the next slot, returns where the
+// samples go
+extern U32 *hpsdr_frame_begin(U32 *frame);
+
+// append count sample sets from src, I from src[left] and Q from
+// src[right] of each stereo pair of 24 bit samples, a mic sample each
+// from mic
+extern U32 *hpsdr_frame_put(U32 *wp, const volatile U32 *src, U16 count, U8 left, U8 right,
+							const S16 *mic);
+
+// whether a sample put since the last call came within
+// HPSDR_OVERLOAD_MARGIN of full scale
+extern Bool hpsdr_frame_overload(void);
+
+// append count sample sets of silence
+extern U32 *hpsdr_frame_put_silence(U32 *wp, U16 count);
+
+// check the sync of a received frame and copy out its C0 to C4
+extern Bool hpsdr_frame_parse_header(const U32 *frame, U8 *cc);
+
+// unpack count sample sets from rp, source selects the pair, into stereo
+// pairs at dst, dst[left] and dst[right], each repeat times; returns the
+// next sample set
+extern const U32 *hpsdr_frame_get(const U32 *rp, volatile U32 *dst, U16 count,
+								  U8 left, U8 right, hpsdr_out_source_t source, U8 repeat);
+
+// pairs stereo pairs of silence at dst
+extern void hpsdr_frame_get_silence(volatile U32 *dst, U16 pairs);
+
+#endif /* HPSDR_FRAME_H_ */
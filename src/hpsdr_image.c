@@ -41,6 +41,11 @@
 #include "taskMoboCtrl.h"
 #include "taskPowerDisplay.h"
 #include "taskPushButtonMenu.h"
+#include "taskRunStats.h"
+#include "eventlog.h"
+#include "dg8saq_queue.h"
+#include "taskStartupLeds.h"
+#include "ram_budget.h"
 #include "device_audio_task.h"
 #include "hpsdr_device_audio_task.h"
 #include "wdt.h"
@@ -68,6 +73,9 @@ static void x_image_init(void) {
 }
 
 static void x_image_task_init(void) {
+  // Control requests answered without polling EP0
+  usb_ctrl_register(DRT_MASK, DRT_VENDOR, usb_user_DG8SAQ);
+
   // Initialize USB task
   usb_task_init();
 
@@ -81,13 +89,18 @@ static void x_image_task_init(void) {
   vStartTaskPushButtonMenu();
   #endif
   vStartTaskMoboCtrl();
+  vStartTaskDG8SAQ();
   // vStartTaskEXERCISE( tskIDLE_PRIORITY );
   hpsdr_AK5394A_task_init();
   hpsdr_device_audio_task_init(HPSDR_EP_IQ_IN, HPSDR_EP_IQ_OUT, 0);
+  vStartTaskRunStats();
+  vStartTaskEventLog();
+  vStartTaskStartupLeds();
 #endif
 #if LCD_DISPLAY						// Multi-line LCD display
   vStartTaskStartupLogDisplay();
 #endif
+  ram_budget_report();
 }
 
 // descriptor accessors
@@ -127,9 +140,6 @@ static uint16_t x_image_get_qualifier_desc_length(void) {
 static void x_image_user_endpoint_init(uint8_t conf_nb) {
 	hpsdr_user_endpoint_init(conf_nb);
 }
-static Bool x_image_user_read_request(uint8_t type, uint8_t request) {
-	return hpsdr_user_read_request(type, request);
-}
 static void x_image_user_set_interface(U8 wIndex, U8 wValue) {
 	hpsdr_user_set_interface(wIndex, wValue);
 }
@@ -156,7 +166,6 @@ const image_t hpsdr_image = {
 	NULL,
 #endif
 	x_image_user_endpoint_init,
-	x_image_user_read_request,
 	x_image_user_set_interface
 };
 
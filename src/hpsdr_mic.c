@@ -0,0 +1,88 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * hpsdr_mic.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Mic samples of the HPSDR IN frames, see hpsdr_mic.h
+ */
+
+#include "compiler.h"
+#include "hpsdr_mic.h"
+
+//
+// Q15, weighted least squares to 1 / CIC response up to HPSDR_MIC_PASS
+// and 0 from HPSDR_MIC_STOP, stop band weighted 10, for ratio 1, 2 and 4
+//
+static const S16 hpsdr_mic_taps[HPSDR_MIC_RATIOS][HPSDR_MIC_TAPS] = {
+	{ 60, 146, -41, -432, -187, 855, 875, -1323, -2607, 1692, 10113, 14551,
+	  10113, 1692, -2607, -1323, 875, 855, -187, -432, -41, 146, 60 },
+	{ 75, 187, -41, -545, -272, 1046, 1187, -1487, -3395, 1140, 10664, 15756,
+	  10664, 1140, -3395, -1487, 1187, 1046, -272, -545, -41, 187, 75 },
+	{ 79, 198, -41, -576, -297, 1098, 1276, -1526, -3607, 988, 10810, 16080,
+	  10810, 988, -3607, -1526, 1276, 1098, -297, -576, -41, 198, 79 }
+};
+
+static void hpsdr_mic_reset(hpsdr_mic_t *mp, U8 ratio) {
+	U8 k;
+
+	mp->ratio = ratio;
+	mp->phase = 0;
+	mp->pos = 0;
+	mp->held = 0;
+	for (k = 0; k < HPSDR_MIC_ORDER; k += 1) {
+		mp->integrator[k] = 0;
+		mp->comb[k] = 0;
+	}
+	for (k = 0; k < 2 * HPSDR_MIC_TAPS; k += 1)
+		mp->history[k] = 0;
+}
+
+void hpsdr_mic_run(hpsdr_mic_t *mp, const volatile U32 *src, U16 count, U8 channel,
+				   U8 ratio, S16 *mic) {
+	const S16 *taps, *hp;
+	U32 x, t;
+	S32 acc;
+	U8 k, index, shift;
+
+	if (mp->ratio != ratio)
+		hpsdr_mic_reset(mp, ratio);
+	index = ratio == 4 ? 2 : ratio - 1;			// log2 of 1, 2 and 4
+	taps = hpsdr_mic_taps[index];
+	shift = 8 + HPSDR_MIC_ORDER * index;		// 24 bits and the CIC gain down to 16
+
+	src += channel;
+	while (count--) {
+		// the integrators at the IQ rate, 24 bit sign extended
+		x = (U32)((S32)(*src << 8) >> 8);
+		src += 2;
+		for (k = 0; k < HPSDR_MIC_ORDER; k += 1)
+			x = mp->integrator[k] += x;
+		HPSDR_MIC_WORK(inputs, 1);
+
+		if (++mp->phase == ratio) {
+			mp->phase = 0;
+
+			// the combs at 48 kHz
+			for (k = 0; k < HPSDR_MIC_ORDER; k += 1) {
+				t = x;
+				x -= mp->comb[k];
+				mp->comb[k] = t;
+			}
+
+			// the FIR, oldest input first, the taps are symmetric so each
+			// pair of inputs shares a MAC
+			mp->history[mp->pos] = mp->history[mp->pos + HPSDR_MIC_TAPS] = (S16)((S32)x >> shift);
+			mp->pos = mp->pos + 1 == HPSDR_MIC_TAPS ? 0 : mp->pos + 1;
+			hp = &mp->history[mp->pos];
+			acc = (1 << 14) + (S32)taps[HPSDR_MIC_TAPS / 2] * hp[HPSDR_MIC_TAPS / 2];
+			for (k = 0; k < HPSDR_MIC_TAPS / 2; k += 1)
+				acc += (S32)taps[k] * (hp[k] + hp[HPSDR_MIC_TAPS - 1 - k]);
+			acc >>= 15;
+			mp->held = acc > 32767 ? 32767 : acc < -32768 ? -32768 : acc;
+			HPSDR_MIC_WORK(outputs, 1);
+		}
+		*mic++ = mp->held;
+	}
+}
@@ -0,0 +1,57 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * hpsdr_mic.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The mic samples of the HPSDR IN frames, from one channel of the ADC.
+ *
+ * The mic slots of the frames are at HPSDR_OUT_RATE whatever the IQ rate,
+ * so the channel is decimated by the IQ rate over 48 kHz, 1, 2 or 4: a
+ * HPSDR_MIC_ORDER CIC filter, then a HPSDR_MIC_TAPS FIR at 48 kHz that
+ * makes up the CIC droop to HPSDR_MIC_PASS Hz and stops from
+ * HPSDR_MIC_STOP Hz. Each mic sample goes into the slots of all the IQ
+ * sample sets until the next, so a client may take any one of every
+ * ratio slots.
+ *
+ * All fixed point: the CIC in wrapping 32 bit, which a 24 bit sample at a
+ * gain of 4^HPSDR_MIC_ORDER just fits, the FIR on 16 bit samples with
+ * Q15 coefficients, the taps designed by weighted least squares for each
+ * ratio. The hpsdr-frame-check host tool measures the response and the
+ * work per frame.
+ */
+
+#ifndef HPSDR_MIC_H_
+#define HPSDR_MIC_H_
+
+#include "compiler.h"
+
+#define HPSDR_MIC_ORDER		4		// CIC stages
+#define HPSDR_MIC_TAPS		23		// FIR taps, odd and symmetric
+#define HPSDR_MIC_RATIOS	3		// 1, 2 and 4
+#define HPSDR_MIC_PASS		8000	// Hz, flat to 0.2 dB
+#define HPSDR_MIC_STOP		14000	// Hz, 50 dB down
+
+// the work the host check counts, nothing in the firmware
+#ifndef HPSDR_MIC_WORK
+#define HPSDR_MIC_WORK(what, n)
+#endif
+
+typedef struct {
+	U8 ratio;							// IQ rate over the mic rate the filters run at
+	U8 phase;							// input samples into the current output
+	U8 pos;								// of the next FIR input
+	S16 held;							// the last mic sample
+	U32 integrator[HPSDR_MIC_ORDER];
+	U32 comb[HPSDR_MIC_ORDER];			// the last input of each comb
+	S16 history[2 * HPSDR_MIC_TAPS];	// FIR inputs, twice so the taps read straight
+} hpsdr_mic_t;
+
+// decimate count samples of one channel, src[channel] of each stereo pair
+// of 24 bit samples, at ratio times 48 kHz; the mic sample that goes with
+// each into mic. A new ratio starts the filters over.
+extern void hpsdr_mic_run(hpsdr_mic_t *mp, const volatile U32 *src, U16 count, U8 channel,
+						  U8 ratio, S16 *mic);
+
+#endif /* HPSDR_MIC_H_ */
@@ -52,6 +52,7 @@
 #include "hpsdr_device_audio_task.h"
 #include "taskAK5394A.h"
 #include "uac2_taskAK5394A.h"
+#include "ram_budget.h"
 
 //_____ M A C R O S ________________________________________________________
 
@@ -68,12 +69,12 @@ void hpsdr_AK5394A_task(void*);
 void hpsdr_AK5394A_task_init(void) {
 	current_freq.frequency = 48000;
 	AK5394A_task_init(TRUE);
-	xTaskCreate(hpsdr_AK5394A_task,
+	ram_budget_task_create(hpsdr_AK5394A_task,
 				configTSK_AK5394A_NAME,
 				configTSK_AK5394A_STACK_SIZE,
 				NULL,
 				HPSDR_configTSK_AK5394A_PRIORITY,
-				NULL);
+				ram_budget_AK5394A_stack);
 }
 
 //!
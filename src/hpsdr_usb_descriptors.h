@@ -39,6 +39,7 @@
 
 #include "conf_usb.h"
 #include "usb_descriptors.h"
+#include "hpsdr_frame.h"
 
 #if USB_DEVICE_FEATURE == DISABLED
   #error hpsdr_usb_descriptors.h is #included although USB_DEVICE_FEATURE is disabled
@@ -74,8 +75,8 @@
 // USB Endpoint 1 descriptor
 #define ENDPOINT_NB_1       ( HPSDR_EP_RF_IN | MSK_EP_DIR )
 #define EP_ATTRIBUTES_1		TYPE_BULK
-#define EP_IN_LENGTH_1_FS	512
-#define EP_IN_LENGTH_1_HS	512
+#define EP_IN_LENGTH_1_FS	HPSDR_EP_SIZE_FS
+#define EP_IN_LENGTH_1_HS	HPSDR_EP_SIZE_HS
 #define EP_SIZE_1_FS		EP_IN_LENGTH_1_FS
 #define EP_SIZE_1_HS        EP_IN_LENGTH_1_HS
 #define EP_INTERVAL_1_FS	0x01			 // one packet per frame, each uF 1ms, so only 48khz
@@ -85,8 +86,8 @@
 // USB Endpoint 2 descriptor
 #define ENDPOINT_NB_2       ( HPSDR_EP_IQ_IN | MSK_EP_DIR )
 #define EP_ATTRIBUTES_2     TYPE_BULK
-#define EP_OUT_LENGTH_2_FS	64
-#define EP_OUT_LENGTH_2_HS  512
+#define EP_OUT_LENGTH_2_FS	HPSDR_EP_SIZE_FS
+#define EP_OUT_LENGTH_2_HS  HPSDR_EP_SIZE_HS
 #define EP_SIZE_2_FS		EP_OUT_LENGTH_2_FS
 #define EP_SIZE_2_HS        EP_OUT_LENGTH_2_HS
 #define EP_INTERVAL_2_FS	0x00
@@ -96,8 +97,8 @@
 // USB Endpoint 3 descriptor
 #define ENDPOINT_NB_3       (HPSDR_EP_IQ_OUT)
 #define EP_ATTRIBUTES_3     TYPE_BULK
-#define EP_IN_LENGTH_3_FS   64
-#define EP_IN_LENGTH_3_HS	512
+#define EP_IN_LENGTH_3_FS   HPSDR_EP_SIZE_FS
+#define EP_IN_LENGTH_3_HS	HPSDR_EP_SIZE_HS
 #define EP_SIZE_3_FS		EP_IN_LENGTH_3_FS
 #define EP_SIZE_3_HS        EP_IN_LENGTH_3_HS
 #define EP_INTERVAL_3_FS	0x00
@@ -106,11 +106,6 @@
 // S_freq current_freq;
 // Bool freq_changed = FALSE;
 
-static U8    wValue_msb;
-static U8    wValue_lsb;
-static U16   wIndex;
-static U16   wLength;
-
 //_____ D E C L A R A T I O N S ____________________________________________
 
 
@@ -136,21 +131,4 @@ void hpsdr_user_endpoint_init(U8 conf_nb)
 void hpsdr_user_set_interface(U8 wIndex, U8 wValue) {
 }
 
-//! This function is called by the standard USB read request function when
-//! the USB request is not supported. This function returns TRUE when the
-//! request is processed. This function returns FALSE if the request is not
-//! supported. In this case, a STALL handshake will be automatically
-//! sent by the standard USB read request function.
-//!
-Bool hpsdr_user_read_request(U8 type, U8 request)
-{
-   // Read wValue
-   wValue_lsb = Usb_read_endpoint_data(EP_CONTROL, 8);
-   wValue_msb = Usb_read_endpoint_data(EP_CONTROL, 8);
-   wIndex = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-   wLength = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-
-   return FALSE;  // No supported request
-}
-
 #endif  // USB_DEVICE_FEATURE == ENABLED
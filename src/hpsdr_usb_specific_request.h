@@ -51,14 +51,6 @@ extern void hpsdr_user_endpoint_init(U8);
 
 extern void hpsdr_user_set_interface(U8 wIndex, U8 wValue);
 
-//! This function is called by the standard USB read request function when
-//! the USB request is not supported. This function returns TRUE when the
-//! request is processed. This function returns FALSE if the request is not
-//! supported. In this case, a STALL handshake will be automatically
-//! sent by the standard USB read request function.
-//!
-extern Bool hpsdr_user_read_request(U8, U8);
-
 //! @}
 
 
@@ -78,9 +78,6 @@ uint16_t image_get_qualifier_desc_length(void) {
 void image_user_endpoint_init(uint8_t conf_nb) {
 	image->user_endpoint_init(conf_nb);
 }
-Bool image_user_read_request(uint8_t type, uint8_t request) {
-	return image->user_read_request(type, request);
-}
 void image_user_set_interface(U8 wIndex, U8 wValue) {
 	image->user_set_interface(wIndex, wValue);
 }
@@ -38,7 +38,6 @@ typedef struct {
 	uint16_t (*get_qualifier_desc_length)(void);
 	// usb specific request handling
 	void (*user_endpoint_init)(uint8_t conf_nb);
-	Bool (*user_read_request)(uint8_t type, uint8_t request);
 	void (*user_set_interface)(U8 wIndex, U8 wValue);
 } image_t;
 
@@ -64,7 +63,6 @@ extern uint8_t *image_get_qualifier_desc_pointer(void);
 extern uint16_t image_get_qualifier_desc_length(void);
 // usb specific request handling
 extern void image_user_endpoint_init(uint8_t conf_nb);
-extern Bool image_user_read_request(uint8_t type, uint8_t request);
 extern void image_user_set_interface(U8 wIndex, U8 wValue);
 
 //
@@ -0,0 +1,163 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * iq_correction.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * IQ imbalance correction, see iq_correction.h
+ */
+
+#include "compiler.h"
+#include "flashc.h"
+#include "widget.h"
+#include "taskAK5394A.h"
+#include "iq_correction.h"
+
+#define IQ_CORRECTION_MAGIC		0x4951		// "IQ", anything else is no matrix saved
+#define IQ_CORRECTION_MAX		0x7fffff	// of a 24 bit sample
+
+typedef struct {
+	U16 magic;
+	S16 matrix[4];
+} iq_correction_nvram_t;
+
+// next to features_nvram in the flash user page
+#if defined (__GNUC__)
+__attribute__((__section__(".userpage")))
+#endif
+iq_correction_nvram_t iq_correction_nvram;
+
+static const S16 iq_correction_identity[4] = { IQ_CORRECTION_ONE, 0, 0, IQ_CORRECTION_ONE };
+
+// written only by the vendor request: the staged coefficients, and the
+// applied matrix with a serial that is odd while it is being written
+static S16 iq_correction_staged[4];
+static S16 iq_correction_applied[4];
+static volatile U16 iq_correction_serial;
+
+// written only by the audio task: the matrix in effect and its serial
+static S16 iq_correction_matrix[4];
+static U16 iq_correction_latched;
+static Bool iq_correction_active;
+
+static void iq_correction_copy(S16 *dst, const S16 *src) {
+	U8 k;
+
+	for (k = 0; k < 4; k += 1)
+		dst[k] = src[k];
+}
+
+static Bool iq_correction_is_identity(const S16 *m) {
+	return m[0] == IQ_CORRECTION_ONE && m[1] == 0 && m[2] == 0 && m[3] == IQ_CORRECTION_ONE;
+}
+
+static void iq_correction_apply(void) {
+	iq_correction_serial += 1;
+	iq_correction_copy(iq_correction_applied, iq_correction_staged);
+	iq_correction_serial += 1;
+}
+
+// forget the saved matrix, the identity from the next boot on
+static void iq_correction_factory_reset_handler(void) {
+	flashc_memset8((void *)&iq_correction_nvram, 0, sizeof(iq_correction_nvram.magic), TRUE);
+}
+
+void iq_correction_init(void) {
+	iq_correction_copy(iq_correction_staged,
+					   iq_correction_nvram.magic == IQ_CORRECTION_MAGIC ?
+					   iq_correction_nvram.matrix : iq_correction_identity);
+	iq_correction_apply();
+	iq_correction_copy(iq_correction_matrix, iq_correction_identity);
+	iq_correction_latched = 0;
+	iq_correction_active = FALSE;
+	widget_factory_reset_handler_register(iq_correction_factory_reset_handler);
+}
+
+//
+// a copy torn by a request coming in between is thrown away and the
+// old matrix kept, the next packet takes the new one
+//
+Bool iq_correction_latch(void) {
+	U16 serial = iq_correction_serial;
+	S16 m[4];
+
+	if (serial == iq_correction_latched || (serial & 1) != 0)
+		return iq_correction_active;
+	iq_correction_copy(m, iq_correction_applied);
+	if (serial != iq_correction_serial)
+		return iq_correction_active;
+	iq_correction_copy(iq_correction_matrix, m);
+	iq_correction_latched = serial;
+	iq_correction_active = !iq_correction_is_identity(m);
+	return iq_correction_active;
+}
+
+//
+// 24 by 16 bit products into 64 bits, as mulsd and macsd do, rounded
+// back to Q0 and saturated to 24 bits
+//
+void iq_correction_run(volatile U32 *buf, U16 count, U8 left, U8 right) {
+	S32 a = iq_correction_matrix[0], b = iq_correction_matrix[1];
+	S32 c = iq_correction_matrix[2], d = iq_correction_matrix[3];
+	S32 i, q;
+	S64 acc;
+
+	IQ_CORRECTION_WORK(runs, 1);
+	IQ_CORRECTION_WORK(pairs, count);
+	while (count--) {
+		i = (S32)(buf[left] << 8) >> 8;
+		q = (S32)(buf[right] << 8) >> 8;
+		acc = ((S64)a * i + (S64)b * q + (1 << 13)) >> 14;
+		buf[left] = acc > IQ_CORRECTION_MAX ? IQ_CORRECTION_MAX : acc < -IQ_CORRECTION_MAX - 1 ? -IQ_CORRECTION_MAX - 1 : acc;
+		acc = ((S64)c * i + (S64)d * q + (1 << 13)) >> 14;
+		buf[right] = acc > IQ_CORRECTION_MAX ? IQ_CORRECTION_MAX : acc < -IQ_CORRECTION_MAX - 1 ? -IQ_CORRECTION_MAX - 1 : acc;
+		buf += 2;
+	}
+}
+
+void iq_correction_ahead(U8 audio_buffer_out, U32 index, U16 count, U8 left, U8 right) {
+	U16 run;
+
+	while (count > 0) {
+		run = min(count, (AUDIO_BUFFER_SIZE - index) / 2);
+		iq_correction_run((audio_buffer_out == 0 ? audio_buffer_0 : audio_buffer_1) + index, run, left, right);
+		count -= run;
+		index = 0;
+		audio_buffer_out = 1 - audio_buffer_out;
+	}
+}
+
+U8 iq_correction_request(U16 operation, U16 value, U8 *buffer) {
+	iq_correction_nvram_t saved;
+	U8 flags = 0, k;
+
+	if (operation >= IQ_CORRECTION_SET_A && operation < IQ_CORRECTION_SET_A + 4)
+		iq_correction_staged[operation - IQ_CORRECTION_SET_A] = (S16)value;
+	else if (operation == IQ_CORRECTION_APPLY)
+		iq_correction_apply();
+	else if (operation == IQ_CORRECTION_SAVE) {
+		iq_correction_apply();
+		saved.magic = IQ_CORRECTION_MAGIC;
+		iq_correction_copy(saved.matrix, iq_correction_staged);
+		flashc_memcpy((void *)&iq_correction_nvram, &saved, sizeof(saved), TRUE);
+	} else if (operation == IQ_CORRECTION_IDENTITY) {
+		iq_correction_copy(iq_correction_staged, iq_correction_identity);
+		iq_correction_apply();
+	} else if (operation != IQ_CORRECTION_READ)
+		flags |= IQ_CORRECTION_FLAG_BAD_OP;
+
+	if (!iq_correction_is_identity(iq_correction_applied))
+		flags |= IQ_CORRECTION_FLAG_ACTIVE;
+	if (iq_correction_nvram.magic == IQ_CORRECTION_MAGIC)
+		flags |= IQ_CORRECTION_FLAG_SAVED;
+	buffer[0] = IQ_CORRECTION_VERSION;
+	buffer[1] = flags;
+	for (k = 0; k < 4; k += 1) {
+		buffer[2+2*k] = LSB(iq_correction_applied[k]);
+		buffer[3+2*k] = MSB(iq_correction_applied[k]);
+		buffer[10+2*k] = LSB(iq_correction_staged[k]);
+		buffer[11+2*k] = MSB(iq_correction_staged[k]);
+	}
+	return IQ_CORRECTION_RECORD_SIZE;
+}
@@ -0,0 +1,82 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * iq_correction.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * IQ amplitude and phase imbalance correction of the record stream of the
+ * SDR images, a 2x2 matrix on each pair before it goes out:
+ *
+ *   I' = a * I + b * Q
+ *   Q' = c * I + d * Q
+ *
+ * a to d are Q14, IQ_CORRECTION_ONE is 1.0, the identity is the default and
+ * costs nothing. The matrix a packet is corrected with is taken once at
+ * its start, so a new one never lands halfway into a packet. A gain error g
+ * and phase error p in Q, Q = g * sin(wt + p), take a = 1, b = 0,
+ * c = -tan(p), d = 1 / (g * cos(p)).
+ *
+ * The matrix is set with a DG8SAQ vendor IN request:
+ *   bRequest = IQ_CORRECTION_DG8SAQ_COMMAND, wIndex = operation,
+ *   wValue = the coefficient for IQ_CORRECTION_SET_A to IQ_CORRECTION_SET_D
+ * The SET operations only stage a coefficient, IQ_CORRECTION_APPLY puts the
+ * four staged in effect together, IQ_CORRECTION_SAVE as well and writes
+ * them to the flash user page, where they are read back at the next boot.
+ * A factory reset forgets them. The reply, little endian, in wire order:
+ *   [0]      IQ_CORRECTION_VERSION
+ *   [1]      IQ_CORRECTION_FLAG_ bits
+ *   [2..9]   a, b, c, d in effect
+ *   [10..17] a, b, c, d staged
+ *
+ * The iq-correction-check host tool measures the image rejection and the
+ * cycles per sample.
+ */
+
+#ifndef IQ_CORRECTION_H_
+#define IQ_CORRECTION_H_
+
+#include "compiler.h"
+
+#define IQ_CORRECTION_ONE				(1 << 14)	// 1.0 in Q14
+
+#define IQ_CORRECTION_VERSION			1
+#define IQ_CORRECTION_DG8SAQ_COMMAND	0x76		// vendor IN request, wIndex = operation
+#define IQ_CORRECTION_RECORD_SIZE		(2+2*4+2*4)
+
+// the operations, in wIndex
+#define IQ_CORRECTION_READ				0
+#define IQ_CORRECTION_SET_A				1			// to IQ_CORRECTION_SET_A + 3 for d
+#define IQ_CORRECTION_APPLY				5
+#define IQ_CORRECTION_SAVE				6			// apply and write to flash
+#define IQ_CORRECTION_IDENTITY			7			// stage and apply the identity, not saved
+
+// the flags of the reply
+#define IQ_CORRECTION_FLAG_ACTIVE		0x01		// the matrix in effect is not the identity
+#define IQ_CORRECTION_FLAG_SAVED		0x02		// a matrix is saved in flash
+#define IQ_CORRECTION_FLAG_BAD_OP		0x80		// unknown operation, nothing done
+
+// the work the host check counts, nothing in the firmware
+#ifndef IQ_CORRECTION_WORK
+#define IQ_CORRECTION_WORK(what, n)
+#endif
+
+// read the saved matrix, called once at boot after features_init()
+extern void iq_correction_init(void);
+
+// at the start of a packet, take the matrix last applied, TRUE when it is
+// not the identity and the packet needs correcting
+extern Bool iq_correction_latch(void);
+
+// correct count pairs of 24 bit samples in place, I in buf[left] and Q in
+// buf[right] of each, into sign extended 24 bit samples
+extern void iq_correction_run(volatile U32 *buf, U16 count, U8 left, U8 right);
+
+// correct count pairs of the ADC buffers in place ahead of the USB reader
+// at index of buffer audio_buffer_out, over into the other buffer if need be
+extern void iq_correction_ahead(U8 audio_buffer_out, U32 index, U16 count, U8 left, U8 right);
+
+// the vendor request, returns the reply length
+extern U8 iq_correction_request(U16 operation, U16 value, U8 *buffer);
+
+#endif /* IQ_CORRECTION_H_ */
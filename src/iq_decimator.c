@@ -0,0 +1,112 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * iq_decimator.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Narrowband IQ decimation, see iq_decimator.h
+ */
+
+#include "compiler.h"
+#include "iq_decimator.h"
+
+//
+// Q15, weighted least squares to 1 / CIC response up to IQ_DECIMATOR_PASS
+// and 0 from IQ_DECIMATOR_STOP, stop band weighted 30, at twice the output
+// rate for the CIC of the build
+//
+static const S16 iq_decimator_taps[IQ_DECIMATOR_TAPS] = {
+#if IQ_DECIMATOR_CIC == 1
+	-4, 12, 28, -28, -78, 51, 171, -81, -330, 117, 585, -155, -995, 190, 1703, -220,
+	-3235, 239, 10348, 16138, 10348, 239, -3235, -220, 1703, 190, -995, -155, 585, 117,
+	-330, -81, 171, 51, -78, -28, 28, 12, -4
+#elif IQ_DECIMATOR_CIC == 2
+	-7, 20, 48, -44, -135, 77, 296, -115, -566, 146, 999, -150, -1685, 72, 2834, 256,
+	-5090, -1777, 11502, 19422, 11502, -1777, -5090, 256, 2834, 72, -1685, -150, 999, 146,
+	-566, -115, 296, 77, -135, -44, 48, 20, -7
+#else
+	-7, 20, 50, -45, -140, 79, 306, -117, -587, 148, 1035, -148, -1745, 59, 2930, 302,
+	-5239, -1947, 11592, 19689, 11592, -1947, -5239, 302, 2930, 59, -1745, -148, 1035, 148,
+	-587, -117, 306, 79, -140, -45, 50, 20, -7
+#endif
+};
+
+#define IQ_DECIMATOR_MAX	0x7fffff	// of a 24 bit sample
+
+void iq_decimator_init(iq_decimator_t *dp) {
+	U8 c, k;
+
+	dp->phase = 0;
+	dp->odd = 0;
+	dp->pos = 0;
+	for (c = 0; c < 2; c += 1) {
+		for (k = 0; k < IQ_DECIMATOR_ORDER; k += 1) {
+			dp->integrator[c][k] = 0;
+			dp->comb[c][k] = 0;
+		}
+		for (k = 0; k < 2 * IQ_DECIMATOR_TAPS; k += 1)
+			dp->history[c][k] = 0;
+	}
+}
+
+U16 iq_decimator_run(iq_decimator_t *dp, const volatile U32 *src, U16 count, S32 *dst) {
+	const S32 *hp;
+	S32 *out = dst;
+	U32 x;
+#if IQ_DECIMATOR_CIC > 1
+	U32 t;
+#endif
+	S64 acc;
+	U8 c, k;
+
+	while (count--) {
+		for (c = 0; c < 2; c += 1) {
+			// 24 bit sign extended and pruned, through the integrators at the ADC rate
+			x = (U32)((S32)(src[c] << 8) >> (8 + IQ_DECIMATOR_PRUNE));
+#if IQ_DECIMATOR_CIC > 1
+			for (k = 0; k < IQ_DECIMATOR_ORDER; k += 1)
+				x = dp->integrator[c][k] += x;
+#else
+			dp->integrator[c][IQ_DECIMATOR_ORDER - 1] = x;
+#endif
+		}
+		src += 2;
+		IQ_DECIMATOR_WORK(inputs, 1);
+
+		if (++dp->phase < IQ_DECIMATOR_CIC)
+			continue;
+		dp->phase = 0;
+
+		// the combs at twice the output rate, into the FIR history
+		for (c = 0; c < 2; c += 1) {
+			x = dp->integrator[c][IQ_DECIMATOR_ORDER - 1];
+#if IQ_DECIMATOR_CIC > 1
+			for (k = 0; k < IQ_DECIMATOR_ORDER; k += 1) {
+				t = x;
+				x -= dp->comb[c][k];
+				dp->comb[c][k] = t;
+			}
+#endif
+			dp->history[c][dp->pos] = dp->history[c][dp->pos + IQ_DECIMATOR_TAPS] =
+				(S32)x >> IQ_DECIMATOR_SHIFT;
+		}
+		dp->pos = dp->pos + 1 == IQ_DECIMATOR_TAPS ? 0 : dp->pos + 1;
+		IQ_DECIMATOR_WORK(combs, 1);
+
+		// the FIR only for every other one, oldest input first, the taps
+		// are symmetric so each pair of inputs shares a MAC
+		if ((dp->odd ^= 1) != 0)
+			continue;
+		for (c = 0; c < 2; c += 1) {
+			hp = &dp->history[c][dp->pos];
+			acc = (1 << 14) + (S64)iq_decimator_taps[IQ_DECIMATOR_TAPS / 2] * hp[IQ_DECIMATOR_TAPS / 2];
+			for (k = 0; k < IQ_DECIMATOR_TAPS / 2; k += 1)
+				acc += (S64)iq_decimator_taps[k] * (hp[k] + hp[IQ_DECIMATOR_TAPS - 1 - k]);
+			acc >>= 15;
+			*out++ = acc > IQ_DECIMATOR_MAX ? IQ_DECIMATOR_MAX : acc < -IQ_DECIMATOR_MAX - 1 ? -IQ_DECIMATOR_MAX - 1 : acc;
+		}
+		IQ_DECIMATOR_WORK(outputs, 1);
+	}
+	return (out - dst) / 2;
+}
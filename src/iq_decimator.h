@@ -0,0 +1,79 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * iq_decimator.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The narrowband IQ record stream, both ADC channels decimated by
+ * UAC2_IQ_DECIMATION of uac2_audio_function.h.
+ *
+ * A IQ_DECIMATOR_ORDER CIC filter decimates by half of it, then a
+ * IQ_DECIMATOR_TAPS FIR by the last 2: flat to IQ_DECIMATOR_PASS and down
+ * from IQ_DECIMATOR_STOP percent of the output rate, so nothing folds into
+ * the pass band, and making up the CIC droop. The CIC takes one stage
+ * more at a ratio of 2 to keep its own images out of the pass band. The
+ * decimation is fixed at build time and so are the taps, one table for each.
+ *
+ * All fixed point: the CIC in wrapping 32 bit, the samples pruned to 20
+ * bits at a ratio of 4 for its gain to fit, about what the ADC resolves,
+ * the FIR on the 24 bit samples with Q15 coefficients into 64 bits, as
+ * macwh.d does. The taps are designed by weighted least squares. The
+ * iq-decimator-bench host tool measures the response and the cycles per
+ * sample of each decimation.
+ */
+
+#ifndef IQ_DECIMATOR_H_
+#define IQ_DECIMATOR_H_
+
+#include "compiler.h"
+#include "uac2_audio_function.h"
+
+#define IQ_DECIMATOR_TAPS		39		// FIR taps, odd and symmetric
+#define IQ_DECIMATOR_PASS		40		// percent of the output rate, flat to 0.05 dB
+#define IQ_DECIMATOR_STOP		60		// percent of the output rate, 64 dB down
+
+// the CIC ratio and stages, the sample bits dropped going in, and the
+// shift that takes the CIC gain out again
+#if UAC2_IQ_DECIMATION == 2
+#define IQ_DECIMATOR_CIC		1		// no CIC, the FIR does it all
+#define IQ_DECIMATOR_ORDER		1		// the last sample, for the FIR
+#define IQ_DECIMATOR_PRUNE		0
+#define IQ_DECIMATOR_SHIFT		0
+#elif UAC2_IQ_DECIMATION == 4
+#define IQ_DECIMATOR_CIC		2
+#define IQ_DECIMATOR_ORDER		7
+#define IQ_DECIMATOR_PRUNE		0		// 24 + 7 bits
+#define IQ_DECIMATOR_SHIFT		7
+#elif UAC2_IQ_DECIMATION == 8
+#define IQ_DECIMATOR_CIC		4
+#define IQ_DECIMATOR_ORDER		6
+#define IQ_DECIMATOR_PRUNE		4		// 20 + 12 bits
+#define IQ_DECIMATOR_SHIFT		8
+#else
+#error UAC2_IQ_DECIMATION must be 2, 4 or 8
+#endif
+
+// the work the host bench counts, nothing in the firmware
+#ifndef IQ_DECIMATOR_WORK
+#define IQ_DECIMATOR_WORK(what, n)
+#endif
+
+typedef struct {
+	U8 phase;									// input samples into the current CIC output
+	U8 odd;										// CIC outputs into the current FIR output
+	U8 pos;										// of the next FIR input
+	U32 integrator[2][IQ_DECIMATOR_ORDER];
+	U32 comb[2][IQ_DECIMATOR_ORDER];			// the last input of each comb
+	S32 history[2][2 * IQ_DECIMATOR_TAPS];		// FIR inputs, twice so the taps read straight
+} iq_decimator_t;
+
+// start the filters over
+extern void iq_decimator_init(iq_decimator_t *dp);
+
+// decimate count stereo pairs of 24 bit samples at src into pairs of
+// sign extended 24 bit samples at dst, in the same channel order,
+// returns the number of pairs out
+extern U16 iq_decimator_run(iq_decimator_t *dp, const volatile U32 *src, U16 count, S32 *dst);
+
+#endif /* IQ_DECIMATOR_H_ */
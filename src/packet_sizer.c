@@ -0,0 +1,32 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * packet_sizer.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Samples per record packet, see packet_sizer.h
+ */
+
+#include "compiler.h"
+#include "packet_sizer.h"
+
+U16 packet_sizer_samples(packet_sizer_t *sp, U32 rate, U32 intervals, U16 gap, U16 buffer_size) {
+	U16 samples;
+
+	if (sp->rate != rate || sp->intervals != intervals) {
+		sp->rate = rate;
+		sp->intervals = intervals;
+		sp->phase = 0;
+	}
+
+	sp->phase += rate;
+	samples = sp->phase / intervals;
+	sp->phase -= samples * intervals;
+
+	if (gap < buffer_size / 2 && samples > 0)	// reader close behind the ADC, send less
+		samples -= 1;
+	else if (gap > buffer_size + buffer_size / 2)	// ADC about to lap the reader, send more
+		samples += 1;
+	return samples;
+}
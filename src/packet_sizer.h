@@ -0,0 +1,37 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * packet_sizer.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Samples per packet of a record stream, locked to the ADC clock.
+ *
+ * The nominal count comes from a phase accumulator, so 44.1 kHz at high
+ * speed goes out as 5,6,5,6,... and averages 5.5125 exactly instead of
+ * wandering between the buffer limits. The ADC buffer gap then only has
+ * to correct the drift of the ADC clock against the bus, one sample at a
+ * time once it leaves the middle half of its range.
+ *
+ * With feature_sync_implicit the host plays back at the rate these
+ * packets carry, so their sequence is the only clock reference it gets.
+ * The uac2-sync-sim host tool runs this code against simulated clocks.
+ */
+
+#ifndef PACKET_SIZER_H_
+#define PACKET_SIZER_H_
+
+#include "compiler.h"
+
+typedef struct {
+	U32 rate;				// samples per second the phase was built for
+	U32 intervals;			// service intervals per second
+	U32 phase;				// rate * intervals elapsed, modulo intervals
+} packet_sizer_t;
+
+// samples for the next packet of a stream at rate, sent intervals times a
+// second, with the ADC writer gap words ahead of the USB reader in a pair
+// of buffers of buffer_size words
+extern U16 packet_sizer_samples(packet_sizer_t *sp, U32 rate, U32 intervals, U16 gap, U16 buffer_size);
+
+#endif /* PACKET_SIZER_H_ */
@@ -0,0 +1,114 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * ram_budget.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Static task creation and the boot RAM budget report, see ram_budget.h
+ */
+
+#include "usart.h"     // Shall be included before FreeRTOS header files, since 'inline' is defined to ''; leading to
+                       // link errors
+#include "compiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "print_funcs.h"
+
+#include "taskRunStats.h"
+#include "ram_budget.h"
+
+typedef struct {
+	const signed char *name;
+	U32 stack_bytes;			// static stack, 0 if it came from the pools
+	U32 pool_bytes;				// pool blocks taken by the creation
+} ram_budget_task_t;
+
+static ram_budget_task_t ram_budget_tasks[RAM_BUDGET_MAX_TASKS];
+static U8 ram_budget_count;
+
+// one per role, for whichever image starts
+portSTACK_TYPE ram_budget_device_audio_stack[configTSK_USB_DAUDIO_STACK_SIZE];
+portSTACK_TYPE ram_budget_AK5394A_stack[configTSK_AK5394A_STACK_SIZE];
+
+//
+// create a task on a static stack of stack_words words and register it
+// for the report and the run-time statistics, NULL if it failed
+//
+xTaskHandle ram_budget_task_create(pdTASK_CODE code, const signed char *name, unsigned short stack_words,
+								   void *parameters, unsigned portBASE_TYPE priority, portSTACK_TYPE *stack) {
+	xTaskHandle task = NULL;
+	size_t free_before = xPortGetFreeHeapSize();
+
+	if (xTaskGenericCreate(code, name, stack_words, parameters, priority, &task, stack, NULL) != pdPASS) {
+		print_dbg("ram_budget: cannot create ");
+		print_dbg((const char *)name);
+		print_dbg("\n");
+		return NULL;
+	}
+	if (ram_budget_count < RAM_BUDGET_MAX_TASKS) {
+		ram_budget_task_t *tp = &ram_budget_tasks[ram_budget_count++];
+		tp->name = name;
+		tp->stack_bytes = stack != NULL ? stack_words * sizeof(portSTACK_TYPE) : 0;
+		tp->pool_bytes = free_before - xPortGetFreeHeapSize();
+	}
+	runstats_register_task(task, name);
+	return task;
+}
+
+static void ram_budget_print_column(unsigned long n) {
+	unsigned long width;
+
+	for (width = 100000; width > 1 && n < width; width /= 10)
+		print_dbg_char(' ');
+	print_dbg_ulong(n);
+}
+
+//
+// print the budget, before vTaskStartScheduler() so it goes out
+// ahead of any task output
+//
+void ram_budget_report(void) {
+	U32 static_total = 0, pool_tasks = 0, pool_size = 0, pool_used = 0;
+	size_t block_size;
+	unsigned portBASE_TYPE uxClass, count, used, peak;
+	int i;
+
+	print_dbg("RAM budget, bytes:  static    pool\n");
+	for (i = 0; i < ram_budget_count; i += 1) {
+		ram_budget_task_t *tp = &ram_budget_tasks[i];
+		print_dbg("  ");
+		print_dbg((const char *)tp->name);
+		print_dbg("\n                 ");
+		ram_budget_print_column(tp->stack_bytes);
+		ram_budget_print_column(tp->pool_bytes);
+		print_dbg("\n");
+		static_total += tp->stack_bytes;
+		pool_tasks += tp->pool_bytes;
+	}
+	print_dbg("  IDLE, at scheduler start\n                 ");
+	ram_budget_print_column(0);
+	ram_budget_print_column(configMINIMAL_STACK_SIZE * sizeof(portSTACK_TYPE));
+	print_dbg(" + TCB\n");
+
+	for (uxClass = 0; xPortGetPoolClass(uxClass, &block_size, &count, &used, &peak); uxClass++) {
+		print_dbg("  pool ");
+		print_dbg_ulong(block_size);
+		print_dbg(" x ");
+		print_dbg_ulong(count);
+		print_dbg(": ");
+		print_dbg_ulong(used);
+		print_dbg(" used\n");
+		pool_size += block_size * count;
+		pool_used += block_size * used;
+	}
+	print_dbg("  total static stacks ");
+	print_dbg_ulong(static_total);
+	print_dbg(", pool ");
+	print_dbg_ulong(pool_used);
+	print_dbg(" of ");
+	print_dbg_ulong(pool_size);
+	print_dbg(" in use, ");
+	print_dbg_ulong(pool_used - pool_tasks);
+	print_dbg(" of it by other tasks and queues\n");
+}
@@ -0,0 +1,44 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * ram_budget.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Static task creation and the boot RAM budget report.
+ *
+ * Tasks are created with a stack array the caller declares at file scope,
+ * sized by its configTSK_XXX_STACK_SIZE, so stacks are placed by the linker
+ * and show up in the map file. Only the TCB comes from the fixed block pools
+ * of heap_pool.c, as FreeRTOS V6 has no way to pass in a static TCB.
+ *
+ * The device audio and AK5394A tasks exist once per image, UAC1, UAC2 or
+ * HPSDR, and only one image runs, so each role has one stack here that
+ * whichever image starts takes, instead of one per image.
+ *
+ * ram_budget_report(), called once all tasks exist and before the scheduler
+ * starts, prints per task the static stack and the pool bytes its creation
+ * took, then the state of every pool class, on the debug UART.
+ */
+
+#ifndef RAM_BUDGET_H_
+#define RAM_BUDGET_H_
+
+#include "compiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define RAM_BUDGET_MAX_TASKS	12
+
+// a static stack for ram_budget_task_create()
+#define RAM_BUDGET_STACK(name, words)	static portSTACK_TYPE name[words]
+
+// the stacks shared by the images
+extern portSTACK_TYPE ram_budget_device_audio_stack[configTSK_USB_DAUDIO_STACK_SIZE];
+extern portSTACK_TYPE ram_budget_AK5394A_stack[configTSK_AK5394A_STACK_SIZE];
+
+extern xTaskHandle ram_budget_task_create(pdTASK_CODE code, const signed char *name, unsigned short stack_words,
+										  void *parameters, unsigned portBASE_TYPE priority, portSTACK_TYPE *stack);
+extern void ram_budget_report(void);
+
+#endif /* RAM_BUDGET_H_ */
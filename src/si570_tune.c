@@ -0,0 +1,183 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * si570_tune.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The Si570 driver, see si570_tune.h
+ */
+
+#include "compiler.h"
+#include "board.h"
+#include "twim_patched.h"
+
+#include "eventlog.h"
+#include "si570_tune.h"
+
+static U32 si570_xtal = SI570_XTAL_DEFAULT;
+static U16 si570_smooth = SI570_SMOOTH_PPM;
+static S32 si570_sub;
+static U32 si570_mul = SI570_MUL_ONE;
+
+// the frequency and dividers of the last full update, 0 for none, and the
+// frequency set last, before the subtract and multiply
+static U32 si570_center;
+static U8 si570_hs_div, si570_n1;
+static U32 si570_freq;
+
+static Bool si570_write(U8 reg, const U8 *data, U8 length) {
+	twi_package_t package = {
+		.chip = SI570_I2C_ADDRESS,
+		.addr = reg,
+		.addr_length = 1,
+		.buffer = (void *)data,
+		.length = length
+	};
+	int status = twim_write_packet(TWIM0, &package);
+
+	if (status != TWI_SUCCESS) {
+		eventlog_put(ev_si570_failed, reg, -status, si570_freq);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+//
+// the HS_DIV and N1, 1 or even, that put the DCO lowest in its range
+//
+static Bool si570_dividers(U32 freq, U8 *hs_div, U8 *n1) {
+	static const U8 hs_divs[] = { 11, 9, 7, 6, 5, 4 };
+	U64 dco_min = (U64)SI570_DCO_MIN << 21, dco_max = (U64)SI570_DCO_MAX << 21;
+	U64 f, dco, best = 0;
+	U32 n;
+	U8 h;
+
+	if (freq == 0)
+		return FALSE;
+	for (h = 0; h < sizeof(hs_divs); h += 1) {
+		f = (U64)freq * hs_divs[h];
+		n = (dco_min + f - 1) / f;
+		SI570_WORK(divides, 1);
+		if (n > 1 && (n & 1) != 0)
+			n += 1;
+		if (n > 128)
+			continue;
+		dco = f * n;
+		if (dco <= dco_max && (best == 0 || dco < best)) {
+			best = dco;
+			*hs_div = hs_divs[h];
+			*n1 = n;
+		}
+	}
+	return best != 0;
+}
+
+//
+// RFREQ, 10.28, the DCO over the crystal, rounded: the integer part, then
+// the fraction from the remainder, so no quotient needs more than 64 bits
+//
+static U64 si570_rfreq(U32 freq, U8 hs_div, U8 n1) {
+	U64 dco = ((U64)freq * hs_div * n1) << 3;	// MHz 8.24, as the crystal
+	U64 rfreq = (dco / si570_xtal) << 28;
+
+	SI570_WORK(divides, 2);
+	return rfreq + (((dco % si570_xtal) << 28) + si570_xtal / 2) / si570_xtal;
+}
+
+static void si570_registers(U8 *regs, U8 hs_div, U8 n1, U64 rfreq) {
+	regs[0] = (hs_div - 4) << 5 | (n1 - 1) >> 2;
+	regs[1] = (n1 - 1) << 6 | (U8)(rfreq >> 32);
+	regs[2] = rfreq >> 24;
+	regs[3] = rfreq >> 16;
+	regs[4] = rfreq >> 8;
+	regs[5] = rfreq;
+}
+
+//
+// the frequency subtracted and multiplied, 0 if that is out of range: the
+// integer part of the multiply and the fraction apart, so nothing overflows
+//
+static U32 si570_vfo(U32 freq) {
+	S64 diff = (S64)freq - si570_sub;
+	U64 vfo;
+
+	if (diff <= 0)
+		return 0;
+	vfo = (U64)diff * (si570_mul >> 21) + ((U64)diff * (si570_mul & 0x1fffff) >> 21);
+	return vfo <= 0xffffffff ? vfo : 0;
+}
+
+//
+// within the smooth tune range of the last full update, and the DCO still
+// within its range with the dividers kept
+//
+static Bool si570_in_smooth_range(U32 freq) {
+	U32 delta = freq > si570_center ? freq - si570_center : si570_center - freq;
+	U64 dco = (U64)freq * si570_hs_div * si570_n1;
+
+	return si570_center != 0 && (U64)delta * 1000000 <= (U64)si570_smooth * si570_center
+		&& dco >= (U64)SI570_DCO_MIN << 21 && dco <= (U64)SI570_DCO_MAX << 21;
+}
+
+Bool si570_set_freq(U32 freq) {
+	U8 regs[SI570_REGS], hs_div = si570_hs_div, n1 = si570_n1, control;
+	U32 vfo = si570_vfo(freq);
+	Bool smooth = si570_in_smooth_range(vfo), ok;
+
+	if (! smooth && ! si570_dividers(vfo, &hs_div, &n1))
+		return FALSE;
+	si570_registers(regs, hs_div, n1, si570_rfreq(vfo, hs_div, n1));
+
+	if (smooth) {
+		// RFREQ alone, the M divider held until all of it is in
+		control = SI570_FREEZE_M;
+		ok = si570_write(SI570_REG_CONTROL, &control, 1)
+			&& si570_write(SI570_REG_N1_RFREQ, &regs[1], SI570_REGS - 1);
+		control = 0;
+		ok = si570_write(SI570_REG_CONTROL, &control, 1) && ok;
+	} else {
+		// all of it with the DCO frozen, then the new frequency applied
+		control = SI570_FREEZE_DCO;
+		ok = si570_write(SI570_REG_FREEZE, &control, 1)
+			&& si570_write(SI570_REG_HS_N1, regs, SI570_REGS);
+		control = 0;
+		ok = si570_write(SI570_REG_FREEZE, &control, 1) && ok;
+		control = SI570_NEW_FREQ;
+		ok = ok && si570_write(SI570_REG_CONTROL, &control, 1);
+	}
+	if (! ok) {
+		si570_forget();
+		return FALSE;
+	}
+
+	if (! smooth) {
+		si570_center = vfo;
+		si570_hs_div = hs_div;
+		si570_n1 = n1;
+	}
+	si570_freq = freq;
+	return TRUE;
+}
+
+U32 si570_get_freq(void) {
+	return si570_freq;
+}
+
+void si570_set_xtal(U32 xtal) {
+	si570_xtal = xtal != 0 ? xtal : SI570_XTAL_DEFAULT;
+}
+
+void si570_set_smooth(U16 ppm) {
+	si570_smooth = ppm;
+}
+
+void si570_set_sub_mul(S32 sub, U32 mul) {
+	si570_sub = sub;
+	si570_mul = mul != 0 ? mul : SI570_MUL_ONE;
+}
+
+void si570_forget(void) {
+	si570_center = 0;
+	si570_freq = 0;
+}
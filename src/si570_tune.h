@@ -0,0 +1,81 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * si570_tune.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The Si570 VFO tuned from a DG8SAQ frequency, with the dividers and RFREQ
+ * it was last set to kept, all integer math.
+ *
+ * The output frequency is fxtal * RFREQ / (HS_DIV * N1), the DCO, fxtal *
+ * RFREQ, within SI570_DCO_MIN and SI570_DCO_MAX. A full update picks the
+ * HS_DIV and N1 that give the lowest DCO, RFREQ in 10.28 fixed point from
+ * 64 bit quotients, and writes registers 7 to 12 with the DCO frozen, then
+ * NewFreq. The output stops for up to 10 ms while the DCO settles.
+ *
+ * A frequency within the smooth tune range, SI570_SMOOTH_PPM by default,
+ * of the one of the last full update keeps HS_DIV and N1 and only RFREQ
+ * is written, registers 8 to 12 with the M divider frozen, no NewFreq, so
+ * the output moves without a glitch. Unless that takes the DCO out of its
+ * range, which a full update then avoids.
+ *
+ * The frequency set is the one of the host, the Si570 tuned to (frequency
+ * - subtract) * multiply, as the Mobo firmware does with CALC_FREQ_MUL_ADD,
+ * so a smart VFO runs at 2 or 4 times the frequency, or off it by the IF.
+ *
+ * Frequencies are in the DG8SAQ units: the output and the subtract in MHz
+ * 11.21 fixed point, as DG8SAQ_SET_FREQ has it, the subtract signed, the
+ * multiply 11.21 as well, the crystal in MHz 8.24, as DG8SAQ_SET_XTAL. The registers are those of the 20 and 50 ppm grades,
+ * from 7 on, on TWIM0, which the Mobo firmware sets up.
+ *
+ * The si570-check host tool compares the registers written with a double
+ * precision reference and counts the time an update takes.
+ */
+
+#ifndef SI570_TUNE_H_
+#define SI570_TUNE_H_
+
+#include "compiler.h"
+
+#define SI570_I2C_ADDRESS		0x55
+#define SI570_XTAL_DEFAULT		0x7248f5c3	// 114.285 MHz, 8.24, the nominal crystal
+#define SI570_SMOOTH_PPM		3500		// the smooth tune range of the datasheet
+#define SI570_MUL_ONE			0x200000	// a multiply of 1, 11.21
+#define SI570_DCO_MIN			4850		// MHz
+#define SI570_DCO_MAX			5670		// MHz
+
+#define SI570_REG_HS_N1			7			// HS_DIV - 4 << 5 | N1 - 1 >> 2
+#define SI570_REG_N1_RFREQ		8			// N1 - 1 << 6 | RFREQ >> 32, then RFREQ 31..0 in 9 to 12
+#define SI570_REGS				6			// 7 to 12
+#define SI570_REG_CONTROL		135
+#define SI570_NEW_FREQ			0x40
+#define SI570_FREEZE_M			0x20
+#define SI570_REG_FREEZE		137
+#define SI570_FREEZE_DCO		0x10
+
+// the work the host check counts, nothing in the firmware
+#ifndef SI570_WORK
+#define SI570_WORK(what, n)
+#endif
+
+// the Si570 at frequency, subtracted and multiplied, FALSE if it has no
+// dividers for it or the I2C write failed
+extern Bool si570_set_freq(U32 freq);
+
+// the frequency set last, as set, 0 if none
+extern U32 si570_get_freq(void);
+
+// the subtract and multiply, 0 for a multiply of 1, for the next update on
+extern void si570_set_sub_mul(S32 sub, U32 mul);
+
+// the crystal, and the smooth tune range in ppm, 0 for none, both for the
+// next update on
+extern void si570_set_xtal(U32 xtal);
+extern void si570_set_smooth(U16 ppm);
+
+// the registers were written behind the driver's back, the next update is
+// a full one and the frequency no longer the driver's, 0
+extern void si570_forget(void);
+
+#endif /* SI570_TUNE_H_ */
@@ -0,0 +1,168 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * spectrum.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The spectrum stream on the telemetry endpoint, see spectrum.h
+ */
+
+#include "usart.h"     // Shall be included before FreeRTOS header files, since 'inline' is defined to ''; leading to
+                       // link errors
+#include "compiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "conf_usb.h"
+#include "pdca.h"
+#include "usb_drv.h"
+#include "usb_standard_request.h"
+#include "usb_specific_request.h"
+#include "device_audio_task.h"
+#include "features.h"
+#include "taskAK5394A.h"
+#include "ram_budget.h"
+#include "spectrum_fft.h"
+#include "spectrum.h"
+
+#define SPECTRUM_MS_TO_TICKS(ms)	((portTickType)(ms) * (configTICK_RATE_HZ / 1000))
+#define SPECTRUM_FRAME_MAX			(SPECTRUM_FRAME_HEADER + SPECTRUM_FFT_SIZE)
+#define SPECTRUM_PACKET_WAIT		SPECTRUM_MS_TO_TICKS(5)	// for the host to poll the next packet of a frame
+
+RAM_BUDGET_STACK(spectrum_stack, configTSK_SPECTRUM_STACK_SIZE);
+
+volatile U8 spectrum_alternate_setting;
+
+static volatile U16 spectrum_period = configTSK_SPECTRUM_PERIOD / (configTICK_RATE_HZ / 1000);	// ms
+static volatile U8 spectrum_averages = 4;
+static volatile U8 spectrum_group = 0;
+static U8 spectrum_ep;
+
+static S32 spectrum_x[2 * SPECTRUM_FFT_SIZE];
+static U32 spectrum_sum[SPECTRUM_FFT_SIZE];
+static U8 spectrum_frame[SPECTRUM_FRAME_MAX];
+
+//
+// vendor request reply: set what is asked for, answer what is in effect
+//
+U8 spectrum_set_frame(U16 period, U16 format, U8 *buffer) {
+	U8 averages = LSB(format), group = MSB(format);
+
+	if (format != 0) {
+		spectrum_averages = averages == 0 ? 1 : averages > SPECTRUM_AVERAGES_MAX ? SPECTRUM_AVERAGES_MAX : averages;
+		spectrum_group = group > SPECTRUM_GROUP_MAX ? SPECTRUM_GROUP_MAX : group;
+	}
+	if (period != SPECTRUM_PERIOD_READ)
+		spectrum_period = period;
+	if (spectrum_period < spectrum_averages * SPECTRUM_FFT_PERIOD_MIN)
+		spectrum_period = spectrum_averages * SPECTRUM_FFT_PERIOD_MIN;
+	buffer[0] = LSB(spectrum_period);
+	buffer[1] = MSB(spectrum_period);
+	buffer[2] = spectrum_averages;
+	buffer[3] = spectrum_group;
+	return 4;
+}
+
+//
+// window the latest SPECTRUM_FFT_SIZE pairs the ADC wrote, back from
+// where the PDCA is into the buffer before if need be
+//
+static void spectrum_capture(S32 *x) {
+	volatile avr32_pdca_channel_t *pdca_channel = pdca_get_handler(PDCA_CHANNEL_SSC_RX);
+	const U8 in_left = FEATURE_IN_NORMAL ? 0 : 1;
+	const U8 in_right = FEATURE_IN_NORMAL ? 1 : 0;
+	volatile U32 *filling, *before;
+	U16 written;
+	int in;
+
+	// the PDCA fills the buffer audio_buffer_in does not name
+	do {
+		in = audio_buffer_in;
+		written = (AUDIO_BUFFER_SIZE - pdca_channel->tcr) / 2;
+	} while (in != audio_buffer_in);
+	filling = in == 0 ? audio_buffer_1 : audio_buffer_0;
+	before = in == 0 ? audio_buffer_0 : audio_buffer_1;
+
+	if (written >= SPECTRUM_FFT_SIZE)
+		spectrum_fft_window(x, 0, filling + 2 * (written - SPECTRUM_FFT_SIZE), SPECTRUM_FFT_SIZE, in_left, in_right);
+	else {
+		spectrum_fft_window(x, 0, before + AUDIO_BUFFER_SIZE - 2 * (SPECTRUM_FFT_SIZE - written),
+							SPECTRUM_FFT_SIZE - written, in_left, in_right);
+		spectrum_fft_window(x, SPECTRUM_FFT_SIZE - written, filling, written, in_left, in_right);
+	}
+}
+
+//
+// a frame in packets as the host polls, given up on if it stops
+//
+static void spectrum_send(const U8 *frame, U16 length) {
+	U16 sent, n;
+	portTickType waited;
+
+	// drop the frame if the host has not taken the last one yet
+	if (! Is_usb_in_ready(spectrum_ep))
+		return;
+	for (sent = 0; sent < length; sent += n) {
+		for (waited = 0; ! Is_usb_in_ready(spectrum_ep); waited += 1) {
+			if (waited == SPECTRUM_PACKET_WAIT)
+				return;
+			vTaskDelay(1);
+		}
+		n = min(length - sent, SPECTRUM_EP_SIZE);
+		Usb_reset_endpoint_fifo_access(spectrum_ep);
+		usb_write_ep_txpacket(spectrum_ep, frame + sent, n, NULL);
+		Usb_ack_in_ready_send(spectrum_ep);
+	}
+}
+
+static void vtaskSpectrum(void *pvParameters) {
+	portTickType xLastWakeTime;
+	U16 seq = 0, n;
+	U8 count = 0, group;
+
+	for (n = 0; n < SPECTRUM_FFT_SIZE; n += 1)
+		spectrum_sum[n] = 0;
+	xLastWakeTime = xTaskGetTickCount();
+
+	while (TRUE) {
+		vTaskDelayUntil(&xLastWakeTime, SPECTRUM_MS_TO_TICKS(spectrum_period / spectrum_averages));
+		if (spectrum_alternate_setting != SPECTRUM_ALT || ! Is_device_enumerated()) {
+			for (n = 0; n < SPECTRUM_FFT_SIZE; n += 1)
+				spectrum_sum[n] = 0;
+			count = 0;
+			continue;
+		}
+
+		spectrum_capture(spectrum_x);
+		spectrum_fft_run(spectrum_x);
+		spectrum_fft_accumulate(spectrum_x, spectrum_sum);
+		if (++count < spectrum_averages)
+			continue;
+
+		group = spectrum_group;
+		spectrum_frame[0] = SPECTRUM_FRAME_VERSION;
+		spectrum_frame[1] = 2 * SPECTRUM_FFT_LOG4 - group;
+		spectrum_frame[2] = LSB(seq);
+		spectrum_frame[3] = MSB(seq);
+		spectrum_frame[4] = current_freq.frequency;
+		spectrum_frame[5] = current_freq.frequency >> 8;
+		spectrum_frame[6] = current_freq.frequency >> 16;
+		spectrum_frame[7] = current_freq.frequency >> 24;
+		spectrum_fft_frame(spectrum_sum, count, group, &spectrum_frame[SPECTRUM_FRAME_HEADER]);
+		count = 0;
+		seq += 1;
+
+		spectrum_send(spectrum_frame, SPECTRUM_FRAME_HEADER + (SPECTRUM_FFT_SIZE >> group));
+	}
+}
+
+void vStartTaskSpectrum(U8 ep_spectrum) {
+	spectrum_ep = ep_spectrum;
+	ram_budget_task_create(vtaskSpectrum,
+				configTSK_SPECTRUM_NAME,
+				configTSK_SPECTRUM_STACK_SIZE,
+				NULL,
+				configTSK_SPECTRUM_PRIORITY,
+				spectrum_stack);
+}
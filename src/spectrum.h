@@ -0,0 +1,57 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * spectrum.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The power spectrum of the record IQ on the telemetry endpoint, for
+ * panadapters on hosts that cannot take the full IQ stream.
+ *
+ * Alt setting SPECTRUM_ALT of the telemetry interface turns the endpoint
+ * over from telemetry records to spectrum frames, at a larger packet size.
+ * Every frame period the Spectrum task has averaged a number of FFTs of
+ * the latest ADC pairs, see spectrum_fft.h, and sends one frame, in wire
+ * order:
+ *   [0]      SPECTRUM_FRAME_VERSION
+ *   [1]      log2 of the number of bins
+ *   [2..3]   seq, little endian, gaps mean frames the host did not poll in time
+ *   [4..7]   ADC rate in Hz, little endian, the span of the bins
+ *   [8..]    one byte per bin, 0.5 dB steps below a full scale tone,
+ *            0xff for 127.5 dB or less, the lowest frequency first,
+ *            DC in the middle
+ * in packets of SPECTRUM_EP_SIZE, the last one short. A frame the host
+ * is not polling for when it is ready is dropped, as telemetry records are.
+ *
+ * The frame is set up with a DG8SAQ vendor IN request:
+ *   bRequest = SPECTRUM_DG8SAQ_COMMAND, wValue = frame period in ms,
+ *   wIndex = FFTs averaged a frame | log2 of the FFT bins to one frame bin << 8
+ * SPECTRUM_PERIOD_READ and a wIndex of 0 leave them alone. The period is
+ * raised to SPECTRUM_FFT_PERIOD_MIN per FFT averaged. The 4 byte reply is
+ * the period, little endian, the FFTs averaged and the log2 grouping in
+ * effect.
+ */
+
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
+
+#include "compiler.h"
+
+#define SPECTRUM_ALT				1		// of the telemetry interface
+#define SPECTRUM_EP_SIZE			64		// bytes a packet
+#define SPECTRUM_FRAME_VERSION		1
+#define SPECTRUM_FRAME_HEADER		8
+
+#define SPECTRUM_DG8SAQ_COMMAND		0x77	// vendor IN request, wValue = period in ms
+#define SPECTRUM_PERIOD_READ		0xffff	// wValue that only reads the period back
+#define SPECTRUM_AVERAGES_MAX		16
+#define SPECTRUM_GROUP_MAX			2		// log2, 64 bins a frame at the fewest
+
+// the alt setting of the telemetry interface, set by the SET_INTERFACE request
+extern volatile U8 spectrum_alternate_setting;
+
+extern U8 spectrum_set_frame(U16 period, U16 format, U8 *buffer);
+
+extern void vStartTaskSpectrum(U8 ep_spectrum);
+
+#endif /* SPECTRUM_H_ */
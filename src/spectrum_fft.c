@@ -0,0 +1,231 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * spectrum_fft.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Power spectrum of the record IQ, see spectrum_fft.h
+ */
+
+#include "compiler.h"
+#include "spectrum_fft.h"
+
+#define SPECTRUM_FFT_N		SPECTRUM_FFT_SIZE
+
+// the first half and the middle of the periodic 4 term Blackman-Harris
+// window, Q30, the second half mirrors it
+static const S32 spectrum_fft_window_half[SPECTRUM_FFT_N / 2 + 1] = {
+	64425, 73587, 101236, 147854, 214245, 301536,
+	411176, 544934, 704902, 893491, 1113434, 1367785,
+	1659915, 1993515, 2372588, 2801458, 3284755, 3827422,
+	4434707, 5112159, 5865624, 6701241, 7625434, 8644903,
+	9766620, 10997817, 12345977, 13818822, 15424302, 17170577,
+	19066009, 21119140, 23338677, 25733474, 28312511, 31084870,
+	34059717, 37246275, 40653800, 44291554, 48168775, 52294652,
+	56678290, 61328684, 66254684, 71464958, 76967967, 82771921,
+	88884749, 95314062, 102067113, 109150767, 116571458, 124335154,
+	132447321, 140912887, 149736204, 158921011, 168470403, 178386796,
+	188671891, 199326645, 210351241, 221745055, 233506634, 245633668,
+	258122965, 270970433, 284171057, 297718886, 311607017, 325827584,
+	340371748, 355229693, 370390621, 385842755, 401573339, 417568646,
+	433813987, 450293726, 466991294, 483889208, 500969096, 518211722,
+	535597017, 553104106, 570711353, 588396393, 606136174, 623907006,
+	641684606, 659444150, 677160323, 694807378, 712359192, 729789324,
+	747071081, 764177579, 781081806, 797756693, 814175176, 830310270,
+	846135134, 861623141, 876747949, 891483571, 905804440, 919685485,
+	933102193, 946030678, 958447747, 970330966, 981658719, 992410271,
+	1002565828, 1012106590, 1021014805, 1029273823, 1036868140, 1043783446,
+	1050006664, 1055525989, 1060330921, 1064412300, 1067762325, 1070374586,
+	1072244076, 1073367207, 1073741824
+};
+
+// cos(2 pi k / SPECTRUM_FFT_SIZE) for the first quarter, Q30
+static const S32 spectrum_fft_cos[SPECTRUM_FFT_N / 4 + 1] = {
+	1073741824, 1073418433, 1072448455, 1070832474, 1068571464, 1065666786,
+	1062120190, 1057933813, 1053110176, 1047652185, 1041563127, 1034846671,
+	1027506862, 1019548121, 1010975242, 1001793390, 992008094, 981625251,
+	970651112, 959092290, 946955747, 934248793, 920979082, 907154608,
+	892783698, 877875009, 862437520, 846480531, 830013654, 813046808,
+	795590213, 777654384, 759250125, 740388522, 721080937, 701339000,
+	681174602, 660599890, 639627258, 618269338, 596538995, 574449320,
+	552013618, 529245404, 506158392, 482766489, 459083786, 435124548,
+	410903207, 386434353, 361732726, 336813204, 311690799, 286380643,
+	260897982, 235258165, 209476638, 183568930, 157550647, 131437462,
+	105245103, 78989349, 52686014, 26350943, 0
+};
+
+// log2(1 + i / 64), Q16
+static const U32 spectrum_fft_log2[64 + 1] = {
+	0, 1466, 2909, 4331, 5732, 7112, 8473, 9814, 11136, 12440,
+	13727, 14996, 16248, 17484, 18704, 19909, 21098, 22272, 23433, 24579,
+	25711, 26830, 27936, 29029, 30109, 31178, 32234, 33279, 34312, 35334,
+	36346, 37346, 38336, 39316, 40286, 41246, 42196, 43137, 44068, 44990,
+	45904, 46809, 47705, 48593, 49472, 50344, 51207, 52063, 52911, 53751,
+	54584, 55410, 56229, 57040, 57845, 58643, 59434, 60219, 60997, 61769,
+	62534, 63294, 64047, 64794, 65536
+};
+
+// log2 of the power of the bin of a full scale complex tone, Q16: the
+// tone at 1 << 23 by the sum of the window, 91.84, less the
+// SPECTRUM_FFT_PRESHIFT bit
+#define SPECTRUM_FFT_FULL_SCALE		3738311
+
+// 10 log10(2) in Q8 dB per Q16 of log2, Q22
+#define SPECTRUM_FFT_DB_LOG2		49321
+
+void spectrum_fft_window(S32 *x, U16 at, const volatile U32 *src, U16 count, U8 left, U8 right) {
+	S32 w;
+
+	x += 2 * at;
+	SPECTRUM_FFT_WORK(windows, count);
+	while (count--) {
+		w = spectrum_fft_window_half[at <= SPECTRUM_FFT_N / 2 ? at : SPECTRUM_FFT_N - at];
+		x[0] = ((S64)((S32)(src[left] << 8) >> 8) * w) >> (30 + SPECTRUM_FFT_PRESHIFT);
+		x[1] = ((S64)((S32)(src[right] << 8) >> 8) * w) >> (30 + SPECTRUM_FFT_PRESHIFT);
+		x += 2;
+		src += 2;
+		at += 1;
+	}
+}
+
+//
+// exp(-j 2 pi k / SPECTRUM_FFT_SIZE) for k below three quarters, from the
+// quarter wave of cosines
+//
+static void spectrum_fft_twiddle(U16 k, S32 *c, S32 *s) {
+	if (k <= SPECTRUM_FFT_N / 4) {
+		*c = spectrum_fft_cos[k];
+		*s = spectrum_fft_cos[SPECTRUM_FFT_N / 4 - k];
+	} else if (k <= SPECTRUM_FFT_N / 2) {
+		*c = -spectrum_fft_cos[SPECTRUM_FFT_N / 2 - k];
+		*s = spectrum_fft_cos[k - SPECTRUM_FFT_N / 4];
+	} else {
+		*c = -spectrum_fft_cos[k - SPECTRUM_FFT_N / 2];
+		*s = -spectrum_fft_cos[3 * SPECTRUM_FFT_N / 4 - k];
+	}
+}
+
+// p times (c - j s), Q30 twiddle, rounded
+#define SPECTRUM_FFT_ROTATE(p, re, im, c, s) do { \
+		(p)[0] = ((S64)(re) * (c) + (S64)(im) * (s) + (1 << 29)) >> 30; \
+		(p)[1] = ((S64)(im) * (c) - (S64)(re) * (s) + (1 << 29)) >> 30; \
+	} while (0)
+
+void spectrum_fft_run(S32 *x) {
+	S32 *p0, *p1, *p2, *p3;
+	S32 ar, ai, br, bi, cr, ci, dr, di;
+	S32 t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+	S32 c1, s1, c2, s2, c3, s3;
+	U16 span, quarter, step, j, g;
+
+	// each stage splits every span into four a quarter as long
+	for (span = SPECTRUM_FFT_N, step = 1; span >= 4; span >>= 2, step <<= 2) {
+		quarter = span >> 2;
+		for (j = 0; j < quarter; j += 1) {
+			spectrum_fft_twiddle(j * step, &c1, &s1);
+			spectrum_fft_twiddle(2 * j * step, &c2, &s2);
+			spectrum_fft_twiddle(3 * j * step, &c3, &s3);
+			for (g = j; g < SPECTRUM_FFT_N; g += span) {
+				p0 = &x[2 * g];
+				p1 = p0 + 2 * quarter;
+				p2 = p1 + 2 * quarter;
+				p3 = p2 + 2 * quarter;
+				ar = p0[0]; ai = p0[1];
+				br = p1[0]; bi = p1[1];
+				cr = p2[0]; ci = p2[1];
+				dr = p3[0]; di = p3[1];
+
+				t0r = ar + cr; t0i = ai + ci;
+				t1r = ar - cr; t1i = ai - ci;
+				t2r = br + dr; t2i = bi + di;
+				t3r = br - dr; t3i = bi - di;
+
+				// y0 = t0 + t2, y2 = t0 - t2, y1 = t1 - j t3, y3 = t1 + j t3,
+				// each ym times the twiddle to the m
+				p0[0] = t0r + t2r;
+				p0[1] = t0i + t2i;
+				if (j == 0) {
+					p1[0] = t1r + t3i;
+					p1[1] = t1i - t3r;
+					p2[0] = t0r - t2r;
+					p2[1] = t0i - t2i;
+					p3[0] = t1r - t3i;
+					p3[1] = t1i + t3r;
+				} else {
+					SPECTRUM_FFT_ROTATE(p1, t1r + t3i, t1i - t3r, c1, s1);
+					SPECTRUM_FFT_ROTATE(p2, t0r - t2r, t0i - t2i, c2, s2);
+					SPECTRUM_FFT_ROTATE(p3, t1r - t3i, t1i + t3r, c3, s3);
+				}
+				SPECTRUM_FFT_WORK(butterflies, 1);
+				SPECTRUM_FFT_WORK(rotations, j == 0 ? 0 : 3);
+			}
+		}
+	}
+}
+
+U16 spectrum_fft_level(U64 power) {
+	U32 hi = power >> 32, lo = power, m, log2;
+	U8 msb, i;
+	S64 level;
+
+	if (power == 0)
+		return SPECTRUM_FFT_LEVEL_MAX;
+	// the leading one to the top of m, the 6 bits after it index the
+	// table and the 16 after those interpolate
+	if (hi != 0) {
+		msb = 63 - clz(hi);
+		m = msb == 63 ? hi : (hi << (63 - msb)) | (lo >> (msb - 31));
+	} else {
+		msb = 31 - clz(lo);
+		m = lo << (31 - msb);
+	}
+	i = (m >> 25) & 63;
+	log2 = ((U32)msb << 16) + spectrum_fft_log2[i]
+		+ (((spectrum_fft_log2[i + 1] - spectrum_fft_log2[i]) * ((m >> 9) & 0xffff)) >> 16);
+
+	level = ((S64)(SPECTRUM_FFT_FULL_SCALE - (S32)log2) * SPECTRUM_FFT_DB_LOG2) >> 22;
+	return level < 0 ? 0 : level > SPECTRUM_FFT_LEVEL_MAX - 1 ? SPECTRUM_FFT_LEVEL_MAX - 1 : level;
+}
+
+//
+// bin k of the FFT sits at k with its base 4 digits reversed
+//
+static U16 spectrum_fft_reversed(U16 k) {
+	U16 r = 0;
+	U8 d;
+
+	for (d = 0; d < SPECTRUM_FFT_LOG4; d += 1) {
+		r = (r << 2) | (k & 3);
+		k >>= 2;
+	}
+	return r;
+}
+
+void spectrum_fft_accumulate(const S32 *x, U32 *sum) {
+	const S32 *p;
+	U16 n;
+
+	SPECTRUM_FFT_WORK(levels, SPECTRUM_FFT_N);
+	for (n = 0; n < SPECTRUM_FFT_N; n += 1) {
+		p = &x[2 * spectrum_fft_reversed((n + SPECTRUM_FFT_N / 2) & (SPECTRUM_FFT_N - 1))];
+		sum[n] += spectrum_fft_level((U64)((S64)p[0] * p[0]) + (U64)((S64)p[1] * p[1]));
+	}
+}
+
+void spectrum_fft_frame(U32 *sum, U8 count, U8 shift, U8 *bins) {
+	U32 level, least;
+	U16 n, k;
+
+	for (n = 0; n < (SPECTRUM_FFT_N >> shift); n += 1) {
+		least = 0xffffffff;
+		for (k = n << shift; k < (n + 1) << shift; k += 1) {
+			level = sum[k] / count;
+			least = level < least ? level : least;
+			sum[k] = 0;
+		}
+		// Q8 to 0.5 dB, rounded
+		least = (least + 64) >> 7;
+		bins[n] = least > 0xff ? 0xff : least;
+	}
+}
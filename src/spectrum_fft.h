@@ -0,0 +1,60 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * spectrum_fft.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The power spectrum of the record IQ for the spectrum stream of
+ * spectrum.h, all fixed point.
+ *
+ * A block of SPECTRUM_FFT_SIZE pairs is windowed, 4 term Blackman-Harris in
+ * Q30, into 24 bit samples less SPECTRUM_FFT_PRESHIFT bits, enough headroom
+ * for the growth of the FFT in 32 bits. The FFT is radix-4 decimation in
+ * frequency, in place, with Q30 twiddles and 64 bit products as muls.d
+ * does, and leaves the bins in digit reversed order. The level of each bin
+ * is its power in dB below a full scale complex tone, Q8, from a log2 table
+ * with linear interpolation. Levels are averaged over a number of FFTs,
+ * in dB, and a frame takes the strongest of each group of bins when it
+ * has fewer than the FFT, as a panadapter wants the peaks.
+ *
+ * The spectrum-fft-check host tool compares it with a double precision
+ * reference and counts the cycles per FFT.
+ */
+
+#ifndef SPECTRUM_FFT_H_
+#define SPECTRUM_FFT_H_
+
+#include "compiler.h"
+
+#define SPECTRUM_FFT_LOG4		4			// radix-4 stages
+#define SPECTRUM_FFT_SIZE		(1 << (2 * SPECTRUM_FFT_LOG4))
+#define SPECTRUM_FFT_PRESHIFT	1			// bits dropped after the window
+#define SPECTRUM_FFT_LEVEL_MAX	0xffff		// Q8 dB, for a bin with no power at all
+#define SPECTRUM_FFT_PERIOD_MIN	10			// ms between FFTs at the least, 100 a second
+
+// the work the host check counts, nothing in the firmware
+#ifndef SPECTRUM_FFT_WORK
+#define SPECTRUM_FFT_WORK(what, n)
+#endif
+
+// window count pairs of 24 bit samples at src, I in src[left] and Q in
+// src[right] of each, into x from pair at on, x interleaved re and im
+extern void spectrum_fft_window(S32 *x, U16 at, const volatile U32 *src, U16 count, U8 left, U8 right);
+
+// the FFT of the SPECTRUM_FFT_SIZE pairs of x in place, digit reversed
+extern void spectrum_fft_run(S32 *x);
+
+// the level of each bin of an FFT added to sum, lowest frequency first,
+// so sum[SPECTRUM_FFT_SIZE / 2] is DC
+extern void spectrum_fft_accumulate(const S32 *x, U32 *sum);
+
+// the average of count FFTs in sum into SPECTRUM_FFT_SIZE >> shift bytes
+// of 0.5 dB below full scale each, the strongest bin of each group, sum
+// cleared for the next
+extern void spectrum_fft_frame(U32 *sum, U8 count, U8 shift, U8 *bins);
+
+// the level of a power, Q8 dB below a full scale tone, 0 above it
+extern U16 spectrum_fft_level(U64 power);
+
+#endif /* SPECTRUM_FFT_H_ */
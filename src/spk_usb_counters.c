@@ -0,0 +1,45 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * spk_usb_counters.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The speaker OUT stream counters, see spk_usb_counters.h
+ */
+
+#include "compiler.h"
+#include "spk_usb_counters.h"
+
+spk_usb_counters_t spk_usb_counters;
+
+//!
+//! @brief Count one OUT packet of num_samples. Only the device audio task
+//! may call this.
+//!
+void spk_usb_counters_update(U32 num_samples) {
+	U32 seq = spk_usb_counters.seq;
+	volatile spk_usb_counts_t *cur = &spk_usb_counters.copy[seq & 1];
+	volatile spk_usb_counts_t *next = &spk_usb_counters.copy[(seq + 1) & 1];
+
+	next->heart_beat = cur->heart_beat + 1;
+	next->sample_counter = cur->sample_counter + num_samples;
+	SPK_USB_COUNTERS_BARRIER();
+	spk_usb_counters.seq = seq + 1;		// single aligned store publishes next
+}
+
+//!
+//! @brief Take a consistent snapshot of the OUT counters, from any task.
+//! Retries only if the writer published while we were copying.
+//!
+void spk_usb_counters_read(spk_usb_counts_t *snapshot) {
+	U32 seq;
+
+	do {
+		seq = spk_usb_counters.seq;
+		SPK_USB_COUNTERS_BARRIER();
+		snapshot->heart_beat = spk_usb_counters.copy[seq & 1].heart_beat;
+		snapshot->sample_counter = spk_usb_counters.copy[seq & 1].sample_counter;
+		SPK_USB_COUNTERS_BARRIER();
+	} while (seq != spk_usb_counters.seq);
+}
@@ -0,0 +1,44 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * spk_usb_counters.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Speaker OUT stream counters. The device audio task is the only writer and
+ * publishes each update by bumping seq, always into the copy the readers are
+ * not looking at, so the packet path needs no kernel call and a reader never
+ * sees a heart beat and sample count from different packets.
+ *
+ * The spk-counters-check host tool runs a writer thread against reader
+ * threads and checks that no snapshot is torn.
+ */
+
+#ifndef SPK_USB_COUNTERS_H_
+#define SPK_USB_COUNTERS_H_
+
+#include "compiler.h"
+
+// orders the stores of an update and the loads of a read, nothing on the
+// UC3, which keeps volatile accesses in order, a fence and a yield now and
+// then in the host check
+#ifndef SPK_USB_COUNTERS_BARRIER
+#define SPK_USB_COUNTERS_BARRIER()
+#endif
+
+typedef struct {
+	U32 heart_beat;				// OUT packets received from the host
+	U32 sample_counter;			// samples received from the host
+} spk_usb_counts_t;
+
+typedef struct {
+	volatile U32 seq;			// number of updates, LSB selects the published copy
+	volatile spk_usb_counts_t copy[2];
+} spk_usb_counters_t;
+
+extern spk_usb_counters_t spk_usb_counters;
+
+void spk_usb_counters_update(U32 num_samples);
+void spk_usb_counters_read(spk_usb_counts_t *snapshot);
+
+#endif /* SPK_USB_COUNTERS_H_ */
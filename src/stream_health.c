@@ -0,0 +1,37 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * stream_health.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Audio stream health counters, see stream_health.h
+ */
+
+#include "compiler.h"
+#include "stream_health.h"
+
+volatile U16 stream_health_counts[sh_end];
+
+static U16 stream_health_base[sh_end];		// counts at the last reset
+
+//
+// vendor request reply: the counters since the last reset,
+// then move the baseline if asked to
+//
+U8 stream_health_get_record(U16 flags, U8 *buffer) {
+	U16 count, since;
+	int i;
+
+	buffer[0] = STREAM_HEALTH_VERSION;
+	buffer[1] = sh_end;
+	for (i = 0; i < sh_end; i += 1) {
+		count = stream_health_counts[i];
+		since = count - stream_health_base[i];
+		buffer[2+2*i] = LSB(since);
+		buffer[3+2*i] = MSB(since);
+		if (flags & STREAM_HEALTH_RESET)
+			stream_health_base[i] = count;
+	}
+	return STREAM_HEALTH_RECORD_SIZE;
+}
@@ -0,0 +1,71 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * stream_health.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Counters of the things that go wrong in the audio streams and otherwise
+ * only show up as clicks or silence.
+ *
+ * Every counter has exactly one writer, an audio task or a PDCA interrupt
+ * handler, so STREAM_HEALTH_COUNT() is a plain increment without masking
+ * interrupts. sh_dbg_dropped, of the debug output that shares the PDCA,
+ * is counted by print_funcs.c with interrupts masked. The counters run
+ * from boot and wrap; a reset only moves the baseline the vendor request
+ * reports against, it never writes a counter.
+ *
+ * Not every image has every failure, a counter an image cannot hit stays 0:
+ *   UAC2   all but sh_out_sync
+ *   UAC1   all but sh_fb_clamp, its feedback only steps and is never
+ *          forced back, and sh_out_sync
+ *   HPSDR  the gaps, sh_spk_dma_late, sh_mic_dma_late, sh_rate_change
+ *          from C&C, sh_out_sync and sh_dbg_dropped; no feedback endpoint,
+ *          no stall check and frames rather than packets
+ *
+ * The counters are read with a DG8SAQ vendor IN request:
+ *   bRequest = STREAM_HEALTH_DG8SAQ_COMMAND, wValue = STREAM_HEALTH_RESET
+ *   to reset after reading, 0 to only read
+ * returning, little endian, in wire order:
+ *   [0]     STREAM_HEALTH_VERSION
+ *   [1]     number of counters
+ *   [2..]   one U16 per counter since the last reset, in stream_health_id_t order
+ * Append new counters at the end to keep old readers working.
+ */
+
+#ifndef STREAM_HEALTH_H_
+#define STREAM_HEALTH_H_
+
+#include "compiler.h"
+
+// the counters, in wire order
+typedef enum {
+	sh_spk_underrun,	// DAC reader came within reach of the USB writer
+	sh_spk_overrun,		// USB writer came within reach of the DAC reader
+	sh_spk_stall,		// no OUT packet for a period, speaker buffer cleared
+	sh_spk_dma_late,	// speaker PDCA ran dry before its reload
+	sh_mic_underrun,	// USB reader came within reach of the ADC writer
+	sh_mic_overrun,		// ADC writer came within reach of the USB reader
+	sh_mic_dma_late,	// ADC PDCA ran dry before its reload
+	sh_odd_packet,		// OUT packet not a whole number of sample frames
+	sh_short_packet,	// OUT packet more than one frame below nominal
+	sh_resync,			// speaker writer resynchronized to the DAC reader
+	sh_fb_clamp,		// feedback value forced back to nominal
+	sh_rate_change,		// sample rate changed
+	sh_out_sync,		// HPSDR OUT frame short or out of sync, dropped
+	sh_dbg_dropped,		// debug message dropped on a full ring, see print_dbg_overflow()
+	sh_end
+} stream_health_id_t;
+
+#define STREAM_HEALTH_VERSION			1
+#define STREAM_HEALTH_DG8SAQ_COMMAND	0x75	// vendor IN request, wValue = STREAM_HEALTH_RESET or 0
+#define STREAM_HEALTH_RESET				1
+#define STREAM_HEALTH_RECORD_SIZE		(2+2*sh_end)
+
+extern volatile U16 stream_health_counts[sh_end];
+
+#define STREAM_HEALTH_COUNT(id)		(stream_health_counts[id] += 1)
+
+extern U8 stream_health_get_record(U16 flags, U8 *buffer);
+
+#endif /* STREAM_HEALTH_H_ */
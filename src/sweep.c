@@ -0,0 +1,265 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * sweep.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The frequency sweep of the VFO, see sweep.h
+ */
+
+#include "usart.h"     // Shall be included before FreeRTOS header files, since 'inline' is defined to ''; leading to
+                       // link errors
+#include "compiler.h"
+#include "board.h"
+#include "intc.h"
+#include "tc.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "taskAK5394A.h"
+#include "dg8saq_queue.h"
+#include "sweep.h"
+
+// the UC3A3 has two TC blocks, the UC3A0/1 only one, see taskRunStats.c
+#if defined(AVR32_TC0)
+#define SWEEP_TC		(&AVR32_TC0)
+#define SWEEP_TC_IRQ	ATPASTE2(AVR32_TC0_IRQ, configSWEEP_TC_CHANNEL)
+#else
+#define SWEEP_TC		(&AVR32_TC)
+#define SWEEP_TC_IRQ	ATPASTE2(AVR32_TC_IRQ, configSWEEP_TC_CHANNEL)
+#endif
+#define SWEEP_TC_HZ		(FPBA_HZ / 128)		// TC_CLOCK_SOURCE_TC5, ~516kHz at 66MHz PBA
+
+static U32 sweep_list[SWEEP_LIST_MAX];
+static U32 sweep_start_freq, sweep_step_freq;
+static U16 sweep_count;				// steps, 0 nothing to sweep
+static Bool sweep_range;
+static U16 sweep_dwell = SWEEP_DWELL_MIN;
+static U16 sweep_passes;			// to sweep, 0 until stopped
+
+// written by the interrupt: the step due, the passes done, and a serial
+// one up for each step due
+static volatile Bool sweep_on;
+static volatile U16 sweep_step, sweep_pass, sweep_serial;
+static volatile U16 sweep_tc_left;	// interrupts to the next step
+static U16 sweep_tc_div;			// interrupts a dwell time
+
+// written by the DG8SAQ task
+static U16 sweep_tuned_serial, sweep_tuned_step, sweep_tuned_pass;
+static U16 sweep_late;
+
+// the tags, from the DG8SAQ task to the Telemetry task
+static struct {
+	U16 step, pass;
+	U32 block;
+} sweep_tags[SWEEP_TAGS];
+static volatile U8 sweep_tag_in, sweep_tag_out, sweep_tags_lost;
+
+static U32 sweep_get_le32(const U8 *bp) {
+	return bp[0] | (bp[1] << 8) | ((U32)bp[2] << 16) | ((U32)bp[3] << 24);
+}
+
+static void sweep_put_le16(U8 *bp, U16 v) {
+	bp[0] = v;
+	bp[1] = v >> 8;
+}
+
+//
+// the next step due every dwell time, the DG8SAQ task woken to tune to it
+//
+__attribute__((__interrupt__)) static void sweep_tc_int_handler(void) {
+	tc_read_sr(SWEEP_TC, configSWEEP_TC_CHANNEL);	// acknowledges the RC compare
+	if (--sweep_tc_left != 0)
+		return;
+	sweep_tc_left = sweep_tc_div;
+
+	if (++sweep_step == sweep_count) {
+		sweep_step = 0;
+		if (++sweep_pass == sweep_passes && sweep_passes != 0) {
+			tc_stop(SWEEP_TC, configSWEEP_TC_CHANNEL);
+			sweep_on = FALSE;
+			return;
+		}
+	}
+	sweep_serial += 1;
+	dg8saq_queue_wake_from_isr();
+}
+
+void sweep_stop(void) {
+	tc_stop(SWEEP_TC, configSWEEP_TC_CHANNEL);
+	sweep_on = FALSE;
+}
+
+Bool sweep_running(void) {
+	return sweep_on;
+}
+
+//
+// step 0 due now, the next every dwell time, in as many interrupts as
+// the 16 bit counter needs
+//
+static void sweep_start(U16 dwell, U8 passes) {
+	U32 counts = (U32)(((U64)dwell * SWEEP_DWELL_UNIT * SWEEP_TC_HZ) / 1000000);
+
+	sweep_stop();
+	sweep_dwell = dwell;
+	sweep_passes = passes;
+	sweep_tc_div = counts / 0x10000 + 1;
+	sweep_tc_left = sweep_tc_div;
+	tc_write_rc(SWEEP_TC, configSWEEP_TC_CHANNEL, counts / sweep_tc_div);
+	sweep_tuned_serial = sweep_serial;
+	sweep_late = 0;
+
+	portENTER_CRITICAL();
+	sweep_step = 0;
+	sweep_pass = 0;
+	sweep_serial += 1;
+	sweep_on = TRUE;
+	portEXIT_CRITICAL();
+	tc_start(SWEEP_TC, configSWEEP_TC_CHANNEL);
+	dg8saq_queue_wake();
+}
+
+U8 sweep_request(U16 index, U16 value, U8 *buffer) {
+	U8 flags = 0;
+
+	switch (LSB(index)) {
+	case SWEEP_READ:
+		break;
+	case SWEEP_START:
+		if (sweep_count == 0)
+			flags |= SWEEP_FLAG_BAD_OP;
+		else
+			sweep_start(value < SWEEP_DWELL_MIN ? SWEEP_DWELL_MIN : value, MSB(index));
+		break;
+	case SWEEP_STOP:
+		sweep_stop();
+		break;
+	default:
+		flags |= SWEEP_FLAG_BAD_OP;
+		break;
+	}
+
+	if (sweep_on)
+		flags |= SWEEP_FLAG_RUNNING;
+	if (sweep_range)
+		flags |= SWEEP_FLAG_RANGE;
+	buffer[0] = SWEEP_VERSION;
+	buffer[1] = flags;
+	sweep_put_le16(&buffer[2], sweep_count);
+	sweep_put_le16(&buffer[4], sweep_tuned_step);
+	sweep_put_le16(&buffer[6], sweep_tuned_pass);
+	sweep_put_le16(&buffer[8], sweep_dwell);
+	sweep_put_le16(&buffer[10], sweep_late);
+	return SWEEP_RECORD_SIZE;
+}
+
+Bool sweep_write(U16 index, U16 value, const U8 *data, U16 length) {
+	U32 start, stop, step;
+	U16 n;
+
+	switch (LSB(index)) {
+	case SWEEP_LIST:
+		// in order from index 0
+		if (length % 4 != 0 || value > (sweep_range ? 0 : sweep_count) || value + length / 4 > SWEEP_LIST_MAX)
+			return FALSE;
+		sweep_stop();
+		for (n = 0; n < length / 4; n += 1)
+			sweep_list[value + n] = sweep_get_le32(&data[4 * n]);
+		sweep_count = value + length / 4;
+		sweep_range = FALSE;
+		return TRUE;
+
+	case SWEEP_RANGE:
+		if (length != 12)
+			return FALSE;
+		start = sweep_get_le32(&data[0]);
+		stop = sweep_get_le32(&data[4]);
+		step = sweep_get_le32(&data[8]);
+		if (step == 0 || stop < start || (stop - start) / step >= 0xffff)
+			return FALSE;
+		sweep_stop();
+		sweep_start_freq = start;
+		sweep_step_freq = step;
+		sweep_count = (stop - start) / step + 1;
+		sweep_range = TRUE;
+		return TRUE;
+
+	default:
+		return FALSE;
+	}
+}
+
+Bool sweep_next(U32 *freq) {
+	U16 serial, step, pass;
+	Bool on;
+
+	portENTER_CRITICAL();
+	on = sweep_on;
+	serial = sweep_serial;
+	step = sweep_step;
+	pass = sweep_pass;
+	portEXIT_CRITICAL();
+	if (! on || serial == sweep_tuned_serial)
+		return FALSE;
+
+	// the steps due while the task was busy are skipped
+	sweep_late += (U16)(serial - sweep_tuned_serial - 1);
+	sweep_tuned_serial = serial;
+	sweep_tuned_step = step;
+	sweep_tuned_pass = pass;
+	*freq = sweep_range ? sweep_start_freq + step * sweep_step_freq : sweep_list[step];
+	return TRUE;
+}
+
+//
+// the block being filled has the old frequency in it, the next is the
+// first wholly at the new one
+//
+void sweep_tuned(void) {
+	U8 in = sweep_tag_in, next = (in + 1) % SWEEP_TAGS;
+
+	if (next == sweep_tag_out) {
+		if (sweep_tags_lost != 0xff)
+			sweep_tags_lost += 1;
+		return;
+	}
+	sweep_tags[in].step = sweep_tuned_step;
+	sweep_tags[in].pass = sweep_tuned_pass;
+	sweep_tags[in].block = audio_blocks + 1;
+	sweep_tag_in = next;
+}
+
+U8 sweep_get_tags(U16 *step, U32 *block, U8 max, U16 *pass, U8 *lost) {
+	U8 out = sweep_tag_out, n;
+
+	*lost = sweep_tags_lost;
+	sweep_tags_lost = 0;
+	for (n = 0; n < max && out != sweep_tag_in; n += 1) {
+		if (n == 0)
+			*pass = sweep_tags[out].pass;
+		step[n] = sweep_tags[out].step;
+		block[n] = sweep_tags[out].block;
+		out = (out + 1) % SWEEP_TAGS;
+	}
+	sweep_tag_out = out;
+	return n;
+}
+
+void sweep_init(void) {
+	static const tc_waveform_opt_t waveform_opt = {
+		.channel  = configSWEEP_TC_CHANNEL,
+		.wavsel   = TC_WAVEFORM_SEL_UP_MODE_RC_TRIGGER,	// count 0..RC and restart
+		.tcclks   = TC_CLOCK_SOURCE_TC5					// PBA/128
+	};
+	static const tc_interrupt_t tc_interrupt = {
+		.cpcs     = 1									// RC compare
+	};
+
+	Disable_global_interrupt();
+	INTC_register_interrupt((__int_handler) &sweep_tc_int_handler, SWEEP_TC_IRQ, AVR32_INTC_INT0);
+	Enable_global_interrupt();
+	tc_init_waveform(SWEEP_TC, &waveform_opt);
+	tc_configure_interrupts(SWEEP_TC, configSWEEP_TC_CHANNEL, &tc_interrupt);
+}
@@ -0,0 +1,89 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * sweep.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The VFO stepped through a list of frequencies, or from a start to a stop
+ * frequency, by the firmware, for scanning and panoramic hosts that would
+ * otherwise send a DG8SAQ frequency set per step.
+ *
+ * A TC channel interrupts every dwell time and makes the next step due.
+ * The Si570 is not set from the interrupt, I2C is far too slow for it, the
+ * DG8SAQ task of dg8saq_queue.h tunes to a step due before it runs the
+ * commands queued. Once tuned, a tag of the step and the first ADC capture
+ * block, audio_blocks, wholly at it goes to the Telemetry task, which sends
+ * the tags in sweep records on the telemetry endpoint, see
+ * telemetry_record.h. A step the task got to only after the next one was
+ * due is skipped and counted late. A frequency set from the host stops the
+ * sweep.
+ *
+ * Frequencies are 32 bit words in the units of DG8SAQ_SET_FREQ, little
+ * endian on the wire. They are loaded with a DG8SAQ vendor OUT request:
+ *   bRequest = SWEEP_DG8SAQ_COMMAND, wIndex = SWEEP_LIST,
+ *   wValue = list index of the first, data = up to 16 frequencies
+ * loading the list in order from index 0, the last request ending it, or
+ *   wIndex = SWEEP_RANGE, data = start, stop, step
+ * Either stops a sweep that runs. A bad request is stalled.
+ *
+ * The sweep is started, stopped and read with a vendor IN request:
+ *   bRequest = SWEEP_DG8SAQ_COMMAND, wIndex = operation | passes << 8,
+ *   wValue = dwell time in SWEEP_DWELL_UNIT for SWEEP_START
+ * 0 passes sweep until stopped, a dwell shorter than SWEEP_DWELL_MIN is
+ * raised to it. The reply, little endian, in wire order:
+ *   [0]      SWEEP_VERSION
+ *   [1]      SWEEP_FLAG_ bits
+ *   [2..3]   steps
+ *   [4..5]   step last tuned to
+ *   [6..7]   passes done
+ *   [8..9]   dwell time
+ *   [10..11] steps late
+ */
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include "compiler.h"
+
+#define SWEEP_VERSION			1
+#define SWEEP_DG8SAQ_COMMAND	0x78		// vendor request, wIndex = operation
+#define SWEEP_RECORD_SIZE		12
+
+#define SWEEP_LIST_MAX			256			// frequencies in the list
+#define SWEEP_DWELL_UNIT		100			// us
+#define SWEEP_DWELL_MIN			10			// 1 ms, an Si570 set over I2C and some
+#define SWEEP_TAGS				16			// tags waiting for the Telemetry task
+
+// the operations, in the low byte of wIndex
+#define SWEEP_READ				0			// IN
+#define SWEEP_LIST				1			// OUT, frequencies from list index wValue on
+#define SWEEP_RANGE				2			// OUT, start, stop, step
+#define SWEEP_START				3			// IN, wValue = dwell time
+#define SWEEP_STOP				4			// IN
+
+// the flags of the reply
+#define SWEEP_FLAG_RUNNING		0x01
+#define SWEEP_FLAG_RANGE		0x02		// start, stop and step, not the list
+#define SWEEP_FLAG_BAD_OP		0x80		// unknown operation or nothing to sweep, nothing done
+
+// vendor request reply, start, stop or read
+extern U8 sweep_request(U16 index, U16 value, U8 *buffer);
+
+// vendor OUT request data, FALSE to stall it
+extern Bool sweep_write(U16 index, U16 value, const U8 *data, U16 length);
+
+extern void sweep_stop(void);
+extern Bool sweep_running(void);
+
+// for the DG8SAQ task: the frequency of a step due, then tuned once it is
+extern Bool sweep_next(U32 *freq);
+extern void sweep_tuned(void);
+
+// for the Telemetry task: up to max tags, the pass of the first and the
+// tags lost before it
+extern U8 sweep_get_tags(U16 *step, U32 *block, U8 max, U16 *pass, U8 *lost);
+
+extern void sweep_init(void);
+
+#endif /* SWEEP_H_ */
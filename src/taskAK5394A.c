@@ -49,6 +49,7 @@
 #include "features.h"
 #include "device_audio_task.h"
 #include "taskAK5394A.h"
+#include "stream_health.h"
 
 //_____ M A C R O S ________________________________________________________
 
@@ -56,9 +57,7 @@
 
 //_____ D E C L A R A T I O N S ____________________________________________
 
-volatile U32 spk_usb_heart_beat = 0, old_spk_usb_heart_beat = 0;
-volatile U32 spk_usb_sample_counter = 0, old_spk_usb_sample_counter = 0;
-xSemaphoreHandle mutexSpkUSB;
+U32 old_spk_usb_heart_beat = 0;
 
 static const gpio_map_t SSC_GPIO_MAP = {
 	{SSC_RX_CLOCK, SSC_RX_CLOCK_FUNCTION},
@@ -95,6 +94,7 @@ volatile U32 spk_buffer_1[SPK_BUFFER_SIZE];
 volatile avr32_ssc_t *ssc = &AVR32_SSC;
 
 volatile int audio_buffer_in, spk_buffer_out;
+volatile U32 audio_blocks;		// ADC buffers filled since boot, the capture blocks of the sweep tags
 
 /*! \brief The PDCA interrupt handler.
  *
@@ -102,6 +102,10 @@ volatile int audio_buffer_in, spk_buffer_out;
  * The interrupt will happen when the reload counter reaches 0
  */
 __attribute__((__interrupt__)) static void pdca_int_handler(void) {
+	// the buffer the reload started on is already full too, the channel stopped
+	if (pdca_get_load_size(PDCA_CHANNEL_SSC_RX) == 0)
+		STREAM_HEALTH_COUNT(sh_mic_dma_late);
+	audio_blocks += 1;
 	if (audio_buffer_in == 0) {
 		// Set PDCA channel reload values with address where data to load are stored, and size of the data block to load.
 		pdca_reload_channel(PDCA_CHANNEL_SSC_RX, (void *)audio_buffer_1, AUDIO_BUFFER_SIZE);
@@ -119,6 +123,9 @@ __attribute__((__interrupt__)) static void pdca_int_handler(void) {
  * The interrupt will happen when the reload counter reaches 0
  */
 __attribute__((__interrupt__)) static void spk_pdca_int_handler(void) {
+	// the buffer the reload started on is already played out too, the channel stopped
+	if (pdca_get_load_size(PDCA_CHANNEL_SSC_TX) == 0)
+		STREAM_HEALTH_COUNT(sh_spk_dma_late);
 	if (spk_buffer_out == 0) {
 		// Set PDCA channel reload values with address where data to load are stored, and size of the data block to load.
 		pdca_reload_channel(PDCA_CHANNEL_SSC_TX, (void *)spk_buffer_1, SPK_BUFFER_SIZE);
@@ -165,8 +172,6 @@ void AK5394A_task_init(const Bool uac1) {
 	// LRCK is SCLK / 64 generated by TX_SSC
 	// so SCLK of 6.144Mhz ===> 96khz
 
-	mutexSpkUSB = xSemaphoreCreateMutex();
-
 	if (uac1) {
 		pm_gc_setup(&AVR32_PM, AVR32_PM_GCLK_GCLK1, // gc
 					0,                  // osc_or_pll: use Osc (if 0) or PLL (if 1)
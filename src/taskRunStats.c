@@ -0,0 +1,164 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * taskRunStats.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Per task CPU load and stack headroom, see taskRunStats.h
+ */
+
+#include <string.h>
+
+#include "usart.h"     // Shall be included before FreeRTOS header files, since 'inline' is defined to ''; leading to
+                       // link errors
+#include "compiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tc.h"
+
+#include "taskRunStats.h"
+#include "ram_budget.h"
+
+// the UC3A3 has two TC blocks, the UC3A0/1 only one
+#if defined(AVR32_TC0)
+#define RUNSTATS_TC		(&AVR32_TC0)
+#else
+#define RUNSTATS_TC		(&AVR32_TC)
+#endif
+
+typedef struct {
+	xTaskHandle handle;
+	const signed char *name;
+	unsigned long last_counter;		// run time counter at the previous sample
+	U16 load;						// permille over the last period
+	U16 stack_free;					// high water mark, in words
+} runstats_slot_t;
+
+RAM_BUDGET_STACK(runstats_stack, configTSK_RUNSTATS_STACK_SIZE);
+
+static runstats_slot_t runstats_slots[RUNSTATS_MAX_TASKS];
+static U8 runstats_count = 1;		// slot 0 is the idle task
+static U16 runstats_total_load;
+static unsigned long runstats_last_time;
+
+// software extension of the 16 bit TC counter
+static U16 runstats_last_cv;
+static unsigned long runstats_high;
+
+//
+// start the free-running time base, called by vTaskStartScheduler()
+//
+void vConfigureTimerForRunTimeStats(void) {
+	static const tc_waveform_opt_t waveform_opt = {
+		.channel  = configRUNSTATS_TC_CHANNEL,
+		.wavsel   = TC_WAVEFORM_SEL_UP_MODE,		// count 0..0xFFFF and wrap
+		.tcclks   = TC_CLOCK_SOURCE_TC4				// PBA/32, ~2MHz at 66MHz PBA
+	};
+	tc_init_waveform(RUNSTATS_TC, &waveform_opt);
+	tc_start(RUNSTATS_TC, configRUNSTATS_TC_CHANNEL);
+}
+
+//
+// called from the context switch with interrupts masked, so
+// there is no need for an overflow interrupt: a wrap is
+// detected as the counter going backwards. This holds as long
+// as no one suspends the scheduler for longer than ~32ms.
+//
+unsigned long ulGetRunTimeCounterValue(void) {
+	U16 cv = RUNSTATS_TC->channel[configRUNSTATS_TC_CHANNEL].cv & AVR32_TC_CV_MASK;
+	if (cv < runstats_last_cv)
+		runstats_high += 0x10000;
+	runstats_last_cv = cv;
+	return runstats_high | cv;
+}
+
+//
+// register a task for reporting, ram_budget_task_create() does
+// this for every task it creates
+//
+void runstats_register_task(xTaskHandle handle, const signed char *name) {
+	if (handle == NULL || runstats_count >= RUNSTATS_MAX_TASKS)
+		return;
+	runstats_slots[runstats_count].handle = handle;
+	runstats_slots[runstats_count].name = name;
+	runstats_count += 1;
+}
+
+static void runstats_sample(void) {
+	unsigned long now, elapsed, counter;
+	U32 load;
+	int i;
+
+	portENTER_CRITICAL();
+	now = ulGetRunTimeCounterValue();
+	portEXIT_CRITICAL();
+	elapsed = now - runstats_last_time;
+	runstats_last_time = now;
+	if (elapsed == 0)
+		return;
+
+	for (i = 0; i < runstats_count; i += 1) {
+		runstats_slot_t *sp = &runstats_slots[i];
+		counter = ulTaskGetRunTimeCounter(sp->handle);
+		load = (U32)(((unsigned long long)(counter - sp->last_counter) * 1000) / elapsed);
+		sp->last_counter = counter;
+		sp->load = load > 1000 ? 1000 : load;
+		sp->stack_free = uxTaskGetStackHighWaterMark(sp->handle);
+	}
+	runstats_total_load = 1000 - runstats_slots[0].load;
+}
+
+//
+// fill one slot record for the vendor request, see taskRunStats.h
+// the fields are single writer, a reader may see a mix of two
+// periods across slots but never a torn value
+//
+U8 runstats_get_record(U16 slot, U8 *buffer) {
+	runstats_slot_t *sp;
+	U16 total = runstats_total_load;
+
+	if (slot >= runstats_count || runstats_slots[slot].handle == NULL)
+		return 0;
+	sp = &runstats_slots[slot];
+	memset(buffer, 0, RUNSTATS_RECORD_SIZE);
+	buffer[0] = runstats_count;
+	buffer[1] = slot;
+	buffer[2] = LSB(sp->load);
+	buffer[3] = MSB(sp->load);
+	buffer[4] = LSB(sp->stack_free);
+	buffer[5] = MSB(sp->stack_free);
+	buffer[6] = LSB(total);
+	buffer[7] = MSB(total);
+	strncpy((char *)&buffer[8], (const char *)sp->name, RUNSTATS_NAME_LENGTH);
+	return RUNSTATS_RECORD_SIZE;
+}
+
+// total CPU load over the last period, permille
+U16 runstats_get_total_load(void) {
+	return runstats_total_load;
+}
+
+static void vtaskRunStats(void *pvParameters) {
+	portTickType xLastWakeTime;
+
+	// the idle task only exists once the scheduler has started
+	runstats_slots[0].handle = xTaskGetIdleTaskHandle();
+	runstats_slots[0].name = (const signed char *)"IDLE";
+
+	xLastWakeTime = xTaskGetTickCount();
+	runstats_sample();		// discard the time spent before the first period
+	while (TRUE) {
+		vTaskDelayUntil(&xLastWakeTime, configTSK_RUNSTATS_PERIOD);
+		runstats_sample();
+	}
+}
+
+void vStartTaskRunStats(void) {
+	ram_budget_task_create(vtaskRunStats,
+				configTSK_RUNSTATS_NAME,
+				configTSK_RUNSTATS_STACK_SIZE,
+				NULL,
+				configTSK_RUNSTATS_PRIORITY,
+				runstats_stack);
+}
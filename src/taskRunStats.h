@@ -0,0 +1,46 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * taskRunStats.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Per task CPU load and stack headroom, measured with the FreeRTOS
+ * run-time statistics hooks on a free-running TC channel.
+ *
+ * Tasks created with ram_budget_task_create() are registered for reporting.
+ * Slot 0 is always the idle task; total load is 1000 permille minus idle.
+ * Once per configTSK_RUNSTATS_PERIOD the task turns the run-time counter
+ * deltas into permille figures and samples the stack high water marks.
+ *
+ * The snapshot is read by the host with a DG8SAQ vendor IN request:
+ *   bRequest = RUNSTATS_DG8SAQ_COMMAND, wIndex = slot
+ * returning a RUNSTATS_RECORD_SIZE byte record, little endian, in wire order:
+ *   [0]     number of valid slots
+ *   [1]     slot index (echo of wIndex)
+ *   [2..3]  load of this task over the last period, permille
+ *   [4..5]  stack high water mark, free words
+ *   [6..7]  total CPU load over the last period, permille
+ *   [8..23] task name, NUL padded
+ */
+
+#ifndef TASKRUNSTATS_H_
+#define TASKRUNSTATS_H_
+
+#include "compiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define RUNSTATS_DG8SAQ_COMMAND		0x72	// vendor request to read one slot
+
+#define RUNSTATS_MAX_TASKS			12		// including the idle task in slot 0
+#define RUNSTATS_NAME_LENGTH		16
+#define RUNSTATS_RECORD_SIZE		(8+RUNSTATS_NAME_LENGTH)
+
+extern void runstats_register_task(xTaskHandle handle, const signed char *name);
+extern U8 runstats_get_record(U16 slot, U8 *buffer);
+extern U16 runstats_get_total_load(void);
+
+extern void vStartTaskRunStats(void);
+
+#endif /* TASKRUNSTATS_H_ */
@@ -0,0 +1,64 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * taskStartupLeds.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The LED walk of a fresh enumeration, see taskStartupLeds.h
+ */
+
+#include "usart.h"     // Shall be included before FreeRTOS header files, since 'inline' is defined to ''; leading to
+                       // link errors
+#include "compiler.h"
+#include "board.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "taskStartupLeds.h"
+#include "ram_budget.h"
+
+RAM_BUDGET_STACK(startup_leds_stack, configTSK_STARTUP_LEDS_STACK_SIZE);
+
+static volatile portTickType startup_leds_step;	// 0 when there is nothing to play
+
+void startup_leds_play(portTickType step) {
+	startup_leds_step = step;
+}
+
+// wait one step, FALSE if a new walk was asked for in the meantime
+static Bool startup_leds_wait(portTickType step) {
+	vTaskDelay(step);
+	return startup_leds_step == step;
+}
+
+static void vtaskStartupLeds(void *pcParameters) {
+	static const U32 leds[] = { LED0, LED1, LED2, LED3 };
+	portTickType step;
+	int i;
+
+	while (TRUE) {
+		vTaskDelay(configTSK_STARTUP_LEDS_PERIOD);
+		if ((step = startup_leds_step) == 0)
+			continue;
+
+		LED_On(LED0);
+		for (i = 1; i < 4 && startup_leds_wait(step); i += 1)
+			LED_On(leds[i]);
+		for (i = 0; i < 4 && startup_leds_wait(step); i += 1)
+			LED_Off(leds[i]);
+
+		// done, unless someone asked for a new walk while this one played
+		if (startup_leds_step == step)
+			startup_leds_step = 0;
+	}
+}
+
+void vStartTaskStartupLeds(void) {
+	ram_budget_task_create(vtaskStartupLeds,
+				configTSK_STARTUP_LEDS_NAME,
+				configTSK_STARTUP_LEDS_STACK_SIZE,
+				NULL,
+				configTSK_STARTUP_LEDS_PRIORITY,
+				startup_leds_stack);
+}
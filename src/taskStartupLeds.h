@@ -0,0 +1,28 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * taskStartupLeds.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The LED walk of a fresh enumeration: LED0 to LED3 on, then off again,
+ * one step apart. The device audio tasks used to play it themselves and
+ * held the streams back until it was over, 9 s for UAC1 and UAC2. It runs
+ * in a task of its own at idle priority now, and the streams start as
+ * soon as the device is enumerated and the clocks are stable.
+ */
+
+#ifndef TASKSTARTUPLEDS_H_
+#define TASKSTARTUPLEDS_H_
+
+#include "compiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// start the walk with step ticks between LED changes, from any task;
+// a walk in progress starts over
+extern void startup_leds_play(portTickType step);
+
+extern void vStartTaskStartupLeds(void);
+
+#endif /* TASKSTARTUPLEDS_H_ */
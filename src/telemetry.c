@@ -0,0 +1,164 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * telemetry.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Stream health on a vendor class interrupt IN endpoint, see telemetry.h
+ */
+
+#include "usart.h"     // Shall be included before FreeRTOS header files, since 'inline' is defined to ''; leading to
+                       // link errors
+#include "compiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "conf_usb.h"
+#include "usb_drv.h"
+#include "usb_standard_request.h"
+#include "usb_specific_request.h"
+#include "device_audio_task.h"
+#include "taskAK5394A.h"
+#include "taskRunStats.h"
+#include "stream_health.h"
+#include "ram_budget.h"
+#include "telemetry.h"
+#include "spectrum.h"
+#include "sweep.h"
+
+#define TELEMETRY_MS_TO_TICKS(ms)	((portTickType)(ms) * (configTICK_RATE_HZ / 1000))
+
+RAM_BUDGET_STACK(telemetry_stack, configTSK_TELEMETRY_STACK_SIZE);
+
+static volatile U16 telemetry_period = configTSK_TELEMETRY_PERIOD / (configTICK_RATE_HZ / 1000);	// ms, 0 stopped
+static U8 telemetry_ep;
+
+//
+// vendor request reply: set the period unless asked to read it,
+// answer the period in effect
+//
+U8 telemetry_set_period(U16 period, U8 *buffer) {
+	if (period != TELEMETRY_PERIOD_READ)
+		telemetry_period = (period != 0 && period < TELEMETRY_PERIOD_MIN) ? TELEMETRY_PERIOD_MIN : period;
+	period = telemetry_period;
+	buffer[0] = LSB(period);
+	buffer[1] = MSB(period);
+	return 2;
+}
+
+static void telemetry_put_le16(U8 *bp, U16 v) {
+	bp[0] = v;
+	bp[1] = v >> 8;
+}
+
+static void telemetry_put_le32(U8 *bp, U32 v) {
+	bp[0] = v;
+	bp[1] = v >> 8;
+	bp[2] = v >> 16;
+	bp[3] = v >> 24;
+}
+
+//
+// per second rate of a counter that moved by delta in elapsed ticks
+//
+static U32 telemetry_per_second(U32 delta, portTickType elapsed) {
+	return elapsed == 0 ? 0 : (U32)(((unsigned long long)delta * configTICK_RATE_HZ) / elapsed);
+}
+
+//
+// a record goes out only if the host took the last one, and not while it
+// has the endpoint streaming spectrum frames instead
+//
+static Bool telemetry_ready(void) {
+	return spectrum_alternate_setting != SPECTRUM_ALT && Is_usb_in_ready(telemetry_ep);
+}
+
+static void telemetry_send(const U8 *record) {
+	Usb_reset_endpoint_fifo_access(telemetry_ep);
+	usb_write_ep_txpacket(telemetry_ep, record, TELEMETRY_RECORD_SIZE, NULL);
+	Usb_ack_in_ready_send(telemetry_ep);
+}
+
+//
+// the sweep tags tuned to since the last, FALSE if there are none
+//
+static Bool telemetry_sweep_record(U8 *record, U16 seq) {
+	U16 step[TELEMETRY_SWEEP_TAGS], pass = 0;
+	U32 block[TELEMETRY_SWEEP_TAGS];
+	U8 tags, lost, n;
+
+	tags = sweep_get_tags(step, block, TELEMETRY_SWEEP_TAGS, &pass, &lost);
+	if (tags == 0 && lost == 0)
+		return FALSE;
+	record[0] = TELEMETRY_SWEEP_VERSION;
+	record[1] = TELEMETRY_RECORD_SIZE;
+	telemetry_put_le16(&record[2], seq);
+	telemetry_put_le16(&record[4], pass);
+	record[6] = tags;
+	record[7] = lost;
+	for (n = 0; n < TELEMETRY_SWEEP_TAGS; n += 1) {
+		telemetry_put_le16(&record[8 + 2 * n], n < tags ? step[n] : 0);
+		telemetry_put_le32(&record[16 + 4 * n], n < tags ? block[n] : 0);
+	}
+	return TRUE;
+}
+
+static void vtaskTelemetry(void *pvParameters) {
+	U8 record[TELEMETRY_RECORD_SIZE];
+	spk_usb_counts_t now, last;
+	portTickType xLastWakeTime, last_time, period;
+	U16 seq = 0;
+
+	spk_usb_counters_read(&last);
+	xLastWakeTime = last_time = xTaskGetTickCount();
+
+	while (TRUE) {
+		period = TELEMETRY_MS_TO_TICKS(telemetry_period);
+		// while a sweep runs its tags go out at the shortest period, the
+		// records at theirs in between
+		vTaskDelayUntil(&xLastWakeTime, sweep_running() ? TELEMETRY_MS_TO_TICKS(TELEMETRY_PERIOD_MIN)
+						: period != 0 ? period : TELEMETRY_MS_TO_TICKS(100));
+		if (period == 0 || ! Is_device_enumerated())
+			continue;
+		if (telemetry_ready() && telemetry_sweep_record(record, seq)) {
+			telemetry_send(record);
+			seq += 1;
+			continue;
+		}
+		if (xLastWakeTime - last_time < period)
+			continue;
+
+		spk_usb_counters_read(&now);
+		record[0] = TELEMETRY_RECORD_VERSION;
+		record[1] = TELEMETRY_RECORD_SIZE;
+		telemetry_put_le16(&record[2], seq);
+		telemetry_put_le32(&record[4], xLastWakeTime);
+		telemetry_put_le32(&record[8], current_freq.frequency);
+		telemetry_put_le32(&record[12], FB_rate);
+		telemetry_put_le16(&record[16], spk_gap);
+		telemetry_put_le16(&record[18], SPK_BUFFER_SIZE);
+		telemetry_put_le16(&record[20], telemetry_per_second(now.heart_beat - last.heart_beat, xLastWakeTime - last_time));
+		telemetry_put_le16(&record[22], stream_health_counts[sh_spk_underrun]);
+		telemetry_put_le16(&record[24], stream_health_counts[sh_spk_overrun]);
+		telemetry_put_le16(&record[26], runstats_get_total_load());
+		telemetry_put_le32(&record[28], telemetry_per_second(now.sample_counter - last.sample_counter, xLastWakeTime - last_time));
+		last = now;
+		last_time = xLastWakeTime;
+		seq += 1;
+
+		// dropped if it cannot go out now
+		if (telemetry_ready())
+			telemetry_send(record);
+	}
+}
+
+void vStartTaskTelemetry(U8 ep_telemetry) {
+	telemetry_ep = ep_telemetry;
+	ram_budget_task_create(vtaskTelemetry,
+				configTSK_TELEMETRY_NAME,
+				configTSK_TELEMETRY_STACK_SIZE,
+				NULL,
+				configTSK_TELEMETRY_PRIORITY,
+				telemetry_stack);
+}
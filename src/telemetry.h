@@ -0,0 +1,40 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * telemetry.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Stream health on a vendor class interrupt IN endpoint.
+ *
+ * Every telemetry period the Telemetry task samples the speaker stream and
+ * queues one telemetry_record_t, layout in telemetry_record.h, on the
+ * endpoint. A record the host did not poll in time is dropped, not queued
+ * behind, so the seq field shows the gaps.
+ *
+ * The period is set with a DG8SAQ vendor IN request:
+ *   bRequest = TELEMETRY_DG8SAQ_COMMAND, wValue = period in ms
+ * 0 stops the stream, TELEMETRY_PERIOD_READ leaves it alone, shorter than
+ * TELEMETRY_PERIOD_MIN is raised to it. The 2 byte reply, little endian,
+ * is the period in effect.
+ *
+ * While a frequency sweep of sweep.h runs, the tags of the steps tuned to go
+ * out in sweep records, telemetry_sweep_record_t, as soon as the host polls,
+ * at TELEMETRY_PERIOD_MIN at least, between the records of the period. Tags
+ * wait for the host, up to SWEEP_TAGS of them, and are counted lost after.
+ *
+ * Alt setting SPECTRUM_ALT of the interface has the endpoint stream the
+ * spectrum frames of spectrum.h instead, the records stop meanwhile.
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "compiler.h"
+#include "telemetry_record.h"
+
+extern U8 telemetry_set_period(U16 period, U8 *buffer);
+
+extern void vStartTaskTelemetry(U8 ep_telemetry);
+
+#endif /* TELEMETRY_H_ */
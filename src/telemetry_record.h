@@ -0,0 +1,68 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * telemetry_record.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The record the telemetry interrupt endpoint streams, see telemetry.h.
+ *
+ * Shared between the firmware and the widget-telemetry host decoder, so it
+ * must not include anything beyond <stdint.h>. Fields only ever get added
+ * at the end, with a new TELEMETRY_RECORD_VERSION.
+ */
+
+#ifndef TELEMETRY_RECORD_H_
+#define TELEMETRY_RECORD_H_
+
+#include <stdint.h>
+
+#define TELEMETRY_RECORD_VERSION	1
+#define TELEMETRY_RECORD_SIZE		32		// all a usbmon text line shows of a transfer
+
+//
+// one record as it goes over the wire, all fields little endian
+//
+typedef struct {
+	uint8_t version;		// TELEMETRY_RECORD_VERSION
+	uint8_t size;			// TELEMETRY_RECORD_SIZE
+	uint16_t seq;			// gaps mean records the host did not poll in time
+	uint32_t time;			// TELEMETRY_TIME_HZ ticks since boot
+	uint32_t frequency;		// current_freq, Hz
+	uint32_t fb_rate;		// FB_rate, TELEMETRY_FB_RATE_KHZ per kHz
+	uint16_t gap;			// speaker buffer words between the USB writer and the DAC reader
+	uint16_t gap_nominal;	// where the feedback loop steers gap to
+	uint16_t packets;		// OUT packets per second
+	uint16_t underruns;		// since boot, DAC reader caught up with the USB writer
+	uint16_t overruns;		// since boot, USB writer caught up with the DAC reader
+	uint16_t cpu_load;		// permille over the last run-time stats period
+	uint32_t samples;		// samples per second from the host
+} telemetry_record_t;
+
+//
+// the tags of a frequency sweep, see sweep.h, sent as the steps are tuned
+// to, in place of a record of the period. Told apart by the version, the
+// size is the same, the seq runs on with the records.
+//
+#define TELEMETRY_SWEEP_VERSION		0x81
+#define TELEMETRY_SWEEP_TAGS		4
+
+typedef struct {
+	uint8_t version;		// TELEMETRY_SWEEP_VERSION
+	uint8_t size;			// TELEMETRY_RECORD_SIZE
+	uint16_t seq;
+	uint16_t pass;			// of the sweep, at step[0]
+	uint8_t tags;			// of step and block used
+	uint8_t lost;			// tags dropped before these, saturating
+	uint16_t step[TELEMETRY_SWEEP_TAGS];	// index into the sweep
+	uint32_t block[TELEMETRY_SWEEP_TAGS];	// ADC capture blocks since boot, the first wholly at step
+} telemetry_sweep_record_t;
+
+#define TELEMETRY_TIME_HZ			10000		// configTICK_RATE_HZ
+#define TELEMETRY_FB_RATE_KHZ		(1 << 14)	// FB_rate of 1 kHz, at either bus speed
+
+#define TELEMETRY_DG8SAQ_COMMAND	0x74	// vendor IN request, wValue = period in ms, reply the period
+#define TELEMETRY_PERIOD_READ		0xffff	// wValue that only reads the period back
+#define TELEMETRY_PERIOD_MIN		10		// ms, the endpoint bInterval at full speed
+
+#endif /* TELEMETRY_RECORD_H_ */
@@ -0,0 +1,73 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * uac1_audio_function.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The UAC1 audio function in one table, as uac2_audio_function.h is for
+ * UAC2: the stream format, the endpoint service intervals and the sample
+ * rates of the format type descriptors.
+ *
+ * uac1_usb_descriptors.h takes its format fields, endpoint intervals and
+ * packet sizes from here, the format type descriptors list UAC1_RATES or
+ * UAC1_WIDGET_RATES with UAC1_SAM_FREQ(), and the sampling frequency
+ * GET_MIN/GET_MAX replies are UAC1_RATE_MIN and UAC1_RATE_MAX. The rate
+ * switch itself is the 44.1/48 kHz oscillator mux, a rate beyond those
+ * needs a clock as well. The usb-desc-check host tool holds the compiled
+ * descriptors against it.
+ *
+ * Only plain integer constants and macros, the host tool includes it too.
+ */
+
+#ifndef UAC1_AUDIO_FUNCTION_H_
+#define UAC1_AUDIO_FUNCTION_H_
+
+// both streams
+#define UAC1_NB_CHANNELS			2
+#define UAC1_SUBSLOT_SIZE			3			// bytes per sample on the bus
+#define UAC1_BIT_RESOLUTION			24
+
+// bInterval of the audio endpoints, one packet a ms at either speed
+#define UAC1_EP_INTERVAL_FS			1			// 2^(n-1) frames
+#define UAC1_EP_INTERVAL_HS			4			// 2^(n-1) microframes
+
+// the rates of the format type descriptors, ascending; the widget
+// configurations offer 48 kHz only
+#define UAC1_RATE_MIN				44100
+#define UAC1_RATE_MAX				48000
+
+#define UAC1_RATES(X)		\
+	X(UAC1_RATE_MIN)		\
+	X(UAC1_RATE_MAX)
+
+#define UAC1_WIDGET_RATES(X)	\
+	X(UAC1_RATE_MAX)
+
+//
+// derived, nothing to edit below
+//
+
+#define UAC1_INTERVAL_US_FS			(1000 << (UAC1_EP_INTERVAL_FS - 1))
+#define UAC1_INTERVAL_US_HS			(125 << (UAC1_EP_INTERVAL_HS - 1))
+
+// bytes in one service interval of us microseconds at rate, with room
+// for the extra sample the feedback may ask for
+#define UAC1_EP_BYTES(rate, us)		\
+	((((rate) * (us) + 999999) / 1000000 + 1) * UAC1_NB_CHANNELS * UAC1_SUBSLOT_SIZE)
+
+#define UAC1_EP_SIZE_FS				UAC1_EP_BYTES(UAC1_RATE_MAX, UAC1_INTERVAL_US_FS)
+#define UAC1_EP_SIZE_HS				UAC1_EP_BYTES(UAC1_RATE_MAX, UAC1_INTERVAL_US_HS)
+
+// bSamFreqType, then tSamFreq of each rate, 3 bytes little endian in the
+// U16 and U8 halves of S_usb_format_type_1
+#define UAC1_RATE_COUNT(rate)		+ 1
+#define UAC1_NB_RATES(rates)		(0 rates(UAC1_RATE_COUNT))
+#define UAC1_SAM_FREQ(rate)			Usb_format_mcu_to_usb_data(16, (rate) & 0xffff), ((rate) >> 16) & 0xff,
+
+// S_usb_format_type_1 has room for two
+#if UAC1_NB_RATES(UAC1_RATES) > 2 || UAC1_NB_RATES(UAC1_WIDGET_RATES) > 2
+#error UAC1 format type descriptors hold two rates at most
+#endif
+
+#endif /* UAC1_AUDIO_FUNCTION_H_ */
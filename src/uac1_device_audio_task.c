@@ -84,6 +84,12 @@
 
 #include "composite_widget.h"
 #include "taskAK5394A.h"
+#include "ram_budget.h"
+#include "eventlog.h"
+#include "stream_health.h"
+#include "iq_correction.h"
+#include "usb_power.h"
+#include "taskStartupLeds.h"
 
 //_____ M A C R O S ________________________________________________________
 
@@ -101,12 +107,36 @@
 
 static U32  index, spk_index;
 static U16  old_gap = SPK_BUFFER_SIZE;
+static U16  spk_gap = SPK_BUFFER_SIZE, mic_gap = AUDIO_BUFFER_SIZE;	// last gaps, for the stream health
 static U8 audio_buffer_out, spk_buffer_in;	// the ID number of the buffer used for sending out to the USB
 static volatile U32 *audio_buffer_ptr;
 //static volatile U32 *spk_buffer_ptr;
 
 static U8 ep_audio_in, ep_audio_out, ep_audio_out_fb;
 
+//!
+//! @brief Restart the record stream from the start of buffer 0 after a
+//! resume, the PDCA on the next LRCK frame so the channels come in the
+//! right order. The playback side kept its place through the suspend.
+//!
+static void uac1_device_audio_mic_resync(void)
+{
+	pdca_disable_interrupt_reload_counter_zero(PDCA_CHANNEL_SSC_RX);
+	pdca_disable(PDCA_CHANNEL_SSC_RX);
+
+	audio_buffer_in = 0;
+	audio_buffer_out = 0;
+	index = 0;
+
+	if (!FEATURE_ADC_NONE){
+		// Start with left channel - FS goes low
+		while (!gpio_get_pin_value(AK5394_LRCK));
+		while (gpio_get_pin_value(AK5394_LRCK));
+		AK5394A_pdca_enable();
+		pdca_enable(PDCA_CHANNEL_SSC_RX);
+	}
+}
+
 //!
 //! @brief This function initializes the hardware/software resources
 //! required for device Audio task.
@@ -127,12 +157,12 @@ void uac1_device_audio_task_init(U8 ep_in, U8 ep_out, U8 ep_out_fb)
 	ep_audio_out = ep_out;
 	ep_audio_out_fb = ep_out_fb;
 
-	xTaskCreate(uac1_device_audio_task,
+	ram_budget_task_create(uac1_device_audio_task,
 				configTSK_USB_DAUDIO_NAME,
 				configTSK_USB_DAUDIO_STACK_SIZE,
 				NULL,
 				configTSK_USB_DAUDIO_PRIORITY,
-				NULL);
+				ram_budget_device_audio_stack);
 }
 
 //!
@@ -173,24 +203,23 @@ void uac1_device_audio_task(void *pvParameters)
 		// First, check the device enumeration state
 		if (!Is_device_enumerated()) { time=0; startup=TRUE; continue; };
 
-		if( startup ) {
+		// suspended, the clocks are gated and the streams hold their place
+		if (usb_power_suspended) continue;
+		if (usb_power_resync() && !startup) uac1_device_audio_mic_resync();
 
-
-			time+=UAC1_configTSK_USB_DAUDIO_PERIOD;
+		if( startup ) {
+			// the LED walk plays in its own task, the streams start as soon
+			// as the clocks have settled and the ADC is out of calibration
 #define STARTUP_LED_DELAY  10000
-			if ( time<= 1*STARTUP_LED_DELAY ) {
-				LED_On( LED0 );
+#define STARTUP_SETTLE     10			// 1ms at 10kHz tick
+			if ( time == 0 ) {
+				device_audio_enumerated();
+				startup_leds_play(STARTUP_LED_DELAY);
 				pdca_disable_interrupt_reload_counter_zero(PDCA_CHANNEL_SSC_RX);
 				pdca_disable(PDCA_CHANNEL_SSC_RX);
-				//	            LED_On( LED1 );
-			} else if( time== 2*STARTUP_LED_DELAY ) LED_On( LED1 );
-			else if( time== 3*STARTUP_LED_DELAY ) LED_On( LED2 );
-			else if( time== 4*STARTUP_LED_DELAY ) LED_On( LED3 );
-			else if( time== 5*STARTUP_LED_DELAY ) LED_Off( LED0 );
-			else if( time== 6*STARTUP_LED_DELAY ) LED_Off( LED1 );
-			else if( time== 7*STARTUP_LED_DELAY ) LED_Off( LED2 );
-			else if( time== 8*STARTUP_LED_DELAY ) LED_Off( LED3 );
-			else if( time >= 9*STARTUP_LED_DELAY ) {
+			}
+			time+=UAC1_configTSK_USB_DAUDIO_PERIOD;
+			if ( time >= STARTUP_SETTLE && (!FEATURE_ADC_AK5394A || !gpio_get_pin_value(AK5394_CAL)) ) {
 				startup=FALSE;
 
 				audio_buffer_in = 0;
@@ -240,6 +269,13 @@ void uac1_device_audio_task(void *pvParameters)
 						gap = (AUDIO_BUFFER_SIZE - index) + (AUDIO_BUFFER_SIZE - num_remaining);
 					}
 
+					// count each time reader and writer come within a margin of each other
+#define MIC_GAP_MARGIN	(AUDIO_BUFFER_SIZE / 8)
+					if (gap < MIC_GAP_MARGIN && mic_gap >= MIC_GAP_MARGIN)
+						STREAM_HEALTH_COUNT(sh_mic_underrun);
+					else if (gap > 2*AUDIO_BUFFER_SIZE - MIC_GAP_MARGIN && mic_gap <= 2*AUDIO_BUFFER_SIZE - MIC_GAP_MARGIN)
+						STREAM_HEALTH_COUNT(sh_mic_overrun);
+					mic_gap = gap;
 
 					// Sync the USB stream with the AK stream
 					// throttle back
@@ -252,7 +288,11 @@ void uac1_device_audio_task(void *pvParameters)
 						}
 					}
 
-					Usb_reset_endpoint_fifo_access(EP_AUDIO_IN);
+					// the IQ of the DG8SAQ image corrected in place, one matrix a packet
+					if (FEATURE_IMAGE_UAC1_DG8SAQ && iq_correction_latch() && !mute)
+						iq_correction_ahead(audio_buffer_out, index, num_samples, IN_LEFT, IN_RIGHT);
+
+					Usb_reset_endpoint_fifo_access(EP_AUDIO_IN);
 					for( i=0 ; i < num_samples ; i++ ) {
 						// Fill endpoint with sample raw
 						if (mute==FALSE) {
@@ -300,6 +340,7 @@ void uac1_device_audio_task(void *pvParameters)
 						}
 					}
 					Usb_send_in(EP_AUDIO_IN);		// send the current bank
+					if (!startup) device_audio_first_sample(DEVICE_AUDIO_RECORD);
 				}
 			} // end alt setting == 1
 
@@ -324,12 +365,19 @@ void uac1_device_audio_task(void *pvParameters)
 					}
 
 					if (playerStarted) {
+#define SPK_GAP_MARGIN	(SPK_BUFFER_SIZE / 8)
+						if (gap < SPK_GAP_MARGIN && spk_gap >= SPK_GAP_MARGIN)
+							STREAM_HEALTH_COUNT(sh_spk_overrun);
+						else if (gap > 2*SPK_BUFFER_SIZE - SPK_GAP_MARGIN && spk_gap <= 2*SPK_BUFFER_SIZE - SPK_GAP_MARGIN)
+							STREAM_HEALTH_COUNT(sh_spk_underrun);
+						spk_gap = gap;
+
 						if ((gap < (SPK_BUFFER_SIZE/2)) && (gap < old_gap)) {
 						//if ((gap < SPK_BUFFER_SIZE - 10) && (delta_num > -FB_RATE_DELTA_NUM)) {
 							LED_On(LED0);
 							FB_rate -= FB_RATE_DELTA;
 //							delta_num--;
-							print_dbg_char_char('-');
+							eventlog_put(ev_fb_adjust, -FB_RATE_DELTA, gap, FB_rate);
 							old_gap = gap;
 						}
 						else if ( (gap > (SPK_BUFFER_SIZE + (SPK_BUFFER_SIZE/2))) && (gap > old_gap)) {
@@ -338,7 +386,7 @@ void uac1_device_audio_task(void *pvParameters)
 							FB_rate += FB_RATE_DELTA;
 //							delta_num++;
 							old_gap = gap;
-							print_dbg_char_char('+');
+							eventlog_put(ev_fb_adjust, FB_RATE_DELTA, gap, FB_rate);
 						}
 						else {
 							LED_Off(LED0);
@@ -371,16 +419,22 @@ void uac1_device_audio_task(void *pvParameters)
 				}
 
 				if (Is_usb_out_received(EP_AUDIO_OUT)) {
-					spk_usb_heart_beat++;			// indicates EP_AUDIO_OUT receiving data from host
-
 					Usb_reset_endpoint_fifo_access(EP_AUDIO_OUT);
-					num_samples = Usb_byte_count(EP_AUDIO_OUT) / 6;
+					num_samples = Usb_byte_count(EP_AUDIO_OUT);
+					if (num_samples % 6 != 0)
+						STREAM_HEALTH_COUNT(sh_odd_packet);
+					num_samples = num_samples / 6;
+					if (playerStarted && num_samples + 1 < current_freq.frequency / 1000)
+						STREAM_HEALTH_COUNT(sh_short_packet);
+					spk_usb_counters_update(num_samples);	// indicates EP_AUDIO_OUT receiving data from host
 
 					if(!playerStarted) {
 
 //						gpio_set_gpio_pin(AVR32_PIN_PX55); // BSB debug 20120912, positive edge marks playerStarted FALSE->TRUE
 
 						playerStarted = TRUE;
+						device_audio_first_sample(DEVICE_AUDIO_PLAYBACK);
+						STREAM_HEALTH_COUNT(sh_resync);
 						num_remaining = spk_pdca_channel->tcr;
 
 //						if (spk_buffer_in != spk_buffer_out) {
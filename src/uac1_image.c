@@ -41,6 +41,11 @@
 #include "taskMoboCtrl.h"
 #include "taskPowerDisplay.h"
 #include "taskPushButtonMenu.h"
+#include "taskRunStats.h"
+#include "eventlog.h"
+#include "dg8saq_queue.h"
+#include "taskStartupLeds.h"
+#include "ram_budget.h"
 #include "wdt.h"
 
 #if LCD_DISPLAY				// Multi-line LCD display
@@ -66,6 +71,11 @@ static void x_image_init(void) {
 }
 
 static void x_image_task_init(void) {
+  // Control requests answered without polling EP0
+  usb_ctrl_register(DRT_MASK, DRT_VENDOR, usb_user_DG8SAQ);
+  usb_ctrl_register(DRR_MASK, DRR_INTERFACE, uac1_user_hid_request);
+  usb_ctrl_register(DRT_MASK, DRT_CLASS, uac1_user_audio_request);
+
   // Initialize USB task
   usb_task_init();
 
@@ -79,15 +89,20 @@ static void x_image_task_init(void) {
   vStartTaskPushButtonMenu();
 #endif
   vStartTaskMoboCtrl();
+  vStartTaskDG8SAQ();
   // vStartTaskEXERCISE( tskIDLE_PRIORITY );
   uac1_AK5394A_task_init();
   device_mouse_hid_task_init(UAC1_EP_HID_RX, UAC1_EP_HID_TX);
   uac1_device_audio_task_init(UAC1_EP_AUDIO_IN, UAC1_EP_AUDIO_OUT, UAC1_EP_AUDIO_OUT_FB);
+  vStartTaskRunStats();
+  vStartTaskEventLog();
+  vStartTaskStartupLeds();
 #endif
 #if LCD_DISPLAY						// Multi-line LCD display
 	if ( ! FEATURE_LOG_NONE )
 		vStartTaskStartupLogDisplay();
 #endif
+  ram_budget_report();
 }
 
 // descriptor accessors
@@ -151,9 +166,6 @@ static uint16_t x_image_get_qualifier_desc_length(void) {
 static void x_image_user_endpoint_init(uint8_t conf_nb) {
 	uac1_user_endpoint_init(conf_nb);
 }
-static Bool x_image_user_read_request(uint8_t type, uint8_t request) {
-	return uac1_user_read_request(type, request);
-}
 static void x_image_user_set_interface(U8 wIndex, U8 wValue) {
 	uac1_user_set_interface(wIndex, wValue);
 }
@@ -181,7 +193,6 @@ const image_t uac1_audio_image = {
 	NULL,
 #endif
 	x_image_user_endpoint_init,
-	x_image_user_read_request,
 	x_image_user_set_interface
 };
 
@@ -207,7 +218,6 @@ const image_t uac1_dg8saq_image = {
 	NULL,
 #endif
 	x_image_user_endpoint_init,
-	x_image_user_read_request,
 	x_image_user_set_interface
 };
 
@@ -52,7 +52,10 @@
 #include "device_audio_task.h"
 #include "uac1_device_audio_task.h"
 #include "taskAK5394A.h"
+#include "stream_health.h"
+#include "usb_power.h"
 #include "uac1_taskAK5394A.h"
+#include "ram_budget.h"
 #include "Mobo_config.h"
 
 //_____ M A C R O S ________________________________________________________
@@ -69,12 +72,12 @@ void uac1_AK5394A_task(void*);
 //!
 void uac1_AK5394A_task_init(void) {
 	AK5394A_task_init(TRUE);
-	xTaskCreate(uac1_AK5394A_task,
+	ram_budget_task_create(uac1_AK5394A_task,
 				configTSK_AK5394A_NAME,
 				configTSK_AK5394A_STACK_SIZE,
 				NULL,
 				UAC1_configTSK_AK5394A_PRIORITY,
-				NULL);
+				ram_budget_AK5394A_stack);
 }
 
 //!
@@ -85,6 +88,8 @@ void uac1_AK5394A_task(void *pvParameters) {
 	xLastWakeTime = xTaskGetTickCount();
 
 	int i;
+	spk_usb_counts_t spk_usb;
+	Bool spk_streaming = FALSE;
 
 	while (TRUE) {
 		// All the hardwork is done by the pdca and the interrupt handler.
@@ -92,6 +97,12 @@ void uac1_AK5394A_task(void *pvParameters) {
 
 		vTaskDelayUntil(&xLastWakeTime, UAC1_configTSK_AK5394A_PERIOD);
 
+		// no OUT packets while suspended is not a stall
+		if (usb_power_suspended) {
+			spk_streaming = FALSE;
+			continue;
+		}
+
 		if (freq_changed) {
 			spk_mute = TRUE;
 			if (current_freq.frequency == 48000)
@@ -145,13 +156,20 @@ void uac1_AK5394A_task(void *pvParameters) {
 */
 
 // silence speaker if USB data out is stalled, as indicated by heart-beat counter
-		if (old_spk_usb_heart_beat == spk_usb_heart_beat){
+		spk_usb_counters_read(&spk_usb);
+		if (old_spk_usb_heart_beat == spk_usb.heart_beat){
+				// a stream that stops while still selected is a stall
+				if (spk_streaming && usb_alternate_setting_out == 1)
+					STREAM_HEALTH_COUNT(sh_spk_stall);
+				spk_streaming = FALSE;
 				for (i = 0; i < SPK_BUFFER_SIZE; i++) {
 					spk_buffer_0[i] = 0;
 					spk_buffer_1[i] = 0;
 				}
 		}
-		old_spk_usb_heart_beat = spk_usb_heart_beat;
+		else
+			spk_streaming = TRUE;
+		old_spk_usb_heart_beat = spk_usb.heart_beat;
 
 		if (FEATURE_IMAGE_UAC1_DG8SAQ) {
 			spk_mute = TX_state ? FALSE : TRUE;
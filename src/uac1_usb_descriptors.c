@@ -300,11 +300,7 @@ const S_usb_user_configuration_descriptor uac1_usb_conf_desc_fs =
 	   ,  FORMAT_NB_CHANNELS
 	   ,  FORMAT_FRAME_SIZE
 	   ,  FORMAT_BIT_RESOLUTION
-	   ,  FORMAT_SAMPLE_FREQ_NB
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_441)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_48)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
+	   ,  FORMAT_SAMPLE_FREQ(UAC1_RATES)
     }
 	,
 	{   sizeof(S_usb_endpoint_audio_descriptor_1)
@@ -372,11 +368,7 @@ const S_usb_user_configuration_descriptor uac1_usb_conf_desc_fs =
 	   ,  FORMAT_NB_CHANNELS
 	   ,  FORMAT_FRAME_SIZE
 	   ,  FORMAT_BIT_RESOLUTION
-	   ,  FORMAT_SAMPLE_FREQ_NB
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_441)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_48)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
+	   ,  FORMAT_SAMPLE_FREQ(UAC1_RATES)
 	}
     ,
 	{   sizeof(S_usb_endpoint_audio_descriptor_1)
@@ -604,11 +596,7 @@ const S_usb_user_configuration_descriptor uac1_usb_conf_desc_hs =
 	   ,  FORMAT_NB_CHANNELS
 	   ,  FORMAT_FRAME_SIZE
 	   ,  FORMAT_BIT_RESOLUTION
-	   ,  FORMAT_SAMPLE_FREQ_NB
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_441)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_48)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
+	   ,  FORMAT_SAMPLE_FREQ(UAC1_RATES)
 	}
 	,
     {   sizeof(S_usb_endpoint_audio_descriptor_1)
@@ -676,11 +664,7 @@ const S_usb_user_configuration_descriptor uac1_usb_conf_desc_hs =
 	   ,  FORMAT_NB_CHANNELS
 	   ,  FORMAT_FRAME_SIZE
 	   ,  FORMAT_BIT_RESOLUTION
-	   ,  FORMAT_SAMPLE_FREQ_NB
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_441)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_48)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
+	   ,  FORMAT_SAMPLE_FREQ(UAC1_RATES)
     }
 	,
 	{   sizeof(S_usb_endpoint_audio_descriptor_1)
@@ -907,9 +891,7 @@ const S_usb_user_configuration_descriptor uac1_usb_conf_desc_hs_widget =
 	   ,  FORMAT_NB_CHANNELS
 	   ,  FORMAT_FRAME_SIZE
 	   ,  FORMAT_BIT_RESOLUTION
-	   ,  0x01
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_48)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
+	   ,  FORMAT_SAMPLE_FREQ(UAC1_WIDGET_RATES)
 	}
 	,
     {   sizeof(S_usb_endpoint_audio_descriptor_1)
@@ -979,9 +961,7 @@ const S_usb_user_configuration_descriptor uac1_usb_conf_desc_hs_widget =
 	   ,  FORMAT_NB_CHANNELS
 	   ,  FORMAT_FRAME_SIZE
 	   ,  FORMAT_BIT_RESOLUTION
-	   ,  0x01
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_48)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
+	   ,  FORMAT_SAMPLE_FREQ(UAC1_WIDGET_RATES)
     }
 	,
 	{   sizeof(S_usb_endpoint_audio_descriptor_1)
@@ -1209,9 +1189,7 @@ const S_usb_user_configuration_descriptor uac1_usb_conf_desc_fs_widget =
 	   ,  FORMAT_NB_CHANNELS
 	   ,  FORMAT_FRAME_SIZE
 	   ,  FORMAT_BIT_RESOLUTION
-	   ,  0x01
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_48)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
+	   ,  FORMAT_SAMPLE_FREQ(UAC1_WIDGET_RATES)
     }
 	,
 	{   sizeof(S_usb_endpoint_audio_descriptor_1)
@@ -1281,9 +1259,7 @@ const S_usb_user_configuration_descriptor uac1_usb_conf_desc_fs_widget =
 	   ,  FORMAT_NB_CHANNELS
 	   ,  FORMAT_FRAME_SIZE
 	   ,  FORMAT_BIT_RESOLUTION
-	   ,  0x01
-	   ,  Usb_format_mcu_to_usb_data(16, FORMAT_LSBYTE_SAMPLE_FREQ_48)
-	   ,  FORMAT_MSBYTE_SAMPLE_FREQ
+	   ,  FORMAT_SAMPLE_FREQ(UAC1_WIDGET_RATES)
 	}
     ,
 	{   sizeof(S_usb_endpoint_audio_descriptor_1)
@@ -48,6 +48,7 @@
 #include "usb_task.h"
 #include "usb_descriptors.h"
 #include "hid.h"
+#include "uac1_audio_function.h"
 
 //_____ M A C R O S ________________________________________________________
 
@@ -132,12 +133,12 @@
 #define ENDPOINT_NB_3       ( UAC1_EP_AUDIO_OUT )
 #define EP_ATTRIBUTES_3     0b00000101      // ISOCHRONOUS ASYNCHRONOUS EXPLICIT FEEDBACK
 //#define EP_ATTRIBUTES_3     0b00001101      // ISOCHRONOUS SYNCHRONOUS
-#define EP_IN_LENGTH_3_HS   294				// 3 bytes * 48 khz * stereo + 6 bytes for add sample
-#define EP_IN_LENGTH_3_FS	294
+#define EP_IN_LENGTH_3_HS   UAC1_EP_SIZE_HS	// 3 bytes * 48 khz * stereo + 6 bytes for add sample
+#define EP_IN_LENGTH_3_FS	UAC1_EP_SIZE_FS
 #define EP_SIZE_3_FS		EP_IN_LENGTH_3_FS
 #define EP_SIZE_3_HS        EP_IN_LENGTH_3_HS
-#define EP_INTERVAL_3_FS	0x01			 // one packet per uframe
-#define EP_INTERVAL_3_HS    0x04			 // One packet per 8 uframe
+#define EP_INTERVAL_3_FS	UAC1_EP_INTERVAL_FS	// one packet per frame
+#define EP_INTERVAL_3_HS    UAC1_EP_INTERVAL_HS	// One packet per 8 uframe
 #define EP_BSYNC_ADDRESS_3	0x05			 // feedback EP is EP 5
 //#define EP_BSYNC_ADDRESS_3	0x04			 // feedback EP is EP 4 - using audio input pipe to sync
 //#define EP_BSYNC_ADDRESS_3	0x00
@@ -145,12 +146,12 @@
 // USB Endpoint 4 descriptor
 #define ENDPOINT_NB_4       ( UAC1_EP_AUDIO_IN | MSK_EP_DIR )
 #define EP_ATTRIBUTES_4     0b00100101      // ISOCHRONOUS ASYNCHRONOUS IMPLICIT FEEDBACK
-#define EP_IN_LENGTH_4_HS   294				// 3 bytes * 48 khz * stereo + 6 bytes for add sample
-#define EP_IN_LENGTH_4_FS	294
+#define EP_IN_LENGTH_4_HS   UAC1_EP_SIZE_HS	// 3 bytes * 48 khz * stereo + 6 bytes for add sample
+#define EP_IN_LENGTH_4_FS	UAC1_EP_SIZE_FS
 #define EP_SIZE_4_FS		EP_IN_LENGTH_4_FS
 #define EP_SIZE_4_HS        EP_IN_LENGTH_4_HS
-#define EP_INTERVAL_4_FS	0x01			 // one packet per uframe
-#define EP_INTERVAL_4_HS    0x04			 // One packet per 8 uframe
+#define EP_INTERVAL_4_FS	UAC1_EP_INTERVAL_FS	// one packet per frame
+#define EP_INTERVAL_4_HS    UAC1_EP_INTERVAL_HS	// One packet per 8 uframe
 
 /* Note:  The EPs have to be re-arranged.  Feedback EP has to be immediately following the OUT EP
 // USB Endpoint 5 descriptor*/
@@ -176,7 +177,7 @@
 #define INPUT_TERMINAL_ID				0x01
 #define INPUT_TERMINAL_TYPE				0x0201 	// Terminal is microphone
 #define INPUT_TERMINAL_ASSOCIATION		0x00   	// No association
-#define INPUT_TERMINAL_NB_CHANNELS		0x02   	// Two channels for input terminal
+#define INPUT_TERMINAL_NB_CHANNELS		UAC1_NB_CHANNELS	// Two channels for input terminal
 #define INPUT_TERMINAL_CHANNEL_CONF		0x0003 	// Two channels at front left and front right positions
 #define INPUT_TERMINAL_CH_NAME_ID		0x00	// No channel name
 
@@ -199,7 +200,7 @@
 #define SPK_INPUT_TERMINAL_ID			0x11
 #define SPK_INPUT_TERMINAL_TYPE			0x0101	// USB Streaming
 #define SPK_INPUT_TERMINAL_ASSOCIATION	0x00	// No association
-#define SPK_INPUT_TERMINAL_NB_CHANNELS	0x02	// Two channels - stereo
+#define SPK_INPUT_TERMINAL_NB_CHANNELS	UAC1_NB_CHANNELS	// Two channels - stereo
 #define SPK_INPUT_TERMINAL_CHANNEL_CONF	0x0003	// left front and right front
 #define SPK_INPUT_TERMINAL_CH_NAME_ID	0x00	// No channel name
 
@@ -245,15 +246,11 @@
 #define AS_FORMAT_TAG						0x0001 // PCM Format
 // Format type for ALT1
 #define FORMAT_TYPE							0x01	// Format TypeI
-#define FORMAT_NB_CHANNELS					0x02	// Two Channels
-#define FORMAT_FRAME_SIZE					0x03	// 3 bytes per audio sample
-#define FORMAT_BIT_RESOLUTION				0x18	// 24 bits per sample
-#define FORMAT_SAMPLE_FREQ_NB				0x02	// Two frequency supported
-#define FORMAT_LSBYTE_SAMPLE_FREQ_441		0xac44	// 44.1khz
-#define FORMAT_LSBYTE_SAMPLE_FREQ_48		0xbb80	// 48khz
-#define FORMAT_MSBYTE_SAMPLE_FREQ			0x00	// MsByte
-//#define FORMAT_LSBYTE_SAMPLE_FREQ			0x7700	// 96khz
-//#define FORMAT_MSBYTE_SAMPLE_FREQ			0x01	// MsByte
+#define FORMAT_NB_CHANNELS					UAC1_NB_CHANNELS
+#define FORMAT_FRAME_SIZE					UAC1_SUBSLOT_SIZE	// bytes per audio sample
+#define FORMAT_BIT_RESOLUTION				UAC1_BIT_RESOLUTION
+// bSamFreqType and the rates, UAC1_RATES or UAC1_WIDGET_RATES
+#define FORMAT_SAMPLE_FREQ(rates)			UAC1_NB_RATES(rates), rates(UAC1_SAM_FREQ)
 
 
 //Audio endpoint specific descriptor field
@@ -88,6 +88,7 @@
 #include "device_audio_task.h"
 #include "uac1_device_audio_task.h"
 #include "taskAK5394A.h"
+#include "stream_health.h"
 
 
 //_____ M A C R O S ________________________________________________________
@@ -112,17 +113,10 @@
 // S_freq current_freq;
 // Bool freq_changed = FALSE;
 
-static U8    usb_type;
-static U8    wValue_msb;
-static U8    wValue_lsb;
-static U16   wIndex;
-static U16   wLength;
-
 static U8			speed = 1;		// speed == 0, sample rate = 44.1khz
 									// speed == 1, sample rate = 48khz
 
-extern const    void *pbuffer;
-extern          U16   data_to_transfer;
+static U8			uac1_control_buffer[4];		// parameter block of an audio class request
 
 //_____ D E C L A R A T I O N S ____________________________________________
 
@@ -162,646 +156,265 @@ void uac1_user_set_interface(U8 wIndex, U8 wValue) {
 	}
 }
 
-static Bool uac1_user_get_interface_descriptor() {
-	Bool    zlp;
-	U16     wLength;
-	U16		wIndex;
-	U8      descriptor_type;
-	U8      string_type;
-	U16		wInterface;
-
-	// print_dbg_char_char('a'); // BSB debug 20120803
-
-	zlp             = FALSE;                                  /* no zero length packet */
-	string_type     = Usb_read_endpoint_data(EP_CONTROL, 8);  /* read LSB of wValue    */
-	descriptor_type = Usb_read_endpoint_data(EP_CONTROL, 8);  /* read MSB of wValue    */
-	wInterface = usb_format_usb_to_mcu_data(16,Usb_read_endpoint_data(EP_CONTROL, 16));
-	switch( descriptor_type ) {
-	case HID_DESCRIPTOR:
+//! The report data of a HID SET_REPORT arrived, it was received in place.
+//!
+static Bool uac1_user_hid_report_received(const S_usb_setup_data *setup, U8 *data, U16 length)
+{
+	return TRUE;
+}
 
-		// print_dbg_char_char('b'); // BSB debug 20120803
+//! @brief This function is the handler of the HID interface requests,
+//! registered with usb_ctrl_register(). It returns FALSE for requests to
+//! the other interfaces and the HID requests it does not decode, which
+//! then go to uac1_user_audio_request().
+//!
+Bool uac1_user_hid_request(const S_usb_setup_data *setup)
+{
+	U8 report_type = MSB(setup->wValue);
 
-		if (wInterface == DSC_INTERFACE_HID) {
+	if (setup->bmRequestType == IN_INTERFACE && setup->bRequest == GET_DESCRIPTOR) {
+		switch (MSB(setup->wValue)) {
+		case HID_DESCRIPTOR:
+			if (setup->wIndex != DSC_INTERFACE_HID)
+				return TRUE;	// stalled
 #if (USB_HIGH_SPEED_SUPPORT==DISABLED)
-
-			// print_dbg_char_char('c'); // BSB debug 20120803
-
-			if (FEATURE_BOARD_WIDGET) {
-				data_to_transfer = sizeof(uac1_usb_conf_desc_fs_widget.hid);
-				pbuffer          = (const U8*)&uac1_usb_conf_desc_fs_widget.hid;
-			} else {
-				data_to_transfer = sizeof(uac1_usb_conf_desc_fs.hid);
-				pbuffer          = (const U8*)&uac1_usb_conf_desc_fs.hid;
-			}
-			break;
+			if (FEATURE_BOARD_WIDGET)
+				usb_ctrl_send(&uac1_usb_conf_desc_fs_widget.hid, sizeof(uac1_usb_conf_desc_fs_widget.hid));
+			else
+				usb_ctrl_send(&uac1_usb_conf_desc_fs.hid, sizeof(uac1_usb_conf_desc_fs.hid));
 #else
-
-			// print_dbg_char_char('d'); // BSB debug 20120803
-
 			if (FEATURE_BOARD_WIDGET) {
-				if( Is_usb_full_speed_mode() ) {
-					data_to_transfer = sizeof(uac1_usb_conf_desc_fs_widget.hid);
-					pbuffer          = (const U8*)&uac1_usb_conf_desc_fs_widget.hid;
-				} else {
-					data_to_transfer = sizeof(uac1_usb_conf_desc_hs_widget.hid);
-					pbuffer          = (const U8*)&uac1_usb_conf_desc_hs_widget.hid;
-				}
+				if( Is_usb_full_speed_mode() )
+					usb_ctrl_send(&uac1_usb_conf_desc_fs_widget.hid, sizeof(uac1_usb_conf_desc_fs_widget.hid));
+				else
+					usb_ctrl_send(&uac1_usb_conf_desc_hs_widget.hid, sizeof(uac1_usb_conf_desc_hs_widget.hid));
 			} else {
-				if( Is_usb_full_speed_mode() ) {
-					data_to_transfer = sizeof(uac1_usb_conf_desc_fs.hid);
-					pbuffer          = (const U8*)&uac1_usb_conf_desc_fs.hid;
-				} else {
-					data_to_transfer = sizeof(uac1_usb_conf_desc_hs.hid);
-					pbuffer          = (const U8*)&uac1_usb_conf_desc_hs.hid;
-				}
+				if( Is_usb_full_speed_mode() )
+					usb_ctrl_send(&uac1_usb_conf_desc_fs.hid, sizeof(uac1_usb_conf_desc_fs.hid));
+				else
+					usb_ctrl_send(&uac1_usb_conf_desc_hs.hid, sizeof(uac1_usb_conf_desc_hs.hid));
 			}
-			break;
 #endif
-		}
-		return FALSE;
-	case HID_REPORT_DESCRIPTOR:
-
-		// print_dbg_char_char('e'); // BSB debug 20120803
+			return TRUE;
 
-		//? Why doesn't this test for wInterface == DSC_INTERFACE_HID ?
-		data_to_transfer = sizeof(usb_hid_report_descriptor);
-		pbuffer          = usb_hid_report_descriptor;
-		break;
-	case HID_PHYSICAL_DESCRIPTOR:
+		case HID_REPORT_DESCRIPTOR:
+			//? Why doesn't this test for wInterface == DSC_INTERFACE_HID ?
+			usb_ctrl_send(usb_hid_report_descriptor, sizeof(usb_hid_report_descriptor));
+			return TRUE;
 
-		// print_dbg_char_char('f'); // BSB debug 20120803
+		case HID_PHYSICAL_DESCRIPTOR:
+			// TODO
+		default:
+			return TRUE;	// stalled
+		}
+	}
 
-		// TODO
+	if (setup->wIndex != DSC_INTERFACE_HID)
 		return FALSE;
-	default:
-
-		// print_dbg_char_char('g'); // BSB debug 20120803
 
-		return FALSE;
-	}
+	if (setup->bmRequestType == OUT_CL_INTERFACE) { // USB_SETUP_SET_CLASS_INTER
+		switch (setup->bRequest) {
+		case HID_SET_REPORT:
+			// The MSB wValue field specifies the Report Type
+			// The LSB wValue field specifies the Report ID
+			switch (report_type) {
+			case HID_REPORT_OUTPUT:
+				usb_ctrl_receive(usb_report, 2, uac1_user_hid_report_received);
+				return TRUE;
+
+			case HID_REPORT_FEATURE:
+				usb_ctrl_receive(usb_feature_report, 2, uac1_user_hid_report_received);
+				return TRUE;
+
+			case HID_REPORT_INPUT:
+				// TODO
+			default:
+				break;
+			}
+			break;
 
-	wIndex = Usb_read_endpoint_data(EP_CONTROL, 16);
-	wIndex = usb_format_usb_to_mcu_data(16, wIndex);
-	wLength = Usb_read_endpoint_data(EP_CONTROL, 16);
-	wLength = usb_format_usb_to_mcu_data(16, wLength);
-	Usb_ack_setup_received_free();                          //!< clear the setup received flag
+		case HID_SET_IDLE:
+			// When the upper byte of wValue is 0 (zero), the duration is indefinite
+			// else from 0.004 to 1.020 seconds
+			g_u8_report_rate = report_type;
+			usb_ctrl_ack();
+			return TRUE;
 
-	if (wLength > data_to_transfer)
-		{
-			zlp = !(data_to_transfer % EP_CONTROL_LENGTH);  //!< zero length packet condition
-		}
-	else
-		{
-			data_to_transfer = wLength; //!< send only requested number of data bytes
+		case HID_SET_PROTOCOL:
+			// TODO
+			break;
 		}
+	}
 
-	Usb_ack_nak_out(EP_CONTROL);
-
-	while (data_to_transfer && (!Is_usb_nak_out(EP_CONTROL)))
-		{
-			while( !Is_usb_control_in_ready() && !Is_usb_nak_out(EP_CONTROL) );
+	if (setup->bmRequestType == IN_CL_INTERFACE) { // USB_SETUP_GET_CLASS_INTER
+		switch (setup->bRequest) {
+		case HID_GET_REPORT:
+			switch (report_type) {
+			case HID_REPORT_INPUT:
+				usb_ctrl_send(usb_report, 2);
+				return TRUE;
 
-			if( Is_usb_nak_out(EP_CONTROL) )
-				break;    // don't clear the flag now, it will be cleared after
+			case HID_REPORT_FEATURE:
+				usb_ctrl_send(usb_feature_report, 2);
+				return TRUE;
 
-			Usb_reset_endpoint_fifo_access(EP_CONTROL);
-			data_to_transfer = usb_write_ep_txpacket(EP_CONTROL, pbuffer,
-													 data_to_transfer, &pbuffer);
-			if( Is_usb_nak_out(EP_CONTROL) )
+			case HID_REPORT_OUTPUT:
+			default:
 				break;
-			else
-				Usb_ack_control_in_ready_send();  //!< Send data until necessary
-		}
-
-	if ( zlp && (!Is_usb_nak_out(EP_CONTROL)) )
-		{
-			while (!Is_usb_control_in_ready());
-			Usb_ack_control_in_ready_send();
-		}
-
-	while (!(Is_usb_nak_out(EP_CONTROL)));
-	Usb_ack_nak_out(EP_CONTROL);
-	while (!Is_usb_control_out_received());
-	Usb_ack_control_out_received_free();
+			}
+			break;
 
-	// print_dbg_char_char('h'); // BSB debug 20120803
+		case HID_GET_IDLE:
+			usb_ctrl_send(&g_u8_report_rate, 1);
+			return TRUE;
 
-	return TRUE;
-}
+		case HID_GET_PROTOCOL:
+			// TODO
+			break;
+		}
+	}
 
-//! @brief This function manages hid set idle request.
-//!
-//! @param Duration     When the upper byte of wValue is 0 (zero), the duration is indefinite else from 0.004 to 1.020 seconds
-//! @param Report ID    0 the idle rate applies to all input reports, else only applies to the Report ID
-//!
-void uac1_usb_hid_set_idle (U8 u8_report_id, U8 u8_duration ) // BSB 20120710 prefix "uac1_" added
-{
-   Usb_ack_setup_received_free();
-  
-   if( wIndex == DSC_INTERFACE_HID )
-     g_u8_report_rate = u8_duration;
-   
-   Usb_ack_control_in_ready_send();
-   while (!Is_usb_control_in_ready());
+	return FALSE;
 }
 
-
-//! @brief This function manages hid get idle request.
-//!
-//! @param Report ID    0 the idle rate applies to all input reports, else only applies to the Report ID
+//! Parameter blocks are little endian on the wire: the 3 byte sampling
+//! frequency of the streaming endpoints and the 2 byte volume.
 //!
-void uac1_usb_hid_get_idle (U8 u8_report_id) // BSB 20120710 prefix "uac1_" added
+static void uac1_put_sample_rate(U8 *buffer, U32 rate)
 {
-	Usb_ack_setup_received_free();
-   
-   if( (wLength != 0) && (wIndex == DSC_INTERFACE_HID) )
-   {
-      Usb_write_endpoint_data(EP_CONTROL, 8, g_u8_report_rate);
-      Usb_ack_control_in_ready_send();
-   }
-   
-   while (!Is_usb_control_out_received());
-   Usb_ack_control_out_received_free();
+	buffer[0] = rate;
+	buffer[1] = rate >> 8;
+	buffer[2] = rate >> 16;
 }
 
-void audio_get_min(void)
+static void uac1_put_volume(U8 *buffer, S16 volume)
 {
-   U16 i_unit;  // in wIndex
-   U16 length;  // in wLength
-
-   i_unit = wIndex % 256;			// wIndex high byte is interface number
-   length = wLength;
-
-   Usb_ack_setup_received_free();
-   Usb_reset_endpoint_fifo_access(EP_CONTROL);
-   if( i_unit==MIC_FEATURE_UNIT_ID )
-   {
-      switch (wValue_msb)
-      {
-      case CS_MUTE:
-         if( length==1 )
-         {
-            Usb_write_endpoint_data(EP_CONTROL, 8, mute);
-         }
-         break;
-      case CS_VOLUME:
-         if( length==2 )
-         {
-            Usb_write_endpoint_data(EP_CONTROL, 16, Usb_format_mcu_to_usb_data(16, VOL_MIN));
-         }
-         break;
-      }
-    } else if ( i_unit == SPK_FEATURE_UNIT_ID)
-      {
-         switch (wValue_msb)
-         {
-         case CS_MUTE:
-            if( length==1 )
-            {
-               Usb_write_endpoint_data(EP_CONTROL, 8, spk_mute);
-            }
-            break;
-         case CS_VOLUME:
-            if( length==2 )
-            {
-               Usb_write_endpoint_data(EP_CONTROL, 16, Usb_format_mcu_to_usb_data(16, VOL_MIN));
-            }
-            break;
-         }
-      }
-
-/*
-		// 44.1khz min sampling freq
-    	Usb_write_endpoint_data(EP_CONTROL, 8, 0x44);
-    	Usb_write_endpoint_data(EP_CONTROL, 8, 0xac);
-    	Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-*/
-
-   Usb_ack_control_in_ready_send();
-   while(!Is_usb_control_out_received());
-   Usb_ack_control_out_received_free();
+	buffer[0] = volume;
+	buffer[1] = volume >> 8;
 }
 
-void audio_get_max(void)
+static S16 uac1_get_volume(const U8 *data)
 {
-   U16 i_unit;
-   U16 length;
-   i_unit = wIndex % 256;
-   length = wLength;
-
-   Usb_ack_setup_received_free();
-
-   Usb_reset_endpoint_fifo_access(EP_CONTROL);
-   if( i_unit==MIC_FEATURE_UNIT_ID )
-   {
-      switch (wValue_msb)
-      {
-      case CS_MUTE:
-         if( length==1 )
-         {
-            Usb_write_endpoint_data(EP_CONTROL, 8, mute);
-         }
-         break;
-      case CS_VOLUME:
-         if( length==2 )
-         {
-            Usb_write_endpoint_data(EP_CONTROL, 16, Usb_format_mcu_to_usb_data(16, VOL_MAX));
-         }
-         break;
-      }
-   }
-   else if ( i_unit == SPK_FEATURE_UNIT_ID){
-	     switch (wValue_msb)
-	      {
-	      case CS_MUTE:
-	         if( length==1 )
-	         {
-	            Usb_write_endpoint_data(EP_CONTROL, 8, spk_mute);
-	         }
-	         break;
-	      case CS_VOLUME:
-	         if( length==2 )
-	         {
-	            Usb_write_endpoint_data(EP_CONTROL, 16, Usb_format_mcu_to_usb_data(16, VOL_MAX));
-	         }
-	         break;
-	      }
-   }
-
-/*
-		// 48khz max sampling freq
-		Usb_write_endpoint_data(EP_CONTROL, 8, 0x80);
-		Usb_write_endpoint_data(EP_CONTROL, 8, 0xbb);
-		Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-*/
-
-   Usb_ack_control_in_ready_send();
-   while(!Is_usb_control_out_received());
-   Usb_ack_control_out_received_free();
+	return data[0] | (data[1] << 8);
 }
 
-void audio_get_res(void)
+static void uac1_set_sample_rate(U8 rate_lsb)
 {
-   U16 i_unit;
-   U16 length;
-   i_unit = wIndex % 256;
-   length = wLength;
-
-   Usb_ack_setup_received_free();
-
-   Usb_reset_endpoint_fifo_access(EP_CONTROL);
-   if( i_unit==MIC_FEATURE_UNIT_ID )
-   {
-      switch (wValue_msb)
-      {
-      case CS_MUTE:
-         if( length==1 )
-         {
-            Usb_write_endpoint_data(EP_CONTROL, 8, mute);
-         }
-         break;
-      case CS_VOLUME:
-         if( length==2 )
-         {
-            Usb_write_endpoint_data(EP_CONTROL, 16, Usb_format_mcu_to_usb_data(16, VOL_RES));
-         }
-         break;
-      }
-   } else if ( i_unit==SPK_FEATURE_UNIT_ID)
-   {
-	     switch (wValue_msb)
-	      {
-	      case CS_MUTE:
-	         if( length==1 )
-	         {
-	            Usb_write_endpoint_data(EP_CONTROL, 8, spk_mute);
-	         }
-	         break;
-	      case CS_VOLUME:
-	         if( length==2 )
-	         {
-	            Usb_write_endpoint_data(EP_CONTROL, 16, Usb_format_mcu_to_usb_data(16, VOL_RES));
-	         }
-	         break;
-	      }
-   }
-
-/*
-	// 48000 - 44100 = 3900
-   	Usb_write_endpoint_data(EP_CONTROL, 8, 0x3c);
-   	Usb_write_endpoint_data(EP_CONTROL, 8, 0x0f);
-   	Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-*/
-
-   Usb_ack_control_in_ready_send();
-   while(!Is_usb_control_out_received());
-   Usb_ack_control_out_received_free();
+	if (rate_lsb == 0x44) speed = 0;
+	else speed = 1;
+
+	freq_changed = TRUE;
+	STREAM_HEALTH_COUNT(sh_rate_change);
+	if (speed == 0){		// 44.1khz
+		current_freq.frequency = 44100;
+		if (FEATURE_BOARD_USBI2S)
+			gpio_clr_gpio_pin(AVR32_PIN_PX16); // BSB 20110301 MUX in 22.5792MHz/2 for AB-1
+		else if (FEATURE_BOARD_USBDAC)
+			gpio_clr_gpio_pin(AVR32_PIN_PX51);
+	}
+	else {					// 48khz
+		current_freq.frequency = 48000;
+		if (FEATURE_BOARD_USBI2S)
+			gpio_set_gpio_pin(AVR32_PIN_PX16); // BSB 20110301 MUX in 24.576MHz/2 for AB-1
+		else if (FEATURE_BOARD_USBDAC)
+			gpio_set_gpio_pin(AVR32_PIN_PX51);
+	}
 }
 
-void audio_get_cur(void)
+//! The data stage of a SET_CUR arrived, it was received in
+//! uac1_control_buffer.
+//!
+static Bool uac1_user_audio_received(const S_usb_setup_data *setup, U8 *data, U16 length)
 {
-   U16 i_unit;
-   U16 length;
-   i_unit = wIndex % 256;
-   length = wLength;
-
-   Usb_ack_setup_received_free();
-   Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-   if ((usb_type == USB_SETUP_GET_CLASS_ENDPOINT) && (wValue_msb == UAC_EP_CS_ATTR_SAMPLE_RATE)){
-		if (speed == 0){
-		   	Usb_write_endpoint_data(EP_CONTROL, 8, 0x44);
-		   	Usb_write_endpoint_data(EP_CONTROL, 8, 0xac);
-		   	Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-		}
-		else {
-		   	Usb_write_endpoint_data(EP_CONTROL, 8, 0x80);
-		   	Usb_write_endpoint_data(EP_CONTROL, 8, 0xbb);
-		   	Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-		}
-    }
-
-   else if( i_unit==MIC_FEATURE_UNIT_ID )
-   {
-      switch (wValue_msb)
-      {
-      case CS_MUTE:
-         if( length==1 )
-         {
-            Usb_write_endpoint_data(EP_CONTROL, 8, mute);
-         }
-         break;
-      case CS_VOLUME:
-         if( length==2 )
-         {
-            Usb_write_endpoint_data(EP_CONTROL, 16, Usb_format_mcu_to_usb_data(16, volume));
-         }
-         break;
-      }
-
-   } else if (i_unit==SPK_FEATURE_UNIT_ID){
-	     switch (wValue_msb)
-	      {
-	      case CS_MUTE:
-	         if( length==1 )
-	         {
-	            Usb_write_endpoint_data(EP_CONTROL, 8, spk_mute);
-	         }
-	         break;
-	      case CS_VOLUME:
-	         if( length==2 )
-	         {
-	            Usb_write_endpoint_data(EP_CONTROL, 16, Usb_format_mcu_to_usb_data(16, spk_volume));
-	         }
-	         break;
-	      }
-   }
-
-   Usb_ack_control_in_ready_send();
-   while(!Is_usb_control_out_received());
-   Usb_ack_control_out_received_free();
-}
+	U8 i_unit = LSB(setup->wIndex);
+	U8 selector = MSB(setup->wValue);
 
-void audio_set_cur(void)
-{
-   U16 i_unit;
-   U16 length;
-   i_unit = wIndex % 256;
-   length = wLength;
-
-   Usb_ack_setup_received_free();
-   while(!Is_usb_control_out_received());
-   Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-   if ((usb_type == USB_SETUP_SET_CLASS_ENDPOINT) && (wValue_msb == UAC_EP_CS_ATTR_SAMPLE_RATE)){
-		if (Usb_read_endpoint_data(EP_CONTROL, 8) == 0x44) speed = 0;
-		else speed = 1;
-
-		freq_changed = TRUE;
-		if (speed == 0){		// 44.1khz
-			current_freq.frequency = 44100;
-			if (FEATURE_BOARD_USBI2S)
-				gpio_clr_gpio_pin(AVR32_PIN_PX16); // BSB 20110301 MUX in 22.5792MHz/2 for AB-1
-			else if (FEATURE_BOARD_USBDAC)
-				gpio_clr_gpio_pin(AVR32_PIN_PX51);
-			}
-		else {					// 48khz
-			current_freq.frequency = 48000;
-			if (FEATURE_BOARD_USBI2S)
-				gpio_set_gpio_pin(AVR32_PIN_PX16); // BSB 20110301 MUX in 24.576MHz/2 for AB-1
-			else if (FEATURE_BOARD_USBDAC)
-				gpio_set_gpio_pin(AVR32_PIN_PX51);
-		}
+	if (setup->bmRequestType == USB_SETUP_SET_CLASS_ENDPOINT && selector == UAC_EP_CS_ATTR_SAMPLE_RATE) {
+		if (length == 0)
+			return FALSE;
+		uac1_set_sample_rate(data[0]);
 	}
-
-   else if( i_unit==MIC_FEATURE_UNIT_ID )
-   {
-      switch (wValue_msb)
-      {
-      case CS_MUTE:
-         if( length==1 )
-         {
-            mute=Usb_read_endpoint_data(EP_CONTROL, 8);
-         }
-         break;
-      case CS_VOLUME:
-         if( length==2 )
-         {
-            LSB(volume)= Usb_read_endpoint_data(EP_CONTROL, 8);
-            MSB(volume)= Usb_read_endpoint_data(EP_CONTROL, 8);
-         }
-         break;
-      }
-   }
-   else if (i_unit==SPK_FEATURE_UNIT_ID ){
-	   {
-	       switch (wValue_msb)
-	       {
-	       case CS_MUTE:
-	          if( length==1 )
-	          {
-	             spk_mute=Usb_read_endpoint_data(EP_CONTROL, 8);
-	          }
-	          break;
-	       case CS_VOLUME:
-	          if( length==2 )
-	          {
-	             LSB(spk_volume)= Usb_read_endpoint_data(EP_CONTROL, 8);
-	             MSB(spk_volume)= Usb_read_endpoint_data(EP_CONTROL, 8);
-	          }
-	          break;
-	       }
-	    }
-   }
-
-
-   Usb_ack_control_out_received_free();
-   Usb_ack_control_in_ready_send();
-   while (!Is_usb_control_in_ready());
+	else if (i_unit == MIC_FEATURE_UNIT_ID) {
+		if (selector == CS_MUTE && length == 1)
+			mute = data[0];
+		else if (selector == CS_VOLUME && length == 2)
+			volume = uac1_get_volume(data);
+	}
+	else if (i_unit == SPK_FEATURE_UNIT_ID) {
+		if (selector == CS_MUTE && length == 1)
+			spk_mute = data[0];
+		else if (selector == CS_VOLUME && length == 2)
+			spk_volume = uac1_get_volume(data);
+	}
+	return TRUE;
 }
 
-//! This function is called by the standard USB read request function when
-//! the USB request is not supported. This function returns TRUE when the
-//! request is processed. This function returns FALSE if the request is not
-//! supported. In this case, a STALL handshake will be automatically
-//! sent by the standard USB read request function.
+//! @brief This function is the handler of the audio class requests,
+//! registered with usb_ctrl_register(): the feature unit mute and volume
+//! and the sampling frequency of the streaming endpoints. A GET for any
+//! other control gets an empty reply, SET_MIN, SET_MAX and SET_RES are
+//! not supported and stalled.
 //!
-Bool uac1_user_read_request(U8 type, U8 request)
+Bool uac1_user_audio_request(const S_usb_setup_data *setup)
 {
+	U8 i_unit = LSB(setup->wIndex);
+	U8 selector = MSB(setup->wValue);
+	U16 length = 0;
+	S16 vol_cur;
 
-	usb_type = type;
-
-	// print_dbg_char_char('z'); // BSB debug 20120803
-
-	// this should vector to specified interface handler
-	if (type == IN_INTERFACE && request == GET_DESCRIPTOR) return uac1_user_get_interface_descriptor();
-	// Read wValue
-	// why are these file statics?
-	wValue_lsb = Usb_read_endpoint_data(EP_CONTROL, 8);
-	wValue_msb = Usb_read_endpoint_data(EP_CONTROL, 8);
-	wIndex = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-	wLength = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-
-	//** Specific request from Class HID
-	// this should vector to specified interface handler
-	if( wIndex == DSC_INTERFACE_HID )   // Interface number of HID
-		{
-
-			if( type == OUT_CL_INTERFACE ) // USB_SETUP_SET_CLASS_INTER
-				{
-					switch( request )
-						{
-
-						case HID_SET_REPORT:
-							// The MSB wValue field specifies the Report Type
-							// The LSB wValue field specifies the Report ID
-							switch (wValue_msb)
-								{
-								case HID_REPORT_INPUT:
-									// TODO
-									break;
-
-								case HID_REPORT_OUTPUT:
-									Usb_ack_setup_received_free();
-									while (!Is_usb_control_out_received());
-									Usb_reset_endpoint_fifo_access(EP_CONTROL);
-									usb_report[0] = Usb_read_endpoint_data(EP_CONTROL, 8);
-									usb_report[1] = Usb_read_endpoint_data(EP_CONTROL, 8);
-									Usb_ack_control_out_received_free();
-									Usb_ack_control_in_ready_send();
-									while (!Is_usb_control_in_ready());
-									return TRUE;
-
-								case HID_REPORT_FEATURE:
-									Usb_ack_setup_received_free();
-									while (!Is_usb_control_out_received());
-									Usb_reset_endpoint_fifo_access(EP_CONTROL);
-									usb_feature_report[0] = Usb_read_endpoint_data(EP_CONTROL, 8);
-									usb_feature_report[1] = Usb_read_endpoint_data(EP_CONTROL, 8);
-									Usb_ack_control_out_received_free();
-									Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-									while (!Is_usb_control_in_ready()); //!< waits for status phase done
-									return TRUE;
-
-								}
-							break;
-
-						case HID_SET_IDLE:
-							uac1_usb_hid_set_idle(wValue_lsb, wValue_msb);  // BSB 20120710 prefix "uac1_" added
-							return TRUE;
-   
-						case HID_SET_PROTOCOL:
-							// TODO
-							break;
-						}
-				}
-			if( type == IN_CL_INTERFACE) // USB_SETUP_GET_CLASS_INTER
-				{
-					switch( request )
-						{
-						case HID_GET_REPORT:
-							switch (wValue_msb)
-								{
-								case HID_REPORT_INPUT:
-									Usb_ack_setup_received_free();
-
-									Usb_reset_endpoint_fifo_access(EP_CONTROL);
-									Usb_write_endpoint_data(EP_CONTROL, 8, usb_report[0]);
-									Usb_write_endpoint_data(EP_CONTROL, 8, usb_report[1]);
-									Usb_ack_control_in_ready_send();
-
-									while (!Is_usb_control_out_received());
-									Usb_ack_control_out_received_free();
-									return TRUE;
-
-								case HID_REPORT_OUTPUT:
-									break;
-
-								case HID_REPORT_FEATURE:
-									Usb_ack_setup_received_free();
-
-									Usb_reset_endpoint_fifo_access(EP_CONTROL);
-									Usb_write_endpoint_data(EP_CONTROL, 8, usb_feature_report[0]);
-									Usb_write_endpoint_data(EP_CONTROL, 8, usb_feature_report[1]);
-									Usb_ack_control_in_ready_send();
-
-									while (!Is_usb_control_out_received());
-									Usb_ack_control_out_received_free();
-									return TRUE;
-								}
-							break;
-						case HID_GET_IDLE:
-							uac1_usb_hid_get_idle(wValue_lsb); // BSB 20120710 prefix "uac1_" added
-							return TRUE;
-						case HID_GET_PROTOCOL:
-							// TODO
-							break;
-						}
-				}
-		}  // if wIndex ==  HID Interface
-
-
-	//  assume all other requests are for AUDIO interface
-
-	switch (request)
-	    {
-		case BR_REQUEST_SET_CUR:
-			audio_set_cur();
-			return TRUE;
-			// No need to break here !
-
-		case BR_REQUEST_SET_MIN:     //! Set MIN,MAX and RES not supported
-		case BR_REQUEST_SET_MAX:
-		case BR_REQUEST_SET_RES:
+	if ((setup->bmRequestType & DRD_MASK) == DRD_OUT) {
+		if (setup->bRequest != BR_REQUEST_SET_CUR)
 			return FALSE;
-			// No need to break here !
-
-		case BR_REQUEST_GET_CUR:
-			audio_get_cur();
-			return TRUE;
-			// No need to break here !
-
-		case BR_REQUEST_GET_MIN:
-			audio_get_min();
-			return TRUE;
-			// No need to break here !
+		usb_ctrl_receive(uac1_control_buffer, sizeof(uac1_control_buffer), uac1_user_audio_received);
+		return TRUE;
+	}
 
-		case BR_REQUEST_GET_MAX:
-			audio_get_max();
-			return TRUE;
-			// No need to break here !
+	switch (setup->bRequest) {
+	case BR_REQUEST_GET_CUR:
+	case BR_REQUEST_GET_MIN:
+	case BR_REQUEST_GET_MAX:
+	case BR_REQUEST_GET_RES:
+		break;
+	default:
+		return FALSE;
+	}
 
+	if (setup->bmRequestType == USB_SETUP_GET_CLASS_ENDPOINT && selector == UAC_EP_CS_ATTR_SAMPLE_RATE) {
+		switch (setup->bRequest) {
+		case BR_REQUEST_GET_CUR:
+			uac1_put_sample_rate(uac1_control_buffer, speed == 0 ? UAC1_RATE_MIN : UAC1_RATE_MAX);
+			break;
+		case BR_REQUEST_GET_MIN:	// 44.1khz min sampling freq
+			uac1_put_sample_rate(uac1_control_buffer, UAC1_RATE_MIN);
+			break;
+		case BR_REQUEST_GET_MAX:	// 48khz max sampling freq
+			uac1_put_sample_rate(uac1_control_buffer, UAC1_RATE_MAX);
+			break;
 		case BR_REQUEST_GET_RES:
-			audio_get_res();
-			return TRUE;
-			// No need to break here !
-
-		default:
-			return FALSE;
-			// No need to break here !
-	    }
+			uac1_put_sample_rate(uac1_control_buffer, UAC1_RATE_MAX - UAC1_RATE_MIN);
+			break;
+		}
+		length = 3;
+	}
+	else if (i_unit == MIC_FEATURE_UNIT_ID || i_unit == SPK_FEATURE_UNIT_ID) {
+		if (selector == CS_MUTE && setup->wLength == 1) {
+			uac1_control_buffer[0] = i_unit == MIC_FEATURE_UNIT_ID ? mute : spk_mute;
+			length = 1;
+		}
+		else if (selector == CS_VOLUME && setup->wLength == 2) {
+			vol_cur = i_unit == MIC_FEATURE_UNIT_ID ? volume : spk_volume;
+			switch (setup->bRequest) {
+			case BR_REQUEST_GET_CUR: uac1_put_volume(uac1_control_buffer, vol_cur); break;
+			case BR_REQUEST_GET_MIN: uac1_put_volume(uac1_control_buffer, VOL_MIN); break;
+			case BR_REQUEST_GET_MAX: uac1_put_volume(uac1_control_buffer, VOL_MAX); break;
+			case BR_REQUEST_GET_RES: uac1_put_volume(uac1_control_buffer, VOL_RES); break;
+			}
+			length = 2;
+		}
+	}
 
-	return FALSE;  // No supported request
+	usb_ctrl_send(uac1_control_buffer, length);
+	return TRUE;
 }
 
 #endif  // USB_DEVICE_FEATURE == ENABLED
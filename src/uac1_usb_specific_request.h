@@ -29,6 +29,8 @@
   #error usb_specific_request.h is #included although USB_DEVICE_FEATURE is disabled
 #endif
 
+#include "usb_standard_request.h"
+
 
 
 
@@ -51,13 +53,13 @@ extern void uac1_user_endpoint_init(U8);
 
 extern void uac1_user_set_interface(U8 wIndex, U8 wValue);
 
-//! This function is called by the standard USB read request function when
-//! the USB request is not supported. This function returns TRUE when the
-//! request is processed. This function returns FALSE if the request is not
-//! supported. In this case, a STALL handshake will be automatically
-//! sent by the standard USB read request function.
+//! Handler of the HID interface requests, for usb_ctrl_register()
+//!
+extern Bool uac1_user_hid_request(const S_usb_setup_data *setup);
+
+//! Handler of the audio class requests, for usb_ctrl_register()
 //!
-extern Bool uac1_user_read_request(U8, U8);
+extern Bool uac1_user_audio_request(const S_usb_setup_data *setup);
 
 //! @}
 
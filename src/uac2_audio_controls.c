@@ -0,0 +1,273 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * uac2_audio_controls.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Table driven UAC2 class requests, see uac2_audio_controls.h
+ */
+
+#include <string.h>
+
+#include "conf_usb.h"
+
+#if USB_DEVICE_FEATURE == ENABLED
+
+#include "usb_drv.h"
+#include "usb_descriptors.h"
+#include "uac2_usb_descriptors.h"
+#include "uac2_audio_function.h"
+#include "usb_standard_request.h"
+#include "usb_specific_request.h"
+#include "uac2_usb_specific_request.h"
+#include "usb_audio.h"
+#include "device_audio_task.h"
+#include "eventlog.h"
+#include "uac2_audio_controls.h"
+
+// one discrete subrange per rate of uac2_audio_function.h
+static const U8 uac2_mic_range[UAC2_RANGE_SIZE(UAC2_MIC_RATES)] = UAC2_RANGE(UAC2_MIC_RATES);
+static const U8 uac2_spk_range[UAC2_RANGE_SIZE(UAC2_SPK_RATES)] = UAC2_RANGE(UAC2_SPK_RATES);
+static const U8 uac2_iq_range[UAC2_RANGE_SIZE(UAC2_MIC_RATES)] = UAC2_RANGE_IQ(UAC2_MIC_RATES);
+
+static U8 uac2_control_buffer[EP_CONTROL_LENGTH];
+
+//
+// parameter blocks are little endian on the wire
+//
+static void uac2_put_le32(U8 *buffer, U32 v) {
+	buffer[0] = v;
+	buffer[1] = v >> 8;
+	buffer[2] = v >> 16;
+	buffer[3] = v >> 24;
+}
+
+static U32 uac2_get_le32(const U8 *data) {
+	return data[0] | (data[1] << 8) | ((U32)data[2] << 16) | ((U32)data[3] << 24);
+}
+
+//
+// playback streaming interface
+//
+static void uac2_get_as_val_alt_settings(U8 *buffer) {
+	buffer[0] = 0x01;
+	buffer[1] = 0b00000011;		// alt 0 and 1 valid
+}
+
+static void uac2_get_as_act_alt_setting(U8 *buffer) {
+	buffer[0] = usb_alternate_setting_out;
+}
+
+static Bool uac2_set_as_act_alt_setting(const U8 *data) {
+	usb_alternate_setting_out = data[0];
+	usb_alternate_setting_out_changed = TRUE;
+	return TRUE;
+}
+
+static void uac2_get_as_data_format(U8 *buffer) {
+	uac2_put_le32(buffer, 0x00000001);	// only PCM format
+}
+
+//
+// clock sources and selector
+//
+static void uac2_get_sam_freq(U8 *buffer) {
+	uac2_put_le32(buffer, current_freq.frequency);	// 0x0000bb80 is 48khz
+}
+
+static void uac2_get_clock_valid(U8 *buffer) {
+	buffer[0] = TRUE;			// always valid
+}
+
+static void uac2_get_clock_valid_logged(U8 *buffer) {
+	eventlog_put(ev_clock_valid, 0, 0, 0);
+	buffer[0] = TRUE;
+}
+
+static Bool uac2_set_sam_freq_1(const U8 *data) {	// set CUR freq of Mic
+	freq_changed = TRUE;
+	current_freq.frequency = uac2_get_le32(data);
+	Mic_freq = current_freq;
+	uac2_freq_change_handler();
+	Mic_freq_valid = TRUE;
+	return TRUE;
+}
+
+static Bool uac2_set_sam_freq_2(const U8 *data) {
+	freq_changed = TRUE;
+	current_freq.frequency = uac2_get_le32(data);
+	uac2_freq_change_handler();
+
+	// some freq only applies to playback
+	// may need better checking algorithm
+	Mic_freq_valid = current_freq.frequency == Mic_freq.frequency;
+	return TRUE;
+}
+
+// the narrowband IQ clock, the ADC one decimated, setting it sets the ADC
+static void uac2_get_sam_freq_iq(U8 *buffer) {
+	uac2_put_le32(buffer, current_freq.frequency / UAC2_IQ_DECIMATION);
+}
+
+static Bool uac2_set_sam_freq_iq(const U8 *data) {
+	U8 adc[4];
+
+	uac2_put_le32(adc, uac2_get_le32(data) * UAC2_IQ_DECIMATION);
+	return uac2_set_sam_freq_1(adc);
+}
+
+static void uac2_get_clock_selector(U8 *buffer) {
+	buffer[0] = clock_selected;
+}
+
+static Bool uac2_set_clock_selector(const U8 *data) {
+	clock_selected = data[0];
+	clock_changed = TRUE;
+	if (clock_selected < 1 || clock_selected > CSX_INPUT_PINS)
+		clock_selected = 1;
+	return TRUE;
+}
+
+//
+// feature units and input terminals
+//
+static void uac2_get_mic_mute(U8 *buffer) {
+	buffer[0] = mute;
+}
+
+static Bool uac2_set_mic_mute(const U8 *data) {
+	mute = data[0];
+	return TRUE;
+}
+
+static void uac2_get_spk_mute(U8 *buffer) {
+	buffer[0] = spk_mute;
+}
+
+static Bool uac2_set_spk_mute(const U8 *data) {
+	spk_mute = data[0];
+	return TRUE;
+}
+
+// zeros at startup, alt setting 0
+static void uac2_get_mic_cluster(U8 *buffer) {
+	if (usb_alternate_setting != 0) {
+		buffer[0] = INPUT_TERMINAL_NB_CHANNELS;
+		buffer[1] = (U8) INPUT_TERMINAL_CHANNEL_CONF;
+		buffer[5] = INPUT_TERMINAL_STRING_DESC;
+	}
+}
+
+static void uac2_get_spk_cluster(U8 *buffer) {
+	if (usb_alternate_setting_out == 1) {
+		buffer[0] = SPK_INPUT_TERMINAL_NB_CHANNELS;
+		buffer[1] = (U8) SPK_INPUT_TERMINAL_CHANNEL_CONF;
+		buffer[5] = SPK_INPUT_TERMINAL_STRING_DESC;
+	}
+}
+
+#define GET		IN_CL_INTERFACE
+#define SET		OUT_CL_INTERFACE
+#define CUR		AUDIO_CS_REQUEST_CUR
+#define RANGE	AUDIO_CS_REQUEST_RANGE
+#define AS_OUT	DSC_INTERFACE_AS_OUT
+#define AC		DSC_INTERFACE_AUDIO
+#define CN0		UAC2_CTRL_CN0
+#define PAD		UAC2_CTRL_PAD
+
+const uac2_control_t uac2_controls[] = {
+	// type, request, interface, entity, selector, flags, length, get, set, reply
+	{ GET, CUR,   AS_OUT, 0, AUDIO_AS_VAL_ALT_SETTINGS,	CN0, 2, uac2_get_as_val_alt_settings, NULL },
+	{ GET, CUR,   AS_OUT, 0, AUDIO_AS_ACT_ALT_SETTINGS,	CN0, 1, uac2_get_as_act_alt_setting, NULL },
+	{ GET, CUR,   AS_OUT, 0, AUDIO_AS_AUDIO_DATA_FORMAT,	CN0, 4, uac2_get_as_data_format, NULL },
+	{ SET, CUR,   AS_OUT, 0, AUDIO_AS_ACT_ALT_SETTINGS,	0,   1, NULL, uac2_set_as_act_alt_setting },
+
+	{ GET, CUR,   AC, CSD_ID_1, AUDIO_CS_CONTROL_SAM_FREQ,		0,   4, uac2_get_sam_freq, NULL },
+	{ GET, CUR,   AC, CSD_ID_1, AUDIO_CS_CONTROL_CLOCK_VALID,	PAD, 1, uac2_get_clock_valid, NULL },
+	{ GET, RANGE, AC, CSD_ID_1, AUDIO_CS_CONTROL_SAM_FREQ,		0,   sizeof(uac2_mic_range), NULL, NULL, uac2_mic_range },
+	{ SET, CUR,   AC, CSD_ID_1, AUDIO_CS_CONTROL_SAM_FREQ,		CN0, 4, NULL, uac2_set_sam_freq_1 },
+
+	{ GET, CUR,   AC, CSD_ID_2, AUDIO_CS_CONTROL_SAM_FREQ,		0,   4, uac2_get_sam_freq, NULL },
+	{ GET, CUR,   AC, CSD_ID_2, AUDIO_CS_CONTROL_CLOCK_VALID,	PAD, 1, uac2_get_clock_valid_logged, NULL },
+	{ GET, RANGE, AC, CSD_ID_2, AUDIO_CS_CONTROL_SAM_FREQ,		0,   sizeof(uac2_spk_range), NULL, NULL, uac2_spk_range },
+	{ SET, CUR,   AC, CSD_ID_2, AUDIO_CS_CONTROL_SAM_FREQ,		CN0, 4, NULL, uac2_set_sam_freq_2 },
+
+	{ GET, CUR,   AC, CSD_ID_IQ, AUDIO_CS_CONTROL_SAM_FREQ,		0,   4, uac2_get_sam_freq_iq, NULL },
+	{ GET, CUR,   AC, CSD_ID_IQ, AUDIO_CS_CONTROL_CLOCK_VALID,	PAD, 1, uac2_get_clock_valid, NULL },
+	{ GET, RANGE, AC, CSD_ID_IQ, AUDIO_CS_CONTROL_SAM_FREQ,		0,   sizeof(uac2_iq_range), NULL, NULL, uac2_iq_range },
+	{ SET, CUR,   AC, CSD_ID_IQ, AUDIO_CS_CONTROL_SAM_FREQ,		CN0, 4, NULL, uac2_set_sam_freq_iq },
+
+	{ GET, CUR,   AC, CSX_ID, AUDIO_CX_CLOCK_SELECTOR,			PAD, 1, uac2_get_clock_selector, NULL },
+	{ SET, CUR,   AC, CSX_ID, AUDIO_CX_CLOCK_SELECTOR,			CN0, 1, NULL, uac2_set_clock_selector },
+
+	{ GET, CUR,   AC, MIC_FEATURE_UNIT_ID, AUDIO_FU_CONTROL_CS_MUTE,	PAD, 1, uac2_get_mic_mute, NULL },
+	{ SET, CUR,   AC, MIC_FEATURE_UNIT_ID, AUDIO_FU_CONTROL_CS_MUTE,	0,   1, NULL, uac2_set_mic_mute },
+	{ GET, CUR,   AC, SPK_FEATURE_UNIT_ID, AUDIO_FU_CONTROL_CS_MUTE,	PAD, 1, uac2_get_spk_mute, NULL },
+	{ SET, CUR,   AC, SPK_FEATURE_UNIT_ID, AUDIO_FU_CONTROL_CS_MUTE,	0,   1, NULL, uac2_set_spk_mute },
+
+	{ GET, CUR,   AC, INPUT_TERMINAL_ID, AUDIO_TE_CONTROL_CS_CLUSTER,		0, 6, uac2_get_mic_cluster, NULL },
+	{ GET, CUR,   AC, SPK_INPUT_TERMINAL_ID, AUDIO_TE_CONTROL_CS_CLUSTER,	0, 6, uac2_get_spk_cluster, NULL },
+};
+
+const U8 uac2_nb_controls = sizeof(uac2_controls) / sizeof(uac2_controls[0]);
+
+#undef GET
+#undef SET
+#undef CUR
+#undef RANGE
+#undef AS_OUT
+#undef AC
+#undef CN0
+#undef PAD
+
+const uac2_control_t *uac2_control_find(const S_usb_setup_data *setup) {
+	const uac2_control_t *cp;
+
+	for (cp = uac2_controls; cp < &uac2_controls[uac2_nb_controls]; cp += 1)
+		if (cp->type == setup->bmRequestType && cp->request == setup->bRequest &&
+			cp->interface == LSB(setup->wIndex) && cp->entity == MSB(setup->wIndex) &&
+			cp->selector == MSB(setup->wValue) &&
+			( ! (cp->flags & UAC2_CTRL_CN0) || LSB(setup->wValue) == 0))
+			return cp;
+	return NULL;
+}
+
+//
+// the data stage of a SET is in, hand it to the entry
+//
+static Bool uac2_control_received(const S_usb_setup_data *setup, U8 *data, U16 length) {
+	const uac2_control_t *cp = uac2_control_find(setup);
+
+	if (cp == NULL || length < cp->length)
+		return FALSE;
+	return cp->set(data);
+}
+
+Bool uac2_user_audio_request(const S_usb_setup_data *setup) {
+	const uac2_control_t *cp = uac2_control_find(setup);
+	U16 length;
+
+	if (cp == NULL)
+		return FALSE;
+
+	if (cp->type == OUT_CL_INTERFACE) {
+		usb_ctrl_receive(uac2_control_buffer, cp->length, uac2_control_received);
+		return TRUE;
+	}
+
+	if (cp->get == NULL) {				// constant reply
+		usb_ctrl_send(cp->reply, cp->length);
+		return TRUE;
+	}
+
+	memset(uac2_control_buffer, 0, sizeof(uac2_control_buffer));
+	cp->get(uac2_control_buffer);
+	length = cp->length;
+	if (cp->flags & UAC2_CTRL_PAD)		// temp hack to give total # of bytes requested
+		length = max(length, min(setup->wLength, sizeof(uac2_control_buffer)));
+	usb_ctrl_send(uac2_control_buffer, length);
+	return TRUE;
+}
+
+#endif  // USB_DEVICE_FEATURE == ENABLED
@@ -0,0 +1,56 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * uac2_audio_controls.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Table driven UAC2 class requests to the audio control and the playback
+ * streaming interface.
+ *
+ * Every control the device answers has one entry per direction and request
+ * in uac2_controls[], keyed on (interface, entity ID, control selector,
+ * request). The entry gives the length of the parameter block and the
+ * function filling it for a GET, or taking it for a SET CUR, or a constant
+ * reply, so the transfer itself is done once, through usb_ctrl_send() and
+ * usb_ctrl_receive().
+ * A request without an entry is not ours and ends up stalled.
+ *
+ * SET handlers run from the USB device task once the data stage is in, so
+ * they may take their time, as the sample rate change does.
+ */
+
+#ifndef UAC2_AUDIO_CONTROLS_H_
+#define UAC2_AUDIO_CONTROLS_H_
+
+#include "compiler.h"
+#include "usb_standard_request.h"
+
+// uac2_control_t flags
+#define UAC2_CTRL_CN0		0x01	// only for channel number 0, LSB(wValue)
+#define UAC2_CTRL_PAD		0x02	// GET reply zero padded to wLength
+
+typedef struct {
+	U8 type;						// bmRequestType, IN_CL_INTERFACE or OUT_CL_INTERFACE
+	U8 request;						// AUDIO_CS_REQUEST_CUR or AUDIO_CS_REQUEST_RANGE
+	U8 interface;					// LSB(wIndex)
+	U8 entity;						// MSB(wIndex), 0 for a streaming interface
+	U8 selector;					// MSB(wValue)
+	U8 flags;
+	U8 length;						// of the parameter block
+	void (*get)(U8 *buffer);		// fills length bytes of a GET reply
+	Bool (*set)(const U8 *data);	// takes the data of a SET, FALSE stalls the status stage
+	const U8 *reply;				// the GET reply as is, when there is no get function
+} uac2_control_t;
+
+extern const uac2_control_t uac2_controls[];
+extern const U8 uac2_nb_controls;
+
+// the entry answering setup, NULL if there is none
+extern const uac2_control_t *uac2_control_find(const S_usb_setup_data *setup);
+
+//! Handler of the audio class interface requests, for usb_ctrl_register()
+//!
+extern Bool uac2_user_audio_request(const S_usb_setup_data *setup);
+
+#endif /* UAC2_AUDIO_CONTROLS_H_ */
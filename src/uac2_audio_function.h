@@ -0,0 +1,133 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * uac2_audio_function.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The UAC2 audio function in one table: the playback stream format, the
+ * endpoint service intervals, the sample rates of each clock source and
+ * the decimation of the narrowband IQ record stream.
+ *
+ * uac2_usb_descriptors.h takes its channel counts, subslot size, bit
+ * resolution, endpoint intervals and packet sizes from here, and
+ * uac2_audio_controls.c builds its RANGE replies with UAC2_RANGE(), so a
+ * rate is added or dropped in exactly one place. The usb-desc-check host
+ * tool holds the generated descriptors and range blocks against it.
+ *
+ * Only plain integer constants and macros, the host tool includes it too.
+ */
+
+#ifndef UAC2_AUDIO_FUNCTION_H_
+#define UAC2_AUDIO_FUNCTION_H_
+
+// playback stream, and the record stream when it is enabled again
+#define UAC2_NB_CHANNELS			2
+#define UAC2_SUBSLOT_SIZE			4			// bytes per sample on the bus
+#define UAC2_BIT_RESOLUTION			24
+
+// bInterval of the audio endpoints, 2^(n-1) frames or microframes
+#define UAC2_EP_INTERVAL_FS			1			// 1 ms
+#define UAC2_EP_INTERVAL_HS			1			// 125 us, one packet every microframe
+
+// the highest rate the audio endpoints are sized for at each speed, at
+// high speed this is where additional transactions per microframe start
+#define UAC2_RATE_MAX_FS			48000
+#define UAC2_RATE_MAX_HS			384000
+
+// GCLK1 is the bit clock, OSC1 undivided at the highest rate of each
+// family. The boards feed OSC1 their 24.576 and 22.5792 MHz oscillators
+// halved, so 64 bit frames stop at 192 kHz. A board with the full
+// oscillator on OSC1 sets 24576000 here and gets 352.8 and 384 kHz.
+#define UAC2_BCLK_MAX				12288000
+#define UAC2_RATE_MAX_CLOCK			(UAC2_BCLK_MAX / 64)
+
+// the rates of the playback clock source CSD_ID_2 and the record one
+// CSD_ID_1, ascending, each becomes one subrange of the RANGE reply
+#define UAC2_SPK_RATES(X)	\
+	X(44100)				\
+	X(48000)				\
+	X(88200)				\
+	X(96000)				\
+	X(176400)				\
+	X(192000)				\
+	UAC2_SPK_RATES_OCTUPLE(X)
+
+#if UAC2_RATE_MAX_CLOCK >= 384000
+#define UAC2_SPK_RATES_OCTUPLE(X)	\
+	X(352800)				\
+	X(384000)
+#else
+#define UAC2_SPK_RATES_OCTUPLE(X)
+#endif
+
+#define UAC2_MIC_RATES(X)	\
+	X(48000)				\
+	X(96000)				\
+	X(192000)
+
+// alt setting UAC2_IQ_ALT of the record interface is narrowband IQ, alt 1
+// without feature_sync_implicit: the ADC at the record clock rate
+// decimated by UAC2_IQ_DECIMATION, 2, 4 or 8, so 192, 96 and 48 kHz go
+// out as 48, 24 and 12 kHz at the default. Its clock source CSD_ID_IQ
+// offers UAC2_MIC_RATES decimated. The decimation filters of
+// iq_decimator.c are built for this one.
+#ifndef UAC2_IQ_DECIMATION
+#define UAC2_IQ_DECIMATION			4
+#endif
+#define UAC2_IQ_ALT					2
+
+//
+// derived, nothing to edit below
+//
+
+#define UAC2_INTERVAL_US_FS			(1000 << (UAC2_EP_INTERVAL_FS - 1))
+#define UAC2_INTERVAL_US_HS			(125 << (UAC2_EP_INTERVAL_HS - 1))
+
+// bytes in one service interval of us microseconds at rate, with room
+// for the extra sample the feedback may ask for
+#define UAC2_EP_BYTES_FORMAT(rate, us, channels, subslot)	\
+	((((rate) * (us) + 999999) / 1000000 + 1) * (channels) * (subslot))
+#define UAC2_EP_BYTES(rate, us)		\
+	UAC2_EP_BYTES_FORMAT(rate, us, UAC2_NB_CHANNELS, UAC2_SUBSLOT_SIZE)
+
+// a high speed isochronous endpoint moves up to 3 transactions of at most
+// 1024 bytes in a microframe, split the interval evenly over as few as do
+#define UAC2_EP_TRANSACTIONS(bytes)	(((bytes) + 1023) / 1024)
+#define UAC2_EP_TRANSACTION_SIZE(bytes)	\
+	(((bytes) + UAC2_EP_TRANSACTIONS(bytes) - 1) / UAC2_EP_TRANSACTIONS(bytes))
+// wMaxPacketSize, bits 12..11 are the additional transactions
+#define UAC2_EP_MAX_PACKET(bytes)	\
+	(UAC2_EP_TRANSACTION_SIZE(bytes) | ((UAC2_EP_TRANSACTIONS(bytes) - 1) << 11))
+
+#define UAC2_EP_BYTES_FS			UAC2_EP_BYTES(UAC2_RATE_MAX_FS, UAC2_INTERVAL_US_FS)
+#define UAC2_EP_BYTES_HS			UAC2_EP_BYTES(UAC2_RATE_MAX_HS, UAC2_INTERVAL_US_HS)
+
+#define UAC2_EP_SIZE_FS				UAC2_EP_BYTES_FS
+#define UAC2_EP_SIZE_HS				UAC2_EP_TRANSACTION_SIZE(UAC2_EP_BYTES_HS)
+#define UAC2_EP_TRANSACTIONS_HS		UAC2_EP_TRANSACTIONS(UAC2_EP_BYTES_HS)
+#define UAC2_EP_MAX_PACKET_HS		UAC2_EP_MAX_PACKET(UAC2_EP_BYTES_HS)
+
+// the record endpoint in the narrowband IQ alt setting
+#define UAC2_IQ_EP_BYTES_FS			UAC2_EP_BYTES(UAC2_RATE_MAX_FS / UAC2_IQ_DECIMATION, UAC2_INTERVAL_US_FS)
+#define UAC2_IQ_EP_BYTES_HS			UAC2_EP_BYTES(UAC2_RATE_MAX_HS / UAC2_IQ_DECIMATION, UAC2_INTERVAL_US_HS)
+#define UAC2_IQ_EP_SIZE_FS			UAC2_IQ_EP_BYTES_FS
+#define UAC2_IQ_EP_SIZE_HS			UAC2_EP_TRANSACTION_SIZE(UAC2_IQ_EP_BYTES_HS)
+#define UAC2_IQ_EP_TRANSACTIONS_HS	UAC2_EP_TRANSACTIONS(UAC2_IQ_EP_BYTES_HS)
+#define UAC2_IQ_EP_MAX_PACKET_HS	UAC2_EP_MAX_PACKET(UAC2_IQ_EP_BYTES_HS)
+
+// layout 5.2.3.3 of the UAC2 spec: wNumSubRanges, then dMIN, dMAX, dRES
+// of each subrange, little endian
+#define UAC2_LE32(v)				((v) & 0xff), (((v) >> 8) & 0xff), (((v) >> 16) & 0xff), (((v) >> 24) & 0xff)
+#define UAC2_RATE_COUNT(rate)		+ 1
+#define UAC2_RATE_SUBRANGE(rate)	UAC2_LE32(rate), UAC2_LE32(rate), UAC2_LE32(0),
+
+#define UAC2_NB_RATES(rates)		(0 rates(UAC2_RATE_COUNT))
+#define UAC2_RANGE_SIZE(rates)		(2 + 12 * UAC2_NB_RATES(rates))
+#define UAC2_RANGE(rates)			{ UAC2_NB_RATES(rates) & 0xff, UAC2_NB_RATES(rates) >> 8, rates(UAC2_RATE_SUBRANGE) }
+
+// the same of the narrowband IQ clock, each rate decimated
+#define UAC2_IQ_RATE_SUBRANGE(rate)	UAC2_RATE_SUBRANGE((rate) / UAC2_IQ_DECIMATION)
+#define UAC2_RANGE_IQ(rates)		{ UAC2_NB_RATES(rates) & 0xff, UAC2_NB_RATES(rates) >> 8, rates(UAC2_IQ_RATE_SUBRANGE) }
+
+#endif /* UAC2_AUDIO_FUNCTION_H_ */
@@ -85,6 +85,14 @@
 
 #include "composite_widget.h"
 #include "taskAK5394A.h"
+#include "ram_budget.h"
+#include "eventlog.h"
+#include "stream_health.h"
+#include "packet_sizer.h"
+#include "iq_decimator.h"
+#include "iq_correction.h"
+#include "usb_power.h"
+#include "taskStartupLeds.h"
 
 //_____ M A C R O S ________________________________________________________
 
@@ -98,10 +106,114 @@
 
 static U32  index, spk_index;
 static U16  old_gap = SPK_BUFFER_SIZE;
+static U16  mic_gap = AUDIO_BUFFER_SIZE;
 static U8 audio_buffer_out, spk_buffer_in;	// the ID number of the buffer used for sending out
 											// to the USB and reading from USB
 
 static U8 ep_audio_in, ep_audio_out, ep_audio_out_fb;
+static packet_sizer_t mic_sizer;
+
+// the narrowband IQ alt setting: the decimator, the ADC rate it started
+// at, 0 while the alt setting is not selected, and one packet of output
+#define IQ_PAIRS_MAX	(Max(UAC2_IQ_EP_BYTES_FS, UAC2_IQ_EP_BYTES_HS) / (UAC2_NB_CHANNELS * UAC2_SUBSLOT_SIZE))
+static iq_decimator_t iq_filter;
+static U32 iq_rate;
+static S32 iq_pairs[UAC2_NB_CHANNELS * IQ_PAIRS_MAX];
+
+//!
+//! @brief Decimate num_pairs record pairs worth of the ADC buffers into the
+//! IN endpoint, the runs split where the buffers swap
+//!
+static void uac2_device_audio_iq_send(U8 ep, U16 num_pairs, U8 in_left, U8 in_right)
+{
+	volatile U32 *buffer;
+	U16 inputs = num_pairs * UAC2_IQ_DECIMATION, run, n = 0, i;
+	U8 c;
+	S32 sample;
+
+	while (inputs > 0) {
+		buffer = audio_buffer_out == 0 ? audio_buffer_0 : audio_buffer_1;
+		run = min(inputs, (AUDIO_BUFFER_SIZE - index) / 2);
+		n += iq_decimator_run(&iq_filter, &buffer[index], run, &iq_pairs[2*n]);
+		inputs -= run;
+		index += 2*run;
+		if (index >= AUDIO_BUFFER_SIZE) {
+			index = 0;
+			audio_buffer_out = 1 - audio_buffer_out;
+		}
+	}
+
+	// the decimator is the same on both channels, so the IQ correction
+	// after it, at the output rate
+	if (FEATURE_IMAGE_UAC2_DG8SAQ && iq_correction_latch())
+		iq_correction_run((volatile U32 *)iq_pairs, n, in_left, in_right);
+
+	// 24 bits in 4 byte subslots, little endian
+	for (i = 0; i < n; i++) {
+		for (c = 0; c < 2; c++) {
+			sample = mute ? 0 : iq_pairs[2*i + (c == 0 ? in_left : in_right)];
+			Usb_write_endpoint_data(ep, 8, 0x00);
+			Usb_write_endpoint_data(ep, 8, sample);
+			Usb_write_endpoint_data(ep, 8, sample >> 8);
+			Usb_write_endpoint_data(ep, 8, sample >> 16);
+		}
+	}
+}
+
+//!
+//! @brief Words between the USB writer and the DAC reader in the pair of
+//! speaker buffers, counting each time they come within a margin of each other
+//!
+static U16 uac2_spk_gap_update(volatile avr32_pdca_channel_t *spk_pdca_channel, Bool playerStarted)
+{
+	U16 num_remaining, gap;
+
+	num_remaining = spk_pdca_channel->tcr;
+	if (spk_buffer_in != spk_buffer_out) {
+		// DAC and USB using same buffer
+		if ( spk_index < (SPK_BUFFER_SIZE - num_remaining))
+			gap = SPK_BUFFER_SIZE - num_remaining - spk_index;
+		else
+			gap = SPK_BUFFER_SIZE - spk_index + SPK_BUFFER_SIZE - num_remaining + SPK_BUFFER_SIZE;
+	}
+	else {
+		// usb and pdca working on different buffers
+		gap = (SPK_BUFFER_SIZE - spk_index) + (SPK_BUFFER_SIZE - num_remaining);
+	}
+
+#define SPK_GAP_MARGIN	(SPK_BUFFER_SIZE / 8)
+	if (playerStarted) {
+		if (gap < SPK_GAP_MARGIN && spk_gap >= SPK_GAP_MARGIN)
+			STREAM_HEALTH_COUNT(sh_spk_overrun);
+		else if (gap > 2*SPK_BUFFER_SIZE - SPK_GAP_MARGIN && spk_gap <= 2*SPK_BUFFER_SIZE - SPK_GAP_MARGIN)
+			STREAM_HEALTH_COUNT(sh_spk_underrun);
+		spk_gap = gap;
+	}
+	return gap;
+}
+
+//!
+//! @brief Restart the record stream from the start of buffer 0 after a
+//! resume, the PDCA on the next LRCK frame so the channels come in the
+//! right order. The playback side kept its place through the suspend.
+//!
+static void uac2_device_audio_mic_resync(void)
+{
+	pdca_disable_interrupt_reload_counter_zero(PDCA_CHANNEL_SSC_RX);
+	pdca_disable(PDCA_CHANNEL_SSC_RX);
+
+	audio_buffer_in = 0;
+	audio_buffer_out = 0;
+	index = 0;
+
+	if (!FEATURE_ADC_NONE){
+		// Start with left channel - FS goes low
+		while (!gpio_get_pin_value(AK5394_LRCK));
+		while (gpio_get_pin_value(AK5394_LRCK));
+		AK5394A_pdca_enable();
+		pdca_enable(PDCA_CHANNEL_SSC_RX);
+	}
+}
 
 //!
 //! @brief This function initializes the hardware/software resources
@@ -119,12 +231,12 @@ void uac2_device_audio_task_init(U8 ep_in, U8 ep_out, U8 ep_out_fb)
 	ep_audio_out = ep_out;
 	ep_audio_out_fb = ep_out_fb;
 
-	xTaskCreate(uac2_device_audio_task,
+	ram_budget_task_create(uac2_device_audio_task,
 				configTSK_USB_DAUDIO_NAME,
 				configTSK_USB_DAUDIO_STACK_SIZE,
 				NULL,
 				configTSK_USB_DAUDIO_PRIORITY,
-				NULL);
+				ram_budget_device_audio_stack);
 }
 
 
@@ -164,29 +276,23 @@ void uac2_device_audio_task(void *pvParameters)
 		// First, check the device enumeration state
 		if (!Is_device_enumerated()) { time=0; startup=TRUE; continue; };
 
+		// suspended, the clocks are gated and the streams hold their place
+		if (usb_power_suspended) continue;
+		if (usb_power_resync() && !startup) uac2_device_audio_mic_resync();
+
 		if( startup ) {
-			time+=UAC2_configTSK_USB_DAUDIO_PERIOD;
+			// the LED walk plays in its own task, the streams start as soon
+			// as the clocks have settled and the ADC is out of calibration
 #define STARTUP_LED_DELAY  10000
-			if ( time<= 1*STARTUP_LED_DELAY ) {
-				LED_On( LED0 );
+#define STARTUP_SETTLE     10			// 1ms at 10kHz tick
+			if ( time == 0 ) {
+				device_audio_enumerated();
+				startup_leds_play(STARTUP_LED_DELAY);
 				pdca_disable_interrupt_reload_counter_zero(PDCA_CHANNEL_SSC_RX);
 				pdca_disable(PDCA_CHANNEL_SSC_RX);
 			}
-			else if( time== 2*STARTUP_LED_DELAY )
-				LED_On( LED1 );
-			else if( time== 3*STARTUP_LED_DELAY )
-				LED_On( LED2 );
-			else if( time== 4*STARTUP_LED_DELAY )
-				LED_On( LED3 );
-			else if( time== 5*STARTUP_LED_DELAY )
-				LED_Off( LED0 );
-			else if( time== 6*STARTUP_LED_DELAY )
-				LED_Off( LED1 );
-			else if( time== 7*STARTUP_LED_DELAY )
-				LED_Off( LED2 );
-			else if( time== 8*STARTUP_LED_DELAY )
-				LED_Off( LED3 );
-			else if( time >= 9*STARTUP_LED_DELAY )
+			time+=UAC2_configTSK_USB_DAUDIO_PERIOD;
+			if ( time >= STARTUP_SETTLE && (!FEATURE_ADC_AK5394A || !gpio_get_pin_value(AK5394_CAL)) )
 			{
 				startup=FALSE;
 				audio_buffer_in = 0;
@@ -209,12 +315,12 @@ void uac2_device_audio_task(void *pvParameters)
 			}
 		}
 
-		if ((usb_alternate_setting == 1)) {
-			if(Mic_freq_valid) {
-				if (current_freq.frequency == 96000) num_samples = 24;
-				else if (current_freq.frequency == 48000) num_samples = 12;
-				else num_samples = 48;	// freq 192khz
-
+		if (usb_alternate_setting != DSC_IQ_ALT)
+			iq_rate = 0;
+		// the full rate alt 1 with feature_sync_implicit, narrowband IQ DSC_IQ_ALT with either
+		if (usb_alternate_setting != 0) {
+			// with feature_sync_implicit the record stream is the playback clock, it runs on the playback rate
+			if (Mic_freq_valid || FEATURE_SYNC_IMPLICIT) {
 				if (!FEATURE_ADC_NONE) {
 					if (Is_usb_in_ready(EP_AUDIO_IN)) {	// Endpoint ready for data transfer?
 
@@ -240,16 +346,40 @@ void uac2_device_audio_task(void *pvParameters)
 							gap = (AUDIO_BUFFER_SIZE - index) + (AUDIO_BUFFER_SIZE - num_remaining);
 						}
 
-						if ( gap < AUDIO_BUFFER_SIZE/2 ) {
-							// throttle back, transfer less
-							num_samples--;
+						// count each time reader and writer come within a margin of each other
+#define MIC_GAP_MARGIN	(AUDIO_BUFFER_SIZE / 8)
+						if (gap < MIC_GAP_MARGIN && mic_gap >= MIC_GAP_MARGIN)
+							STREAM_HEALTH_COUNT(sh_mic_underrun);
+						else if (gap > 2*AUDIO_BUFFER_SIZE - MIC_GAP_MARGIN && mic_gap <= 2*AUDIO_BUFFER_SIZE - MIC_GAP_MARGIN)
+							STREAM_HEALTH_COUNT(sh_mic_overrun);
+						mic_gap = gap;
+
+						// the narrowband IQ alt setting, UAC2_IQ_DECIMATION ADC pairs
+						// to each pair it sends, the decimator started over with the rate
+						if (usb_alternate_setting == DSC_IQ_ALT) {
+							if (iq_rate != current_freq.frequency) {
+								iq_rate = current_freq.frequency;
+								iq_decimator_init(&iq_filter);
+							}
+							num_samples = packet_sizer_samples(&mic_sizer, current_freq.frequency,
+								(Is_usb_full_speed_mode() ? 1000 : 1000000 / UAC2_INTERVAL_US_HS) * UAC2_IQ_DECIMATION,
+								gap / UAC2_IQ_DECIMATION, AUDIO_BUFFER_SIZE / UAC2_IQ_DECIMATION);
+
+							Usb_reset_endpoint_fifo_access(EP_AUDIO_IN);
+							uac2_device_audio_iq_send(EP_AUDIO_IN, num_samples, IN_LEFT, IN_RIGHT);
+							num_samples = 0;				// none for the loop below
 						}
-						else if (gap > (AUDIO_BUFFER_SIZE + AUDIO_BUFFER_SIZE/2)) {
-							// transfer more
-							num_samples++;
+						else {
+							// samples per service interval, 24 at 192khz high speed, on the ADC clock
+							num_samples = packet_sizer_samples(&mic_sizer, current_freq.frequency,
+								Is_usb_full_speed_mode() ? 1000 : 1000000 / UAC2_INTERVAL_US_HS,
+								gap, AUDIO_BUFFER_SIZE);
+							// the IQ of the DG8SAQ image corrected in place, one matrix a packet
+							if (FEATURE_IMAGE_UAC2_DG8SAQ && iq_correction_latch() && !mute)
+								iq_correction_ahead(audio_buffer_out, index, num_samples, IN_LEFT, IN_RIGHT);
+							Usb_reset_endpoint_fifo_access(EP_AUDIO_IN);
 						}
 
-						Usb_reset_endpoint_fifo_access(EP_AUDIO_IN);
 						for( i=0 ; i < num_samples ; i++ ) {
 							   // Fill endpoint with samples
 							if (!mute) {
@@ -264,6 +394,7 @@ void uac2_device_audio_task(void *pvParameters)
 									sample_MSB = audio_buffer_1[index+IN_LEFT] >> 16;
 								}
 
+								Usb_write_endpoint_data(EP_AUDIO_IN, 8, 0x00);		// 24 bits in 4 byte subslots
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, sample_LSB);
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, sample_SB);
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, sample_MSB);
@@ -279,6 +410,7 @@ void uac2_device_audio_task(void *pvParameters)
 									sample_MSB = audio_buffer_1[index+IN_RIGHT] >> 16;
 								}
 
+								Usb_write_endpoint_data(EP_AUDIO_IN, 8, 0x00);		// 24 bits in 4 byte subslots
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, sample_LSB);
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, sample_SB);
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, sample_MSB);
@@ -296,9 +428,12 @@ void uac2_device_audio_task(void *pvParameters)
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, 0x00);
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, 0x00);
 								Usb_write_endpoint_data(EP_AUDIO_IN, 8, 0x00);
+								Usb_write_endpoint_data(EP_AUDIO_IN, 8, 0x00);
+								Usb_write_endpoint_data(EP_AUDIO_IN, 8, 0x00);
 							}
 						}
 						Usb_send_in(EP_AUDIO_IN);		// send the current bank
+						if (!startup) device_audio_first_sample(DEVICE_AUDIO_RECORD);
 					}
 				} // end FEATURE_ADC
 			}
@@ -306,24 +441,13 @@ void uac2_device_audio_task(void *pvParameters)
 
 		if (usb_alternate_setting_out == 1) {
 
-			if (Is_usb_in_ready(EP_AUDIO_OUT_FB)) {	// Endpoint buffer free ?
+			// no feedback endpoint with feature_sync_implicit, the host follows the record packets
+			if (!FEATURE_SYNC_IMPLICIT && Is_usb_in_ready(EP_AUDIO_OUT_FB)) {	// Endpoint buffer free ?
 				Usb_ack_in_ready(EP_AUDIO_OUT_FB);	// acknowledge in ready
 
 				Usb_reset_endpoint_fifo_access(EP_AUDIO_OUT_FB);
 				// Sync DAC spk data stream by calculating gap and provide feedback
-				num_remaining = spk_pdca_channel->tcr;
-				if (spk_buffer_in != spk_buffer_out) {
-					// DAC and USB using same buffer
-					
-					if ( spk_index < (SPK_BUFFER_SIZE - num_remaining))
-						gap = SPK_BUFFER_SIZE - num_remaining - spk_index;
-					else
-						gap = SPK_BUFFER_SIZE - spk_index + SPK_BUFFER_SIZE - num_remaining + SPK_BUFFER_SIZE;
-				}
-				else {
-					// usb and pdca working on different buffers
-					gap = (SPK_BUFFER_SIZE - spk_index) + (SPK_BUFFER_SIZE - num_remaining);
-				}
+				gap = uac2_spk_gap_update(spk_pdca_channel, playerStarted);
 
 				//feedback calculate only in playing mode
 				if (Is_usb_full_speed_mode()) {			// FB rate is 3 bytes in 10.14 format
@@ -341,13 +465,13 @@ void uac2_device_audio_task(void *pvParameters)
 								LED_On(LED0);
 								FB_rate -= 2*FB_RATE_DELTA;
 								old_gap = gap;
-								print_dbg_char_char('/');
+								eventlog_put(ev_fb_adjust, -2*FB_RATE_DELTA, gap, FB_rate);
 							}
 							else if (gap < SPK_GAP_L1) { 	// gap < inner lower bound => 1*FB_RATE_DELTA
 								LED_On(LED0);
 								FB_rate -= FB_RATE_DELTA;
 								old_gap = gap;
-								print_dbg_char_char('-');
+								eventlog_put(ev_fb_adjust, -FB_RATE_DELTA, gap, FB_rate);
 							}
 							else {
 								LED_Off(LED0);
@@ -359,13 +483,13 @@ void uac2_device_audio_task(void *pvParameters)
 								LED_On(LED1);
 								FB_rate += 2*FB_RATE_DELTA;
 								old_gap = gap;
-								print_dbg_char_char('*');
+								eventlog_put(ev_fb_adjust, 2*FB_RATE_DELTA, gap, FB_rate);
 							}
 							else if (gap > SPK_GAP_U1) { 	// gap > inner upper bound => 1*FB_RATE_DELTA
 								LED_On(LED1);
 								FB_rate += FB_RATE_DELTA;
 								old_gap = gap;
-								print_dbg_char_char('+');
+								eventlog_put(ev_fb_adjust, FB_RATE_DELTA, gap, FB_rate);
 							}
 							else {
 								LED_Off(LED0);
@@ -395,13 +519,13 @@ void uac2_device_audio_task(void *pvParameters)
 								LED_On(LED0);
 								FB_rate -= 2*FB_RATE_DELTA;
 								old_gap = gap;
-								print_dbg_char_char('/');
+								eventlog_put(ev_fb_adjust, -2*FB_RATE_DELTA, gap, FB_rate);
 							}
 							else if (gap < SPK_GAP_L1) { 	// gap < inner lower bound => 1*FB_RATE_DELTA
 								LED_On(LED0);
 								FB_rate -= FB_RATE_DELTA;
 								old_gap = gap;
-								print_dbg_char_char('-');
+								eventlog_put(ev_fb_adjust, -FB_RATE_DELTA, gap, FB_rate);
 							}
 							else {
 								LED_Off(LED0);
@@ -413,13 +537,13 @@ void uac2_device_audio_task(void *pvParameters)
 								LED_On(LED1);
 								FB_rate += 2*FB_RATE_DELTA;
 								old_gap = gap;
-								print_dbg_char_char('*');
+								eventlog_put(ev_fb_adjust, 2*FB_RATE_DELTA, gap, FB_rate);
 							}
 							else if (gap > SPK_GAP_U1) { 	// gap > inner upper bound => 1*FB_RATE_DELTA
 								LED_On(LED1);
 								FB_rate += FB_RATE_DELTA;
 								old_gap = gap;
-								print_dbg_char_char('+');
+								eventlog_put(ev_fb_adjust, FB_RATE_DELTA, gap, FB_rate);
 							}
 							else {
 								LED_Off(LED0);
@@ -456,9 +580,11 @@ void uac2_device_audio_task(void *pvParameters)
 //					Alternative Linux quirk replacement code, insert nominal FB_rate after a short interlude of requesting 99ksps (see uac2_usb_specific_request.c)
 					if ( (current_freq.frequency == 88200) && (FB_rate > (98 << 14) ) ) {
 						FB_rate = (88 << 14) + (1<<14)/5;
+						STREAM_HEALTH_COUNT(sh_fb_clamp);
 					}
 					if ( (current_freq.frequency == 96000) && (FB_rate > (98 << 14) ) ) {
 						FB_rate = (96) << 14;
+						STREAM_HEALTH_COUNT(sh_fb_clamp);
 					}
 				}
 
@@ -478,22 +604,29 @@ void uac2_device_audio_task(void *pvParameters)
 
 				Usb_reset_endpoint_fifo_access(EP_AUDIO_OUT);
 
+				// without the feedback endpoint the gap is only watched, once a packet
+				if (FEATURE_SYNC_IMPLICIT)
+					(void)uac2_spk_gap_update(spk_pdca_channel, playerStarted);
+
 				// BSB debug 20120913
 				num_samples = Usb_byte_count(EP_AUDIO_OUT);
-//				if ( (num_samples & (U16)7) != 0)
-//					print_dbg_char_char('7');
+				if ( (num_samples & (U16)7) != 0)
+					STREAM_HEALTH_COUNT(sh_odd_packet);
 				num_samples = num_samples / 8;
+				if (playerStarted && num_samples + 1 < current_freq.frequency /
+					(Is_usb_full_speed_mode() ? 1000 : 1000000 / UAC2_INTERVAL_US_HS))
+					STREAM_HEALTH_COUNT(sh_short_packet);
 
-				xSemaphoreTake( mutexSpkUSB, portMAX_DELAY );
-				spk_usb_heart_beat++;					// indicates EP_AUDIO_OUT receiving data from host
-				spk_usb_sample_counter += num_samples; 	// track the num of samples received
-				xSemaphoreGive(mutexSpkUSB);
+				// indicates EP_AUDIO_OUT receiving data from host, and tracks the num of samples received
+				spk_usb_counters_update(num_samples);
 				if(!playerStarted) {
 
 //					gpio_set_gpio_pin(AVR32_PIN_PX55); // BSB debug 20120911, positive edge marks playerStarted FALSE->TRUE
 //					print_dbg_char_char('Y'); // BSB debug 20120911
 
 					playerStarted = TRUE;
+					device_audio_first_sample(DEVICE_AUDIO_PLAYBACK);
+					STREAM_HEALTH_COUNT(sh_resync);
 					num_remaining = spk_pdca_channel->tcr;
 //					if (spk_buffer_in != spk_buffer_out) {
 //						spk_buffer_in = 1 - spk_buffer_in;
@@ -581,6 +714,7 @@ void uac2_device_audio_task(void *pvParameters)
 			playerStarted=FALSE;
 //			gpio_clr_gpio_pin(AVR32_PIN_PX55); // BSB 20120911 debug
 			old_gap = SPK_BUFFER_SIZE;
+			spk_gap = SPK_BUFFER_SIZE;
 		}
 	} // end while vTask
 }
@@ -50,6 +50,13 @@
 #include "taskMoboCtrl.h"
 #include "taskPowerDisplay.h"
 #include "taskPushButtonMenu.h"
+#include "taskRunStats.h"
+#include "eventlog.h"
+#include "dg8saq_queue.h"
+#include "taskStartupLeds.h"
+#include "telemetry.h"
+#include "spectrum.h"
+#include "ram_budget.h"
 #include "wdt.h"
 
 #if LCD_DISPLAY				// Multi-line LCD display
@@ -64,6 +71,7 @@
 #include "uac2_usb_descriptors.h"
 #include "usb_specific_request.h"
 #include "uac2_usb_specific_request.h"
+#include "uac2_audio_controls.h"
 #include "uac2_device_audio_task.h"
 
 // image launch
@@ -75,6 +83,11 @@ static void x_image_init(void) {
 }
 
 static void x_image_task_init(void) {
+	// Control requests answered without polling EP0
+	usb_ctrl_register(DRT_MASK, DRT_VENDOR, usb_user_DG8SAQ);
+	usb_ctrl_register(DRR_MASK, DRR_INTERFACE, uac2_user_hid_request);
+	usb_ctrl_register(DRT_MASK | DRR_MASK, DRT_CLASS | DRR_INTERFACE, uac2_user_audio_request);
+
 	// Initialize USB task
 	usb_task_init();
 
@@ -87,15 +100,22 @@ static void x_image_task_init(void) {
 	vStartTaskPushButtonMenu();
 #endif
 	vStartTaskMoboCtrl();
+	vStartTaskDG8SAQ();
 	// vStartTaskEXERCISE( tskIDLE_PRIORITY );
 	uac2_AK5394A_task_init();
 	device_mouse_hid_task_init(UAC2_EP_HID_RX, UAC2_EP_HID_TX); // Added BSB 20120719
 	uac2_device_audio_task_init(UAC2_EP_AUDIO_IN, UAC2_EP_AUDIO_OUT, UAC2_EP_AUDIO_OUT_FB);
+	vStartTaskRunStats();
+	vStartTaskEventLog();
+	vStartTaskStartupLeds();
+	vStartTaskTelemetry(UAC2_EP_TELEMETRY);
+	vStartTaskSpectrum(UAC2_EP_TELEMETRY);
 #endif
 #if LCD_DISPLAY						// Multi-line LCD display
 	if ( ! FEATURE_LOG_NONE )
 		vStartTaskStartupLogDisplay();
 #endif
+	ram_budget_report();
 }
 
 // descriptor accessors
@@ -112,22 +132,34 @@ static uint16_t x_dg8saq_get_dev_desc_length(void) {
 	return (uint16_t)sizeof(uac2_dg8saq_usb_dev_desc);
 }
 static uint8_t *x_image_get_conf_desc_pointer(void) {
+	if (FEATURE_SYNC_IMPLICIT)
+		return (uint8_t *)&uac2_usb_conf_desc_implicit_fs;
 	return (uint8_t *)&uac2_usb_conf_desc_fs;
 }
 static uint16_t x_image_get_conf_desc_length(void) {
+	if (FEATURE_SYNC_IMPLICIT)
+		return sizeof(uac2_usb_conf_desc_implicit_fs);
 	return sizeof(uac2_usb_conf_desc_fs);
 }
 static uint8_t *x_image_get_conf_desc_fs_pointer(void) {
+	if (FEATURE_SYNC_IMPLICIT)
+		return (uint8_t *)&uac2_usb_conf_desc_implicit_fs;
 	return (uint8_t *)&uac2_usb_conf_desc_fs;
 }
 static uint16_t x_image_get_conf_desc_fs_length(void) {
+	if (FEATURE_SYNC_IMPLICIT)
+		return sizeof(uac2_usb_conf_desc_implicit_fs);
 	return sizeof(uac2_usb_conf_desc_fs);
 }
 #if USB_HIGH_SPEED_SUPPORT==ENABLED
 static uint8_t *x_image_get_conf_desc_hs_pointer(void) {
+	if (FEATURE_SYNC_IMPLICIT)
+		return (uint8_t *)&uac2_usb_conf_desc_implicit_hs;
 	return (uint8_t *)&uac2_usb_conf_desc_hs;
 }
 static uint16_t x_image_get_conf_desc_hs_length(void) {
+	if (FEATURE_SYNC_IMPLICIT)
+		return sizeof(uac2_usb_conf_desc_implicit_hs);
 	return sizeof(uac2_usb_conf_desc_hs);
 }
 static uint8_t *x_image_get_qualifier_desc_pointer(void) {
@@ -141,9 +173,6 @@ static uint16_t x_image_get_qualifier_desc_length(void) {
 static void x_image_user_endpoint_init(uint8_t conf_nb) {
 	uac2_user_endpoint_init(conf_nb);
 }
-static Bool x_image_user_read_request(uint8_t type, uint8_t request) {
-	return uac2_user_read_request(type, request);
-}
 static void x_image_user_set_interface(U8 wIndex, U8 wValue) {
 	uac2_user_set_interface(wIndex, wValue);
 }
@@ -171,7 +200,6 @@ const image_t uac2_audio_image = {
 	NULL,
 #endif
 	x_image_user_endpoint_init,
-	x_image_user_read_request,
 	x_image_user_set_interface
 };
 
@@ -197,7 +225,6 @@ const image_t uac2_dg8saq_image = {
 	NULL,
 #endif
 	x_image_user_endpoint_init,
-	x_image_user_read_request,
 	x_image_user_set_interface
 };
 
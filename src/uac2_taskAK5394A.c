@@ -58,7 +58,10 @@
 #include "uac2_device_audio_task.h"
 #include "uac2_usb_descriptors.h"
 #include "taskAK5394A.h"
+#include "stream_health.h"
+#include "usb_power.h"
 #include "uac2_taskAK5394A.h"
+#include "ram_budget.h"
 #include "Mobo_config.h"
 
 //_____ M A C R O S ________________________________________________________
@@ -79,12 +82,12 @@ void uac2_AK5394A_task_init(void) {
 	gpio_clr_gpio_pin(SAMPLEFREQ_VAL1);
 	gpio_set_gpio_pin(SAMPLEFREQ_VAL0);
 
-	xTaskCreate(uac2_AK5394A_task,
+	ram_budget_task_create(uac2_AK5394A_task,
 				configTSK_AK5394A_NAME,
 				configTSK_AK5394A_STACK_SIZE,
 				NULL,
 				UAC2_configTSK_AK5394A_PRIORITY,
-				NULL);
+				ram_budget_AK5394A_stack);
 }
 
 //!
@@ -94,6 +97,8 @@ void uac2_AK5394A_task(void *pvParameters) {
 	portTickType xLastWakeTime;
 	xLastWakeTime = xTaskGetTickCount();
 	int i;
+	spk_usb_counts_t spk_usb;
+	Bool spk_streaming = FALSE;
 /*
 	U32 poolingFreq;
 	U32 FB_rate_int;
@@ -110,14 +115,27 @@ void uac2_AK5394A_task(void *pvParameters) {
 
 		vTaskDelayUntil(&xLastWakeTime, UAC2_configTSK_AK5394A_PERIOD);
 
+		// no OUT packets while suspended is not a stall
+		if (usb_power_suspended) {
+			spk_streaming = FALSE;
+			continue;
+		}
+
 		// silence speaker if USB data out is stalled, as indicated by heart-beat counter
-		if (old_spk_usb_heart_beat == spk_usb_heart_beat){
+		spk_usb_counters_read(&spk_usb);
+		if (old_spk_usb_heart_beat == spk_usb.heart_beat){
+			// a stream that stops while still selected is a stall
+			if (spk_streaming && usb_alternate_setting_out == 1)
+				STREAM_HEALTH_COUNT(sh_spk_stall);
+			spk_streaming = FALSE;
 			for (i = 0; i < SPK_BUFFER_SIZE; i++) {
 				spk_buffer_0[i] = 0;
 				spk_buffer_1[i] = 0;
 			}
 		}
-		old_spk_usb_heart_beat = spk_usb_heart_beat;
+		else
+			spk_streaming = TRUE;
+		old_spk_usb_heart_beat = spk_usb.heart_beat;
 
 
 		if (FEATURE_IMAGE_UAC2_DG8SAQ) {
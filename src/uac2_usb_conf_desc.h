@@ -0,0 +1,567 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * uac2_usb_conf_desc.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * The UAC2 configuration descriptor, written once for the four
+ * configurations of the image: full and high speed, each with
+ * feature_sync_explicit and with feature_sync_implicit. FEATURE_SYNC_IMPLICIT
+ * picks one of the two at run time, see uac2_image.c, so both are in flash.
+ *
+ * No include guard, it is included once for each, with
+ *   UAC2_CONF_IMPLICIT	0: the OUT_FB endpoint, the record interface has
+ *						   the narrowband IQ alt 1 only
+ *						1: no OUT_FB, the mic terminals, and the record
+ *						   interface has the full rate alt 1 on the playback
+ *						   clock, narrowband IQ at UAC2_IQ_ALT
+ * and, from uac2_usb_descriptors.h, nothing more for the struct type, or,
+ * from uac2_usb_descriptors.c, for the descriptor itself
+ *   UAC2_CONF_NAME		the name of the descriptor
+ *   UAC2_CONF_HS		0 full speed, 1 high speed
+ * It undefines them again.
+ */
+
+#if UAC2_CONF_IMPLICIT
+#define UAC2_CONF_TYPE		S_usb_user_configuration_descriptor_implicit
+#else
+#define UAC2_CONF_TYPE		S_usb_user_configuration_descriptor
+#endif
+
+#ifndef UAC2_CONF_NAME
+
+typedef
+#if (defined __ICCAVR32__)
+#pragma pack(1)
+#endif
+struct
+#if (defined __GNUC__)
+__attribute__((__packed__))
+#endif
+{
+	S_usb_configuration_descriptor			cfg;
+	S_usb_interface_descriptor	 			ifc0;
+
+	//! Audio descriptors Class 2
+
+	S_usb_interface_association_descriptor	iad1;
+	S_usb_interface_descriptor				ifc1;
+	S_usb_ac_interface_descriptor_2			audioac;
+	S_usb_clock_source_descriptor			audio_cs2;
+	S_usb_clock_source_descriptor			audio_cs_iq;
+#if UAC2_CONF_IMPLICIT
+	S_usb_in_ter_descriptor_2 				mic_in_ter;
+	S_usb_feature_unit_descriptor_2			mic_fea_unit;
+	S_usb_out_ter_descriptor_2				mic_out_ter;
+#endif
+	S_usb_in_ter_descriptor_2				iq_in_ter;
+	S_usb_out_ter_descriptor_2				iq_out_ter;
+	S_usb_in_ter_descriptor_2				spk_in_ter;
+	S_usb_feature_unit_descriptor_2			spk_fea_unit;
+	S_usb_out_ter_descriptor_2				spk_out_ter;
+	S_usb_as_interface_descriptor	 		spk_as_alt0;
+	S_usb_as_interface_descriptor	 		spk_as_alt1;
+	S_usb_as_g_interface_descriptor_2		spk_g_as;
+	S_usb_format_type_2						spk_format_type;
+	S_usb_endpoint_audio_descriptor_2 		ep2;
+	S_usb_endpoint_audio_specific_2			ep2_s;
+#if ! UAC2_CONF_IMPLICIT
+	S_usb_endpoint_audio_descriptor_2 		ep3;
+#endif
+	S_usb_as_interface_descriptor	 		rec_as_alt0;
+#if UAC2_CONF_IMPLICIT
+	S_usb_as_interface_descriptor	 		mic_as_alt1;
+	S_usb_as_g_interface_descriptor_2		mic_g_as;
+	S_usb_format_type_2						mic_format_type;
+	S_usb_endpoint_audio_descriptor_2 		ep1;
+	S_usb_endpoint_audio_specific_2			ep1_s;
+#endif
+	S_usb_as_interface_descriptor	 		iq_as_alt;
+	S_usb_as_g_interface_descriptor_2		iq_g_as;
+	S_usb_format_type_2						iq_format_type;
+	S_usb_endpoint_audio_descriptor_2 		ep1_iq;
+	S_usb_endpoint_audio_specific_2			ep1_iq_s;
+
+	// BSB 20120720 Added
+	S_usb_interface_descriptor		ifc3;
+	S_usb_hid_descriptor           	hid;
+	S_usb_endpoint_descriptor      	ep4;
+	S_usb_endpoint_descriptor	   	ep5;
+
+	S_usb_interface_descriptor		ifc4;
+	S_usb_endpoint_descriptor      	ep6;
+	S_usb_interface_descriptor		ifc4_spectrum;
+	S_usb_endpoint_descriptor      	ep6_spectrum;
+}
+#if (defined __ICCAVR32__)
+#pragma pack()
+#endif
+UAC2_CONF_TYPE;
+
+#else
+
+#if UAC2_CONF_HS
+#define UAC2_CONF_SPEED(fs, hs)		hs
+#else
+#define UAC2_CONF_SPEED(fs, hs)		fs
+#endif
+
+const UAC2_CONF_TYPE UAC2_CONF_NAME =
+{
+  {
+    sizeof(S_usb_configuration_descriptor),
+    CONFIGURATION_DESCRIPTOR,
+    Usb_format_mcu_to_usb_data(16, sizeof(UAC2_CONF_TYPE)),
+    NB_INTERFACE,
+    CONF_NB,
+    CONF_INDEX,
+    CONF_ATTRIBUTES,
+    MAX_POWER
+  }
+,
+  {
+    sizeof(S_usb_interface_descriptor),
+    INTERFACE_DESCRIPTOR,
+    INTERFACE_NB0,
+    ALTERNATE_NB0,
+    NB_ENDPOINT0,
+    INTERFACE_CLASS0,
+    INTERFACE_SUB_CLASS0,
+    INTERFACE_PROTOCOL0,
+    INTERFACE_INDEX0
+  }
+,
+  {  sizeof(S_usb_interface_association_descriptor) // 4.6
+  ,  DESCRIPTOR_IAD
+  ,  FIRST_INTERFACE1					// bFirstInterface
+  ,  INTERFACE_COUNT1 					// bInterfaceCount
+  ,  UAC2_CONF_SPEED(INTERFACE_CLASS1, FUNCTION_CLASS)
+  ,  UAC2_CONF_SPEED(INTERFACE_SUB_CLASS1, FUNCTION_SUB_CLASS)
+  ,  UAC2_CONF_SPEED(INTERFACE_PROTOCOL1, FUNCTION_PROTOCOL)
+  ,  UAC2_CONF_SPEED(INTERFACE_INDEX1, FUNCTION_INDEX)
+  }
+,
+  {
+    sizeof(S_usb_interface_descriptor),
+    INTERFACE_DESCRIPTOR,
+    INTERFACE_NB1,
+    ALTERNATE_NB1,
+    NB_ENDPOINT1,
+    INTERFACE_CLASS1,
+    INTERFACE_SUB_CLASS1,
+    INTERFACE_PROTOCOL1,
+    INTERFACE_INDEX1
+  }
+,
+  // the mic terminals and feature unit only with feature_sync_implicit
+  {  sizeof(S_usb_ac_interface_descriptor_2)
+  ,  CS_INTERFACE
+  ,  HEADER_SUB_TYPE
+  ,  Usb_format_mcu_to_usb_data(16, AUDIO_CLASS_REVISION_2)
+  ,  HEADSET_CATEGORY
+  ,  Usb_format_mcu_to_usb_data(16, sizeof(S_usb_ac_interface_descriptor_2)
+		+ 2*sizeof(S_usb_clock_source_descriptor)
+		+ (2 + UAC2_CONF_IMPLICIT)*sizeof(S_usb_in_ter_descriptor_2)
+		+ (1 + UAC2_CONF_IMPLICIT)*sizeof(S_usb_feature_unit_descriptor_2)
+		+ (2 + UAC2_CONF_IMPLICIT)*sizeof(S_usb_out_ter_descriptor_2))
+  ,  MIC_LATENCY_CONTROL
+  }
+,
+  {  sizeof (S_usb_clock_source_descriptor)
+  ,  CS_INTERFACE
+  ,  DESCRIPTOR_SUBTYPE_AUDIO_AC_CLOCK_SOURCE
+  ,  CSD_ID_2
+  ,  CSD_ID_2_TYPE
+  ,  CSD_ID_2_CONTROL
+  ,  UAC2_CONF_SPEED(INPUT_TERMINAL_ID, OUTPUT_TERMINAL_ID)
+  ,  UAC2_CONF_SPEED(0x00, CLOCK_SOURCE_2_INDEX)
+  }
+,
+  {  sizeof (S_usb_clock_source_descriptor)
+  ,  CS_INTERFACE
+  ,  DESCRIPTOR_SUBTYPE_AUDIO_AC_CLOCK_SOURCE
+  ,  CSD_ID_IQ
+  ,  CSD_ID_IQ_TYPE
+  ,  CSD_ID_IQ_CONTROL
+  ,  IQ_INPUT_TERMINAL_ID
+  ,  0x00
+  }
+,
+#if UAC2_CONF_IMPLICIT
+  {  sizeof(S_usb_in_ter_descriptor_2)
+  ,  CS_INTERFACE
+  ,  INPUT_TERMINAL_SUB_TYPE
+  ,  INPUT_TERMINAL_ID
+  ,  Usb_format_mcu_to_usb_data(16, INPUT_TERMINAL_TYPE)
+  ,  INPUT_TERMINAL_ASSOCIATION
+  ,  MIC_CLOCK_ID_IMPLICIT
+  ,  INPUT_TERMINAL_NB_CHANNELS
+  ,  Usb_format_mcu_to_usb_data(32, INPUT_TERMINAL_CHANNEL_CONF)
+  ,  INPUT_TERMINAL_CH_NAME_ID
+  ,  Usb_format_mcu_to_usb_data(16, INPUT_TERMINAL_CONTROLS)
+  ,  INPUT_TERMINAL_STRING_DESC
+  }
+,
+  {  sizeof(S_usb_feature_unit_descriptor_2)
+  ,  CS_INTERFACE
+  ,  FEATURE_UNIT_SUB_TYPE
+  ,  MIC_FEATURE_UNIT_ID
+  ,  MIC_FEATURE_UNIT_SOURCE_ID
+  ,  Usb_format_mcu_to_usb_data(32, MIC_BMA_CONTROLS)
+  ,  Usb_format_mcu_to_usb_data(32, MIC_BMA_CONTROLS_CH_1)
+  ,  Usb_format_mcu_to_usb_data(32, MIC_BMA_CONTROLS_CH_2)
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_out_ter_descriptor_2)
+  ,  CS_INTERFACE
+  ,  OUTPUT_TERMINAL_SUB_TYPE
+  ,  OUTPUT_TERMINAL_ID
+  ,  Usb_format_mcu_to_usb_data(16, OUTPUT_TERMINAL_TYPE)
+  ,  OUTPUT_TERMINAL_ASSOCIATION
+  ,  OUTPUT_TERMINAL_SOURCE_ID
+  ,  MIC_CLOCK_ID_IMPLICIT
+  ,  Usb_format_mcu_to_usb_data(16, OUTPUT_TERMINAL_CONTROLS)
+  ,  0x00
+  }
+,
+#endif
+  {  sizeof(S_usb_in_ter_descriptor_2)
+  ,  CS_INTERFACE
+  ,  INPUT_TERMINAL_SUB_TYPE
+  ,  IQ_INPUT_TERMINAL_ID
+  ,  Usb_format_mcu_to_usb_data(16, IQ_INPUT_TERMINAL_TYPE)
+  ,  INPUT_TERMINAL_ASSOCIATION
+  ,  CSD_ID_IQ
+  ,  INPUT_TERMINAL_NB_CHANNELS
+  ,  Usb_format_mcu_to_usb_data(32, INPUT_TERMINAL_CHANNEL_CONF)
+  ,  INPUT_TERMINAL_CH_NAME_ID
+  ,  Usb_format_mcu_to_usb_data(16, INPUT_TERMINAL_CONTROLS)
+  ,  INPUT_TERMINAL_STRING_DESC
+  }
+,
+  {  sizeof(S_usb_out_ter_descriptor_2)
+  ,  CS_INTERFACE
+  ,  OUTPUT_TERMINAL_SUB_TYPE
+  ,  IQ_OUTPUT_TERMINAL_ID
+  ,  Usb_format_mcu_to_usb_data(16, OUTPUT_TERMINAL_TYPE)
+  ,  OUTPUT_TERMINAL_ASSOCIATION
+  ,  IQ_OUTPUT_TERMINAL_SOURCE_ID
+  ,  CSD_ID_IQ
+  ,  Usb_format_mcu_to_usb_data(16, OUTPUT_TERMINAL_CONTROLS)
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_in_ter_descriptor_2)
+  ,  CS_INTERFACE
+  ,  INPUT_TERMINAL_SUB_TYPE
+  ,  SPK_INPUT_TERMINAL_ID
+  ,  Usb_format_mcu_to_usb_data(16, SPK_INPUT_TERMINAL_TYPE)
+  ,  SPK_INPUT_TERMINAL_ASSOCIATION
+  ,  CSD_ID_2
+  ,  SPK_INPUT_TERMINAL_NB_CHANNELS
+  ,  Usb_format_mcu_to_usb_data(32, SPK_INPUT_TERMINAL_CHANNEL_CONF)
+  ,  UAC2_CONF_SPEED(INPUT_TERMINAL_CH_NAME_ID, SPK_INPUT_TERMINAL_CH_NAME_ID)
+  ,  Usb_format_mcu_to_usb_data(16, INPUT_TERMINAL_CONTROLS)
+  ,  UAC2_CONF_SPEED(INPUT_TERMINAL_STRING_DESC, SPK_INPUT_TERMINAL_STRING_DESC)
+  }
+,
+  {  sizeof(S_usb_feature_unit_descriptor_2)
+  ,  CS_INTERFACE
+  ,  FEATURE_UNIT_SUB_TYPE
+  ,  SPK_FEATURE_UNIT_ID
+  ,  SPK_FEATURE_UNIT_SOURCE_ID
+  ,  Usb_format_mcu_to_usb_data(32, SPK_BMA_CONTROLS)
+  ,  Usb_format_mcu_to_usb_data(32, SPK_BMA_CONTROLS_CH_1)
+  ,  Usb_format_mcu_to_usb_data(32, SPK_BMA_CONTROLS_CH_2)
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_out_ter_descriptor_2)
+  ,  CS_INTERFACE
+  ,  OUTPUT_TERMINAL_SUB_TYPE
+  ,  SPK_OUTPUT_TERMINAL_ID
+  ,  Usb_format_mcu_to_usb_data(16, SPK_OUTPUT_TERMINAL_TYPE)
+  ,  SPK_OUTPUT_TERMINAL_ASSOCIATION
+  ,  SPK_OUTPUT_TERMINAL_SOURCE_ID
+  ,  CSD_ID_2
+  ,  Usb_format_mcu_to_usb_data(16, SPK_OUTPUT_TERMINAL_CONTROLS)
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_as_interface_descriptor)
+  ,  INTERFACE_DESCRIPTOR
+  ,  STD_AS_INTERFACE_OUT
+  ,  ALT0_AS_INTERFACE_INDEX
+  ,  ALT0_AS_NB_ENDPOINT
+  ,  ALT0_AS_INTERFACE_CLASS
+  ,  ALT0_AS_INTERFACE_SUB_CLASS
+  ,  ALT0_AS_INTERFACE_PROTOCOL
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_as_interface_descriptor)
+  ,  INTERFACE_DESCRIPTOR
+  ,  STD_AS_INTERFACE_OUT
+  ,  ALT1_AS_INTERFACE_INDEX
+  ,  UAC2_CONF_IMPLICIT ? ALT1_AS_NB_ENDPOINT_OUT_IMPLICIT : ALT1_AS_NB_ENDPOINT_OUT
+  ,  ALT1_AS_INTERFACE_CLASS
+  ,  ALT1_AS_INTERFACE_SUB_CLASS
+  ,  ALT1_AS_INTERFACE_PROTOCOL
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_as_g_interface_descriptor_2)
+  ,  CS_INTERFACE
+  ,  GENERAL_SUB_TYPE
+  ,  SPK_INPUT_TERMINAL_ID
+  ,  AS_CONTROLS
+  ,  AS_FORMAT_TYPE
+  ,  Usb_format_mcu_to_usb_data(32, AS_FORMATS)
+  ,  AS_NB_CHANNELS
+  ,  Usb_format_mcu_to_usb_data(32, AS_CHAN_CONFIG)
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_format_type_2)
+  ,  CS_INTERFACE
+  ,  FORMAT_SUB_TYPE
+  ,  FORMAT_TYPE_1
+  ,  FORMAT_SUBSLOT_SIZE_1
+  ,  FORMAT_BIT_RESOLUTION_1
+  }
+,
+  {  sizeof(S_usb_endpoint_audio_descriptor_2)
+  ,  ENDPOINT_DESCRIPTOR
+  ,  ENDPOINT_NB_2
+  ,  EP_ATTRIBUTES_2
+  ,  Usb_format_mcu_to_usb_data(16, UAC2_CONF_SPEED(EP_SIZE_2_FS, EP_MAX_PACKET_2_HS))
+  ,  UAC2_CONF_SPEED(EP_INTERVAL_2_FS, EP_INTERVAL_2_HS)
+  }
+,
+  {  sizeof(S_usb_endpoint_audio_specific_2)
+  ,  CS_ENDPOINT
+  ,  GENERAL_SUB_TYPE
+  ,  AUDIO_EP_ATRIBUTES
+  ,  AUDIO_EP_CONTROLS
+  ,  AUDIO_EP_DELAY_UNIT
+  ,  Usb_format_mcu_to_usb_data(16, AUDIO_EP_LOCK_DELAY)
+  }
+,
+#if ! UAC2_CONF_IMPLICIT
+  // the explicit feedback, the implicit one follows the record packets
+  {  sizeof(S_usb_endpoint_audio_descriptor_2)
+  ,  ENDPOINT_DESCRIPTOR
+  ,  ENDPOINT_NB_3
+  ,  EP_ATTRIBUTES_3
+  ,  Usb_format_mcu_to_usb_data(16, UAC2_CONF_SPEED(EP_SIZE_3_FS, EP_SIZE_3_HS))
+  ,  UAC2_CONF_SPEED(EP_INTERVAL_3_FS, EP_INTERVAL_3_HS)
+  }
+,
+#endif
+  {  sizeof(S_usb_as_interface_descriptor)
+  ,  INTERFACE_DESCRIPTOR
+  ,  STD_AS_INTERFACE_IN
+  ,  ALT0_AS_INTERFACE_INDEX
+  ,  ALT0_AS_NB_ENDPOINT
+  ,  ALT0_AS_INTERFACE_CLASS
+  ,  ALT0_AS_INTERFACE_SUB_CLASS
+  ,  ALT0_AS_INTERFACE_PROTOCOL
+  ,  0x00
+  }
+,
+#if UAC2_CONF_IMPLICIT
+  // the full rate record alt on the playback clock
+  {  sizeof(S_usb_as_interface_descriptor)
+  ,  INTERFACE_DESCRIPTOR
+  ,  STD_AS_INTERFACE_IN
+  ,  ALT1_AS_INTERFACE_INDEX
+  ,  ALT1_AS_NB_ENDPOINT
+  ,  ALT1_AS_INTERFACE_CLASS
+  ,  ALT1_AS_INTERFACE_SUB_CLASS
+  ,  ALT1_AS_INTERFACE_PROTOCOL
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_as_g_interface_descriptor_2)
+  ,  CS_INTERFACE
+  ,  GENERAL_SUB_TYPE
+  ,  AS_TERMINAL_LINK
+  ,  MIC_AS_CONTROLS
+  ,  AS_FORMAT_TYPE
+  ,  Usb_format_mcu_to_usb_data(32, AS_FORMATS)
+  ,  AS_NB_CHANNELS
+  ,  Usb_format_mcu_to_usb_data(32, AS_CHAN_CONFIG)
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_format_type_2)
+  ,  CS_INTERFACE
+  ,  FORMAT_SUB_TYPE
+  ,  FORMAT_TYPE_1
+  ,  FORMAT_SUBSLOT_SIZE_1
+  ,  FORMAT_BIT_RESOLUTION_1
+  }
+,
+  {  sizeof(S_usb_endpoint_audio_descriptor_2)
+  ,  ENDPOINT_DESCRIPTOR
+  ,  ENDPOINT_NB_1
+  ,  EP_ATTRIBUTES_1
+  ,  Usb_format_mcu_to_usb_data(16, UAC2_CONF_SPEED(EP_SIZE_1_FS, EP_MAX_PACKET_1_HS))
+  ,  UAC2_CONF_SPEED(EP_INTERVAL_1_FS, EP_INTERVAL_1_HS)
+  }
+,
+  {  sizeof(S_usb_endpoint_audio_specific_2)
+  ,  CS_ENDPOINT
+  ,  GENERAL_SUB_TYPE
+  ,  AUDIO_EP_ATRIBUTES
+  ,  AUDIO_EP_CONTROLS
+  ,  AUDIO_EP_DELAY_UNIT
+  ,  Usb_format_mcu_to_usb_data(16, AUDIO_EP_LOCK_DELAY)
+  }
+,
+#endif
+  // the narrowband IQ alt, see DSC_IQ_ALT
+  {  sizeof(S_usb_as_interface_descriptor)
+  ,  INTERFACE_DESCRIPTOR
+  ,  STD_AS_INTERFACE_IN
+  ,  UAC2_CONF_IMPLICIT ? IQ_AS_INTERFACE_INDEX : IQ_AS_INTERFACE_INDEX_EXPLICIT
+  ,  ALT1_AS_NB_ENDPOINT
+  ,  ALT1_AS_INTERFACE_CLASS
+  ,  ALT1_AS_INTERFACE_SUB_CLASS
+  ,  ALT1_AS_INTERFACE_PROTOCOL
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_as_g_interface_descriptor_2)
+  ,  CS_INTERFACE
+  ,  GENERAL_SUB_TYPE
+  ,  IQ_AS_TERMINAL_LINK
+  ,  MIC_AS_CONTROLS
+  ,  AS_FORMAT_TYPE
+  ,  Usb_format_mcu_to_usb_data(32, AS_FORMATS)
+  ,  AS_NB_CHANNELS
+  ,  Usb_format_mcu_to_usb_data(32, AS_CHAN_CONFIG)
+  ,  0x00
+  }
+,
+  {  sizeof(S_usb_format_type_2)
+  ,  CS_INTERFACE
+  ,  FORMAT_SUB_TYPE
+  ,  FORMAT_TYPE_1
+  ,  FORMAT_SUBSLOT_SIZE_1
+  ,  FORMAT_BIT_RESOLUTION_1
+  }
+,
+  {  sizeof(S_usb_endpoint_audio_descriptor_2)
+  ,  ENDPOINT_DESCRIPTOR
+  ,  ENDPOINT_NB_1
+  ,  EP_ATTRIBUTES_1_IQ
+  ,  Usb_format_mcu_to_usb_data(16, UAC2_CONF_SPEED(EP_SIZE_1_IQ_FS, EP_MAX_PACKET_1_IQ_HS))
+  ,  UAC2_CONF_SPEED(EP_INTERVAL_1_FS, EP_INTERVAL_1_HS)
+  }
+,
+  {  sizeof(S_usb_endpoint_audio_specific_2)
+  ,  CS_ENDPOINT
+  ,  GENERAL_SUB_TYPE
+  ,  AUDIO_EP_ATRIBUTES
+  ,  AUDIO_EP_CONTROLS
+  ,  AUDIO_EP_DELAY_UNIT
+  ,  Usb_format_mcu_to_usb_data(16, AUDIO_EP_LOCK_DELAY)
+  }
+
+  // BSB 20120720 Insert EP 4 and 5, HID TX and RX begin
+  ,
+  {
+  	sizeof(S_usb_interface_descriptor),
+  	INTERFACE_DESCRIPTOR,
+  	INTERFACE_NB3,
+  	ALTERNATE_NB3,
+  	NB_ENDPOINT3,
+  	INTERFACE_CLASS3,
+  	INTERFACE_SUB_CLASS3,
+  	INTERFACE_PROTOCOL3,
+  	INTERFACE_INDEX3
+  }
+  ,
+  {
+  	sizeof(S_usb_hid_descriptor),
+  	HID_DESCRIPTOR,
+  	Usb_format_mcu_to_usb_data(16, HID_VERSION),
+  	HID_COUNTRY_CODE,
+  	HID_NUM_DESCRIPTORS,
+  	HID_REPORT_DESCRIPTOR,
+  	Usb_format_mcu_to_usb_data(16, sizeof(usb_hid_report_descriptor))
+  }
+  ,
+  {
+  	sizeof(S_usb_endpoint_descriptor),
+  	ENDPOINT_DESCRIPTOR,
+  	ENDPOINT_NB_4,
+  	EP_ATTRIBUTES_4,
+  	Usb_format_mcu_to_usb_data(16, UAC2_CONF_SPEED(EP_SIZE_4_FS, EP_SIZE_4_HS)),
+  	EP_INTERVAL_4
+  }
+  ,
+  {
+  	sizeof(S_usb_endpoint_descriptor),
+  	ENDPOINT_DESCRIPTOR,
+  	ENDPOINT_NB_5,
+  	EP_ATTRIBUTES_5,
+  	Usb_format_mcu_to_usb_data(16, UAC2_CONF_SPEED(EP_SIZE_5_FS, EP_SIZE_5_HS)),
+  	EP_INTERVAL_5
+  }
+  // BSB 20120720 Insert EP 4 and 5, HID TX and RX end
+  ,
+  {
+  	sizeof(S_usb_interface_descriptor),
+  	INTERFACE_DESCRIPTOR,
+  	INTERFACE_NB4,
+  	ALTERNATE_NB4,
+  	NB_ENDPOINT4,
+  	INTERFACE_CLASS4,
+  	INTERFACE_SUB_CLASS4,
+  	INTERFACE_PROTOCOL4,
+  	INTERFACE_INDEX4
+  }
+  ,
+  {
+  	sizeof(S_usb_endpoint_descriptor),
+  	ENDPOINT_DESCRIPTOR,
+  	ENDPOINT_NB_6,
+  	EP_ATTRIBUTES_6,
+  	Usb_format_mcu_to_usb_data(16, UAC2_CONF_SPEED(EP_IN_LENGTH_6_FS, EP_IN_LENGTH_6_HS)),
+  	UAC2_CONF_SPEED(EP_INTERVAL_6_FS, EP_INTERVAL_6_HS)
+  }
+  ,
+  {
+  	sizeof(S_usb_interface_descriptor),
+  	INTERFACE_DESCRIPTOR,
+  	INTERFACE_NB4,
+  	ALTERNATE_NB4_SPECTRUM,
+  	NB_ENDPOINT4,
+  	INTERFACE_CLASS4,
+  	INTERFACE_SUB_CLASS4,
+  	INTERFACE_PROTOCOL4,
+  	INTERFACE_INDEX4
+  }
+  ,
+  {
+  	sizeof(S_usb_endpoint_descriptor),
+  	ENDPOINT_DESCRIPTOR,
+  	ENDPOINT_NB_6,
+  	EP_ATTRIBUTES_6,
+  	Usb_format_mcu_to_usb_data(16, EP_IN_LENGTH_6_SPECTRUM),
+  	UAC2_CONF_SPEED(EP_INTERVAL_6_SPECTRUM_FS, EP_INTERVAL_6_SPECTRUM_HS)
+  }
+};
+
+#undef UAC2_CONF_SPEED
+#undef UAC2_CONF_NAME
+#undef UAC2_CONF_HS
+
+#endif
+
+#undef UAC2_CONF_TYPE
+#undef UAC2_CONF_IMPLICIT
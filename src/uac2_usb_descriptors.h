@@ -46,12 +46,15 @@
 #include "usb_standard_request.h"
 #include "usb_task.h"
 #include "hid.h" // Added BSB 20120719
+#include "uac2_audio_function.h"
+#include "telemetry_record.h"
+#include "spectrum.h"
 
 //_____ U S B    D E F I N E S _____________________________________________
 
 
 // CONFIGURATION
-#define NB_INTERFACE	   4	//!  DG8SAQ, Audio (2), HID
+#define NB_INTERFACE	   6	//!  DG8SAQ, Audio (3), HID, telemetry
 #define CONF_NB            1     //! Number of this configuration
 #define CONF_INDEX         0
 #define CONF_ATTRIBUTES    USB_CONFIG_BUSPOWERED	//USB_CONFIG_SELFPOWERED
@@ -59,7 +62,7 @@
 
 // IAD for Audio
 #define FIRST_INTERFACE1	1
-#define INTERFACE_COUNT1	2						//!  Audio Control, Audio Out
+#define INTERFACE_COUNT1	3						//!  Audio Control, Audio Out, Audio In
 #define FUNCTION_CLASS		AUDIO_CLASS
 #define FUNCTION_SUB_CLASS  0
 #define FUNCTION_PROTOCOL	IP_VERSION_02_00
@@ -81,7 +84,7 @@
 // In most cases: translation from uac1 code follows pattern of NB1 -> NB4, NB2 -> NB5
 
 // USB HID Interface descriptor
-#define INTERFACE_NB3			    3
+#define INTERFACE_NB3			    4				   //! after the record interface
 #define ALTERNATE_NB3	            0                  //! The alt setting nb of this interface
 #define NB_ENDPOINT3			    2                  //! The number of endpoints this interface has
 #define INTERFACE_CLASS3		    HID_CLASS          //! HID Class
@@ -116,6 +119,33 @@
 
 // BSB 20120719 HID insertion end
 
+// USB telemetry Interface descriptor, see telemetry.h
+#define INTERFACE_NB4			    5				   //! after the HID interface
+#define ALTERNATE_NB4	            0
+#define NB_ENDPOINT4			    1
+#define INTERFACE_CLASS4		    VENDOR_CLASS
+#define INTERFACE_SUB_CLASS4        NO_SUBCLASS
+#define INTERFACE_PROTOCOL4    		NO_PROTOCOL
+#define INTERFACE_INDEX4       		0
+
+#define DSC_INTERFACE_TELEMETRY		INTERFACE_NB4
+
+// the spectrum alt setting of the telemetry interface, see spectrum.h
+#define ALTERNATE_NB4_SPECTRUM		SPECTRUM_ALT
+
+// USB Endpoint 6 descriptor, sized in the hardware for either alt setting
+#define ENDPOINT_NB_6           (UAC2_EP_TELEMETRY | MSK_EP_DIR)
+#define EP_ATTRIBUTES_6         TYPE_INTERRUPT
+#define EP_IN_LENGTH_6_FS       TELEMETRY_RECORD_SIZE
+#define EP_SIZE_6_FS            Max(EP_IN_LENGTH_6_FS, EP_IN_LENGTH_6_SPECTRUM)
+#define EP_IN_LENGTH_6_HS       TELEMETRY_RECORD_SIZE
+#define EP_SIZE_6_HS            Max(EP_IN_LENGTH_6_HS, EP_IN_LENGTH_6_SPECTRUM)
+#define EP_INTERVAL_6_FS        TELEMETRY_PERIOD_MIN	//! 10 ms
+#define EP_INTERVAL_6_HS        7						//! 2^(7-1) uframes, 8 ms
+#define EP_IN_LENGTH_6_SPECTRUM	SPECTRUM_EP_SIZE
+#define EP_INTERVAL_6_SPECTRUM_FS	1					//! 1 ms
+#define EP_INTERVAL_6_SPECTRUM_HS	4					//! 2^(4-1) uframes, 1 ms
+
 
 // Audio Class V2.0 descriptor values
 
@@ -134,27 +164,34 @@
 // USB Endpoint 1 descriptor
 #define ENDPOINT_NB_1       ( UAC2_EP_AUDIO_IN | MSK_EP_DIR )
 #define EP_ATTRIBUTES_1		0b00100101         // ISOCHROUNOUS ASYNCHRONOUS IMPLICIT FEEDBACK
-//#define EP_IN_LENGTH_1_FS	294				// 3 bytes * 49 samples * stereo
-//#define EP_IN_LENGTH_1_HS	294
-#define EP_IN_LENGTH_1_FS	392				// 4 bytes * 49 samples * stereo
-#define EP_IN_LENGTH_1_HS	392
+#define EP_IN_LENGTH_1_FS	UAC2_EP_SIZE_FS		// 4 bytes * 49 samples * stereo, see uac2_audio_function.h
+#define EP_IN_LENGTH_1_HS	UAC2_EP_SIZE_HS
 #define EP_SIZE_1_FS		EP_IN_LENGTH_1_FS
 #define EP_SIZE_1_HS        EP_IN_LENGTH_1_HS
-#define EP_INTERVAL_1_FS	0x01			 // one packet per uframe, each uF 1ms, so only 48khz
-#define EP_INTERVAL_1_HS    0x02			 // One packet per 2 uframe, each uF 125us, so 192khz
+#define EP_NBTRANS_1_HS		UAC2_EP_TRANSACTIONS_HS	// transactions per microframe
+#define EP_MAX_PACKET_1_HS	UAC2_EP_MAX_PACKET_HS	// wMaxPacketSize with the additional transactions
+#define EP_INTERVAL_1_FS	UAC2_EP_INTERVAL_FS	 // one packet per uframe, each uF 1ms, so only 48khz
+#define EP_INTERVAL_1_HS    UAC2_EP_INTERVAL_HS	 // One packet per uframe, each uF 125us
+// the narrowband IQ alt setting, see uac2_audio_function.h, plain asynchronous:
+// its packets are paced by the decimated rate, no playback clock to follow
+#define EP_ATTRIBUTES_1_IQ	0b00000101			// ISOCHRONOUS ASYNC
+#define EP_SIZE_1_IQ_FS		UAC2_IQ_EP_SIZE_FS
+#define EP_SIZE_1_IQ_HS		UAC2_IQ_EP_SIZE_HS		// of one transaction
+#define EP_NBTRANS_1_IQ_HS	UAC2_IQ_EP_TRANSACTIONS_HS
+#define EP_MAX_PACKET_1_IQ_HS	UAC2_IQ_EP_MAX_PACKET_HS
 
 
 // USB Endpoint 2 descriptor
 #define ENDPOINT_NB_2       ( UAC2_EP_AUDIO_OUT )
 #define EP_ATTRIBUTES_2     0b00000101			// ISOCHRONOUS ASYNC
-//#define EP_OUT_LENGTH_2_HS  294				// 3 bytes * 49 samples * stereo
-//#define EP_OUT_LENGTH_2_FS	294
-#define EP_OUT_LENGTH_2_HS  392				// 4 bytes * 49 samples * stereo
-#define EP_OUT_LENGTH_2_FS	392
+#define EP_OUT_LENGTH_2_HS  UAC2_EP_SIZE_HS		// 4 bytes * 49 samples * stereo, see uac2_audio_function.h
+#define EP_OUT_LENGTH_2_FS	UAC2_EP_SIZE_FS
 #define EP_SIZE_2_FS		EP_OUT_LENGTH_2_FS
-#define EP_SIZE_2_HS        EP_OUT_LENGTH_2_HS
-#define EP_INTERVAL_2_FS	0x01			 // one packet per uframe
-#define EP_INTERVAL_2_HS    0x02			 // One packet per 2 uframe
+#define EP_SIZE_2_HS        EP_OUT_LENGTH_2_HS		// of one transaction
+#define EP_NBTRANS_2_HS		UAC2_EP_TRANSACTIONS_HS	// transactions per microframe
+#define EP_MAX_PACKET_2_HS	UAC2_EP_MAX_PACKET_HS	// wMaxPacketSize with the additional transactions
+#define EP_INTERVAL_2_FS	UAC2_EP_INTERVAL_FS	 // one packet per uframe
+#define EP_INTERVAL_2_HS    UAC2_EP_INTERVAL_HS	 // One packet per uframe, 384khz
 
 
 // USB Endpoint 3 descriptor
@@ -182,6 +219,9 @@
 #define CSD_ID_2						0x05
 #define CSD_ID_2_TYPE					0b00000001	// fixed freq internal clock
 #define CSD_ID_2_CONTROL				0b00000111	// freq r/w, validity r
+#define CSD_ID_IQ						0x07		// the narrowband IQ stream, the ADC clock decimated
+#define CSD_ID_IQ_TYPE					0b00000001	// fixed freq internal clock
+#define CSD_ID_IQ_CONTROL				0b00000111	// freq r/w, validity r
 
 // Clock Selector descriptor
 #define CSX_ID							0x06
@@ -195,7 +235,7 @@
 #define INPUT_TERMINAL_ID				0x01
 #define INPUT_TERMINAL_TYPE				0x0201 	// Terminal is microphone
 #define INPUT_TERMINAL_ASSOCIATION		0x00   	// No association
-#define INPUT_TERMINAL_NB_CHANNELS		0x02   	// Two channels for input terminal
+#define INPUT_TERMINAL_NB_CHANNELS		UAC2_NB_CHANNELS	// Two channels for input terminal
 #define INPUT_TERMINAL_CHANNEL_CONF		0x00000003 	// Two channels at front left and front right positions
 //#define INPUT_TERMINAL_CONTROLS			0x0040	// D7-6 Cluster control - readonly
 #define INPUT_TERMINAL_CONTROLS			0x0000	// none
@@ -217,11 +257,17 @@
 #define MIC_BMA_CONTROLS_CH_1		   0x00000003	//
 #define MIC_BMA_CONTROLS_CH_2		   0x00000003
 
+// IQ Input and Output Terminal, the record channels on CSD_ID_IQ
+#define IQ_INPUT_TERMINAL_ID			0x21
+#define IQ_INPUT_TERMINAL_TYPE			0x0710	// Radio receiver
+#define IQ_OUTPUT_TERMINAL_ID			0x23
+#define IQ_OUTPUT_TERMINAL_SOURCE_ID	IQ_INPUT_TERMINAL_ID
+
 // Speaker Input Terminal
 #define SPK_INPUT_TERMINAL_ID			0x11
 #define SPK_INPUT_TERMINAL_TYPE			0x0101	// USB Streaming
 #define SPK_INPUT_TERMINAL_ASSOCIATION	0x00	// No association
-#define SPK_INPUT_TERMINAL_NB_CHANNELS	0x02
+#define SPK_INPUT_TERMINAL_NB_CHANNELS	UAC2_NB_CHANNELS
 #define SPK_INPUT_TERMINAL_CHANNEL_CONF	0x0003	// left front and right front
 #define SPK_INPUT_TERMINAL_CH_NAME_ID	0x00	
 #define SPK_INPUT_TERMINAL_STRING_DESC	AIT_INDEX
@@ -241,7 +287,7 @@
 #define SPK_OUTPUT_TERMINAL_CONTROLS		0x0000	// no controls
 
 //Audio Streaming (AS) interface descriptor
-//#define STD_AS_INTERFACE_IN				0x03   // Index of Std AS Interface for Audio In
+#define STD_AS_INTERFACE_IN				0x03   // Index of Std AS Interface for Audio In
 #define STD_AS_INTERFACE_OUT			0x02   // Index of Std AS Interface for Audio Out
 
 #define DSC_INTERFACE_AS				STD_AS_INTERFACE_IN
@@ -278,13 +324,13 @@
 #define AS_FORMAT_TYPE						0x01		// PCM Format
 #define AS_FORMATS							0x00000001	// PCM only
 #define AS_CONTROLS							0b00000111	// active alt settings r/w, valid alt settings r
-#define AS_NB_CHANNELS						0x02
+#define AS_NB_CHANNELS						UAC2_NB_CHANNELS
 #define AS_CHAN_CONFIG						0x00000003	// L+R front
 
 // Format type for ALT1
 #define FORMAT_TYPE_1						0x01	// Format TypeI
-#define FORMAT_SUBSLOT_SIZE_1				0x04	// Number of bytes per subslot
-#define FORMAT_BIT_RESOLUTION_1				0x18	// 24 bits per sample
+#define FORMAT_SUBSLOT_SIZE_1				UAC2_SUBSLOT_SIZE	// Number of bytes per subslot
+#define FORMAT_BIT_RESOLUTION_1				UAC2_BIT_RESOLUTION	// 24 bits per sample
 
 //Audio endpoint specific descriptor field
 #define AUDIO_EP_ATRIBUTES				0b00000000	 	// No sampling freq, no pitch, no pading
@@ -296,72 +342,41 @@
 #define ALT1_AS_NB_ENDPOINT_OUT			0x02   // two EP,  OUT and OUT_FB
 #define AS_TERMINAL_LINK_OUT		    SPK_INPUT_TERMINAL_ID
 
-//! Usb Class-Specific AS Isochronous Feedback Endpoint Descriptors pp 4.10.2.2 (none)
+// feature_sync_implicit: the record stream is back, on the playback clock
+// CSD_ID_2, and the playback stream follows its packet sizes instead of
+// the OUT_FB endpoint, see packet_sizer.h
+#define ALT1_AS_NB_ENDPOINT_OUT_IMPLICIT	0x01   // OUT only
+#define MIC_CLOCK_ID_IMPLICIT			CSD_ID_2
+#define MIC_AS_CONTROLS					0b00000000	// no alt setting controls on the record interface
 
-typedef
-#if (defined __ICCAVR32__)
-#pragma pack(1)
-#endif
-struct
-#if (defined __GNUC__)
-__attribute__((__packed__))
-#endif
-{
-	S_usb_configuration_descriptor			cfg;
-	S_usb_interface_descriptor	 			ifc0;
-
-	//! Audio descriptors Class 2
-
-	S_usb_interface_association_descriptor	iad1;
-	S_usb_interface_descriptor				ifc1;
-	S_usb_ac_interface_descriptor_2			audioac;
-//	S_usb_clock_source_descriptor			audio_cs1;
-	S_usb_clock_source_descriptor			audio_cs2;
-//	S_usb_clock_selector_descriptor			audio_csel;
-	//			S_usb_clock_multiplier_descriptor		audio_cmul;
-/*
-	S_usb_in_ter_descriptor_2 				mic_in_ter;
-	S_usb_feature_unit_descriptor_2			mic_fea_unit;
-	S_usb_out_ter_descriptor_2				mic_out_ter;
-*/
-	S_usb_in_ter_descriptor_2				spk_in_ter;
-	S_usb_feature_unit_descriptor_2			spk_fea_unit;
-	S_usb_out_ter_descriptor_2				spk_out_ter;
-	S_usb_as_interface_descriptor	 		spk_as_alt0;
-	S_usb_as_interface_descriptor	 		spk_as_alt1;
-	S_usb_as_g_interface_descriptor_2		spk_g_as;
-	S_usb_format_type_2						spk_format_type;
-	S_usb_endpoint_audio_descriptor_2 		ep2;
-	S_usb_endpoint_audio_specific_2			ep2_s;
-	S_usb_endpoint_audio_descriptor_2 		ep3;
-
-	// BSB 20120720 Added
-	S_usb_interface_descriptor		ifc3;
-	S_usb_hid_descriptor           	hid;
-	S_usb_endpoint_descriptor      	ep4;
-	S_usb_endpoint_descriptor	   	ep5;
+// the narrowband IQ alt setting of the record interface, the same format
+// on its own terminal and clock CSD_ID_IQ, so the host runs it at the
+// decimated rate. Alt UAC2_IQ_ALT with feature_sync_implicit, the only
+// streaming alt of the record interface without
+#define IQ_AS_INTERFACE_INDEX			UAC2_IQ_ALT
+#define IQ_AS_INTERFACE_INDEX_EXPLICIT	ALT1_AS_INTERFACE_INDEX
+#define IQ_AS_TERMINAL_LINK				IQ_OUTPUT_TERMINAL_ID
 
+#define DSC_IQ_ALT						(FEATURE_SYNC_IMPLICIT ? IQ_AS_INTERFACE_INDEX : IQ_AS_INTERFACE_INDEX_EXPLICIT)
 
-/*
-	S_usb_as_interface_descriptor	 		mic_as_alt0;
-	S_usb_as_interface_descriptor	 		mic_as_alt1;
-	S_usb_as_g_interface_descriptor_2		mic_g_as;
-	S_usb_format_type_2						mic_format_type;
-	S_usb_endpoint_audio_descriptor_2 		ep1;
-	S_usb_endpoint_audio_specific_2			ep1_s;
-*/
-}
-#if (defined __ICCAVR32__)
-#pragma pack()
-#endif
-S_usb_user_configuration_descriptor;
+//! Usb Class-Specific AS Isochronous Feedback Endpoint Descriptors pp 4.10.2.2 (none)
+
+//! The configuration descriptor, S_usb_user_configuration_descriptor of
+//! feature_sync_explicit and S_usb_user_configuration_descriptor_implicit
+//! of feature_sync_implicit, from the one struct of uac2_usb_conf_desc.h
+#define UAC2_CONF_IMPLICIT	0
+#include "uac2_usb_conf_desc.h"
+#define UAC2_CONF_IMPLICIT	1
+#include "uac2_usb_conf_desc.h"
 
 extern const S_usb_device_descriptor uac2_dg8saq_usb_dev_desc;
 extern const S_usb_device_descriptor uac2_audio_usb_dev_desc;
 extern const S_usb_user_configuration_descriptor uac2_usb_conf_desc_fs;
+extern const S_usb_user_configuration_descriptor_implicit uac2_usb_conf_desc_implicit_fs;
 
 #if USB_HIGH_SPEED_SUPPORT==ENABLED
 	extern const S_usb_user_configuration_descriptor uac2_usb_conf_desc_hs;
+	extern const S_usb_user_configuration_descriptor_implicit uac2_usb_conf_desc_implicit_hs;
 	extern const S_usb_device_qualifier_descriptor uac2_usb_qualifier_desc;
 #endif
 
@@ -78,6 +78,7 @@
 #include "usb_drv.h"
 #include "usb_descriptors.h"
 #include "uac2_usb_descriptors.h"
+#include "uac2_audio_function.h"
 #include "usb_standard_request.h"
 #include "usb_specific_request.h"
 #include "usart.h"
@@ -89,6 +90,9 @@
 #include "device_audio_task.h"
 #include "uac2_device_audio_task.h"
 #include "taskAK5394A.h"
+#include "eventlog.h"
+#include "stream_health.h"
+#include "spectrum.h"
 
 
 //_____ M A C R O S ________________________________________________________
@@ -100,81 +104,41 @@
 //_____ P R I V A T E   D E C L A R A T I O N S ____________________________
 
 
-static U8    wValue_msb;
-static U8    wValue_lsb;
-static U16   wIndex;
-static U16   wLength;
-
 Bool Mic_freq_valid = FALSE;
 S_freq Mic_freq;
 
-extern const    void *pbuffer;
-extern          U16   data_to_transfer;
-
-
-const U8 Speedx_1[26] = {
-0x02,0x00,				//number of sample rate triplets
-
-0x44,0xac,0x00,0x00,	//44.1k Min
-0x10,0xb1,0x02,0x00,	//176.4k Max
-0x44,0xac,0x00,0x00,	//44.1k Res
-
-0x80,0xbb,0x00,0x00,	//48k Min
-0x00,0xee,0x02,0x00,	//192k Max
-0x80,0xbb,0x00,0x00,	//48k Res
-};
-
-/*
-const U8 Speedx_1[62] = {
-0x05,0x00,				//number of sample rate triplets
-						// EP0 limit of 64 bytes so max of 5 triplets
-0x44,0xac,0x00,0x00,	//44.1k Min
-0x44,0xac,0x00,0x00,	//44.1k Max
-0x00,0x00,0x00,0x00,	// 0 Res
-
-0x80,0xbb,0x00,0x00,	//48k Min
-0x80,0xbb,0x00,0x00,	//48k Max
-0x00,0x00,0x00,0x00,	// 0 Res
-
-0x88,0x58,0x01,0x00,	//88.2k Min
-0x88,0x58,0x01,0x00,	//88.2k Max
-0x00,0x00,0x00,0x00,	// 0 Res
-
-0x00,0x77,0x01,0x00,	//96k Min
-0x00,0x77,0x01,0x00,	//96k Max
-0x00,0x00,0x00,0x00,	// 0 Res
-
-0x00,0xee,0x02,0x00,	//192k Min
-0x00,0xee,0x02,0x00,	//192k Max
-0x00,0x00,0x00,0x00		// 0 Res
-};
-*/
-
-const U8 Speedx_2[38] = {
-0x03,0x00,				//number of sample rate triplets
-
-0x80,0xbb,0x00,0x00,	//48k Min
-0x80,0xbb,0x00,0x00,	//48k Max
-0x00,0x00,0x00,0x00,	// 0 Res
-
-0x00,0x77,0x01,0x00,	//96k Min
-0x00,0x77,0x01,0x00,	//96k Max
-0x00,0x00,0x00,0x00,	// 0 Res
-
-0x00,0xee,0x02,0x00,	//192k Min
-0x00,0xee,0x02,0x00,	//192k Max
-0x00,0x00,0x00,0x00		// 0 Res
-};
 
+//_____ D E C L A R A T I O N S ____________________________________________
 
 
-//_____ D E C L A R A T I O N S ____________________________________________
+//
+// GCLK1 is the bit clock, 64 times the rate, OSC1 divided down from
+// UAC2_RATE_MAX_CLOCK or its 44.1 khz counterpart, the MUX swaps the
+// oscillator. A rate above what OSC1 gives gets it undivided.
+//
+static void uac2_gclk1_setup(U32 frequency) {
+	U32 ratio;
 
+	if (frequency % 11025 == 0)
+		ratio = (UAC2_RATE_MAX_CLOCK / 48000 * 44100) / frequency;
+	else
+		ratio = UAC2_RATE_MAX_CLOCK / frequency;
+
+	pm_gc_disable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+	pm_gc_setup(&AVR32_PM, AVR32_PM_GCLK_GCLK1, // gc
+				0,                  // osc_or_pll: use Osc (if 0) or PLL (if 1)
+				1,                  // pll_osc: select Osc0/PLL0 or Osc1/PLL1
+				ratio > 1,          // diven
+				ratio > 1 ? ratio / 2 - 1 : 0);	// divided by 2 * (div + 1)
+	pm_gc_enable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+}
 
-void uac2_freq_change_handler() {
+void uac2_freq_change_handler(void) {
 		int i;
 
 		if (freq_changed) {
+			eventlog_put(ev_rate_change, current_freq.frequency, 0, 0);
+			STREAM_HEALTH_COUNT(sh_rate_change);
 			spk_mute = TRUE;						// mute speaker while changing frequency and oscillator
 			for (i = 0; i < SPK_BUFFER_SIZE; i++) {	// clears speaker buffer
 				spk_buffer_0[i] = 0;
@@ -201,13 +165,7 @@ void uac2_freq_change_handler() {
 					gpio_clr_gpio_pin(AK5394_DFS1);
 				}
 
-				pm_gc_disable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
-				pm_gc_setup(&AVR32_PM, AVR32_PM_GCLK_GCLK1, // gc
-							0,                  // osc_or_pll: use Osc (if 0) or PLL (if 1)
-							1,                  // pll_osc: select Osc0/PLL0 or Osc1/PLL1
-							1,                  // diven - enabled
-							0);                 // divided by 2.  Therefore GCLK1 = 6.144Mhz
-				pm_gc_enable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+				uac2_gclk1_setup(current_freq.frequency);
 
 /*
 				if (FEATURE_LINUX_QUIRK_ON)
@@ -235,13 +193,7 @@ void uac2_freq_change_handler() {
 					gpio_clr_gpio_pin(AK5394_DFS1);
 				}
 
-				pm_gc_disable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
-				pm_gc_setup(&AVR32_PM, AVR32_PM_GCLK_GCLK1, // gc
-								  0,                  // osc_or_pll: use Osc (if 0) or PLL (if 1)
-								  1,                  // pll_osc: select Osc0/PLL0 or Osc1/PLL1
-								  1,                  // diven - enabled
-								  0);                 // divided by 2.  Therefore GCLK1 = 6.144Mhz
-				pm_gc_enable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+				uac2_gclk1_setup(current_freq.frequency);
 
 /*
 				if (FEATURE_LINUX_QUIRK_ON)
@@ -268,13 +220,7 @@ void uac2_freq_change_handler() {
 	    			gpio_clr_gpio_pin(AK5394_DFS0);		// H L -> 192khz
 	    			gpio_set_gpio_pin(AK5394_DFS1);
 
-	    			pm_gc_disable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
-	    			pm_gc_setup(&AVR32_PM, AVR32_PM_GCLK_GCLK1, // gc
-	    								  0,                  // osc_or_pll: use Osc (if 0) or PLL (if 1)
-	    								  1,                  // pll_osc: select Osc0/PLL0 or Osc1/PLL1
-	    								  0,                  // diven - disabled
-	    								  0);                 // GCLK1 = 12.288Mhz
-	    			pm_gc_enable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+	    			uac2_gclk1_setup(current_freq.frequency);
 
 	    			FB_rate = (176 << 14) + ((1<<14)*4) / 10;
 
@@ -296,19 +242,42 @@ void uac2_freq_change_handler() {
 					gpio_set_gpio_pin(AK5394_DFS1);
 				}
 
-				pm_gc_disable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
-				pm_gc_setup(&AVR32_PM, AVR32_PM_GCLK_GCLK1, // gc
-							0,                  // osc_or_pll: use Osc (if 0) or PLL (if 1)
-							1,                  // pll_osc: select Osc0/PLL0 or Osc1/PLL1
-							0,                  // diven - disabled
-							0);                 // GCLK1 = 12.288Mhz
-				pm_gc_enable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+				uac2_gclk1_setup(current_freq.frequency);
 
 				FB_rate = (192) << 14;
 
     			gpio_clr_gpio_pin(SAMPLEFREQ_VAL0);
     			gpio_set_gpio_pin(SAMPLEFREQ_VAL1);
 
+			} else if (current_freq.frequency == 352800 || current_freq.frequency == 384000) {
+				// only in the RANGE reply when OSC1 makes the bit clock, see uac2_audio_function.h
+				pdca_disable_interrupt_reload_counter_zero(PDCA_CHANNEL_SSC_RX);
+				pdca_disable(PDCA_CHANNEL_SSC_RX);
+
+				if (current_freq.frequency == 384000) {
+					if (FEATURE_BOARD_USBI2S)
+						gpio_set_gpio_pin(AVR32_PIN_PX16); // MUX in the 24.576MHz family
+					else if (FEATURE_BOARD_USBDAC)
+						gpio_set_gpio_pin(AVR32_PIN_PX51);
+					FB_rate = (384) << 14;
+				} else {
+					if (FEATURE_BOARD_USBI2S)
+						gpio_clr_gpio_pin(AVR32_PIN_PX16); // MUX in the 22.5792MHz family
+					else if (FEATURE_BOARD_USBDAC)
+						gpio_clr_gpio_pin(AVR32_PIN_PX51);
+					FB_rate = (352 << 14) + ((1<<14)*8) / 10;
+				}
+
+				if ( FEATURE_ADC_AK5394A ) {
+					gpio_clr_gpio_pin(AK5394_DFS0);		// H L -> 192khz, the ADC goes no higher
+					gpio_set_gpio_pin(AK5394_DFS1);
+				}
+
+				uac2_gclk1_setup(current_freq.frequency);
+
+    			gpio_set_gpio_pin(SAMPLEFREQ_VAL0);
+    			gpio_set_gpio_pin(SAMPLEFREQ_VAL1);
+
 			} else if (current_freq.frequency == 48000) {
 				// if there are two XO, PX16 sets the 48x
 				// gpio_set_gpio_pin(AVR32_PIN_PX16);
@@ -325,13 +294,7 @@ void uac2_freq_change_handler() {
 					gpio_clr_gpio_pin(AK5394_DFS1);
 				}
 
-				pm_gc_disable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
-				pm_gc_setup(&AVR32_PM, AVR32_PM_GCLK_GCLK1, // gc
-							0,                  // osc_or_pll: use Osc (if 0) or PLL (if 1)
-							1,                  // pll_osc: select Osc0/PLL0 or Osc1/PLL1
-							1,                  // diven - enabled
-							1);                 // divided by 4.  Therefore GCLK1 = 3.072Mhz
-				pm_gc_enable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+				uac2_gclk1_setup(current_freq.frequency);
 
 				FB_rate = (48) << 14;
 
@@ -355,13 +318,7 @@ void uac2_freq_change_handler() {
 					gpio_clr_gpio_pin(AK5394_DFS1);
 				}
 
-				pm_gc_disable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
-				pm_gc_setup(&AVR32_PM, AVR32_PM_GCLK_GCLK1, // gc
-							0,                  // osc_or_pll: use Osc (if 0) or PLL (if 1)
-							1,                  // pll_osc: select Osc0/PLL0 or Osc1/PLL1
-							1,                  // diven - enabled
-							1);                 // divided by 4.  Therefore GCLK1 = 3.072Mhz
-				pm_gc_enable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+				uac2_gclk1_setup(current_freq.frequency);
 
 				FB_rate = (44 << 14) + (1 << 14)/10;
 
@@ -401,22 +358,35 @@ void uac2_freq_change_handler() {
 //!
 void uac2_user_endpoint_init(U8 conf_nb)
 {
+	spectrum_alternate_setting = 0;		// telemetry records until the host asks for spectrum frames
 	if( Is_usb_full_speed_mode() ) {
-		(void)Usb_configure_endpoint(UAC2_EP_AUDIO_OUT_FB, EP_ATTRIBUTES_3, DIRECTION_IN, EP_SIZE_3_FS, DOUBLE_BANK, 0);
+		// feature_sync_implicit: the full rate record endpoint in place of the
+		// feedback endpoint, else the feedback and the narrowband IQ one
+		if (FEATURE_SYNC_IMPLICIT)
+			(void)Usb_configure_endpoint(UAC2_EP_AUDIO_IN, EP_ATTRIBUTES_1, DIRECTION_IN, EP_SIZE_1_FS, DOUBLE_BANK, 0);
+		else {
+			(void)Usb_configure_endpoint(UAC2_EP_AUDIO_OUT_FB, EP_ATTRIBUTES_3, DIRECTION_IN, EP_SIZE_3_FS, DOUBLE_BANK, 0);
+			(void)Usb_configure_endpoint(UAC2_EP_AUDIO_IN, EP_ATTRIBUTES_1_IQ, DIRECTION_IN, EP_SIZE_1_IQ_FS, DOUBLE_BANK, 0);
+		}
 		(void)Usb_configure_endpoint(UAC2_EP_AUDIO_OUT, EP_ATTRIBUTES_2, DIRECTION_OUT, EP_SIZE_2_FS, DOUBLE_BANK, 0);
-		//(void)Usb_configure_endpoint(UAC2_EP_AUDIO_IN, EP_ATTRIBUTES_1, DIRECTION_IN, EP_SIZE_1_FS, DOUBLE_BANK, 0);
 		// BSB 20120720 HID insert attempt begin
 		(void)Usb_configure_endpoint(UAC2_EP_HID_TX, EP_ATTRIBUTES_4, DIRECTION_IN, EP_SIZE_4_FS, SINGLE_BANK, 0);
 		(void)Usb_configure_endpoint(UAC2_EP_HID_RX, EP_ATTRIBUTES_5, DIRECTION_OUT, EP_SIZE_5_FS, SINGLE_BANK, 0);
 		// BSB 20120720 HID insert attempt end
+		(void)Usb_configure_endpoint(UAC2_EP_TELEMETRY, EP_ATTRIBUTES_6, DIRECTION_IN, EP_SIZE_6_FS, SINGLE_BANK, 0);
 	} else {
-		(void)Usb_configure_endpoint(UAC2_EP_AUDIO_OUT_FB, EP_ATTRIBUTES_3, DIRECTION_IN, EP_SIZE_3_HS, DOUBLE_BANK, 0);
-		(void)Usb_configure_endpoint(UAC2_EP_AUDIO_OUT, EP_ATTRIBUTES_2, DIRECTION_OUT, EP_SIZE_2_HS, DOUBLE_BANK, 0);
-		//(void)Usb_configure_endpoint(UAC2_EP_AUDIO_IN, EP_ATTRIBUTES_1, DIRECTION_IN, EP_SIZE_1_HS, DOUBLE_BANK, 0);
+		if (FEATURE_SYNC_IMPLICIT)
+			(void)Usb_configure_endpoint(UAC2_EP_AUDIO_IN, EP_ATTRIBUTES_1, DIRECTION_IN, EP_SIZE_1_HS, DOUBLE_BANK, EP_NBTRANS_1_HS);
+		else {
+			(void)Usb_configure_endpoint(UAC2_EP_AUDIO_OUT_FB, EP_ATTRIBUTES_3, DIRECTION_IN, EP_SIZE_3_HS, DOUBLE_BANK, 0);
+			(void)Usb_configure_endpoint(UAC2_EP_AUDIO_IN, EP_ATTRIBUTES_1_IQ, DIRECTION_IN, EP_SIZE_1_IQ_HS, DOUBLE_BANK, EP_NBTRANS_1_IQ_HS);
+		}
+		(void)Usb_configure_endpoint(UAC2_EP_AUDIO_OUT, EP_ATTRIBUTES_2, DIRECTION_OUT, EP_SIZE_2_HS, DOUBLE_BANK, EP_NBTRANS_2_HS);
 		// BSB 20120720 HID insert attempt begin
 		(void)Usb_configure_endpoint(UAC2_EP_HID_TX, EP_ATTRIBUTES_4, DIRECTION_IN, EP_SIZE_4_HS, SINGLE_BANK, 0);
 		(void)Usb_configure_endpoint(UAC2_EP_HID_RX, EP_ATTRIBUTES_5, DIRECTION_OUT, EP_SIZE_5_HS, SINGLE_BANK, 0);
 		// BSB 20120720 HID insert attempt end
+		(void)Usb_configure_endpoint(UAC2_EP_TELEMETRY, EP_ATTRIBUTES_6, DIRECTION_IN, EP_SIZE_6_HS, SINGLE_BANK, 0);
 	}
 }
 
@@ -426,750 +396,131 @@ void uac2_user_endpoint_init(U8 conf_nb)
 void uac2_user_set_interface(U8 wIndex, U8 wValue) {
    //* Check whether it is the audio streaming interface and Alternate Setting that is being set
    usb_interface_nb = wIndex;
-//   if (usb_interface_nb == STD_AS_INTERFACE_IN) {
-//	   usb_alternate_setting = wValue;
-//	   usb_alternate_setting_changed = TRUE;
-//   } else if (usb_interface_nb == STD_AS_INTERFACE_OUT) {
-	if (usb_interface_nb == STD_AS_INTERFACE_OUT) {
+	if (usb_interface_nb == STD_AS_INTERFACE_IN) {
+	   usb_alternate_setting = wValue;
+	   usb_alternate_setting_changed = TRUE;
+	} else if (usb_interface_nb == STD_AS_INTERFACE_OUT) {
 	   usb_alternate_setting_out = wValue;
 	   usb_alternate_setting_out_changed = TRUE;
+	} else if (usb_interface_nb == DSC_INTERFACE_TELEMETRY) {
+	   spectrum_alternate_setting = wValue;
    }
 
 }
 
 // BSB 20120720 copy from uac1_usb_specific_request.c insert
 
-static Bool uac2_user_get_interface_descriptor() {
-	Bool    zlp;
-	U16     wLength;
-	U16		wIndex;
-	U8      descriptor_type;
-	U8      string_type;
-	U16		wInterface;
-
-//	print_dbg_char_char('a'); // BSB debug 20120803
-
-	zlp             = FALSE;                                  /* no zero length packet */
-	string_type     = Usb_read_endpoint_data(EP_CONTROL, 8);  /* read LSB of wValue    */
-	descriptor_type = Usb_read_endpoint_data(EP_CONTROL, 8);  /* read MSB of wValue    */
-	wInterface = usb_format_usb_to_mcu_data(16,Usb_read_endpoint_data(EP_CONTROL, 16));
-	switch( descriptor_type ) {
-	case HID_DESCRIPTOR:
+//! The report data of a HID SET_REPORT arrived, it was received in place.
+//!
+static Bool uac2_user_hid_report_received(const S_usb_setup_data *setup, U8 *data, U16 length)
+{
+	return TRUE;
+}
 
-//		print_dbg_char_char('b'); // BSB debug 20120803
+//! @brief This function is the handler of the HID interface requests,
+//! registered with usb_ctrl_register(). It returns FALSE for requests to
+//! the other interfaces and the HID requests it does not decode, which
+//! then go to uac2_user_audio_request().
+//!
+Bool uac2_user_hid_request(const S_usb_setup_data *setup)
+{
+	U8 report_type = MSB(setup->wValue);
 
-		if (wInterface == DSC_INTERFACE_HID) {
+	if (setup->bmRequestType == IN_INTERFACE && setup->bRequest == GET_DESCRIPTOR) {
+		switch (MSB(setup->wValue)) {
+		case HID_DESCRIPTOR:
+			if (setup->wIndex != DSC_INTERFACE_HID)
+				return TRUE;	// stalled
 #if (USB_HIGH_SPEED_SUPPORT==DISABLED)
-
-			// print_dbg_char_char('c'); // BSB debug 20120803
-
-			data_to_transfer = sizeof(uac2_usb_conf_desc_fs.hid);
-			pbuffer          = (const U8*)&uac2_usb_conf_desc_fs.hid;
-			break;
+			usb_ctrl_send(&uac2_usb_conf_desc_fs.hid, sizeof(uac2_usb_conf_desc_fs.hid));
 #else
-
-			// print_dbg_char_char('d'); // BSB debug 20120803
-
-			if( Is_usb_full_speed_mode() ) {
-				data_to_transfer = sizeof(uac2_usb_conf_desc_fs.hid);
-				pbuffer          = (const U8*)&uac2_usb_conf_desc_fs.hid;
-			} else {
-				data_to_transfer = sizeof(uac2_usb_conf_desc_hs.hid);
-				pbuffer          = (const U8*)&uac2_usb_conf_desc_hs.hid;
-			}
-			break;
+			if( Is_usb_full_speed_mode() )
+				usb_ctrl_send(&uac2_usb_conf_desc_fs.hid, sizeof(uac2_usb_conf_desc_fs.hid));
+			else
+				usb_ctrl_send(&uac2_usb_conf_desc_hs.hid, sizeof(uac2_usb_conf_desc_hs.hid));
 #endif
-		}
-		return FALSE;
-	case HID_REPORT_DESCRIPTOR:
-
-		// print_dbg_char_char('e'); // BSB debug 20120803
+			return TRUE;
 
-		//? Why doesn't this test for wInterface == DSC_INTERFACE_HID ?
-		data_to_transfer = sizeof(usb_hid_report_descriptor);
-		pbuffer          = usb_hid_report_descriptor;
-		break;
-	case HID_PHYSICAL_DESCRIPTOR:
+		case HID_REPORT_DESCRIPTOR:
+			//? Why doesn't this test for wInterface == DSC_INTERFACE_HID ?
+			usb_ctrl_send(usb_hid_report_descriptor, sizeof(usb_hid_report_descriptor));
+			return TRUE;
 
-		// print_dbg_char_char('f'); // BSB debug 20120803
+		case HID_PHYSICAL_DESCRIPTOR:
+			// TODO
+		default:
+			return TRUE;	// stalled
+		}
+	}
 
-		// TODO
+	if (setup->wIndex != DSC_INTERFACE_HID)
 		return FALSE;
-	default:
-
-		// print_dbg_char_char('g'); // BSB debug 20120803
 
-		return FALSE;
-	}
+	if (setup->bmRequestType == OUT_CL_INTERFACE) { // USB_SETUP_SET_CLASS_INTER
+		switch (setup->bRequest) {
+		case HID_SET_REPORT:
+			// The MSB wValue field specifies the Report Type
+			// The LSB wValue field specifies the Report ID
+			switch (report_type) {
+			case HID_REPORT_OUTPUT:
+				usb_ctrl_receive(usb_report, 2, uac2_user_hid_report_received);
+				return TRUE;
+
+			case HID_REPORT_FEATURE:
+				usb_ctrl_receive(usb_feature_report, 2, uac2_user_hid_report_received);
+				return TRUE;
+
+			case HID_REPORT_INPUT:
+				// TODO
+			default:
+				break;
+			}
+			break;
 
-	wIndex = Usb_read_endpoint_data(EP_CONTROL, 16);
-	wIndex = usb_format_usb_to_mcu_data(16, wIndex);
-	wLength = Usb_read_endpoint_data(EP_CONTROL, 16);
-	wLength = usb_format_usb_to_mcu_data(16, wLength);
-	Usb_ack_setup_received_free();                          //!< clear the setup received flag
+		case HID_SET_IDLE:
+			// When the upper byte of wValue is 0 (zero), the duration is indefinite
+			// else from 0.004 to 1.020 seconds
+			g_u8_report_rate = report_type;
+			usb_ctrl_ack();
+			return TRUE;
 
-	if (wLength > data_to_transfer)
-		{
-			zlp = !(data_to_transfer % EP_CONTROL_LENGTH);  //!< zero length packet condition
-		}
-	else
-		{
-			data_to_transfer = wLength; //!< send only requested number of data bytes
+		case HID_SET_PROTOCOL:
+			// TODO
+			break;
 		}
+	}
 
-	Usb_ack_nak_out(EP_CONTROL);
-
-	while (data_to_transfer && (!Is_usb_nak_out(EP_CONTROL)))
-		{
-			while( !Is_usb_control_in_ready() && !Is_usb_nak_out(EP_CONTROL) );
+	if (setup->bmRequestType == IN_CL_INTERFACE) { // USB_SETUP_GET_CLASS_INTER
+		switch (setup->bRequest) {
+		case HID_GET_REPORT:
+			switch (report_type) {
+			case HID_REPORT_INPUT:
+				usb_ctrl_send(usb_report, 2);
+				return TRUE;
 
-			if( Is_usb_nak_out(EP_CONTROL) )
-				break;    // don't clear the flag now, it will be cleared after
+			case HID_REPORT_FEATURE:
+				usb_ctrl_send(usb_feature_report, 2);
+				return TRUE;
 
-			Usb_reset_endpoint_fifo_access(EP_CONTROL);
-			data_to_transfer = usb_write_ep_txpacket(EP_CONTROL, pbuffer,
-													 data_to_transfer, &pbuffer);
-			if( Is_usb_nak_out(EP_CONTROL) )
+			case HID_REPORT_OUTPUT:
+			default:
 				break;
-			else
-				Usb_ack_control_in_ready_send();  //!< Send data until necessary
-		}
-
-	if ( zlp && (!Is_usb_nak_out(EP_CONTROL)) )
-		{
-			while (!Is_usb_control_in_ready());
-			Usb_ack_control_in_ready_send();
-		}
-
-	while (!(Is_usb_nak_out(EP_CONTROL)));
-	Usb_ack_nak_out(EP_CONTROL);
-	while (!Is_usb_control_out_received());
-	Usb_ack_control_out_received_free();
-
-	// print_dbg_char_char('h'); // BSB debug 20120803
-
-	return TRUE;
-}
-
-//! @brief This function manages hid set idle request.
-//!
-//! @param Duration     When the upper byte of wValue is 0 (zero), the duration is indefinite else from 0.004 to 1.020 seconds
-//! @param Report ID    0 the idle rate applies to all input reports, else only applies to the Report ID
-//!
-void uac2_usb_hid_set_idle (U8 u8_report_id, U8 u8_duration ) // BSB 20120710 prefix "uac2_" added
-{
-   Usb_ack_setup_received_free();
-
-   if( wIndex == DSC_INTERFACE_HID )
-     g_u8_report_rate = u8_duration;
-
-   Usb_ack_control_in_ready_send();
-   while (!Is_usb_control_in_ready());
-}
-
+			}
+			break;
 
-//! @brief This function manages hid get idle request.
-//!
-//! @param Report ID    0 the idle rate applies to all input reports, else only applies to the Report ID
-//!
-void uac2_usb_hid_get_idle (U8 u8_report_id)  // BSB 20120710 prefix "uac2_" added
-{
-	Usb_ack_setup_received_free();
+		case HID_GET_IDLE:
+			usb_ctrl_send(&g_u8_report_rate, 1);
+			return TRUE;
 
-   if( (wLength != 0) && (wIndex == DSC_INTERFACE_HID) )
-   {
-      Usb_write_endpoint_data(EP_CONTROL, 8, g_u8_report_rate);
-      Usb_ack_control_in_ready_send();
-   }
+		case HID_GET_PROTOCOL:
+			// TODO
+			break;
+		}
+	}
 
-   while (!Is_usb_control_out_received());
-   Usb_ack_control_out_received_free();
+	return FALSE;
 }
 
 // BSB 20120720 copy from uac2_usb_specific_request.c end
 
-//! This function is called by the standard USB read request function when
-//! the USB request is not supported. This function returns TRUE when the
-//! request is processed. This function returns FALSE if the request is not
-//! supported. In this case, a STALL handshake will be automatically
-//! sent by the standard USB read request function.
-//!
-Bool uac2_user_read_request(U8 type, U8 request)
-{   int i;
-
-
-	// BSB 20120720 added
-	// this should vector to specified interface handler
-	if (type == IN_INTERFACE && request == GET_DESCRIPTOR) return uac2_user_get_interface_descriptor();
-
-	// Read wValue
-	// why are these file statics?
-	wValue_lsb = Usb_read_endpoint_data(EP_CONTROL, 8);
-	wValue_msb = Usb_read_endpoint_data(EP_CONTROL, 8);
-	wIndex = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-	wLength = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-
-	// BSB 20120720 copy from uac1_usb_specific_request begin
-
-	//** Specific request from Class HID
-	// this should vector to specified interface handler
-	if( wIndex == DSC_INTERFACE_HID )   // Interface number of HID
-		{
-
-			if( type == OUT_CL_INTERFACE ) // USB_SETUP_SET_CLASS_INTER
-				{
-					switch( request )
-						{
-
-						case HID_SET_REPORT:
-							// The MSB wValue field specifies the Report Type
-							// The LSB wValue field specifies the Report ID
-							switch (wValue_msb)
-								{
-								case HID_REPORT_INPUT:
-									// TODO
-									break;
-
-								case HID_REPORT_OUTPUT:
-									Usb_ack_setup_received_free();
-									while (!Is_usb_control_out_received());
-									Usb_reset_endpoint_fifo_access(EP_CONTROL);
-									usb_report[0] = Usb_read_endpoint_data(EP_CONTROL, 8);
-									usb_report[1] = Usb_read_endpoint_data(EP_CONTROL, 8);
-									Usb_ack_control_out_received_free();
-									Usb_ack_control_in_ready_send();
-									while (!Is_usb_control_in_ready());
-									return TRUE;
-
-								case HID_REPORT_FEATURE:
-									Usb_ack_setup_received_free();
-									while (!Is_usb_control_out_received());
-									Usb_reset_endpoint_fifo_access(EP_CONTROL);
-									usb_feature_report[0] = Usb_read_endpoint_data(EP_CONTROL, 8);
-									usb_feature_report[1] = Usb_read_endpoint_data(EP_CONTROL, 8);
-									Usb_ack_control_out_received_free();
-									Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-									while (!Is_usb_control_in_ready()); //!< waits for status phase done
-									return TRUE;
-
-								}
-							break;
-
-						case HID_SET_IDLE:
-							uac2_usb_hid_set_idle(wValue_lsb, wValue_msb); // BSB 20120710 prefix "uac2_" added
-							return TRUE;
-
-						case HID_SET_PROTOCOL:
-							// TODO
-							break;
-						}
-				}
-			if( type == IN_CL_INTERFACE) // USB_SETUP_GET_CLASS_INTER
-				{
-					switch( request )
-						{
-						case HID_GET_REPORT:
-							switch (wValue_msb)
-								{
-								case HID_REPORT_INPUT:
-									Usb_ack_setup_received_free();
-
-									Usb_reset_endpoint_fifo_access(EP_CONTROL);
-									Usb_write_endpoint_data(EP_CONTROL, 8, usb_report[0]);
-									Usb_write_endpoint_data(EP_CONTROL, 8, usb_report[1]);
-									Usb_ack_control_in_ready_send();
-
-									while (!Is_usb_control_out_received());
-									Usb_ack_control_out_received_free();
-									return TRUE;
-
-								case HID_REPORT_OUTPUT:
-									break;
-
-								case HID_REPORT_FEATURE:
-									Usb_ack_setup_received_free();
-
-									Usb_reset_endpoint_fifo_access(EP_CONTROL);
-									Usb_write_endpoint_data(EP_CONTROL, 8, usb_feature_report[0]);
-									Usb_write_endpoint_data(EP_CONTROL, 8, usb_feature_report[1]);
-									Usb_ack_control_in_ready_send();
-
-									while (!Is_usb_control_out_received());
-									Usb_ack_control_out_received_free();
-									return TRUE;
-								}
-							break;
-						case HID_GET_IDLE:
-							uac2_usb_hid_get_idle(wValue_lsb); // BSB 20120710 prefix "uac2_" added
-							return TRUE;
-						case HID_GET_PROTOCOL:
-							// TODO
-							break;
-						}
-				}
-		}  // if wIndex ==  HID Interface
-
-	// BSB 20120720 copy from uac1_usb_specific_request end
-
-
-
-	if (type == IN_CL_INTERFACE || type == OUT_CL_INTERFACE) {    // process Class Specific Interface
-
-		//  request for AUDIO interfaces
-
-/*
-		if (wIndex == DSC_INTERFACE_AS) {				// Audio Streaming Interface
-			if (type == IN_CL_INTERFACE) {			// get controls
-
-				if (wValue_msb == AUDIO_AS_VAL_ALT_SETTINGS && wValue_lsb == 0
-					&& request == AUDIO_CS_REQUEST_CUR) {
-					Usb_ack_setup_received_free();
-
-					Usb_reset_endpoint_fifo_access(EP_CONTROL);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x01);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0b00000011); // alt 0 and 1 valid
-					Usb_ack_control_in_ready_send();
-
-					while (!Is_usb_control_out_received());
-					Usb_ack_control_out_received_free();
-					return TRUE;
-				} else if (wValue_msb == AUDIO_AS_ACT_ALT_SETTINGS && wValue_lsb == 0
- 						   && request == AUDIO_CS_REQUEST_CUR) {
-					Usb_ack_setup_received_free();
-					Usb_reset_endpoint_fifo_access(EP_CONTROL);
-					Usb_write_endpoint_data(EP_CONTROL, 8, usb_alternate_setting);
-					Usb_ack_control_in_ready_send();
-					while (!Is_usb_control_out_received());
-					Usb_ack_control_out_received_free();
-					return TRUE;
-				} else if (wValue_msb == AUDIO_AS_AUDIO_DATA_FORMAT && wValue_lsb == 0
- 						   && request == AUDIO_CS_REQUEST_CUR) {
-					Usb_ack_setup_received_free();
-					Usb_reset_endpoint_fifo_access(EP_CONTROL);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x01);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);	// only PCM format
-					Usb_ack_control_in_ready_send();
-					while (!Is_usb_control_out_received());
-					Usb_ack_control_out_received_free();
-					return TRUE;
-				} else return FALSE;
-
-			} else if (type == OUT_CL_INTERFACE) {		// set controls
-				if (wValue_msb == AUDIO_AS_ACT_ALT_SETTINGS
-					&& request == AUDIO_CS_REQUEST_CUR) {
-					Usb_ack_setup_received_free();
-					while (!Is_usb_control_out_received());
-					Usb_reset_endpoint_fifo_access(EP_CONTROL);
-					usb_alternate_setting = Usb_read_endpoint_data(EP_CONTROL, 8);
-					usb_alternate_setting_changed = TRUE;
-					Usb_ack_control_out_received_free();
-					Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-					while (!Is_usb_control_in_ready()); //!< waits for status phase done
-					return FALSE;
-				}
-			} // end OUT_CL_INTERFACE
-		} // end DSC_INTERFACE_AS
-*/
-
-
-		if (wIndex == DSC_INTERFACE_AS_OUT) {				// Playback Audio Streaming Interface
-
-			if (type == IN_CL_INTERFACE) {			// get controls
-
-				if (wValue_msb == AUDIO_AS_VAL_ALT_SETTINGS && wValue_lsb == 0
-					&& request == AUDIO_CS_REQUEST_CUR) {
-					Usb_ack_setup_received_free();
-
-					Usb_reset_endpoint_fifo_access(EP_CONTROL);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x01);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0b00000011); // alt 0 and 1 valid
-					Usb_ack_control_in_ready_send();
-
-					while (!Is_usb_control_out_received());
-					Usb_ack_control_out_received_free();
-					return TRUE;
-				} else if (wValue_msb == AUDIO_AS_ACT_ALT_SETTINGS && wValue_lsb == 0
- 						   && request == AUDIO_CS_REQUEST_CUR) {
-					Usb_ack_setup_received_free();
-					Usb_reset_endpoint_fifo_access(EP_CONTROL);
-					Usb_write_endpoint_data(EP_CONTROL, 8, usb_alternate_setting_out);
-					Usb_ack_control_in_ready_send();
-					while (!Is_usb_control_out_received());
-					Usb_ack_control_out_received_free();
-					return TRUE;
-				} else if (wValue_msb == AUDIO_AS_AUDIO_DATA_FORMAT && wValue_lsb == 0
- 						   && request == AUDIO_CS_REQUEST_CUR) {
-					Usb_ack_setup_received_free();
-					Usb_reset_endpoint_fifo_access(EP_CONTROL);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x01);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-					Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);	// only PCM format
-					Usb_ack_control_in_ready_send();
-					while (!Is_usb_control_out_received());
-					Usb_ack_control_out_received_free();
-					return TRUE;
-				} else return FALSE;
-
-			} else if (type == OUT_CL_INTERFACE) {		// set controls
-				if (wValue_msb == AUDIO_AS_ACT_ALT_SETTINGS
-					&& request == AUDIO_CS_REQUEST_CUR) {
-					Usb_ack_setup_received_free();
-					while (!Is_usb_control_out_received());
-					Usb_reset_endpoint_fifo_access(EP_CONTROL);
-					usb_alternate_setting_out = Usb_read_endpoint_data(EP_CONTROL, 8);
-					usb_alternate_setting_out_changed = TRUE;
-					Usb_ack_control_out_received_free();
-					Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-					while (!Is_usb_control_in_ready()); //!< waits for status phase done
-					return FALSE;
-				}
-			} // end OUT_CL_INTERFACE
-		} // end DSC_INTERFACE_AS_OUT
-
-		if ( (wIndex % 256) == DSC_INTERFACE_AUDIO) {// low byte wIndex is Interface number
-													// high byte is for EntityID
-			if (type == IN_CL_INTERFACE) {			// get controls
-				switch (wIndex /256) {
-				case CSD_ID_1:
-					if (wValue_msb == AUDIO_CS_CONTROL_SAM_FREQ //&& wValue_lsb == 0
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						Usb_write_endpoint_data(EP_CONTROL, 8, current_freq.freq_bytes[3]); // 0x0000bb80 is 48khz
-						Usb_write_endpoint_data(EP_CONTROL, 8, current_freq.freq_bytes[2]); // 0x00017700 is 96khz
-						Usb_write_endpoint_data(EP_CONTROL, 8, current_freq.freq_bytes[1]); // 0x0002ee00 is 192khz
-						Usb_write_endpoint_data(EP_CONTROL, 8, current_freq.freq_bytes[0]);
-						Usb_ack_control_in_ready_send();
-
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else if (wValue_msb == AUDIO_CS_CONTROL_CLOCK_VALID //&& wValue_lsb == 0
-							 && request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						Usb_write_endpoint_data(EP_CONTROL, 8, TRUE);	// always valid
-						// temp hack to give total # of bytes requested
-						for (i = 0; i < (wLength - 1); i++)
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-						Usb_ack_control_in_ready_send();
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else if (wValue_msb == AUDIO_CS_CONTROL_SAM_FREQ //&& wValue_lsb == 0
-							 && request == AUDIO_CS_REQUEST_RANGE) {
-						Usb_ack_setup_received_free();
-
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-						// give total # of bytes requested
-						for (i = 0; i < min(wLength, sizeof(Speedx_1)); i++) {
-							//if (FEATURE_DAC_GENERIC)
-								Usb_write_endpoint_data(EP_CONTROL, 8, Speedx_2[i]);
-							//else Usb_write_endpoint_data(EP_CONTROL, 8, Speedx_2[i]);
-							}
-						Usb_ack_control_in_ready_send();
-
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-
-					} else return FALSE;
-
-				case CSD_ID_2:
-					if (wValue_msb == AUDIO_CS_CONTROL_SAM_FREQ //&& wValue_lsb == 0
-						&& request == AUDIO_CS_REQUEST_CUR) {
-
-//						print_dbg_char_char('h'); // BSB debug 20120910
-
-						Usb_ack_setup_received_free();
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						Usb_write_endpoint_data(EP_CONTROL, 8, current_freq.freq_bytes[3]); // 0x0000bb80 is 48khz
-						Usb_write_endpoint_data(EP_CONTROL, 8, current_freq.freq_bytes[2]); // 0x00017700 is 96khz
-						Usb_write_endpoint_data(EP_CONTROL, 8, current_freq.freq_bytes[1]); // 0x0002ee00 is 192khz
-						Usb_write_endpoint_data(EP_CONTROL, 8, current_freq.freq_bytes[0]);
-						Usb_ack_control_in_ready_send();
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else if (wValue_msb == AUDIO_CS_CONTROL_CLOCK_VALID //&& wValue_lsb == 0
-							 && request == AUDIO_CS_REQUEST_CUR) {
-
-						print_dbg_char_char('i'); // BSB debug 20120910
-
-						Usb_ack_setup_received_free();
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						Usb_write_endpoint_data(EP_CONTROL, 8, TRUE);	// always valid
-						// temp hack to give total # of bytes requested
-						for (i = 0; i < (wLength - 1); i++)
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-
-						Usb_ack_control_in_ready_send();
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else if (wValue_msb == AUDIO_CS_CONTROL_SAM_FREQ //&& wValue_lsb == 0
-							 && request == AUDIO_CS_REQUEST_RANGE) {
-//						print_dbg_char_char('j'); // BSB debug 20120910
-						Usb_ack_setup_received_free();
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-						// give total # of bytes requested
-						for (i = 0; i < min(wLength, sizeof(Speedx_1)); i++) {
-							//if (FEATURE_DAC_GENERIC)
-								Usb_write_endpoint_data(EP_CONTROL, 8, Speedx_1[i]);
-							//else Usb_write_endpoint_data(EP_CONTROL, 8, Speedx_2[i]);
-						}
-						Usb_ack_control_in_ready_send();
-
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-
-				case CSX_ID:
-					if (wValue_msb == AUDIO_CX_CLOCK_SELECTOR //&& wValue_lsb == 0
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						Usb_write_endpoint_data(EP_CONTROL, 8, clock_selected);
-						// temp hack to give total # of bytes requested
-						for (i = 0; i < (wLength - 1); i++)
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-						Usb_ack_control_in_ready_send();
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				case MIC_FEATURE_UNIT_ID:
-					if (wValue_msb == AUDIO_FU_CONTROL_CS_MUTE
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-						Usb_write_endpoint_data(EP_CONTROL, 8, mute);
-						// temp hack to give total # of bytes requested
-						for (i = 0; i < (wLength - 1); i++)
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-
-						Usb_ack_control_in_ready_send();
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				case SPK_FEATURE_UNIT_ID:
-					if (wValue_msb == AUDIO_FU_CONTROL_CS_MUTE
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-						Usb_write_endpoint_data(EP_CONTROL, 8, spk_mute);
-						// temp hack to give total # of bytes requested
-						for (i = 0; i < (wLength - 1); i++)
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-
-						Usb_ack_control_in_ready_send();
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				case INPUT_TERMINAL_ID:
-					if (wValue_msb == AUDIO_TE_CONTROL_CS_CLUSTER //&& wValue_lsb == 0
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						if (usb_alternate_setting == 1) {
-							Usb_write_endpoint_data(EP_CONTROL, 8, INPUT_TERMINAL_NB_CHANNELS);
-							Usb_write_endpoint_data(EP_CONTROL, 8, (U8) INPUT_TERMINAL_CHANNEL_CONF);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, INPUT_TERMINAL_STRING_DESC);
-						}
-						else {			// zero's at startup alt setting 0
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-						};
-						Usb_ack_control_in_ready_send();
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				case SPK_INPUT_TERMINAL_ID:
-					if (wValue_msb == AUDIO_TE_CONTROL_CS_CLUSTER //&& wValue_lsb == 0
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						if (usb_alternate_setting_out == 1) {
-							Usb_write_endpoint_data(EP_CONTROL, 8, SPK_INPUT_TERMINAL_NB_CHANNELS);
-							Usb_write_endpoint_data(EP_CONTROL, 8, (U8) SPK_INPUT_TERMINAL_CHANNEL_CONF);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, SPK_INPUT_TERMINAL_STRING_DESC);
-						}
-						else {			// zero's at startup alt setting 0
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-							Usb_write_endpoint_data(EP_CONTROL, 8, 0x00);
-						};
-						Usb_ack_control_in_ready_send();
-						while (!Is_usb_control_out_received());
-						Usb_ack_control_out_received_free();
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				default:
-					return FALSE;
-				} // end switch EntityID
-			} else if (type == OUT_CL_INTERFACE) {		// set controls
-				switch (wIndex /256) {
-				case CSD_ID_1:							// set CUR freq of Mic
-					if (wValue_msb == AUDIO_CS_CONTROL_SAM_FREQ && wValue_lsb == 0
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						freq_changed = TRUE;
-						Usb_ack_setup_received_free();
-						while (!Is_usb_control_out_received());
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-						current_freq.freq_bytes[3]=Usb_read_endpoint_data(EP_CONTROL, 8);		// read 4 bytes freq to set
-						current_freq.freq_bytes[2]=Usb_read_endpoint_data(EP_CONTROL, 8);
-						current_freq.freq_bytes[1]=Usb_read_endpoint_data(EP_CONTROL, 8);
-						current_freq.freq_bytes[0]=Usb_read_endpoint_data(EP_CONTROL, 8);
-						Mic_freq.freq_bytes[3]=current_freq.freq_bytes[3];
-						Mic_freq.freq_bytes[2]=current_freq.freq_bytes[2];
-						Mic_freq.freq_bytes[1]=current_freq.freq_bytes[1];
-						Mic_freq.freq_bytes[0]=current_freq.freq_bytes[0];
-						uac2_freq_change_handler();
-						Mic_freq_valid = TRUE;
-
-						Usb_ack_control_out_received_free();
-						Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-						while (!Is_usb_control_in_ready()); //!< waits for status phase done
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				case CSD_ID_2:							// set CUR freq
-//					print_dbg_char_char('o'); // BSB debug 20120910
-					if (wValue_msb == AUDIO_CS_CONTROL_SAM_FREQ && wValue_lsb == 0
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						freq_changed = TRUE;
-						Usb_ack_setup_received_free();
-						while (!Is_usb_control_out_received());
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						current_freq.freq_bytes[3]=Usb_read_endpoint_data(EP_CONTROL, 8);		// read 4 bytes freq to set
-						current_freq.freq_bytes[2]=Usb_read_endpoint_data(EP_CONTROL, 8);
-						current_freq.freq_bytes[1]=Usb_read_endpoint_data(EP_CONTROL, 8);
-						current_freq.freq_bytes[0]=Usb_read_endpoint_data(EP_CONTROL, 8);
-						uac2_freq_change_handler();
-
-						// some freq only applies to playback
-						// may need better checking algorithm
-						if (current_freq.frequency == Mic_freq.frequency) 	Mic_freq_valid = TRUE;
-						else Mic_freq_valid = FALSE;
-
-						Usb_ack_control_out_received_free();
-						Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-						while (!Is_usb_control_in_ready()); //!< waits for status phase done
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				case CSX_ID:
-					if (wValue_msb == AUDIO_CX_CLOCK_SELECTOR && wValue_lsb == 0
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-						while (!Is_usb_control_out_received());
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						clock_selected = Usb_read_endpoint_data(EP_CONTROL, 8);
-						clock_changed = TRUE;
-						Usb_ack_control_out_received_free();
-						Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-						while (!Is_usb_control_in_ready()); //!< waits for status phase done
-						if (clock_selected < 1 || clock_selected > CSX_INPUT_PINS)
-							clock_selected = 1;
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				case MIC_FEATURE_UNIT_ID:
-					if (wValue_msb == AUDIO_FU_CONTROL_CS_MUTE
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-						while (!Is_usb_control_out_received());
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						mute = Usb_read_endpoint_data(EP_CONTROL, 8);
-						Usb_ack_control_out_received_free();
-						Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-						while (!Is_usb_control_in_ready()); //!< waits for status phase done
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				case SPK_FEATURE_UNIT_ID:
-					if (wValue_msb == AUDIO_FU_CONTROL_CS_MUTE
-						&& request == AUDIO_CS_REQUEST_CUR) {
-						Usb_ack_setup_received_free();
-						while (!Is_usb_control_out_received());
-						Usb_reset_endpoint_fifo_access(EP_CONTROL);
-						spk_mute = Usb_read_endpoint_data(EP_CONTROL, 8);
-						Usb_ack_control_out_received_free();
-						Usb_ack_control_in_ready_send();    //!< send a ZLP for STATUS phase
-						while (!Is_usb_control_in_ready()); //!< waits for status phase done
-						return TRUE;
-					}
-					else
-						return FALSE;
-
-				default:
-					return FALSE;
-				}
-			} // end OUT_CL_INTERFACE
-
-		} // end Audio Control Interface
-
-
-	} // end CL_INTERFACE
-
-	return FALSE;  // No supported request
-}
-
 #endif  // USB_DEVICE_FEATURE == ENABLED
@@ -0,0 +1,82 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_power.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * USB suspend and resume of the audio hardware, see usb_power.h
+ */
+
+#include "compiler.h"
+#include "board.h"
+#include "gpio.h"
+#include "pm.h"
+#include "pdca.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "features.h"
+#include "taskAK5394A.h"
+#include "eventlog.h"
+#include "usb_power.h"
+
+volatile Bool usb_power_suspended = FALSE;
+
+static Bool rx_running;					// record PDCA state at suspend
+static volatile Bool rx_resync;
+
+//
+// USB interrupt, the bus went idle for 3 ms
+//
+void usb_power_suspend(void) {
+	if (usb_power_suspended)
+		return;
+	usb_power_suspended = TRUE;
+
+	// pause the DMA first, where it stands in the buffers is what resume restores
+	rx_running = pdca_get_channel_status(PDCA_CHANNEL_SSC_RX);
+	pdca_disable(PDCA_CHANNEL_SSC_RX);
+	pdca_disable(PDCA_CHANNEL_SSC_TX);
+	AVR32_SSC.cr = AVR32_SSC_CR_RXDIS_MASK | AVR32_SSC_CR_TXDIS_MASK;
+
+	// the setup of GCLK1 stays, only the enable goes
+	pm_gc_disable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+	if (FEATURE_ADC_AK5394A)
+		gpio_clr_gpio_pin(AK5394_RSTN);		// powered down, and safe without its clocks
+
+	eventlog_put(ev_usb_suspend, rx_running, 0, 0);
+}
+
+//
+// USB interrupt, wake up or resume signalling on the bus
+//
+void usb_power_resume(void) {
+	if ( ! usb_power_suspended)
+		return;
+
+	if (FEATURE_ADC_AK5394A)
+		gpio_set_gpio_pin(AK5394_RSTN);		// calibrates, then runs on its own
+	pm_gc_enable(&AVR32_PM, AVR32_PM_GCLK_GCLK1);
+	AVR32_SSC.cr = AVR32_SSC_CR_RXEN_MASK | AVR32_SSC_CR_TXEN_MASK;
+	pdca_enable(PDCA_CHANNEL_SSC_TX);
+	rx_resync = rx_running;
+
+	usb_power_suspended = FALSE;
+	eventlog_put(ev_usb_resume, rx_running, 0, 0);
+}
+
+Bool usb_power_resync(void) {
+	if ( ! rx_resync)
+		return FALSE;
+	rx_resync = FALSE;
+	return TRUE;
+}
+
+//
+// the idle task, with nothing to do while the bus sleeps stop the CPU
+// until the next interrupt, the RTOS tick or the USB wake up
+//
+void vApplicationIdleHook(void) {
+	if (usb_power_suspended)
+		SLEEP(AVR32_PM_SMODE_IDLE);
+}
@@ -0,0 +1,39 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb_power.h
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * USB suspend and resume of the audio hardware.
+ *
+ * On suspend the USB interrupt pauses both PDCA channels where they are,
+ * stops the SSC, gates GCLK1 and holds the AK5394A in reset, and the idle
+ * task sleeps the CPU until the bus wakes up. Nothing else is touched: the
+ * configuration, alternate settings, rate and the positions of the USB
+ * side in the audio buffers all survive, so on resume the clocks, the SSC
+ * and the playback PDCA just carry on from where they stopped. The record
+ * PDCA comes back through the audio task, which has to line it up with
+ * LRCK again, see usb_power_resync().
+ *
+ * The AK5394A calibrates after its reset, 8704 LRCK periods, the record
+ * stream carries silence until then.
+ */
+
+#ifndef USB_POWER_H_
+#define USB_POWER_H_
+
+#include "compiler.h"
+
+// TRUE from the suspend interrupt to the wake up or resume interrupt
+extern volatile Bool usb_power_suspended;
+
+// the Usb_suspend_action() and Usb_wake_up_action() / Usb_resume_action() of conf_usb.h
+extern void usb_power_suspend(void);
+extern void usb_power_resume(void);
+
+// TRUE once after a resume that found the record PDCA running, the device
+// audio task then restarts it on the next LRCK edge
+extern Bool usb_power_resync(void);
+
+#endif /* USB_POWER_H_ */
@@ -84,6 +84,14 @@
 #include "pm.h"
 #include "Mobo_config.h"
 #include "DG8SAQ_cmd.h"
+#include "taskRunStats.h"
+#include "eventlog.h"
+#include "telemetry.h"
+#include "stream_health.h"
+#include "iq_correction.h"
+#include "spectrum.h"
+#include "dg8saq_queue.h"
+#include "sweep.h"
 // #include "usb_audio.h"
 // #include "device_audio_task.h"
 
@@ -146,21 +154,6 @@ void usb_user_set_interface(U8 wIndex, U8 wValue) {
 	image_user_set_interface(wIndex, wValue);
 }
 
-//! This function is called by the standard USB read request function when
-//! the USB request is not supported. This function returns TRUE when the
-//! request is processed. This function returns FALSE if the request is not
-//! supported. In this case, a STALL handshake will be automatically
-//! sent by the standard USB read request function.
-//!
-Bool usb_user_read_request(U8 type, U8 request)
-{
-  // Test for Vendor specific request - DG8SAQ type of request
-  if ( (type & DRT_MASK) == DRT_VENDOR )
-	  return usb_user_DG8SAQ (type, request);
-  return image_user_read_request(type, request);
-}
-
-
 //! This function returns the size and the pointer on a user information
 //! structure
 //!
@@ -246,64 +239,76 @@ Bool usb_user_get_descriptor(U8 type, U8 string)
   return pbuffer != NULL;
 }
 
-Bool usb_user_DG8SAQ(U8 type, U8 command) {
+//
+// the data of a host to device command arrived, in task context, queued
+// for the DG8SAQ task and acknowledged, see dg8saq_queue.h
+//
+static Bool usb_user_DG8SAQ_write(const S_usb_setup_data *setup, U8 *data, U16 length) {
+	dg8saq_reverse(data, length);
+	return dg8saq_queue_write(setup->bRequest, setup->wValue, setup->wIndex, data, length);
+}
 
-	U16 wValue, wIndex, wLength;
-	U8 replyLen;
-	int x;
+//
+// a frequency list or range for the sweep arrived, little endian as sent
+//
+static Bool usb_user_sweep_write(const S_usb_setup_data *setup, U8 *data, U16 length) {
+	return sweep_write(setup->wIndex, setup->wValue, data, length);
+}
 
-    // Grab the wValue, wIndex / wLength
-	wValue  = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-	wIndex  = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
-	wLength  = usb_format_usb_to_mcu_data(16, Usb_read_endpoint_data(EP_CONTROL, 16));
+Bool usb_user_DG8SAQ(const S_usb_setup_data *setup) {
+
+	U8 command = setup->bRequest;
+	S16 replyLen;
 
 	//-------------------------------------------------------------------------------
 	// Process USB Host to Device transmissions.  No result is returned.
 	//-------------------------------------------------------------------------------
-	if (type == (DRD_OUT | DRT_STD | DRT_VENDOR)) {
-		Usb_ack_setup_received_free();
-		while (!Is_usb_control_out_received());
-		Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-		//for (x = 0; x<wLength;x++)
-		if (wLength>0)
-			for (x = wLength-1; x>=0;x--) {
-				dg8saqBuffer[x] = Usb_read_endpoint_data(EP_CONTROL, 8);
-			}
-		Usb_ack_control_out_received_free();
-		Usb_ack_control_in_ready_send();
-		while (!Is_usb_control_in_ready());
-
-		// This is our all important hook - Do the magic... control Si570 etc...
-		dg8saqFunctionWrite(command, wValue, wIndex, dg8saqBuffer, wLength);
+	if (setup->bmRequestType == (DRD_OUT | DRT_STD | DRT_VENDOR)) {
+		// a single packet at most, as before, a longer data stage is refused
+		// rather than cut
+		if (setup->wLength > EP_CONTROL_LENGTH)
+			usb_ctrl_stall();
+		else
+			usb_ctrl_receive(dg8saqBuffer, setup->wLength,
+							 command == SWEEP_DG8SAQ_COMMAND ? usb_user_sweep_write : usb_user_DG8SAQ_write);
+		return TRUE;
 	}
 	//-------------------------------------------------------------------------------
 	// Process USB query commands and return a result (flexible size data payload)
 	//-------------------------------------------------------------------------------
-	else if (type == (DRD_IN | DRT_STD | DRT_VENDOR)) {
-		// This is our all important hook - Process and execute command, read CW paddle state etc...
-		replyLen = dg8saqFunctionSetup(command, wValue, wIndex, dg8saqBuffer);
-
-		Usb_ack_setup_received_free();
-
-		Usb_reset_endpoint_fifo_access(EP_CONTROL);
-
-		// Write out if packet is larger than zero
-		if (replyLen) {
-			for (x = replyLen-1; x>=0;x--) {
-				Usb_write_endpoint_data(EP_CONTROL, 8, dg8saqBuffer[x]);	// send the reply
-			}
+	if (setup->bmRequestType == (DRD_IN | DRT_STD | DRT_VENDOR)) {
+		if (command == RUNSTATS_DG8SAQ_COMMAND) {
+			// Task load and stack records, already in wire order
+			replyLen = runstats_get_record(setup->wIndex, dg8saqBuffer);
+		} else if (command == EVENTLOG_DG8SAQ_COMMAND) {
+			// Binary event log records from sequence number wIndex on
+			replyLen = eventlog_get_records(setup->wIndex, dg8saqBuffer);
+		} else if (command == TELEMETRY_DG8SAQ_COMMAND) {
+			// Telemetry endpoint period, wValue in ms
+			replyLen = telemetry_set_period(setup->wValue, dg8saqBuffer);
+		} else if (command == STREAM_HEALTH_DG8SAQ_COMMAND) {
+			// Stream health counters, wValue = STREAM_HEALTH_RESET to reset after reading
+			replyLen = stream_health_get_record(setup->wValue, dg8saqBuffer);
+		} else if (command == IQ_CORRECTION_DG8SAQ_COMMAND) {
+			// IQ imbalance correction matrix, wIndex = operation, wValue = coefficient
+			replyLen = iq_correction_request(setup->wIndex, setup->wValue, dg8saqBuffer);
+		} else if (command == SPECTRUM_DG8SAQ_COMMAND) {
+			// Spectrum frames, wValue = period in ms, wIndex = averages | grouping << 8
+			replyLen = spectrum_set_frame(setup->wValue, setup->wIndex, dg8saqBuffer);
+		} else if (command == SWEEP_DG8SAQ_COMMAND) {
+			// Frequency sweep, wIndex = operation | passes << 8, wValue = dwell time
+			replyLen = sweep_request(setup->wIndex, setup->wValue, dg8saqBuffer);
+		} else {
+			// Answered from the status cache of the DG8SAQ task, or once it ran
+			dg8saq_queue_query(command, setup->wValue, setup->wIndex);
+			return TRUE;
 		}
 
-		Usb_ack_control_in_ready_send();
-		while (!Is_usb_control_in_ready());			// handshake modified by Alex 16 May 2010
-
-		while ( !Is_usb_control_out_received());
-		Usb_ack_control_out_received_free();
-
+		usb_ctrl_send(dg8saqBuffer, replyLen);
+		return TRUE;
 	}
 
-	return TRUE;
+	return FALSE;
 }
 
 #endif  // USB_DEVICE_FEATURE == ENABLED
@@ -77,6 +77,8 @@
   #error usb_specific_request.h is #included although USB_DEVICE_FEATURE is disabled
 #endif
 
+#include "usb_standard_request.h"
+
 
 
 
@@ -126,15 +128,8 @@ extern void usb_user_endpoint_init(U8);
 
 extern void usb_user_set_interface(U8 wIndex, U8 wValue);
 
-//! This function is called by the standard USB read request function when
-//! the USB request is not supported. This function returns TRUE when the
-//! request is processed. This function returns FALSE if the request is not
-//! supported. In this case, a STALL handshake will be automatically
-//! sent by the standard USB read request function.
-//!
-extern Bool usb_user_read_request(U8, U8);
 extern Bool usb_user_get_descriptor(U8, U8);
-extern Bool usb_user_DG8SAQ(U8, U8); // for processing DG8SAQ type of commands
+extern Bool usb_user_DG8SAQ(const S_usb_setup_data *setup); // for processing DG8SAQ type of commands, see usb_ctrl_register()
 
 // dg8saq EP0 hooks for the Mobo firmware
 // extern void dg8saqFunctionWrite(U8, U16, U16, U8 *, U8 );
@@ -0,0 +1,156 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * uac2-sync-sim.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Run src/packet_sizer.c, the record packet sizes of feature_sync_implicit,
+ * on the host against simulated clocks, and check that a host slaving its
+ * playback to them keeps the speaker buffer where it started:
+ *
+ *   uac2-sync-sim [-v]
+ *
+ * For every UAC2 rate at each bus speed, and the ADC/DAC crystal off by
+ * each of a few ppm against the bus SOF:
+ *
+ *   - the ADC writes into the pair of record buffers on its own clock,
+ *     the device reads a packet every service interval
+ *   - every packet is within one sample of the nominal rate per interval
+ *     and fits the endpoint
+ *   - the ADC writer never laps the USB reader, nor the other way round
+ *   - the host sends back packets of the sizes it received, a few
+ *     intervals later, and the DAC, on the same crystal as the ADC,
+ *     reads them out of the pair of speaker buffers without either
+ *     side lapping the other or the gap drifting away from the middle
+ *
+ * Exits 1 if any stream fails, -v prints each stream.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "uac2_audio_function.h"
+#include "packet_sizer.h"
+
+// as in src/taskAK5394A.h, words of one buffer of each pair
+#define AUDIO_BUFFER_SIZE	(48*2*8)
+#define SPK_BUFFER_SIZE		(48*2*16)
+
+#define SIM_SECONDS			30		// bus time simulated for each stream
+#define SIM_HOST_LATENCY	4		// intervals between an IN packet and its OUT packet
+
+static const S32 sim_ppm[] = { -500, -100, 0, 100, 500 };
+
+static int verbose;
+static int errors;
+
+// one stream at rate, on a crystal ppm off the bus, intervals packets a
+// second of at most max_samples, gaps in words as the firmware has them
+static void sim_stream(U32 rate, S32 ppm, U32 intervals, U16 max_samples) {
+	packet_sizer_t sizer;
+	U16 in_flight[SIM_HOST_LATENCY];
+	U64 adc_acc = 0, adc_frames = 0, usb_frames = 0, dac_acc = 0;
+	int64_t mic_gap, spk_gap = SPK_BUFFER_SIZE;
+	int64_t mic_min = AUDIO_BUFFER_SIZE, mic_max = AUDIO_BUFFER_SIZE;
+	int64_t spk_min = SPK_BUFFER_SIZE, spk_max = SPK_BUFFER_SIZE;
+	const U32 nominal_lo = rate / intervals, nominal_hi = (rate + intervals - 1) / intervals;
+	const U64 clock = (U64)rate * (1000000 + ppm);		// ADC and DAC frames a second, times 1e6
+	const U64 tick = (U64)intervals * 1000000;
+	// the record gap stays within a packet of the middle half of its range,
+	// the speaker gap moves by as much and by what is in flight to the host
+	const int64_t spk_drift = AUDIO_BUFFER_SIZE / 2 + 2 * (SIM_HOST_LATENCY + 1) * max_samples;
+	U32 n, total = intervals * SIM_SECONDS;
+	U16 samples;
+	Bool failed = FALSE, playing = FALSE;
+
+	memset(&sizer, 0, sizeof(sizer));
+	memset(in_flight, 0, sizeof(in_flight));
+
+	for (n = 0; n < total && ! failed; n += 1) {
+		// the ADC PDCA fills the record buffers for one interval, the
+		// device then sends the next record packet
+		adc_acc += clock;
+		adc_frames += adc_acc / tick;
+		adc_acc %= tick;
+		mic_gap = AUDIO_BUFFER_SIZE + 2 * ((int64_t)adc_frames - (int64_t)usb_frames);
+		if (mic_gap <= 0 || mic_gap >= 2 * AUDIO_BUFFER_SIZE) {
+			fprintf(stderr, "uac2-sync-sim: %u Hz %+d ppm %u/s: record gap %lld at packet %u\n",
+					rate, ppm, intervals, (long long)mic_gap, n);
+			failed = TRUE;
+		}
+		if (mic_gap < mic_min) mic_min = mic_gap;
+		if (mic_gap > mic_max) mic_max = mic_gap;
+
+		samples = packet_sizer_samples(&sizer, rate, intervals, (U16)mic_gap, AUDIO_BUFFER_SIZE);
+		usb_frames += samples;
+		if (samples + 1 < nominal_lo || samples > nominal_hi + 1 || samples > max_samples) {
+			fprintf(stderr, "uac2-sync-sim: %u Hz %+d ppm %u/s: packet %u of %u samples\n",
+					rate, ppm, intervals, n, samples);
+			failed = TRUE;
+		}
+
+		// the host plays back what it got, a few intervals later, and
+		// the DAC reads on the ADC crystal from the first packet on,
+		// the writer starting one buffer ahead as in the audio task
+		playing |= n >= SIM_HOST_LATENCY;
+		if (playing) {
+			spk_gap += 2 * in_flight[n % SIM_HOST_LATENCY];
+			dac_acc += clock;
+			spk_gap -= 2 * (int64_t)(dac_acc / tick);
+			dac_acc %= tick;
+			if (spk_gap <= 0 || spk_gap >= 2 * SPK_BUFFER_SIZE
+				|| spk_gap < SPK_BUFFER_SIZE - spk_drift || spk_gap > SPK_BUFFER_SIZE + spk_drift) {
+				fprintf(stderr, "uac2-sync-sim: %u Hz %+d ppm %u/s: speaker gap %lld at packet %u\n",
+						rate, ppm, intervals, (long long)spk_gap, n);
+				failed = TRUE;
+			}
+			if (spk_gap < spk_min) spk_min = spk_gap;
+			if (spk_gap > spk_max) spk_max = spk_gap;
+		}
+		in_flight[n % SIM_HOST_LATENCY] = samples;
+	}
+
+	if (verbose)
+		printf("%6u Hz %+4d ppm %4u/s: %.4f samples a packet, record gap %lld..%lld, speaker gap %lld..%lld\n",
+			   rate, ppm, intervals, (double)usb_frames / n,
+			   (long long)mic_min, (long long)mic_max, (long long)spk_min, (long long)spk_max);
+	if (failed)
+		errors += 1;
+}
+
+static int streams;
+
+static void sim_rate(U32 rate) {
+	int i;
+
+	for (i = 0; i < sizeof(sim_ppm) / sizeof(sim_ppm[0]); i += 1) {
+		if (rate <= UAC2_RATE_MAX_FS) {
+			sim_stream(rate, sim_ppm[i], 1000000 / UAC2_INTERVAL_US_FS,
+					   UAC2_EP_BYTES_FS / (UAC2_NB_CHANNELS * UAC2_SUBSLOT_SIZE));
+			streams += 1;
+		}
+		sim_stream(rate, sim_ppm[i], 1000000 / UAC2_INTERVAL_US_HS,
+				   UAC2_EP_BYTES_HS / (UAC2_NB_CHANNELS * UAC2_SUBSLOT_SIZE));
+		streams += 1;
+	}
+}
+
+#define SIM_RATE(rate)	sim_rate(rate);
+
+int main(int argc, char *argv[]) {
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	// feature_sync_implicit records on the playback clock, at its rates
+	UAC2_SPK_RATES(SIM_RATE)
+
+	if (errors) {
+		fprintf(stderr, "uac2-sync-sim: %d of %d streams failed\n", errors, streams);
+		return 1;
+	}
+	printf("uac2-sync-sim: %d streams ok\n", streams);
+	return 0;
+}
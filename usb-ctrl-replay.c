@@ -0,0 +1,529 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb-ctrl-replay.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Play recorded control transfers against the EP0 state machine of
+ * usb_standard_request.c, built for the host against the simulated
+ * controller in etc/usb-ctrl-replay/usb_drv.h.
+ *
+ *   usb-ctrl-replay [-v] file...
+ *
+ * A recording has one host token per line, # starts a comment:
+ *
+ *   setup bb rr vl vh il ih ll lh   SETUP packet, as on the wire
+ *   in [xx ...]                     IN token, expects these data bytes,
+ *                                   none for a zero length packet
+ *   out [xx ...]                    OUT token with these data bytes
+ *   in stall / out stall            the token must be stalled
+ *   in nak / out nak                the token must be NAKed, still after
+ *                                   the retries
+ *   speed full|high                 bus speed for the following requests
+ *   address n / config n            check the device address, configuration
+ *   idle                            check the state machine went back to idle
+ *   reply [xx ...]                  another task answers the deferred request,
+ *                                   with this data if it is an IN one
+ *   reply stall                     another task stalls the deferred request
+ *   reply stale                     the answer to the oldest request deferred
+ *                                   and not answered must be refused, a
+ *                                   SETUP came since
+ *   set name value                  set a variable of the audio controls
+ *   expect name value               check a variable of the audio controls
+ *
+ * Tokens the device NAKs are retried a few times, running the interrupt
+ * and the USB device task in between. Vendor requests to the device go to
+ * a registered handler modelled on the DG8SAQ one: an IN request answers
+ * LSB(wValue) bytes counting up from 0x10, an OUT request takes its data
+ * and stalls the status stage when bRequest is 0xff. A request with
+ * bRequest 0x04 is deferred, the IN one at the SETUP, the OUT one once
+ * its data came, for the reply lines to answer. A request no handler
+ * takes is stalled.
+ *
+ * Audio class requests go to uac2_user_audio_request() and the control
+ * table of src/uac2_audio_controls.c, on the variables below. Once any
+ * recording touched the table, every entry must have been used by one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "usb_drv.h"
+#include "usb_descriptors.h"
+#include "usb_standard_request.h"
+#include "usb_specific_request.h"
+#include "uac2_usb_specific_request.h"
+#include "device_audio_task.h"
+#include "eventlog.h"
+#include "uac2_audio_controls.h"
+
+#define RETRIES		4
+
+usb_sim_t usb_sim;
+static int verbose;
+
+//
+// the descriptors of a device with an audio like interface 1,
+// three alternate settings, and 64 bytes of configuration
+//
+const U8 replay_dev_desc[18] = {
+	18, DEVICE_DESCRIPTOR, 0x00, 0x02, 0xef, 0x02, 0x01, EP_CONTROL_LENGTH,
+	0xc0, 0x16, 0xdc, 0x05, 0x00, 0x01, 0x01, 0x02, 0x03, NB_CONFIGURATION
+};
+
+#define REPLAY_CONF_DESC(bInterval) {										\
+	9, CONFIGURATION_DESCRIPTOR, 64, 0, 2, 1, 0, 0xc0, 50,					\
+	9, INTERFACE_DESCRIPTOR, 0, 0, 0, 0xff, 0, 0, 0,						\
+	9, INTERFACE_DESCRIPTOR, 1, 0, 0, 0x01, 0x02, 0x20, 0,					\
+	9, INTERFACE_DESCRIPTOR, 1, 1, 1, 0x01, 0x02, 0x20, 0,					\
+	5, 0x24, 0x01, 0x02, 0x01,												\
+	7, ENDPOINT_DESCRIPTOR, 0x81, 0x05, 0x00, 0x02, bInterval,				\
+	9, INTERFACE_DESCRIPTOR, 1, 2, 1, 0x01, 0x02, 0x20, 0,					\
+	7, ENDPOINT_DESCRIPTOR, 0x81, 0x05, 0x00, 0x02, bInterval				\
+}
+
+const U8 replay_conf_desc_fs[] = REPLAY_CONF_DESC(1);
+const U8 replay_conf_desc_hs[] = REPLAY_CONF_DESC(4);
+const U16 replay_conf_desc_length = sizeof(replay_conf_desc_fs);
+
+const U8 replay_qualifier_desc[10] = {
+	10, DEVICE_QUALIFIER_DESCRIPTOR, 0x00, 0x02, 0xef, 0x02, 0x01, EP_CONTROL_LENGTH, NB_CONFIGURATION, 0
+};
+
+static const U8 replay_language_id[4] = { 4, STRING_DESCRIPTOR, 0x09, 0x04 };
+
+extern const void *pbuffer;
+extern U16 data_to_transfer;
+
+//
+// the simulated controller, MCU side
+//
+U32 usb_sim_read_fifo(int bits) {
+	U32 data = 0;
+	int i;
+
+	for (i = 0; i < bits; i += 8)
+		data |= (U32)usb_sim.fifo[usb_sim.fifo_pos++ % sizeof(usb_sim.fifo)] << i;
+	return data;
+}
+
+U32 usb_write_ep_txpacket(U8 ep, const void *txbuf, U32 data_length, const void **ptxbuf) {
+	U32 n = min(data_length, sizeof(usb_sim.fifo) - usb_sim.fifo_pos);
+
+	memcpy(&usb_sim.fifo[usb_sim.fifo_pos], txbuf, n);
+	usb_sim.fifo_pos += n;
+	usb_sim.byte_count = usb_sim.fifo_pos;
+	if (ptxbuf != NULL)
+		*ptxbuf = (const U8 *)txbuf + n;
+	return data_length - n;
+}
+
+U32 usb_read_ep_rxpacket(U8 ep, void *rxbuf, U32 data_length, void **prxbuf) {
+	U32 n = min(data_length, usb_sim.byte_count - min(usb_sim.fifo_pos, usb_sim.byte_count));
+
+	memcpy(rxbuf, &usb_sim.fifo[usb_sim.fifo_pos], n);
+	usb_sim.fifo_pos += n;
+	if (prxbuf != NULL)
+		*prxbuf = (U8 *)rxbuf + n;
+	return data_length - n;
+}
+
+//
+// the usb_specific_request hooks
+//
+void usb_user_endpoint_init(U8 conf_nb) {
+	usb_sim.ep_enabled[1] = TRUE;
+}
+
+void usb_user_set_interface(U8 wIndex, U8 wValue) {
+	if (verbose)
+		printf("  set interface %u alt %u\n", wIndex, wValue);
+}
+
+Bool usb_user_get_descriptor(U8 type, U8 string) {
+	if (type != STRING_DESCRIPTOR || string != LANG_ID)
+		return FALSE;
+	data_to_transfer = sizeof(replay_language_id);
+	pbuffer = replay_language_id;
+	return TRUE;
+}
+
+#define VENDOR_DEFERRED		0x04
+
+static U8 vendor_buffer[256];
+static U16 vendor_tickets[8];	// of the requests deferred and not answered
+static int vendor_deferred;
+static Bool vendor_deferred_in;		// the last one
+
+static void vendor_defer(Bool in) {
+	if (vendor_deferred < 8)
+		vendor_tickets[vendor_deferred++] = usb_ctrl_defer();
+	vendor_deferred_in = in;
+}
+
+static Bool vendor_out_done(const S_usb_setup_data *setup, U8 *data, U16 length) {
+	if (verbose)
+		printf("  vendor OUT %02x, %u bytes\n", setup->bRequest, length);
+	if (setup->bRequest == VENDOR_DEFERRED)
+		vendor_defer(FALSE);
+	return setup->bRequest != 0xff;
+}
+
+static Bool vendor_request(const S_usb_setup_data *setup) {
+	int i;
+
+	if (setup->bmRequestType == (DRD_IN | DRT_VENDOR) && setup->bRequest == VENDOR_DEFERRED) {
+		vendor_defer(TRUE);
+		return TRUE;
+	}
+	if (setup->bmRequestType == (DRD_IN | DRT_VENDOR)) {
+		for (i = 0; i < LSB(setup->wValue); i += 1)
+			vendor_buffer[i] = 0x10 + i;
+		usb_ctrl_send(vendor_buffer, LSB(setup->wValue));
+		return TRUE;
+	}
+	if (setup->bmRequestType == (DRD_OUT | DRT_VENDOR)) {
+		usb_ctrl_receive(vendor_buffer, setup->wLength, vendor_out_done);
+		return TRUE;
+	}
+	return FALSE;
+}
+
+//
+// the state uac2_audio_controls.c works on, the sample rate change
+// only counted
+//
+S_freq current_freq, Mic_freq;
+Bool freq_changed, Mic_freq_valid, clock_changed;
+U8 clock_selected;
+volatile U8 usb_alternate_setting, usb_alternate_setting_out;
+volatile Bool usb_alternate_setting_changed, usb_alternate_setting_out_changed;
+volatile Bool mute, spk_mute;
+static U32 freq_changes, clock_valid_events;
+
+void uac2_freq_change_handler(void) {
+	if (freq_changed)
+		freq_changes += 1;
+	freq_changed = FALSE;
+}
+
+void eventlog_put(eventlog_id_t id, U32 arg0, U32 arg1, U32 arg2) {
+	if (id == ev_clock_valid)
+		clock_valid_events += 1;
+}
+
+#define REPLAY_VAR(name)	{ #name, (void *)&name, sizeof(name) }
+
+static const struct {
+	const char *name;
+	void *p;
+	int size;
+} replay_vars[] = {
+	{ "freq", &current_freq.frequency, 4 },
+	{ "mic_freq", &Mic_freq.frequency, 4 },
+	REPLAY_VAR(Mic_freq_valid),
+	REPLAY_VAR(freq_changed),
+	REPLAY_VAR(freq_changes),
+	REPLAY_VAR(clock_selected),
+	REPLAY_VAR(clock_changed),
+	REPLAY_VAR(clock_valid_events),
+	REPLAY_VAR(usb_alternate_setting),
+	REPLAY_VAR(usb_alternate_setting_out),
+	REPLAY_VAR(usb_alternate_setting_out_changed),
+	REPLAY_VAR(mute),
+	REPLAY_VAR(spk_mute),
+};
+
+#define NB_REPLAY_VARS	(sizeof(replay_vars) / sizeof(replay_vars[0]))
+
+static int replay_var(const char *name) {
+	int i;
+
+	for (i = 0; i < NB_REPLAY_VARS; i += 1)
+		if (strcmp(replay_vars[i].name, name) == 0)
+			return i;
+	return -1;
+}
+
+static U32 replay_var_get(int i) {
+	switch (replay_vars[i].size) {
+	case 1: return *(U8 *)replay_vars[i].p;
+	case 2: return *(U16 *)replay_vars[i].p;
+	default: return *(U32 *)replay_vars[i].p;
+	}
+}
+
+static void replay_var_set(int i, U32 value) {
+	switch (replay_vars[i].size) {
+	case 1: *(U8 *)replay_vars[i].p = value; break;
+	case 2: *(U16 *)replay_vars[i].p = value; break;
+	default: *(U32 *)replay_vars[i].p = value; break;
+	}
+}
+
+// the table entries some SETUP packet went to
+static U8 control_used[64];
+
+static void control_coverage(const U8 *packet) {
+	S_usb_setup_data setup;
+	const uac2_control_t *cp;
+
+	setup.bmRequestType = packet[0];
+	setup.bRequest = packet[1];
+	setup.wValue = packet[2] | (packet[3] << 8);
+	setup.wIndex = packet[4] | (packet[5] << 8);
+	setup.wLength = packet[6] | (packet[7] << 8);
+	if ((cp = uac2_control_find(&setup)) != NULL)
+		control_used[cp - uac2_controls] = 1;
+}
+
+//
+// run the interrupt while it has something to do, and the USB device
+// task whenever the interrupt asks for it, as usb_device_task() does
+//
+static int pump(void) {
+	int i;
+
+	for (i = 0; i < 64; i += 1) {
+		usb_ctrl_state_t state = usb_ctrl_get_state();
+		if (usb_sim.ep0_interrupt_enabled &&
+			((usb_sim.rxstpi && usb_sim.rxstpe) || (usb_sim.rxouti && usb_sim.rxoute) ||
+			 (usb_sim.txini && usb_sim.txine) || (usb_sim.nakouti && usb_sim.nakoute)))
+			usb_ctrl_interrupt();
+		else if (state == USB_CTRL_SETUP || state == USB_CTRL_OUT_DONE)
+			usb_process_request();
+		else
+			return 0;
+	}
+	return -1;
+}
+
+//
+// the simulated controller, host side
+//
+enum { ACK, NAK, STALL };
+
+static void host_setup(const U8 *packet) {
+	usb_sim.ep_stall[EP_CONTROL] = FALSE;	// cleared by the hardware on SETUP
+	memcpy(usb_sim.fifo, packet, 8);
+	usb_sim.byte_count = 8;
+	usb_sim.rxstpi = TRUE;
+	usb_sim.rxouti = FALSE;
+	usb_sim.txini = TRUE;
+}
+
+static int host_in(U8 *packet, int *length) {
+	if (usb_sim.ep_stall[EP_CONTROL])
+		return STALL;
+	if (usb_sim.txini || usb_sim.rxstpi)
+		return NAK;							// no packet in the bank
+	*length = usb_sim.byte_count;
+	memcpy(packet, usb_sim.fifo, *length);
+	usb_sim.byte_count = 0;
+	usb_sim.fifo_pos = 0;
+	usb_sim.txini = TRUE;
+	return ACK;
+}
+
+static int host_out(const U8 *packet, int length) {
+	if (usb_sim.ep_stall[EP_CONTROL])
+		return STALL;
+	if (usb_sim.rxstpi || usb_sim.rxouti || ! usb_sim.txini) {
+		usb_sim.nakouti = TRUE;
+		if ( ! usb_sim.txini) {				// the host gave up on the IN data
+			usb_sim.txini = TRUE;
+			usb_sim.byte_count = 0;
+		}
+		return NAK;
+	}
+	memcpy(usb_sim.fifo, packet, length);
+	usb_sim.byte_count = length;
+	usb_sim.fifo_pos = 0;
+	usb_sim.rxouti = TRUE;
+	return ACK;
+}
+
+static void usb_sim_reset(void) {
+	memset(&usb_sim, 0, sizeof(usb_sim));
+	usb_sim.txini = TRUE;
+	usb_sim.ep_enabled[EP_CONTROL] = TRUE;
+	usb_ctrl_reset();
+}
+
+static const char *handshake_name[] = { "ACK", "NAK", "STALL" };
+
+static int parse_bytes(char *s, U8 *bytes, int *expect) {
+	char *tok;
+	int n = 0;
+
+	*expect = ACK;
+	for (tok = strtok(s, " \t\n"); tok != NULL; tok = strtok(NULL, " \t\n")) {
+		if (strcmp(tok, "stall") == 0)
+			*expect = STALL;
+		else if (strcmp(tok, "nak") == 0)
+			*expect = NAK;
+		else if (n < 256)
+			bytes[n++] = strtoul(tok, NULL, 16);
+	}
+	return n;
+}
+
+static int replay(const char *file) {
+	FILE *fp = fopen(file, "r");
+	char line[1024], *cmd, *args, *hash, name[64];
+	long value;
+	U8 bytes[256], packet[64];
+	int lineno = 0, transfers = 0, n, expect, length, i, handshake;
+
+	if (fp == NULL) {
+		perror(file);
+		return 1;
+	}
+	usb_sim_reset();
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		lineno += 1;
+		if ((hash = strchr(line, '#')) != NULL)
+			*hash = '\0';
+		cmd = strtok(line, " \t\n");
+		if (cmd == NULL)
+			continue;
+		args = strtok(NULL, "");
+		if (args == NULL)
+			args = "";
+		if (verbose)
+			printf("%s:%d: %s\n", file, lineno, cmd);
+
+		if (strcmp(cmd, "set") == 0 || strcmp(cmd, "expect") == 0) {
+			if (sscanf(args, "%63s %li", name, &value) != 2 || (i = replay_var(name)) < 0) {
+				fprintf(stderr, "%s:%d: cannot parse\n", file, lineno);
+				goto failed;
+			}
+			if (cmd[0] == 's')
+				replay_var_set(i, value);
+			else if (replay_var_get(i) != (U32)value) {
+				fprintf(stderr, "%s:%d: %s is %u\n", file, lineno, name, replay_var_get(i));
+				goto failed;
+			}
+			continue;
+		}
+		if (strcmp(cmd, "reply") == 0 && strstr(args, "stale") != NULL) {
+			if (vendor_deferred == 0 || usb_ctrl_deferred_ack(vendor_tickets[0])
+				|| usb_ctrl_deferred_stall(vendor_tickets[0])) {
+				fprintf(stderr, "%s:%d: stale reply taken\n", file, lineno);
+				goto failed;
+			}
+			memmove(vendor_tickets, vendor_tickets + 1, sizeof(vendor_tickets) - sizeof(vendor_tickets[0]));
+			vendor_deferred -= 1;
+			continue;
+		}
+		n = parse_bytes(args, bytes, &expect);
+
+		if (strcmp(cmd, "setup") == 0 && n == 8) {
+			host_setup(bytes);
+			control_coverage(bytes);
+			transfers += 1;
+		} else if (strcmp(cmd, "in") == 0) {
+			for (i = 0; (handshake = host_in(packet, &length)) == NAK && i < RETRIES; i += 1)
+				if (pump() < 0)
+					break;
+			if (handshake != expect) {
+				fprintf(stderr, "%s:%d: IN got %s\n", file, lineno, handshake_name[handshake]);
+				goto failed;
+			}
+			if (expect == ACK && (length != n || memcmp(packet, bytes, n) != 0)) {
+				fprintf(stderr, "%s:%d: IN got", file, lineno);
+				for (i = 0; i < length; i += 1)
+					fprintf(stderr, " %02x", packet[i]);
+				fprintf(stderr, "\n");
+				goto failed;
+			}
+		} else if (strcmp(cmd, "out") == 0) {
+			for (i = 0; (handshake = host_out(bytes, n)) == NAK && i < RETRIES; i += 1)
+				if (pump() < 0)
+					break;
+			if (handshake != expect) {
+				fprintf(stderr, "%s:%d: OUT got %s\n", file, lineno, handshake_name[handshake]);
+				goto failed;
+			}
+		} else if (strcmp(cmd, "reply") == 0) {
+			U16 ticket = vendor_deferred ? vendor_tickets[vendor_deferred - 1] : 0;
+
+			memcpy(vendor_buffer, bytes, n);
+			if (vendor_deferred == 0 || (expect == STALL ? ! usb_ctrl_deferred_stall(ticket) :
+										 vendor_deferred_in ? ! usb_ctrl_deferred_send(ticket, vendor_buffer, n)
+										 : n != 0 || ! usb_ctrl_deferred_ack(ticket))) {
+				fprintf(stderr, "%s:%d: reply refused\n", file, lineno);
+				goto failed;
+			}
+			vendor_deferred = 0;
+		} else if (strcmp(cmd, "speed") == 0) {
+			usb_sim.full_speed = strstr(args, "full") != NULL;
+			continue;
+		} else if (strcmp(cmd, "address") == 0) {
+			if ( ! usb_sim.address_enabled || usb_sim.address != strtoul(args, NULL, 0)) {
+				fprintf(stderr, "%s:%d: address %u%s\n", file, lineno, usb_sim.address,
+						usb_sim.address_enabled ? "" : " not enabled");
+				goto failed;
+			}
+			continue;
+		} else if (strcmp(cmd, "config") == 0) {
+			if (usb_configuration_nb != strtoul(args, NULL, 0)) {
+				fprintf(stderr, "%s:%d: configuration %u\n", file, lineno, usb_configuration_nb);
+				goto failed;
+			}
+			continue;
+		} else if (strcmp(cmd, "idle") == 0) {
+			if (usb_ctrl_get_state() != USB_CTRL_IDLE) {
+				fprintf(stderr, "%s:%d: state %d\n", file, lineno, usb_ctrl_get_state());
+				goto failed;
+			}
+			continue;
+		} else {
+			fprintf(stderr, "%s:%d: cannot parse\n", file, lineno);
+			goto failed;
+		}
+		if (pump() < 0) {
+			fprintf(stderr, "%s:%d: interrupt does not settle\n", file, lineno);
+			goto failed;
+		}
+	}
+	fclose(fp);
+	printf("%s: %d transfers ok\n", file, transfers);
+	return 0;
+
+ failed:
+	fclose(fp);
+	return 1;
+}
+
+int main(int argc, char *argv[]) {
+	int c, i, used = 0, status = 0;
+
+	while ((c = getopt(argc, argv, "v")) != -1) {
+		switch (c) {
+		case 'v': verbose = 1; break;
+		default:
+			fprintf(stderr, "usage: usb-ctrl-replay [-v] file...\n");
+			return 2;
+		}
+	}
+	usb_ctrl_register(DRT_MASK | DRR_MASK, DRT_VENDOR | DRR_DEVICE, vendor_request);
+	usb_ctrl_register(DRT_MASK | DRR_MASK, DRT_CLASS | DRR_INTERFACE, uac2_user_audio_request);
+	for ( ; optind < argc; optind += 1)
+		status |= replay(argv[optind]);
+
+	for (i = 0; i < uac2_nb_controls; i += 1)
+		used += control_used[i];
+	if (used > 0 && used < uac2_nb_controls) {
+		for (i = 0; i < uac2_nb_controls; i += 1)
+			if ( ! control_used[i])
+				fprintf(stderr, "audio control %d, type %02x request %02x entity %02x selector %02x not replayed\n",
+						i, uac2_controls[i].type, uac2_controls[i].request,
+						uac2_controls[i].entity, uac2_controls[i].selector);
+		status = 1;
+	}
+	return status;
+}
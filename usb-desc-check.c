@@ -0,0 +1,540 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb-desc-check.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Walk the configuration descriptors of every image as the firmware
+ * compiles them, built for the host against the stubs in etc/usb-desc-check,
+ * and check what a host would choke on before it gets that far:
+ *
+ *   usb-desc-check [-v]
+ *
+ *   - descriptor lengths, wTotalLength of the configuration and of the
+ *     audio control header, bNumInterfaces, bNumEndpoints of each alt
+ *   - wMaxPacketSize and bInterval legal for the transfer type and speed
+ *   - the periodic endpoints of the widest alt settings fit in a frame
+ *   - each audio streaming endpoint carries the highest rate of its
+ *     format, UAC1 from the format type descriptor, UAC2 from the rates
+ *     of uac2_audio_function.h, decimated in the alts linked to the
+ *     narrowband IQ terminal, plus the extra sample of the feedback
+ *   - the UAC1 format type descriptors are the format and rates of
+ *     uac1_audio_function.h, the HPSDR bulk endpoints the sizes of
+ *     hpsdr_frame.h and a whole number of them to a frame
+ *   - the RANGE replies UAC2_RANGE() generates are well formed
+ *   - the packet size and transaction arithmetic gives the worked examples
+ *
+ * Exits 1 if any image has an error, -v lists what was walked.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "uac1_audio_function.h"
+#include "uac2_audio_function.h"
+#include "hpsdr_frame.h"
+
+// the descriptors, as blobs, their types are of no interest here
+extern const U8 uac1_dg8saq_usb_dev_desc[], uac1_audio_usb_dev_desc[], uac1_usb_qualifier_desc[];
+extern const U8 uac1_usb_conf_desc_fs[], uac1_usb_conf_desc_hs[];
+extern const U8 uac1_usb_conf_desc_fs_widget[], uac1_usb_conf_desc_hs_widget[];
+extern const U8 uac2_dg8saq_usb_dev_desc[], uac2_audio_usb_dev_desc[], uac2_usb_qualifier_desc[];
+extern const U8 uac2_usb_conf_desc_fs[], uac2_usb_conf_desc_hs[];
+extern const U8 uac2_usb_conf_desc_implicit_fs[], uac2_usb_conf_desc_implicit_hs[];
+extern const U8 hpsdr_usb_dev_desc[], hpsdr_usb_qualifier_desc[];
+extern const U8 hpsdr_usb_conf_desc_fs[], hpsdr_usb_conf_desc_hs[];
+
+#define DESC_DEVICE			0x01
+#define DESC_CONFIGURATION	0x02
+#define DESC_INTERFACE		0x04
+#define DESC_ENDPOINT		0x05
+#define DESC_QUALIFIER		0x06
+#define DESC_IAD			0x0B
+#define DESC_HID			0x21
+#define DESC_CS_INTERFACE	0x24
+#define DESC_CS_ENDPOINT	0x25
+
+// the narrowband IQ output terminal of src/uac2_usb_descriptors.h, off by
+// one and its alt is held against the undecimated rate, which it fails
+#define IQ_OUTPUT_TERMINAL_ID	0x23
+
+#define CLASS_AUDIO			0x01
+#define SUBCLASS_CONTROL	0x01
+#define SUBCLASS_STREAMING	0x02
+
+#define EP_ISOCHRONOUS		1
+#define EP_BULK				2
+#define EP_INTERRUPT		3
+
+// what the host controller hands out to periodic transfers, 80% of a
+// microframe at high speed and 90% of a frame at full speed, minus a
+// rough allowance for the token and handshake overhead
+#define PERIODIC_BYTES_HS	6000
+#define PERIODIC_BYTES_FS	1350
+
+typedef struct {
+	const char *name;
+	const U8 *desc;
+	Bool high_speed;
+	int uac;				// audio class version of the streaming checks, 0 for none
+} image_config_t;
+
+static const image_config_t configs[] = {
+	{ "uac1_usb_conf_desc_fs",			uac1_usb_conf_desc_fs,			FALSE, 1 },
+	{ "uac1_usb_conf_desc_hs",			uac1_usb_conf_desc_hs,			TRUE,  1 },
+	{ "uac1_usb_conf_desc_fs_widget",	uac1_usb_conf_desc_fs_widget,	FALSE, 1 },
+	{ "uac1_usb_conf_desc_hs_widget",	uac1_usb_conf_desc_hs_widget,	TRUE,  1 },
+	{ "uac2_usb_conf_desc_fs",			uac2_usb_conf_desc_fs,			FALSE, 2 },
+	{ "uac2_usb_conf_desc_hs",			uac2_usb_conf_desc_hs,			TRUE,  2 },
+	{ "uac2_usb_conf_desc_implicit_fs",	uac2_usb_conf_desc_implicit_fs,	FALSE, 2 },
+	{ "uac2_usb_conf_desc_implicit_hs",	uac2_usb_conf_desc_implicit_hs,	TRUE,  2 },
+	{ "hpsdr_usb_conf_desc_fs",			hpsdr_usb_conf_desc_fs,			FALSE, 0 },
+	{ "hpsdr_usb_conf_desc_hs",			hpsdr_usb_conf_desc_hs,			TRUE,  0 },
+};
+
+static const struct {
+	const char *name;
+	const U8 *desc;
+	U8 type;
+	U8 length;
+} devices[] = {
+	{ "uac1_dg8saq_usb_dev_desc",	uac1_dg8saq_usb_dev_desc,	DESC_DEVICE,	18 },
+	{ "uac1_audio_usb_dev_desc",	uac1_audio_usb_dev_desc,	DESC_DEVICE,	18 },
+	{ "uac1_usb_qualifier_desc",	uac1_usb_qualifier_desc,	DESC_QUALIFIER,	10 },
+	{ "uac2_dg8saq_usb_dev_desc",	uac2_dg8saq_usb_dev_desc,	DESC_DEVICE,	18 },
+	{ "uac2_audio_usb_dev_desc",	uac2_audio_usb_dev_desc,	DESC_DEVICE,	18 },
+	{ "uac2_usb_qualifier_desc",	uac2_usb_qualifier_desc,	DESC_QUALIFIER,	10 },
+	{ "hpsdr_usb_dev_desc",			hpsdr_usb_dev_desc,			DESC_DEVICE,	18 },
+	{ "hpsdr_usb_qualifier_desc",	hpsdr_usb_qualifier_desc,	DESC_QUALIFIER,	10 },
+};
+
+static const U8 uac2_spk_range[] = UAC2_RANGE(UAC2_SPK_RATES);
+static const U8 uac2_mic_range[] = UAC2_RANGE(UAC2_MIC_RATES);
+static const U8 uac2_iq_range[] = UAC2_RANGE_IQ(UAC2_MIC_RATES);
+
+static int verbose;
+static int errors;
+static const char *current;		// name of what is being checked
+
+static void error(int offset, const char *fmt, ...) {
+	va_list ap;
+
+	fprintf(stderr, "%s", current);
+	if (offset >= 0)
+		fprintf(stderr, " +%d", offset);
+	fprintf(stderr, ": ");
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fprintf(stderr, "\n");
+	errors += 1;
+}
+
+static U16 get_le16(const U8 *p) {
+	return p[0] | (p[1] << 8);
+}
+
+static U32 get_le24(const U8 *p) {
+	return p[0] | (p[1] << 8) | ((U32)p[2] << 16);
+}
+
+static U32 get_le32(const U8 *p) {
+	return get_le24(p) | ((U32)p[3] << 24);
+}
+
+//
+// the stream format of the streaming alt being walked, filled in
+// from its class specific descriptors, checked at its data endpoint
+//
+typedef struct {
+	int channels;
+	int subslot;				// bytes per sample on the bus
+	int resolution;
+	int terminal;				// bTerminalLink, UAC2
+	U32 rate_max;
+} stream_t;
+
+//
+// bytes per (micro)frame the endpoint at p may move, 0 for non periodic
+//
+static int periodic_bytes(const U8 *p, Bool high_speed) {
+	int type = p[3] & 0x03;
+	int size = get_le16(&p[4]) & 0x07ff;
+	int mult = (get_le16(&p[4]) >> 11) & 0x03;
+	int interval = p[6];
+
+	if (type == EP_ISOCHRONOUS || (type == EP_INTERRUPT && high_speed))
+		return (size * (mult + 1) + (1 << (interval - 1)) - 1) >> (interval - 1);
+	if (type == EP_INTERRUPT)
+		return (size + interval - 1) / interval;
+	return 0;
+}
+
+static void check_endpoint(const U8 *p, int offset, Bool high_speed) {
+	int type = p[3] & 0x03;
+	int size = get_le16(&p[4]) & 0x07ff;
+	int mult = (get_le16(&p[4]) >> 11) & 0x03;
+	int interval = p[6];
+
+	if ((p[2] & 0x0f) == 0)
+		error(offset, "endpoint 0 in a configuration");
+
+	if ( ! high_speed) {
+		if (mult != 0)
+			error(offset, "endpoint %02x: additional transactions at full speed", p[2]);
+		if (type == EP_ISOCHRONOUS && size > 1023)
+			error(offset, "endpoint %02x: isochronous wMaxPacketSize %d > 1023", p[2], size);
+		if (type == EP_INTERRUPT && size > 64)
+			error(offset, "endpoint %02x: interrupt wMaxPacketSize %d > 64", p[2], size);
+		if (type == EP_BULK && size != 8 && size != 16 && size != 32 && size != 64)
+			error(offset, "endpoint %02x: bulk wMaxPacketSize %d, not 8, 16, 32 or 64", p[2], size);
+	} else {
+		if (type == EP_BULK && (size != 512 || mult != 0))
+			error(offset, "endpoint %02x: bulk wMaxPacketSize %d, not 512", p[2], size);
+		if (type != EP_BULK && (size > 1024 || mult > 2))
+			error(offset, "endpoint %02x: wMaxPacketSize %d x %d", p[2], size, mult + 1);
+		// USB 2.0 table 9-14, a high bandwidth endpoint needs the larger packets
+		if ((mult == 1 && size < 513) || (mult == 2 && size < 683))
+			error(offset, "endpoint %02x: %d additional transactions of only %d bytes", p[2], mult, size);
+	}
+
+	if (type == EP_ISOCHRONOUS || (type == EP_INTERRUPT && high_speed)) {
+		if (interval < 1 || interval > 16)
+			error(offset, "endpoint %02x: bInterval %d not 1..16", p[2], interval);
+	} else if (type == EP_INTERRUPT && interval < 1)
+		error(offset, "endpoint %02x: bInterval 0", p[2]);
+}
+
+//
+// the data endpoint of an audio stream has to carry its highest rate, one
+// extra sample per interval for the feedback to ask for
+//
+static void check_stream(const U8 *p, int offset, Bool high_speed, const stream_t *sp) {
+	int size = get_le16(&p[4]) & 0x07ff;
+	int mult = (get_le16(&p[4]) >> 11) & 0x03;
+	U32 interval_us = (high_speed ? 125 : 1000) << (p[6] - 1);
+	U32 samples = (sp->rate_max * interval_us + 999999) / 1000000 + 1;
+	U32 bytes = samples * sp->channels * sp->subslot;
+
+	if (sp->channels == 0 || sp->subslot == 0) {
+		error(offset, "endpoint %02x: no format for the stream", p[2]);
+		return;
+	}
+	if (sp->resolution > sp->subslot * 8)
+		error(offset, "endpoint %02x: %d bits in %d byte samples", p[2], sp->resolution, sp->subslot);
+	if (bytes > (U32)size * (mult + 1))
+		error(offset, "endpoint %02x: %u Hz needs %u bytes per %u us, wMaxPacketSize %d x %d",
+			  p[2], sp->rate_max, bytes, interval_us, size, mult + 1);
+	if (verbose)
+		printf("  endpoint %02x: %d x %d bytes, %u Hz needs %u\n",
+			   p[2], size, mult + 1, sp->rate_max, bytes);
+}
+
+static void check_config(const image_config_t *cp) {
+	const U8 *desc = cp->desc;
+	int total = get_le16(&desc[2]);
+	int offset, i;
+	int interface = -1, alt = 0, endpoints = 0, klass = 0, subclass = 0;
+	int ac_offset = -1, ac_total = 0, ac_sum = 0;
+	int iad_first = -1, iad_count = 0;
+	Bool seen[256];
+	int nb_interfaces = 0;
+	int alt_bytes = 0;
+	int widest[256];				// periodic bytes of the widest alt of each interface
+	int periodic = 0;
+	stream_t stream;
+
+	current = cp->name;
+	memset(seen, 0, sizeof(seen));
+	memset(widest, 0, sizeof(widest));
+	memset(&stream, 0, sizeof(stream));
+
+	if (desc[0] != 9 || desc[1] != DESC_CONFIGURATION) {
+		error(0, "not a configuration descriptor");
+		return;
+	}
+
+	for (offset = 0; offset < total; offset += desc[offset]) {
+		const U8 *p = &desc[offset];
+		int length = p[0];
+
+		if (length < 2 || offset + length > total) {
+			error(offset, "descriptor of %d bytes overruns wTotalLength %d", length, total);
+			return;
+		}
+
+		// the audio control header counts itself and the unit and terminal descriptors after it
+		if (ac_offset >= 0 && p[1] != DESC_CS_INTERFACE) {
+			if (ac_sum != ac_total)
+				error(ac_offset, "audio control wTotalLength %d, descriptors add up to %d", ac_total, ac_sum);
+			ac_offset = -1;
+		}
+
+		switch (p[1]) {
+		case DESC_CONFIGURATION:
+			if (offset != 0)
+				error(offset, "second configuration descriptor");
+			break;
+
+		case DESC_IAD:
+			if (length != 8)
+				error(offset, "interface association of %d bytes", length);
+			iad_first = p[2];
+			iad_count = p[3];
+			break;
+
+		case DESC_INTERFACE:
+			if (length != 9)
+				error(offset, "interface of %d bytes", length);
+			if (interface >= 0 && endpoints != 0)
+				error(offset, "interface %d alt %d: %d endpoints missing", interface, alt, endpoints);
+			if (interface >= 0 && alt_bytes > widest[interface])
+				widest[interface] = alt_bytes;
+			interface = p[2];
+			alt = p[3];
+			endpoints = p[4];
+			klass = p[5];
+			subclass = p[6];
+			alt_bytes = 0;
+			memset(&stream, 0, sizeof(stream));
+			if ( ! seen[interface]) {
+				seen[interface] = TRUE;
+				nb_interfaces += 1;
+				if (alt != 0)
+					error(offset, "interface %d starts at alt %d", interface, alt);
+			}
+			if (iad_first >= 0 && (interface < iad_first || interface >= iad_first + iad_count) && klass == CLASS_AUDIO)
+				error(offset, "audio interface %d outside of its association %d..%d",
+					  interface, iad_first, iad_first + iad_count - 1);
+			if (verbose)
+				printf(" interface %d alt %d class %02x/%02x, %d endpoints\n",
+					   interface, alt, klass, subclass, endpoints);
+			break;
+
+		case DESC_ENDPOINT:
+			// UAC1 audio endpoints carry bRefresh and bSynchAddress
+			if (length != 7 && ! (length == 9 && cp->uac == 1 && klass == CLASS_AUDIO))
+				error(offset, "endpoint of %d bytes", length);
+			if (interface < 0)
+				error(offset, "endpoint outside of an interface");
+			if (endpoints-- == 0)
+				error(offset, "interface %d alt %d: more endpoints than bNumEndpoints", interface, alt);
+			check_endpoint(p, offset, cp->high_speed);
+			alt_bytes += periodic_bytes(p, cp->high_speed);
+			// the Ozy interface of the HPSDR image, the one without audio
+			if (cp->uac == 0 && (p[3] & 0x03) == EP_BULK) {
+				int size = get_le16(&p[4]) & 0x07ff;
+
+				if (size != (cp->high_speed ? HPSDR_EP_SIZE_HS : HPSDR_EP_SIZE_FS))
+					error(offset, "endpoint %02x: wMaxPacketSize %d, not that of hpsdr_frame.h", p[2], size);
+				else if (HPSDR_FRAME_BYTES % size != 0)
+					error(offset, "endpoint %02x: %d byte frames in %d byte packets", p[2], HPSDR_FRAME_BYTES, size);
+			}
+			// the data endpoint of a stream, not its explicit feedback
+			if (cp->uac != 0 && klass == CLASS_AUDIO && subclass == SUBCLASS_STREAMING
+				&& (p[3] & 0x03) == EP_ISOCHRONOUS && (p[3] & 0x30) != 0x10)
+				check_stream(p, offset, cp->high_speed, &stream);
+			break;
+
+		case DESC_HID:
+			if (length != 9)
+				error(offset, "HID descriptor of %d bytes", length);
+			break;
+
+		case DESC_CS_INTERFACE:
+			if (klass != CLASS_AUDIO)
+				break;
+			if (subclass == SUBCLASS_CONTROL) {
+				if (p[2] == 0x01) {				// header
+					ac_offset = offset;
+					ac_total = get_le16(&p[cp->uac == 2 ? 6 : 5]);
+					ac_sum = 0;
+				}
+				ac_sum += length;
+			} else if (subclass == SUBCLASS_STREAMING) {
+				if (p[2] == 0x01 && cp->uac == 2) {			// AS general, bTerminalLink, bNrChannels
+					stream.terminal = p[3];
+					stream.channels = p[10];
+				}
+				if (p[2] == 0x02 && p[3] == 0x01) {			// format type I
+					if (cp->uac == 2) {
+						stream.subslot = p[4];
+						stream.resolution = p[5];
+						stream.rate_max = cp->high_speed ? UAC2_RATE_MAX_HS : UAC2_RATE_MAX_FS;
+						// the narrowband IQ alt of the record interface, decimated
+						if (stream.terminal == IQ_OUTPUT_TERMINAL_ID)
+							stream.rate_max /= UAC2_IQ_DECIMATION;
+					} else {
+						stream.channels = p[4];
+						stream.subslot = p[5];
+						stream.resolution = p[6];
+						// the widget images leave room for a second rate, hosts read bSamFreqType
+						if (length < 8 + 3 * (p[7] == 0 ? 2 : p[7]))
+							error(offset, "format type of %d bytes for %d rates", length, p[7]);
+						// discrete rates, or the lower and upper bound of a continuous range
+						for (i = 0; i < (p[7] == 0 ? 2 : p[7]); i += 1)
+							if (get_le24(&p[8 + 3*i]) > stream.rate_max)
+								stream.rate_max = get_le24(&p[8 + 3*i]);
+						if (stream.channels != UAC1_NB_CHANNELS || stream.subslot != UAC1_SUBSLOT_SIZE
+							|| stream.resolution != UAC1_BIT_RESOLUTION)
+							error(offset, "format %d x %d bytes of %d bits, not that of uac1_audio_function.h",
+								  stream.channels, stream.subslot, stream.resolution);
+						if (p[7] == 0 || stream.rate_max != UAC1_RATE_MAX
+							|| get_le24(&p[8]) != (p[7] == 1 ? UAC1_RATE_MAX : UAC1_RATE_MIN))
+							error(offset, "rates not those of uac1_audio_function.h");
+					}
+				}
+			}
+			break;
+
+		case DESC_CS_ENDPOINT:
+			break;
+
+		default:
+			error(offset, "unexpected descriptor type %02x", p[1]);
+			break;
+		}
+	}
+
+	if (offset != total)
+		error(offset, "descriptors end past wTotalLength %d", total);
+	if (ac_offset >= 0 && ac_sum != ac_total)
+		error(ac_offset, "audio control wTotalLength %d, descriptors add up to %d", ac_total, ac_sum);
+	if (interface >= 0 && endpoints != 0)
+		error(-1, "interface %d alt %d: %d endpoints missing", interface, alt, endpoints);
+	if (interface >= 0 && alt_bytes > widest[interface])
+		widest[interface] = alt_bytes;
+	if (nb_interfaces != desc[4])
+		error(4, "bNumInterfaces %d, %d interfaces described", desc[4], nb_interfaces);
+	for (i = 0; i < nb_interfaces; i += 1)
+		if ( ! seen[i])
+			error(-1, "interface numbers not 0..%d", nb_interfaces - 1);
+
+	for (i = 0; i < 256; i += 1)
+		periodic += widest[i];
+	if (periodic > (cp->high_speed ? PERIODIC_BYTES_HS : PERIODIC_BYTES_FS))
+		error(-1, "periodic endpoints need %d bytes per %s", periodic, cp->high_speed ? "microframe" : "frame");
+
+	if (verbose)
+		printf("%s: %d bytes, %d interfaces, %d periodic bytes per %s\n", cp->name, total,
+			   nb_interfaces, periodic, cp->high_speed ? "microframe" : "frame");
+}
+
+//
+// the packet size arithmetic of uac2_audio_function.h against worked
+// examples, the DoP rates carry DSD64..DSD512 in 24 bit PCM
+//
+static const struct {
+	U32 rate;
+	U32 us;
+	U8 channels;
+	U8 subslot;
+	U16 bytes;				// per service interval, one sample of slack
+	U8 transactions;
+	U16 max_packet;			// wMaxPacketSize
+} packet_cases[] = {
+	{   44100, 1000, 2, 4,  368, 1, 368 },
+	{   48000, 1000, 2, 4,  392, 1, 392 },
+	{  192000,  250, 2, 4,  392, 1, 392 },
+	{  192000,  125, 2, 4,  200, 1, 200 },
+	{  352800,  125, 2, 4,  368, 1, 368 },
+	{  384000,  125, 2, 4,  392, 1, 392 },
+	{  705600,  125, 2, 4,  720, 1, 720 },		// DoP DSD256
+	{  768000,  125, 2, 4,  776, 1, 776 },
+	{ 1411200,  125, 2, 4, 1424, 2, 712 | (1 << 11) },	// DoP DSD512
+	{  384000,  125, 8, 4, 1568, 2, 784 | (1 << 11) },
+	{  768000,  125, 6, 4, 2328, 3, 776 | (2 << 11) },
+};
+
+static void check_packet_arithmetic(void) {
+	int i;
+
+	current = "uac2_audio_function.h";
+	for (i = 0; i < sizeof(packet_cases) / sizeof(packet_cases[0]); i += 1) {
+		U32 bytes = UAC2_EP_BYTES_FORMAT(packet_cases[i].rate, packet_cases[i].us,
+										 packet_cases[i].channels, packet_cases[i].subslot);
+
+		if (bytes != packet_cases[i].bytes || UAC2_EP_TRANSACTIONS(bytes) != packet_cases[i].transactions
+			|| UAC2_EP_MAX_PACKET(bytes) != packet_cases[i].max_packet)
+			error(-1, "%u Hz x %d every %u us: %u bytes, %u x %u, wMaxPacketSize %04x, expected %u, %u, %04x",
+				  packet_cases[i].rate, packet_cases[i].channels, packet_cases[i].us, bytes,
+				  UAC2_EP_TRANSACTIONS(bytes), UAC2_EP_TRANSACTION_SIZE(bytes), UAC2_EP_MAX_PACKET(bytes),
+				  packet_cases[i].bytes, packet_cases[i].transactions, packet_cases[i].max_packet);
+	}
+
+	if (UAC2_EP_TRANSACTIONS_HS > 3)
+		error(-1, "UAC2_RATE_MAX_HS needs %d transactions per microframe", UAC2_EP_TRANSACTIONS_HS);
+	if (UAC2_EP_SIZE_HS * UAC2_EP_TRANSACTIONS_HS < UAC2_EP_BYTES_HS)
+		error(-1, "%d x %d bytes for %d", UAC2_EP_TRANSACTIONS_HS, UAC2_EP_SIZE_HS, UAC2_EP_BYTES_HS);
+}
+
+//
+// wNumSubRanges, then discrete ascending subranges, none the endpoints can't carry
+// nor the bit clock make
+//
+static void check_range(const char *name, const U8 *range, int size) {
+	int n = get_le16(range);
+	int i;
+	U32 previous = 0;
+	Bool full_speed = FALSE;
+
+	current = name;
+	if (size != 2 + 12 * n) {
+		error(-1, "%d bytes for %d subranges", size, n);
+		return;
+	}
+	for (i = 0; i < n; i += 1) {
+		const U8 *sp = &range[2 + 12*i];
+		U32 rate = get_le32(sp);
+
+		if (get_le32(&sp[4]) != rate || get_le32(&sp[8]) != 0)
+			error(2 + 12*i, "subrange %d not a discrete rate", i);
+		if (rate <= previous)
+			error(2 + 12*i, "%u Hz after %u Hz", rate, previous);
+		if (rate > UAC2_RATE_MAX_HS)
+			error(2 + 12*i, "%u Hz above UAC2_RATE_MAX_HS", rate);
+		if (rate > UAC2_RATE_MAX_CLOCK)
+			error(2 + 12*i, "%u Hz above UAC2_RATE_MAX_CLOCK", rate);
+		if (rate <= UAC2_RATE_MAX_FS)
+			full_speed = TRUE;
+		previous = rate;
+	}
+	if ( ! full_speed)
+		error(-1, "no rate for full speed");
+	if (verbose)
+		printf("%s: %d rates\n", name, n);
+}
+
+int main(int argc, char *argv[]) {
+	int i;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	for (i = 0; i < sizeof(devices) / sizeof(devices[0]); i += 1) {
+		current = devices[i].name;
+		if (devices[i].desc[0] != devices[i].length || devices[i].desc[1] != devices[i].type)
+			error(0, "not a %d byte descriptor of type %d", devices[i].length, devices[i].type);
+		else if (devices[i].desc[7] != 64)
+			error(7, "bMaxPacketSize0 %d", devices[i].desc[7]);
+	}
+
+	for (i = 0; i < sizeof(configs) / sizeof(configs[0]); i += 1)
+		check_config(&configs[i]);
+
+	check_packet_arithmetic();
+	check_range("UAC2_SPK_RATES", uac2_spk_range, sizeof(uac2_spk_range));
+	check_range("UAC2_MIC_RATES", uac2_mic_range, sizeof(uac2_mic_range));
+	check_range("UAC2_MIC_RATES / UAC2_IQ_DECIMATION", uac2_iq_range, sizeof(uac2_iq_range));
+
+	if (errors) {
+		fprintf(stderr, "usb-desc-check: %d errors\n", errors);
+		return 1;
+	}
+	printf("usb-desc-check: %d configurations ok\n", (int)(sizeof(configs) / sizeof(configs[0])));
+	return 0;
+}
@@ -0,0 +1,202 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * usb-fifo-check.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Run usb_write_ep_txpacket() and usb_read_ep_rxpacket() of usb_drv.c on
+ * the host against the simulated FIFO in etc/usb-fifo-check/usb_drv.h:
+ *
+ *   usb-fifo-check [-v]
+ *
+ * For every FIFO position and buffer alignment modulo 8 and every length
+ * up to past the end of the endpoint, in one call and split in two:
+ *
+ *   - every FIFO access is aligned as the USBB wants it
+ *   - the bytes arrive in order, nothing beyond them is touched
+ *   - the return value and the updated buffer address are right
+ *   - at most 6 8-bit accesses a call and no 16-bit ones, and with buffer
+ *     and FIFO aligned alike at most two 32-bit ones besides the 64-bit ones
+ *
+ * Exits 1 if any transfer fails, -v prints the access counts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "usb_drv.h"
+
+#define CHECK_EP		1
+#define CHECK_EP_SIZE	64
+#define CHECK_GUARD		16		// bytes checked on either side of a read buffer
+
+usb_fifo_sim_t usb_fifo_sim;
+
+static U64 fifo_window[CHECK_EP_SIZE / sizeof(U64)];	// the addresses of the FIFO data register
+static U32 accesses[9];		// by size in bytes
+static int verbose;
+static int errors;
+static int transfers;
+static const char *fail;	// first rule a transfer broke
+
+//
+// the simulated FIFO data register
+//
+static U8 *fifo_access(const volatile void *ptr, U16 size) {
+	U32 offset = (const volatile U8 *)ptr - (U8 *)fifo_window;
+
+	if (offset >= sizeof(fifo_window))
+		fail = fail ? fail : "access outside the FIFO window";
+	else if (offset % (size < 4 ? size : 4) != 0)
+		fail = fail ? fail : "misaligned access";
+	else if (offset % 4 != usb_fifo_sim.pos % 4)
+		fail = fail ? fail : "address does not match the DPRAM position";
+	else if (usb_fifo_sim.pos + size > usb_fifo_sim.size)
+		fail = fail ? fail : "access past the end of the endpoint";
+	if (fail)
+		return NULL;
+	accesses[size] += 1;
+	usb_fifo_sim.pos += size;
+	return &usb_fifo_sim.data[usb_fifo_sim.pos - size];
+}
+
+#define SIM_READ(bits) \
+	TPASTE2(U, bits) TPASTE2(usb_fifo_sim_read, bits)(const volatile void *ptr) { \
+		TPASTE2(U, bits) data = 0; \
+		U8 *dp = fifo_access(ptr, sizeof(data)); \
+		if (dp) memcpy(&data, dp, sizeof(data)); \
+		return data; \
+	}
+#define SIM_WRITE(bits) \
+	void TPASTE2(usb_fifo_sim_write, bits)(volatile void *ptr, TPASTE2(U, bits) data) { \
+		U8 *dp = fifo_access(ptr, sizeof(data)); \
+		if (dp) memcpy(dp, &data, sizeof(data)); \
+	}
+
+SIM_READ(8) SIM_READ(16) SIM_READ(32) SIM_READ(64)
+SIM_WRITE(8) SIM_WRITE(16) SIM_WRITE(32) SIM_WRITE(64)
+
+// a FIFO at fifo_pos as if that many bytes went through it already
+static void sim_reset(Bool in, U16 fifo_pos) {
+	usb_fifo_sim.in = in;
+	usb_fifo_sim.size = CHECK_EP_SIZE;
+	usb_fifo_sim.pos = fifo_pos;
+	pep_fifo[CHECK_EP].u8ptr = (U8 *)fifo_window + fifo_pos;
+	memset(accesses, 0, sizeof(accesses));
+	fail = NULL;
+}
+
+static void check_accesses(int calls, Bool same_alignment) {
+	if (accesses[1] > 6 * calls)
+		fail = fail ? fail : "more than 6 8-bit accesses a call";
+	else if (accesses[2] > 0)
+		fail = fail ? fail : "16-bit accesses";
+	else if (same_alignment && accesses[4] > 2)
+		fail = fail ? fail : "more than 2 32-bit accesses with aligned buffer";
+	if ((U32)((U8 *)pep_fifo[CHECK_EP].u8ptr - (U8 *)fifo_window) % 4 != usb_fifo_sim.pos % 4)
+		fail = fail ? fail : "FIFO address left off the DPRAM position";
+}
+
+static void report(const char *what, U16 fifo_pos, U16 buf_ofs, U32 length, U32 split) {
+	transfers += 1;
+	if (fail) {
+		fprintf(stderr, "usb-fifo-check: %s at FIFO %u, buffer +%u, %u bytes split at %u: %s\n",
+				what, fifo_pos, buf_ofs, length, split, fail);
+		errors += 1;
+	} else if (verbose)
+		printf("%s FIFO %2u buffer +%u %3u bytes split %3u: %u x 8, %u x 32, %u x 64 bits\n",
+			   what, fifo_pos, buf_ofs, length, split, accesses[1], accesses[4], accesses[8]);
+}
+
+//
+// write length bytes from a buffer at buf_ofs into a FIFO at fifo_pos,
+// in two calls split bytes apart, split within the endpoint
+//
+static void check_write(U16 fifo_pos, U16 buf_ofs, U32 length, U32 split) {
+	U64 buffer[(CHECK_EP_SIZE + 2 * CHECK_GUARD) / sizeof(U64)];
+	U8 *src = (U8 *)buffer + buf_ofs;
+	const void *end;
+	U32 n = min(length, (U32)CHECK_EP_SIZE - fifo_pos), left, i;
+
+	for (i = 0; i < sizeof(buffer); i += 1)
+		((U8 *)buffer)[i] = (U8)(i * 7 + 1);
+	memset(usb_fifo_sim.data, 0xee, sizeof(usb_fifo_sim.data));
+	sim_reset(TRUE, fifo_pos);
+
+	left = usb_write_ep_txpacket(CHECK_EP, src, split, &end);
+	if (left != split - min(split, n) || end != src + min(split, n))
+		fail = fail ? fail : "first call returned wrong count or address";
+	left = usb_write_ep_txpacket(CHECK_EP, end, length - split, &end);
+	if (left != length - n || end != src + n)
+		fail = fail ? fail : "returned wrong count or address";
+	if (usb_fifo_sim.pos != fifo_pos + n || memcmp(&usb_fifo_sim.data[fifo_pos], src, n) != 0)
+		fail = fail ? fail : "wrong data in the FIFO";
+	for (i = 0; i < sizeof(usb_fifo_sim.data); i += 1)
+		if ((i < fifo_pos || i >= fifo_pos + n) && usb_fifo_sim.data[i] != 0xee)
+			fail = fail ? fail : "wrote outside the transfer";
+	check_accesses(split ? 2 : 1, split == 0 && buf_ofs % 4 == fifo_pos % 4);
+	report("write", fifo_pos, buf_ofs, length, split);
+}
+
+//
+// read length bytes from a FIFO at fifo_pos into a buffer at buf_ofs,
+// in two calls split bytes apart, split within the endpoint
+//
+static void check_read(U16 fifo_pos, U16 buf_ofs, U32 length, U32 split) {
+	U64 buffer[(CHECK_EP_SIZE + 2 * CHECK_GUARD) / sizeof(U64) + 1];
+	U8 *dst = (U8 *)buffer + CHECK_GUARD + buf_ofs;
+	void *end;
+	U32 n = min(length, (U32)CHECK_EP_SIZE - fifo_pos), left, i;
+
+	for (i = 0; i < sizeof(usb_fifo_sim.data); i += 1)
+		usb_fifo_sim.data[i] = (U8)(i * 13 + 5);
+	memset(buffer, 0xee, sizeof(buffer));
+	sim_reset(FALSE, fifo_pos);
+	usb_fifo_sim.received = CHECK_EP_SIZE - fifo_pos;	// what is left of the bank
+
+	left = usb_read_ep_rxpacket(CHECK_EP, dst, split, &end);
+	if (left != split - min(split, n) || end != dst + min(split, n))
+		fail = fail ? fail : "first call returned wrong count or address";
+	usb_fifo_sim.received -= min(split, n);
+	left = usb_read_ep_rxpacket(CHECK_EP, end, length - split, &end);
+	if (left != length - n || end != dst + n)
+		fail = fail ? fail : "returned wrong count or address";
+	if (usb_fifo_sim.pos != fifo_pos + n || memcmp(dst, &usb_fifo_sim.data[fifo_pos], n) != 0)
+		fail = fail ? fail : "wrong data in the buffer";
+	for (i = 0; i < sizeof(buffer); i += 1)
+		if (((U8 *)buffer + i < dst || (U8 *)buffer + i >= dst + n) && ((U8 *)buffer)[i] != 0xee)
+			fail = fail ? fail : "wrote outside the buffer";
+	check_accesses(split ? 2 : 1, split == 0 && buf_ofs % 4 == fifo_pos % 4);
+	report("read", fifo_pos, buf_ofs, length, split);
+}
+
+int main(int argc, char *argv[]) {
+	U16 fifo_pos, buf_ofs;
+	U32 length, split;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+		verbose = 1;
+
+	// every alignment of both sides, every length to past the endpoint,
+	// in one call, and from the start of the FIFO split anywhere
+	for (fifo_pos = 0; fifo_pos < 8; fifo_pos += 1)
+		for (buf_ofs = 0; buf_ofs < 8; buf_ofs += 1)
+			for (length = 0; length <= CHECK_EP_SIZE + 8; length += 1) {
+				check_write(fifo_pos, buf_ofs, length, 0);
+				check_read(fifo_pos, buf_ofs, length, 0);
+				if (fifo_pos == 0)
+					for (split = 1; split < min(length, CHECK_EP_SIZE); split += 1) {
+						check_write(0, buf_ofs, length, split);
+						check_read(0, buf_ofs, length, split);
+					}
+			}
+
+	if (errors) {
+		fprintf(stderr, "usb-fifo-check: %d of %d transfers failed\n", errors, transfers);
+		return 1;
+	}
+	printf("usb-fifo-check: %d transfers ok\n", transfers);
+	return 0;
+}
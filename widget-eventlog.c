@@ -0,0 +1,160 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * widget-eventlog.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Decode the binary event log of the widget firmware into text.
+ *
+ *   widget-eventlog [file]           decode "EVT ..." lines captured from the
+ *                                    debug UART, from file or stdin
+ *   widget-eventlog -u [-f] [-d vid:pid]
+ *                                    read the log over USB with the vendor
+ *                                    request, -f keeps following new events
+ *
+ * The event names and format strings come from src/eventlog_events.h,
+ * the same table the firmware is built with.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <libusb-1.0/libusb.h>
+
+#include "src/eventlog_events.h"
+
+#define EVENT(name, format) format,
+static const char * const event_formats[] = { EVENTLOG_EVENTS };
+#undef EVENT
+
+static int have_last_seq = 0;
+static uint16_t last_seq;
+
+static uint32_t get_le32(const uint8_t *bp) {
+	return bp[0] | (bp[1] << 8) | (bp[2] << 16) | ((uint32_t)bp[3] << 24);
+}
+
+static void decode_record(const uint8_t *bp) {
+	eventlog_record_t r;
+	int i;
+
+	r.id = bp[0] | (bp[1] << 8);
+	r.seq = bp[2] | (bp[3] << 8);
+	r.time = get_le32(&bp[4]);
+	for (i = 0; i < 3; i += 1)
+		r.arg[i] = get_le32(&bp[8+4*i]);
+
+	if (have_last_seq && r.seq != (uint16_t)(last_seq + 1))
+		printf("-- %u events lost --\n", (uint16_t)(r.seq - last_seq - 1));
+	have_last_seq = 1;
+	last_seq = r.seq;
+
+	printf("%12.6f %5u ", (double)r.time / EVENTLOG_TIME_HZ, r.seq);
+	if (r.id < ev_end)
+		printf(event_formats[r.id], r.arg[0], r.arg[1], r.arg[2]);
+	else
+		printf("unknown event %u: 0x%x 0x%x 0x%x", r.id, r.arg[0], r.arg[1], r.arg[2]);
+	printf("\n");
+}
+
+static int decode_uart(FILE *fp) {
+	char line[256];
+	uint8_t record[EVENTLOG_RECORD_SIZE];
+	const size_t plen = strlen(EVENTLOG_UART_PREFIX);
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		char *hp = strstr(line, EVENTLOG_UART_PREFIX);
+		int i;
+		if (hp == NULL)
+			continue;						// other debug output
+		hp += plen;
+		for (i = 0; i < EVENTLOG_RECORD_SIZE; i += 1) {
+			unsigned int byte;
+			if (sscanf(hp + 2*i, "%2x", &byte) != 1)
+				break;
+			record[i] = byte;
+		}
+		if (i == EVENTLOG_RECORD_SIZE)
+			decode_record(record);
+	}
+	return 0;
+}
+
+static int decode_usb(int vid, int pid, int follow) {
+	libusb_device_handle *handle;
+	uint8_t buffer[64];
+	uint16_t seq = 0;
+	int n, i;
+
+	if (libusb_init(NULL) < 0) {
+		fprintf(stderr, "widget-eventlog: cannot initialize libusb\n");
+		return 1;
+	}
+	handle = libusb_open_device_with_vid_pid(NULL, vid, pid);
+	if (handle == NULL) {
+		fprintf(stderr, "widget-eventlog: no device %04x:%04x\n", vid, pid);
+		libusb_exit(NULL);
+		return 1;
+	}
+	for (;;) {
+		n = libusb_control_transfer(handle,
+									LIBUSB_ENDPOINT_IN | LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_DEVICE,
+									EVENTLOG_DG8SAQ_COMMAND, 0, seq, buffer, sizeof(buffer), 1000);
+		if (n < 0) {
+			fprintf(stderr, "widget-eventlog: %s\n", libusb_error_name(n));
+			break;
+		}
+		for (i = 0; i + EVENTLOG_RECORD_SIZE <= n; i += EVENTLOG_RECORD_SIZE) {
+			decode_record(&buffer[i]);
+			seq = last_seq + 1;
+		}
+		if (n == 0) {
+			if ( ! follow)
+				break;
+			fflush(stdout);
+			usleep(100000);
+		}
+	}
+	libusb_close(handle);
+	libusb_exit(NULL);
+	return n < 0;
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: widget-eventlog [file]\n"
+			"       widget-eventlog -u [-f] [-d vid:pid]\n");
+	exit(2);
+}
+
+int main(int argc, char *argv[]) {
+	int usb = 0, follow = 0, vid = 0x16c0, pid = 0x05dc;
+	int c;
+
+	while ((c = getopt(argc, argv, "ufd:")) != -1) {
+		switch (c) {
+		case 'u': usb = 1; break;
+		case 'f': follow = 1; break;
+		case 'd':
+			if (sscanf(optarg, "%x:%x", &vid, &pid) != 2)
+				usage();
+			break;
+		default: usage();
+		}
+	}
+	if (usb)
+		return decode_usb(vid, pid, follow);
+	if (optind < argc) {
+		FILE *fp = fopen(argv[optind], "r");
+		int status;
+		if (fp == NULL) {
+			perror(argv[optind]);
+			return 1;
+		}
+		status = decode_uart(fp);
+		fclose(fp);
+		return status;
+	}
+	return decode_uart(stdin);
+}
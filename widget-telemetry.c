@@ -0,0 +1,189 @@
+/* -*- mode: c; tab-width: 4; c-basic-offset: 4 -*- */
+/*
+ * widget-telemetry.c
+ *
+ *  Created on: 2026-10-18
+ *      Author: SDR-Widget team
+ *
+ * Decode the telemetry records of the widget firmware into one line of
+ * tab separated columns per record, for a spreadsheet or gnuplot.
+ *
+ *   widget-telemetry [-e ep] [file]  decode the completed interrupt IN
+ *                                    transfers of endpoint ep, default 6,
+ *                                    in a usbmon text dump, from file or
+ *                                    stdin, as in
+ *                                    cat /sys/kernel/debug/usb/usbmon/1u
+ *   widget-telemetry -b [file]       decode raw records, as read from the
+ *                                    endpoint by any other means
+ *
+ * The tags of a frequency sweep, src/sweep.h, print as comment lines
+ *   # sweep pass p step s block b
+ * the ADC capture block b the first wholly at step s.
+ *
+ * Start the stream, or change its period, with the vendor request in
+ * src/telemetry.h. The record layout comes from src/telemetry_record.h,
+ * the same header the firmware is built with.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "src/telemetry_record.h"
+
+static int have_last_seq = 0;
+static uint16_t last_seq;
+
+static uint16_t get_le16(const uint8_t *bp) {
+	return bp[0] | (bp[1] << 8);
+}
+
+static uint32_t get_le32(const uint8_t *bp) {
+	return bp[0] | (bp[1] << 8) | (bp[2] << 16) | ((uint32_t)bp[3] << 24);
+}
+
+static void print_header(void) {
+	printf("# time\tseq\trate\tfeedback\tfill%%\tpackets\tsamples\tunderruns\toverruns\tcpu%%\n");
+}
+
+static void decode_seq(uint16_t seq) {
+	if (have_last_seq && seq != (uint16_t)(last_seq + 1))
+		printf("# %u records lost\n", (uint16_t)(seq - last_seq - 1));
+	have_last_seq = 1;
+	last_seq = seq;
+}
+
+static void decode_sweep(const uint8_t *bp) {
+	telemetry_sweep_record_t r;
+	unsigned n;
+
+	r.seq = get_le16(&bp[2]);
+	r.pass = get_le16(&bp[4]);
+	r.tags = bp[6];
+	r.lost = bp[7];
+	decode_seq(r.seq);
+
+	if (r.lost != 0)
+		printf("# sweep %u tags lost\n", r.lost);
+	for (n = 0; n < r.tags && n < TELEMETRY_SWEEP_TAGS; n += 1) {
+		r.step[n] = get_le16(&bp[8 + 2 * n]);
+		r.block[n] = get_le32(&bp[16 + 4 * n]);
+		// the pass is one up where the steps start over
+		if (n != 0 && r.step[n] <= r.step[n - 1])
+			r.pass += 1;
+		printf("# sweep pass %u step %u block %u\n", r.pass, r.step[n], r.block[n]);
+	}
+}
+
+static void decode_record(const uint8_t *bp) {
+	telemetry_record_t r;
+
+	r.version = bp[0];
+	r.size = bp[1];
+	if (r.version == TELEMETRY_SWEEP_VERSION && r.size == TELEMETRY_RECORD_SIZE) {
+		decode_sweep(bp);
+		return;
+	}
+	if (r.version != TELEMETRY_RECORD_VERSION || r.size != TELEMETRY_RECORD_SIZE) {
+		printf("# unknown record version %u size %u\n", r.version, r.size);
+		return;
+	}
+	r.seq = get_le16(&bp[2]);
+	r.time = get_le32(&bp[4]);
+	r.frequency = get_le32(&bp[8]);
+	r.fb_rate = get_le32(&bp[12]);
+	r.gap = get_le16(&bp[16]);
+	r.gap_nominal = get_le16(&bp[18]);
+	r.packets = get_le16(&bp[20]);
+	r.underruns = get_le16(&bp[22]);
+	r.overruns = get_le16(&bp[24]);
+	r.cpu_load = get_le16(&bp[26]);
+	r.samples = get_le32(&bp[28]);
+
+	decode_seq(r.seq);
+
+	printf("%.4f\t%u\t%u\t%.3f\t%.1f\t%u\t%u\t%u\t%u\t%.1f\n",
+		   (double)r.time / TELEMETRY_TIME_HZ, r.seq, r.frequency,
+		   (double)r.fb_rate * 1000 / TELEMETRY_FB_RATE_KHZ,
+		   r.gap_nominal == 0 ? 0.0 : 50.0 * r.gap / r.gap_nominal,
+		   r.packets, r.samples, r.underruns, r.overruns, r.cpu_load / 10.0);
+}
+
+//
+// a usbmon text line reads
+//   tag timestamp C Ii:bus:dev:ep status:interval length = data words
+// with the data words in transfer order, up to 32 bytes of them
+//
+static int decode_usbmon(FILE *fp, int ep) {
+	char line[512];
+	uint8_t record[TELEMETRY_RECORD_SIZE];
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		char type[16], *dp;
+		unsigned int bus, dev, lep;
+		int length, n, i = 0;
+
+		if (sscanf(line, "%*s %*s C %15s %*s %d", type, &length) != 2
+			|| sscanf(type, "Ii:%u:%u:%u", &bus, &dev, &lep) != 3
+			|| (int)lep != ep || length != TELEMETRY_RECORD_SIZE
+			|| (dp = strchr(line, '=')) == NULL)
+			continue;						// other traffic
+		for (dp += 1; i < TELEMETRY_RECORD_SIZE; ) {
+			unsigned int byte;
+			while (*dp == ' ')
+				dp += 1;
+			if (sscanf(dp, "%2x%n", &byte, &n) != 1)
+				break;
+			record[i++] = byte;
+			dp += n;
+		}
+		if (i == TELEMETRY_RECORD_SIZE)
+			decode_record(record);
+	}
+	return 0;
+}
+
+static int decode_binary(FILE *fp) {
+	uint8_t record[TELEMETRY_RECORD_SIZE];
+
+	while (fread(record, sizeof(record), 1, fp) == 1)
+		decode_record(record);
+	return ferror(fp) != 0;
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: widget-telemetry [-e ep] [file]\n"
+			"       widget-telemetry -b [file]\n");
+	exit(2);
+}
+
+int main(int argc, char *argv[]) {
+	int binary = 0, ep = 6;
+	int c, status;
+	FILE *fp = stdin;
+
+	while ((c = getopt(argc, argv, "be:")) != -1) {
+		switch (c) {
+		case 'b': binary = 1; break;
+		case 'e':
+			if (sscanf(optarg, "%i", &ep) != 1)
+				usage();
+			ep &= 0x0f;
+			break;
+		default: usage();
+		}
+	}
+	if (optind < argc) {
+		fp = fopen(argv[optind], binary ? "rb" : "r");
+		if (fp == NULL) {
+			perror(argv[optind]);
+			return 1;
+		}
+	}
+	print_header();
+	status = binary ? decode_binary(fp) : decode_usbmon(fp, ep);
+	if (fp != stdin)
+		fclose(fp);
+	return status;
+}